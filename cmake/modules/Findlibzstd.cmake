@@ -0,0 +1,22 @@
+# - Try to find libzstd
+# Once done this will define
+#  LIBZSTD_FOUND - System has libzstd
+#  LIBZSTD_INCLUDE_DIRS - The libzstd include directories
+#  LIBZSTD_LIBRARIES - The libraries needed to use libzstd
+
+find_path(LIBZSTD_INCLUDE_DIR zstd.h
+          HINTS ${LIBZSTD_INCLUDEDIR} )
+
+find_library(LIBZSTD_LIBRARY NAMES zstd libzstd
+             HINTS ${LIBZSTD_LIBDIR})
+
+include(FindPackageHandleStandardArgs)
+# handle the QUIETLY and REQUIRED arguments and set LIBZSTD_FOUND to TRUE
+# if all listed variables are TRUE
+find_package_handle_standard_args(libzstd  DEFAULT_MSG
+                                  LIBZSTD_LIBRARY LIBZSTD_INCLUDE_DIR)
+
+mark_as_advanced(LIBZSTD_INCLUDE_DIR LIBZSTD_LIBRARY )
+
+set(LIBZSTD_LIBRARIES ${LIBZSTD_LIBRARY} )
+set(LIBZSTD_INCLUDE_DIRS ${LIBZSTD_INCLUDE_DIR} )
@@ -0,0 +1,162 @@
+#include "yamlConfigFile.h"
+#include <time.h>
+
+//
+// Adversarial hash-collision benchmark.  The two-character strings "Ab"
+// and "BA" have the same djb2 hash, so every key made by concatenating
+// N of them collides under djb2 (2^N keys share one hash value).  Build
+// a mapping of such keys and, as a control, a mapping of random keys of
+// the same length, then time looking up every key through the mapping
+// index.  With a seeded hash the two cases should cost about the same.
+//
+// usage:  hash_collision_benchmark {<block-count> {<seed>}}
+//
+// A seed can also be provided via the YAMLCONFIGFILE_HASH_SEED
+// environment variable.
+//
+
+double
+now()
+{
+    struct timespec         t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (double)t.tv_sec + 1e-9 * (double)t.tv_nsec;
+}
+
+//
+
+uint64_t
+djb2(
+    const char              *s
+)
+{
+    uint64_t                h = 5381;
+
+    while ( *s ) h = ((h << 5) + h) + *s++;
+    return h;
+}
+
+//
+
+void
+makeCollidingKey(
+    char                    *key,
+    unsigned int            blockCount,
+    unsigned int            keyIndex
+)
+{
+    unsigned int            i;
+
+    for ( i = 0; i < blockCount; i++ ) {
+        memcpy(key, (keyIndex & (1 << i)) ? "BA" : "Ab", 2);
+        key += 2;
+    }
+    *key = '\0';
+}
+
+//
+
+void
+makeRandomKey(
+    char                    *key,
+    unsigned int            blockCount,
+    unsigned int            keyIndex
+)
+{
+    unsigned int            i = 2 * blockCount;
+    uint64_t                state = 0x9E3779B97F4A7C15ULL * (keyIndex + 1);
+
+    while ( i-- ) {
+        state ^= state << 13; state ^= state >> 7; state ^= state << 17;
+        *key++ = "ABab"[state & 3];
+    }
+    *key = '\0';
+}
+
+//
+
+double
+timeLookups(
+    void                    (*makeKey)(char*, unsigned int, unsigned int),
+    unsigned int            blockCount,
+    unsigned int            *outDistinctDjb2
+)
+{
+    unsigned int            keyCount = 1 << blockCount, i;
+    size_t                  docLen = 0, docCapacity = (size_t)keyCount * (2 * blockCount + 16) + 16;
+    char                    *doc = malloc(docCapacity);
+    char                    key[64], path[80];
+    uint64_t                *hashes = malloc(keyCount * sizeof(uint64_t));
+    yamlConfigFileRef       configFile;
+    double                  t0, dt;
+
+    docLen += sprintf(doc + docLen, "keys:\n");
+    for ( i = 0; i < keyCount; i++ ) {
+        makeKey(key, blockCount, i);
+        hashes[i] = djb2(key);
+        docLen += sprintf(doc + docLen, "  %s: %u\n", key, i);
+    }
+    configFile = yamlConfigFileCreateWithInputString(doc, docLen, yamlConfigFileOptions_noKeyPathCache);
+    if ( ! configFile ) {
+        fprintf(stderr, "ERROR:  unable to parse generated document\n");
+        exit(EINVAL);
+    }
+
+    // Count distinct djb2 values (how badly the old unseeded hash would collide):
+    *outDistinctDjb2 = 0;
+    for ( i = 0; (i < keyCount) && (i < 4096); i++ ) {
+        unsigned int        j = 0;
+
+        while ( (j < i) && (hashes[j] != hashes[i]) ) j++;
+        if ( j == i ) (*outDistinctDjb2)++;
+    }
+
+    t0 = now();
+    for ( i = 0; i < keyCount; i++ ) {
+        yamlKeyPathBuffer   keyPathBuffer;
+        yamlKeyPathRef      keyPath;
+        int                 value = -1;
+
+        makeKey(key, blockCount, i);
+        snprintf(path, sizeof(path), "keys.%s", key);
+        keyPath = yamlKeyPathCreateWithStringInBuffer(path, yamlCStringFullLength, 0, &keyPathBuffer, sizeof(keyPathBuffer), NULL, NULL);
+        if ( ! yamlConfigFileCoerceScalarAtPath(configFile, keyPath, NULL, NULL, NULL, yamlConfigFileCoerceToType_int, &value) || (value != (int)i) ) {
+            fprintf(stderr, "ERROR:  lookup of %s failed\n", key);
+            exit(EINVAL);
+        }
+    }
+    dt = now() - t0;
+    yamlConfigFileRelease(configFile);
+    free(hashes);
+    free(doc);
+    return dt;
+}
+
+//
+
+int
+main(
+    int                     argc,
+    const char*             argv[]
+)
+{
+    unsigned int            blockCount = 14, distinctColliding, distinctRandom;
+    double                  tColliding, tRandom;
+
+    if ( argc > 1 ) blockCount = strtoul(argv[1], NULL, 0);
+    if ( argc > 2 ) yamlHashSetSeed(strtoull(argv[2], NULL, 0));
+    if ( blockCount < 1 ) blockCount = 1;
+    if ( blockCount > 20 ) blockCount = 20;
+
+    printf("hash seed:  0x%016llx\n", (unsigned long long)yamlHashGetSeed());
+    tColliding = timeLookups(makeCollidingKey, blockCount, &distinctColliding);
+    tRandom = timeLookups(makeRandomKey, blockCount, &distinctRandom);
+
+    printf("%-16s %8s %16s %12s %12s\n", "key set", "keys", "distinct djb2", "total (s)", "ns/lookup");
+    printf("%-16s %8u %16u %12.4f %12.1f\n", "djb2-colliding", 1 << blockCount, distinctColliding, tColliding, 1e9 * tColliding / (1 << blockCount));
+    printf("%-16s %8u %16u %12.4f %12.1f\n", "random", 1 << blockCount, distinctRandom, tRandom, 1e9 * tRandom / (1 << blockCount));
+    printf("(distinct djb2 values counted over the first 4096 keys)\n");
+    printf("colliding/random time ratio: %.2f\n", tColliding / tRandom);
+    return 0;
+}
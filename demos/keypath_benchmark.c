@@ -0,0 +1,112 @@
+#include "yamlKeyPath.h"
+#include <time.h>
+
+//
+// Time compilation of key paths via yamlKeyPathCreate() and
+// yamlKeyPathCreateWithString() (including the hash computation), and
+// report whether equal paths produced by the two constructors hash
+// identically.
+//
+// usage:  keypath_benchmark {<iterations>}
+//
+
+double
+now()
+{
+    struct timespec         t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (double)t.tv_sec + 1e-9 * (double)t.tv_nsec;
+}
+
+//
+
+yamlKeyPathRef
+createShortPath(void)
+{
+    return yamlKeyPathCreate(0, NULL,
+                YAML_MAPPING_NODE, "solver",
+                YAML_MAPPING_NODE, "abstol",
+                YAML_NO_NODE
+            );
+}
+
+const char *shortPathString = "solver.abstol";
+
+//
+
+yamlKeyPathRef
+createLongPath(void)
+{
+    return yamlKeyPathCreate(0, NULL,
+                YAML_MAPPING_NODE, "reaction-mechanism",
+                YAML_MAPPING_NODE, "species-thermodynamic-tables",
+                YAML_MAPPING_NODE, "nasa-7-coefficient-polynomials",
+                YAML_SEQUENCE_NODE, 12,
+                YAML_MAPPING_NODE, "high-temperature-range",
+                YAML_SEQUENCE_NODE, 3,
+                YAML_NO_NODE
+            );
+}
+
+const char *longPathString = "reaction-mechanism.species-thermodynamic-tables.nasa-7-coefficient-polynomials[12].high-temperature-range[3]";
+
+//
+
+double
+timeCreate(
+    yamlKeyPathRef          (*createFn)(void),
+    unsigned int            iterations
+)
+{
+    double                  t0 = now();
+    unsigned int            i = iterations;
+
+    while ( i-- ) yamlKeyPathRelease(createFn());
+    return 1e9 * (now() - t0) / iterations;
+}
+
+//
+
+double
+timeCreateWithString(
+    const char              *keyPathString,
+    unsigned int            iterations
+)
+{
+    double                  t0 = now();
+    unsigned int            i = iterations;
+
+    while ( i-- ) yamlKeyPathRelease(yamlKeyPathCreateWithString(keyPathString, yamlCStringFullLength, 0, NULL, NULL));
+    return 1e9 * (now() - t0) / iterations;
+}
+
+//
+
+int
+main(
+    int                     argc,
+    const char*             argv[]
+)
+{
+    unsigned int            iterations = 1000000;
+    yamlKeyPathRef          p1, p2;
+
+    if ( argc > 1 ) iterations = strtoul(argv[1], NULL, 0);
+    if ( iterations == 0 ) iterations = 1;
+
+    printf("%-36s %10s\n", "constructor", "ns/path");
+    printf("%-36s %10.1f\n", "yamlKeyPathCreate (short)", timeCreate(createShortPath, iterations));
+    printf("%-36s %10.1f\n", "yamlKeyPathCreateWithString (short)", timeCreateWithString(shortPathString, iterations));
+    printf("%-36s %10.1f\n", "yamlKeyPathCreate (long)", timeCreate(createLongPath, iterations));
+    printf("%-36s %10.1f\n", "yamlKeyPathCreateWithString (long)", timeCreateWithString(longPathString, iterations));
+
+    p1 = createLongPath();
+    p2 = yamlKeyPathCreateWithString("  Reaction-Mechanism.species-thermodynamic-tables.nasa-7-coefficient-polynomials[12].high-temperature-range[3] ", yamlCStringFullLength, yamlKeyPathCompileOptions_caseFoldKeys, NULL, NULL);
+    printf("equal paths from both constructors:  isEqual = %s, hashes %s\n",
+            yamlKeyPathIsEqual(p1, p2) ? "true" : "false",
+            (yamlKeyPathGetHash(p1) == yamlKeyPathGetHash(p2)) ? "match" : "DIFFER");
+    yamlKeyPathRelease(p1);
+    yamlKeyPathRelease(p2);
+    return 0;
+}
@@ -0,0 +1,260 @@
+#include "yamlConfigFile.h"
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <dirent.h>
+
+//
+// Generate a YAML document of (roughly) the requested size and time how
+// long yamlConfigFileCreateWithFileAtPath() takes to load it using the
+// default stdio input path and each of the alternate input paths
+// (including a parallel load using every online processor and the native
+// fast-path YAML and JSON parsers), then how long a filtered load of just a
+// few sections takes.  Throughput is reported for the unfiltered loads.
+// Finally, the document is compiled to a snapshot and the time to load the
+// snapshot and resolve the first filter key path in it is reported, as is
+// the time to load the document through the parse cache once an entry for
+// it has been written.
+//
+// Pass a JSON yaml-file to time the JSON parser (a YAML file falls back to
+// libyaml for the jsonInput load).
+//
+// usage:  load_benchmark {<size-in-MB> {<repeat-count> {<yaml-file> {<include-path> ..}}}}
+//
+// If a yaml-file is provided and it exists, it is used as-is rather than
+// being generated.  The filtered load includes the given key paths, or
+// "general" and "table-0" by default.
+//
+
+double
+now()
+{
+    struct timespec         t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (double)t.tv_sec + 1e-9 * (double)t.tv_nsec;
+}
+
+//
+
+bool
+generateDocument(
+    const char              *path,
+    size_t                  targetSize
+)
+{
+    FILE                    *fptr = fopen(path, "w");
+    size_t                  size = 0;
+    unsigned int            tableId = 0;
+
+    if ( ! fptr ) return false;
+
+    size += fprintf(fptr, "general:\n    tolerance: 1.54e-2\n    uses-bfgs: on\n\n");
+    while ( size < targetSize ) {
+        unsigned int        row = 0;
+
+        size += fprintf(fptr, "table-%u:\n    description: \"parameter table %u\"\n    rows:\n", tableId, tableId);
+        while ( (row < 1000) && (size < targetSize) ) {
+            size += fprintf(fptr, "      - [ %u, %.9e, %.9e, %.9e, species-%u ]\n", row, row * 1.25e-3, row * -3.5e+2, 1.0 / (row + 1), row % 97);
+            row++;
+        }
+        tableId++;
+    }
+    fclose(fptr);
+    return true;
+}
+
+//
+
+double
+timeLoad(
+    const char              *path,
+    yamlOptionsBitvec       options,
+    const yamlConfigFileFilter *filter,
+    unsigned int            repeatCount
+)
+{
+    double                  best = -1.0;
+
+    while ( repeatCount-- ) {
+        double              t0 = now(), dt;
+        yamlConfigFileRef   f = yamlConfigFileCreateWithFileAtPathAndFilter(path, options | yamlConfigFileOptions_doNotCache | yamlConfigFileOptions_noParseCache, filter);
+
+        dt = now() - t0;
+        if ( ! f ) {
+            fprintf(stderr, "ERROR:  failed to load %s\n", path);
+            return -1.0;
+        }
+        yamlConfigFileRelease(f);
+        if ( (best < 0.0) || (dt < best) ) best = dt;
+    }
+    return best;
+}
+
+//
+
+double
+timeSnapshotLoad(
+    const char              *path,
+    const char              *snapshotPath,
+    yamlKeyPathRef          keyPath,
+    unsigned int            repeatCount
+)
+{
+    yamlConfigFileRef       f = yamlConfigFileCreateWithFileAtPath(path, yamlConfigFileOptions_mapInputFile | yamlConfigFileOptions_doNotCache | yamlConfigFileOptions_noParseCache);
+    yamlErrorCode           errorCode = 0;
+    double                  best = -1.0;
+
+    if ( ! f ) {
+        fprintf(stderr, "ERROR:  failed to load %s\n", path);
+        return -1.0;
+    }
+    if ( ! yamlConfigFileWriteSnapshotToPath(f, snapshotPath, &errorCode) ) {
+        fprintf(stderr, "ERROR:  failed to write snapshot %s (error %u)\n", snapshotPath, errorCode);
+        yamlConfigFileRelease(f);
+        return -1.0;
+    }
+    yamlConfigFileRelease(f);
+
+    while ( repeatCount-- ) {
+        double              t0 = now(), dt;
+
+        f = yamlConfigFileCreateWithSnapshotAtPath(snapshotPath, yamlConfigFileOptions_doNotCache, &errorCode);
+        if ( f && keyPath ) yamlConfigFileGetNodeAtPath(f, keyPath, NULL, NULL, NULL);
+        dt = now() - t0;
+        if ( ! f ) {
+            fprintf(stderr, "ERROR:  failed to load snapshot %s (error %u)\n", snapshotPath, errorCode);
+            best = -1.0;
+            break;
+        }
+        yamlConfigFileRelease(f);
+        if ( (best < 0.0) || (dt < best) ) best = dt;
+    }
+    unlink(snapshotPath);
+    return best;
+}
+
+//
+
+double
+timeParseCacheLoad(
+    const char              *path,
+    const char              *cacheDirectory,
+    unsigned int            repeatCount
+)
+{
+    yamlConfigFileRef       f;
+    double                  best = -1.0;
+    DIR                     *dirPtr;
+
+    // The first load parses the document and writes the cache entry:
+    yamlConfigFileSetParseCacheDirectory(cacheDirectory);
+    if ( ! (f = yamlConfigFileCreateWithFileAtPath(path, yamlConfigFileOptions_doNotCache)) ) {
+        fprintf(stderr, "ERROR:  failed to load %s\n", path);
+    } else {
+        yamlConfigFileRelease(f);
+        while ( repeatCount-- ) {
+            double          t0 = now(), dt;
+
+            f = yamlConfigFileCreateWithFileAtPath(path, yamlConfigFileOptions_doNotCache);
+            dt = now() - t0;
+            if ( ! f ) {
+                fprintf(stderr, "ERROR:  failed to load %s through the parse cache\n", path);
+                best = -1.0;
+                break;
+            }
+            yamlConfigFileRelease(f);
+            if ( (best < 0.0) || (dt < best) ) best = dt;
+        }
+    }
+    yamlConfigFileSetParseCacheDirectory(NULL);
+
+    // Remove the cache entry and directory:
+    if ( (dirPtr = opendir(cacheDirectory)) ) {
+        struct dirent       *entry;
+        char                entryPath[PATH_MAX];
+
+        while ( (entry = readdir(dirPtr)) ) {
+            if ( entry->d_name[0] == '.' ) continue;
+            snprintf(entryPath, sizeof(entryPath), "%s/%s", cacheDirectory, entry->d_name);
+            unlink(entryPath);
+        }
+        closedir(dirPtr);
+        rmdir(cacheDirectory);
+    }
+    return best;
+}
+
+//
+
+int
+main(
+    int                     argc,
+    const char*             argv[]
+)
+{
+    size_t                  sizeInMB = 64;
+    unsigned int            repeatCount = 3;
+    const char              *path = "load_benchmark.yaml";
+    const char              *snapshotPath = "load_benchmark.snapshot";
+    const char              *cacheDirectory = "load_benchmark.cache";
+    bool                    shouldRemove = false;
+    const char              *defaultIncludes[] = { "general", "table-0" };
+    const char*             *includes = defaultIncludes;
+    unsigned int            includeCount = 2, i;
+    yamlKeyPathRef          includePaths[16];
+    yamlConfigFileFilter    filter = { includePaths, 0, NULL, 0 };
+    double                  tStdio, tMapped, tParallel, tFast, tJSON, tFiltered, tSnapshot, tParseCache, sizeMB;
+    struct stat             finfo;
+
+    if ( argc > 1 ) sizeInMB = strtoul(argv[1], NULL, 0);
+    if ( argc > 2 ) repeatCount = strtoul(argv[2], NULL, 0);
+    if ( argc > 3 ) path = argv[3];
+    if ( argc > 4 ) {
+        includes = argv + 4;
+        includeCount = argc - 4;
+    }
+    if ( repeatCount == 0 ) repeatCount = 1;
+
+    if ( access(path, R_OK) != 0 ) {
+        printf("Generating %zu MB test document at %s...\n", sizeInMB, path);
+        if ( ! generateDocument(path, sizeInMB * 1024 * 1024) ) {
+            fprintf(stderr, "ERROR:  unable to write %s\n", path);
+            return EIO;
+        }
+        shouldRemove = true;
+    }
+
+    for ( i = 0; (i < includeCount) && (filter.includePathCount < 16); i++ ) {
+        yamlKeyPathRef      includePath = yamlKeyPathCreateWithString(includes[i], yamlCStringFullLength, 0, NULL, NULL);
+
+        if ( includePath ) includePaths[filter.includePathCount++] = includePath;
+    }
+
+    tStdio = timeLoad(path, yamlConfigFileOptions_none, NULL, repeatCount);
+    tMapped = timeLoad(path, yamlConfigFileOptions_mapInputFile, NULL, repeatCount);
+    tParallel = timeLoad(path, yamlConfigFileOptions_parallelLoad, NULL, repeatCount);
+    tFast = timeLoad(path, yamlConfigFileOptions_fastParse, NULL, repeatCount);
+    tJSON = timeLoad(path, yamlConfigFileOptions_jsonInput, NULL, repeatCount);
+    tFiltered = timeLoad(path, yamlConfigFileOptions_mapInputFile, &filter, repeatCount);
+    tSnapshot = timeSnapshotLoad(path, snapshotPath, filter.includePathCount ? includePaths[0] : NULL, repeatCount);
+    tParseCache = timeParseCacheLoad(path, cacheDirectory, repeatCount);
+
+    sizeMB = ( stat(path, &finfo) == 0 ) ? (double)finfo.st_size / (1024.0 * 1024.0) : 0.0;
+    printf("%-24s %10s %10s\n", "input path", "best (s)", "MB/s");
+    printf("%-24s %10.4f %10.1f\n", "stdio (default)", tStdio, sizeMB / tStdio);
+    printf("%-24s %10.4f %10.1f\n", "mapInputFile", tMapped, sizeMB / tMapped);
+    printf("%-24s %10.4f %10.1f   (%u threads)\n", "parallelLoad", tParallel, sizeMB / tParallel, yamlConfigFileGetParallelLoadThreadCount());
+    printf("%-24s %10.4f %10.1f\n", "fastParse", tFast, sizeMB / tFast);
+    printf("%-24s %10.4f %10.1f\n", "jsonInput", tJSON, sizeMB / tJSON);
+    printf("%-24s %10.4f\n", "mapInputFile+filter", tFiltered);
+    printf("%-24s %10.6f\n", "snapshot+lookup", tSnapshot);
+    printf("%-24s %10.4f %10.1f\n", "parse cache hit", tParseCache, sizeMB / tParseCache);
+    if ( (tStdio > 0.0) && (tMapped > 0.0) ) printf("speedup: %.2fx\n", tStdio / tMapped);
+    if ( (tMapped > 0.0) && (tFast > 0.0) ) printf("fastParse speedup over mapInputFile: %.2fx\n", tMapped / tFast);
+
+    while ( filter.includePathCount ) yamlKeyPathRelease(includePaths[--filter.includePathCount]);
+
+    if ( shouldRemove ) unlink(path);
+    return 0;
+}
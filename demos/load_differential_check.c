@@ -0,0 +1,1882 @@
+#include "yamlConfigFile.h"
+#include <unistd.h>
+#include <poll.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#ifdef HAVE_ZLIB
+# include <zlib.h>
+#endif
+
+//
+// Differential check of the alternate load paths and APIs against the
+// serial libyaml load done by yamlConfigFileCreateWithFileAtPath().  Each
+// fixture is loaded both ways and the two documents are walked together,
+// node by node:  every pair of nodes must agree in type, tag, style and
+// content, and aliased (shared) nodes must be shared the same way in both.
+// In parallel mode their start and end marks must agree, too (the native
+// parsers do not record marks).  A load that fails must fail both ways.
+//
+// usage:  load_differential_check {-m <mode>} {-r <size-in-MB>} {-z <count> {-s <seed>}} <fixture> {<fixture> ..}
+//
+// Modes:
+//
+//   parallel    yamlConfigFileOptions_parallelLoad with four threads
+//   fast        yamlConfigFileOptions_fastParse
+//   json        yamlConfigFileOptions_jsonInput
+//   stream      every document of a yamlConfigFileStream (with
+//               yamlConfigFileOptions_mapInputFile) against the documents
+//               yaml_parser_load() produces in turn
+//   lazy        yamlConfigFileOptions_lazySubtrees, walked along key paths
+//               from the root so that deferred subtrees are materialized
+//   filter      yamlConfigFileCreateWithFileAtPathAndFilter() including the
+//               last top-level value and then its last child, and
+//               excluding the first top-level value and then its first
+//               child; what the filter keeps must match the serial load
+//               and what it discards must be absent (or a null scalar in
+//               a sequence)
+//   records     every record of a yamlConfigFileRecordIterator (with
+//               yamlConfigFileOptions_mapInputFile) against the items of
+//               the root sequence; any other root must be refused with
+//               yamlConfigFileError_invalidType
+//   batch       yamlConfigFileCreateWithFilesAtPaths() on four threads with
+//               the fixture three times and a missing file, uncached and
+//               cached; a repeated path must receive the cached copy
+//   async       yamlConfigFileAsyncLoadCreateWithFileAtPath() plain,
+//               cancelled at once, with a deadline of a microsecond and of
+//               a missing file; each must notify exactly once, and a
+//               cancelled or expired load that finished anyway must match
+//   push        a yamlConfigFilePushParser fed the text in pieces of random
+//               length; a feed may only fail where the serial load fails
+//   incremental a yamlConfigFileIncrementalLoad (with
+//               yamlConfigFileOptions_mapInputFile) advanced by steps with
+//               random event budgets, each of which must be respected
+//   snapshot    yamlConfigFileCreateWithSnapshotAtPath() on a snapshot of
+//               the serial load, walked along exact and caseless key paths
+//               and by id; truncated, extended and damaged snapshots (and
+//               YAML text) must be refused, and snapshots with a flipped
+//               bit that are accepted must be walked without crashing
+//   parsecache  yamlConfigFileCreateWithFileAtPath() with a private parse
+//               cache directory:  a miss, a hit, and a miss after the file
+//               is touched and after an edit that keeps its size and
+//               modification time; a hit must not rewrite the entry and a
+//               miss must
+//   gzip        the fixture compressed as one gzip member and split between
+//               two, loaded from the file and read as a stream (with
+//               yamlConfigFileOptions_mapInputFile); the single member is
+//               also loaded from memory and read by a record iterator.
+//               Truncated input and input followed by junk must fail the
+//               stream (only present when the library is built with zlib)
+//
+// Parallel loads only split documents of a few MB, so in parallel mode
+// each fixture is also checked after being repeated until it is at least
+// <size-in-MB> (default 4) long.  Every occurrence of "@N@" in a fixture is
+// replaced by the number of the copy, so keys and anchors can be made
+// unique per copy (or left alone to produce duplicate keys).  Anything
+// before a line reading "#--- repeat ---" is included once, ahead of the
+// copies.  Each fixture is checked with both LF and CRLF line breaks.
+//
+// In the fast, json, stream, records, push and incremental modes, -z also
+// loads <count> randomly-mutated copies of each fixture (bytes deleted,
+// inserted or replaced with YAML and JSON indicators, lines duplicated or
+// re-indented, text truncated) from memory both ways; the fixtures are
+// chosen so that the mutations reach the constructs the native parsers must
+// leave to libyaml.  The mutations are reproducible for a given <seed>, and
+// the input of any mismatch is printed.  The JSON parser decodes UTF-16
+// surrogate pairs that libyaml rejects, so in json mode a load that
+// succeeds where libyaml failed is not a mismatch if the text contains a
+// surrogate escape.
+//
+// The exit status is non-zero if any check found a mismatch.
+//
+
+typedef struct checkMode {
+    const char              *name;
+    yamlOptionsBitvec       options;
+    bool                    shouldRepeat;
+    bool                    canFuzz;
+    bool                    decodesSurrogatePairs;
+    bool                    checksMarks;
+    bool                    (*check)(const struct checkMode *mode, const char *path, const char *text, size_t length);
+} checkMode;
+
+//
+
+typedef struct {
+    yamlConfigFileRef       configFile[2];
+    yaml_document_t         *document[2];
+    int                     *nodeMap[2];
+    int                     nodeMapCapacity[2];
+    bool                    checksMarks;
+    bool                    isQuiet;
+    char                    where[4096];
+    size_t                  whereLength;
+} checkContext;
+
+//
+
+bool
+checkContextMapNode(
+    checkContext            *context,
+    int                     side,
+    int                     nodeId,
+    int                     otherNodeId
+)
+{
+    if ( nodeId >= context->nodeMapCapacity[side] ) {
+        int                 newCapacity = 2 * nodeId + 64;
+        int                 *newMap = realloc(context->nodeMap[side], newCapacity * sizeof(int));
+
+        if ( ! newMap ) return false;
+        memset(newMap + context->nodeMapCapacity[side], 0, (newCapacity - context->nodeMapCapacity[side]) * sizeof(int));
+        context->nodeMap[side] = newMap;
+        context->nodeMapCapacity[side] = newCapacity;
+    }
+    context->nodeMap[side][nodeId] = otherNodeId;
+    return true;
+}
+
+//
+
+int
+checkContextGetMappedNode(
+    checkContext            *context,
+    int                     side,
+    int                     nodeId
+)
+{
+    return ( nodeId < context->nodeMapCapacity[side] ) ? context->nodeMap[side][nodeId] : 0;
+}
+
+//
+
+yaml_node_t*
+checkContextGetNode(
+    checkContext            *context,
+    int                     side,
+    int                     nodeId
+)
+{
+    // A side is either a yamlConfigFile or a bare libyaml document:
+    if ( context->document[side] ) return yaml_document_get_node(context->document[side], nodeId);
+    return yamlConfigFileGetNodeWithId(context->configFile[side], nodeId);
+}
+
+//
+
+void
+checkContextResetNodeMaps(
+    checkContext            *context
+)
+{
+    free((void*)context->nodeMap[0]);
+    free((void*)context->nodeMap[1]);
+    context->nodeMap[0] = context->nodeMap[1] = NULL;
+    context->nodeMapCapacity[0] = context->nodeMapCapacity[1] = 0;
+}
+
+//
+
+bool
+checkMismatch(
+    checkContext            *context,
+    const char              *what
+)
+{
+    // Mismatches are expected (and not reported) when walking a damaged
+    // document:
+    if ( ! context->isQuiet ) printf("    MISMATCH at %s: %s\n", context->whereLength ? context->where : "/", what);
+    return false;
+}
+
+//
+
+bool
+checkNodes(
+    checkContext            *context,
+    int                     nodeId0,
+    int                     nodeId1
+)
+{
+    yaml_node_t             *node0 = checkContextGetNode(context, 0, nodeId0);
+    yaml_node_t             *node1 = checkContextGetNode(context, 1, nodeId1);
+    size_t                  whereLength = context->whereLength;
+    bool                    isSame = true;
+    long                    i, count;
+
+    if ( ! node0 || ! node1 ) return checkMismatch(context, ( node0 || node1 ) ? "node present in only one document" : "missing node");
+
+    // A node already reached (through an alias) must correspond to the same
+    // node in both documents:
+    if ( checkContextGetMappedNode(context, 0, nodeId0) || checkContextGetMappedNode(context, 1, nodeId1) ) {
+        if ( (checkContextGetMappedNode(context, 0, nodeId0) != nodeId1) || (checkContextGetMappedNode(context, 1, nodeId1) != nodeId0) ) return checkMismatch(context, "nodes are shared differently");
+        return true;
+    }
+    if ( ! checkContextMapNode(context, 0, nodeId0, nodeId1) || ! checkContextMapNode(context, 1, nodeId1, nodeId0) ) return checkMismatch(context, "out of memory");
+
+    if ( node0->type != node1->type ) return checkMismatch(context, "node types differ");
+    if ( ! node0->tag != ! node1->tag ) return checkMismatch(context, "tag present in only one document");
+    if ( node0->tag && strcmp((const char*)node0->tag, (const char*)node1->tag) ) return checkMismatch(context, "tags differ");
+    if ( context->checksMarks ) {
+        if ( (node0->start_mark.index != node1->start_mark.index) || (node0->start_mark.line != node1->start_mark.line) || (node0->start_mark.column != node1->start_mark.column) ) return checkMismatch(context, "start marks differ");
+        if ( (node0->end_mark.index != node1->end_mark.index) || (node0->end_mark.line != node1->end_mark.line) || (node0->end_mark.column != node1->end_mark.column) ) return checkMismatch(context, "end marks differ");
+    }
+    switch ( node0->type ) {
+        case YAML_SCALAR_NODE:
+            if ( node0->data.scalar.style != node1->data.scalar.style ) return checkMismatch(context, "scalar styles differ");
+            if ( (node0->data.scalar.length != node1->data.scalar.length) || memcmp(node0->data.scalar.value, node1->data.scalar.value, node0->data.scalar.length) ) return checkMismatch(context, "scalar values differ");
+            break;
+
+        case YAML_SEQUENCE_NODE:
+            if ( node0->data.sequence.style != node1->data.sequence.style ) return checkMismatch(context, "sequence styles differ");
+            count = node0->data.sequence.items.top - node0->data.sequence.items.start;
+            if ( count != node1->data.sequence.items.top - node1->data.sequence.items.start ) return checkMismatch(context, "sequence lengths differ");
+            for ( i = 0; isSame && (i < count); i++ ) {
+                context->whereLength += snprintf(context->where + whereLength, sizeof(context->where) - whereLength, "[%ld]", i);
+                if ( context->whereLength >= sizeof(context->where) ) context->whereLength = sizeof(context->where) - 1;
+                isSame = checkNodes(context, node0->data.sequence.items.start[i], node1->data.sequence.items.start[i]);
+                context->whereLength = whereLength;
+                context->where[whereLength] = '\0';
+            }
+            break;
+
+        case YAML_MAPPING_NODE:
+            if ( node0->data.mapping.style != node1->data.mapping.style ) return checkMismatch(context, "mapping styles differ");
+            count = node0->data.mapping.pairs.top - node0->data.mapping.pairs.start;
+            if ( count != node1->data.mapping.pairs.top - node1->data.mapping.pairs.start ) return checkMismatch(context, "mapping sizes differ");
+            for ( i = 0; isSame && (i < count); i++ ) {
+                yaml_node_t *key = checkContextGetNode(context, 0, node0->data.mapping.pairs.start[i].key);
+
+                if ( key && (key->type == YAML_SCALAR_NODE) ) {
+                    context->whereLength += snprintf(context->where + whereLength, sizeof(context->where) - whereLength, "/%.*s", (int)key->data.scalar.length, (const char*)key->data.scalar.value);
+                } else {
+                    context->whereLength += snprintf(context->where + whereLength, sizeof(context->where) - whereLength, "/<pair %ld>", i);
+                }
+                if ( context->whereLength >= sizeof(context->where) ) context->whereLength = sizeof(context->where) - 1;
+                isSame = checkNodes(context, node0->data.mapping.pairs.start[i].key, node1->data.mapping.pairs.start[i].key)
+                            && checkNodes(context, node0->data.mapping.pairs.start[i].value, node1->data.mapping.pairs.start[i].value);
+                context->whereLength = whereLength;
+                context->where[whereLength] = '\0';
+            }
+            break;
+
+        default:
+            break;
+    }
+    return isSame;
+}
+
+//
+
+bool
+checkNodesAlongKeyPaths(
+    checkContext            *context,
+    int                     nodeId0,
+    yaml_node_t             *node1
+)
+{
+    yaml_node_t             *node0 = checkContextGetNode(context, 0, nodeId0);
+    size_t                  whereLength = context->whereLength;
+    bool                    isSame = true;
+    long                    i, count;
+
+    // Each child of node1 is reached by a key path from node1 rather than
+    // by id, so nodes in documents that are not reachable by id (e.g. the
+    // deferred subtrees of a lazy load) are compared, too.  Only the nodes
+    // themselves are compared, and a node shared through aliases is walked
+    // once:
+    if ( ! node0 || ! node1 ) return checkMismatch(context, ( node0 || node1 ) ? "node present in only one document" : "missing node");
+    if ( checkContextGetMappedNode(context, 0, nodeId0) ) return true;
+    if ( ! checkContextMapNode(context, 0, nodeId0, nodeId0) ) return checkMismatch(context, "out of memory");
+
+    if ( node0->type != node1->type ) return checkMismatch(context, "node types differ");
+    if ( ! node0->tag != ! node1->tag ) return checkMismatch(context, "tag present in only one document");
+    if ( node0->tag && strcmp((const char*)node0->tag, (const char*)node1->tag) ) return checkMismatch(context, "tags differ");
+    switch ( node0->type ) {
+        case YAML_SCALAR_NODE:
+            if ( node0->data.scalar.style != node1->data.scalar.style ) return checkMismatch(context, "scalar styles differ");
+            if ( (node0->data.scalar.length != node1->data.scalar.length) || memcmp(node0->data.scalar.value, node1->data.scalar.value, node0->data.scalar.length) ) return checkMismatch(context, "scalar values differ");
+            break;
+
+        case YAML_SEQUENCE_NODE:
+            if ( node0->data.sequence.style != node1->data.sequence.style ) return checkMismatch(context, "sequence styles differ");
+            count = node0->data.sequence.items.top - node0->data.sequence.items.start;
+            if ( count != node1->data.sequence.items.top - node1->data.sequence.items.start ) return checkMismatch(context, "sequence lengths differ");
+            for ( i = 0; isSame && (i < count); i++ ) {
+                yamlKeyPathRef  keyPath = yamlKeyPathCreate(0, NULL, YAML_SEQUENCE_NODE, (int)i, YAML_NO_NODE);
+
+                context->whereLength += snprintf(context->where + whereLength, sizeof(context->where) - whereLength, "[%ld]", i);
+                if ( context->whereLength >= sizeof(context->where) ) context->whereLength = sizeof(context->where) - 1;
+                if ( ! keyPath ) {
+                    isSame = checkMismatch(context, "unable to create a key path");
+                } else {
+                    isSame = checkNodesAlongKeyPaths(context, node0->data.sequence.items.start[i], yamlConfigFileGetNodeAtPath(context->configFile[1], keyPath, node1, NULL, NULL));
+                    yamlKeyPathRelease(keyPath);
+                }
+                context->whereLength = whereLength;
+                context->where[whereLength] = '\0';
+            }
+            break;
+
+        case YAML_MAPPING_NODE:
+            if ( node0->data.mapping.style != node1->data.mapping.style ) return checkMismatch(context, "mapping styles differ");
+            count = node0->data.mapping.pairs.top - node0->data.mapping.pairs.start;
+            if ( count != node1->data.mapping.pairs.top - node1->data.mapping.pairs.start ) return checkMismatch(context, "mapping sizes differ");
+            for ( i = 0; isSame && (i < count); i++ ) {
+                yaml_node_t     *key = checkContextGetNode(context, 0, node0->data.mapping.pairs.start[i].key);
+                yamlKeyPathRef  keyPath;
+
+                // A key path can only reach the value of the first pair with
+                // a given scalar key, which is the one the serial load finds:
+                if ( ! key || (key->type != YAML_SCALAR_NODE) || memchr(key->data.scalar.value, '\0', key->data.scalar.length) ) continue;
+                if ( ! (keyPath = yamlKeyPathCreate(0, NULL, YAML_MAPPING_NODE, (const char*)key->data.scalar.value, YAML_NO_NODE)) ) return checkMismatch(context, "unable to create a key path");
+                if ( yamlConfigFileGetNodeAtPath(context->configFile[0], keyPath, node0, NULL, NULL) != checkContextGetNode(context, 0, node0->data.mapping.pairs.start[i].value) ) {
+                    yamlKeyPathRelease(keyPath);
+                    continue;
+                }
+
+                context->whereLength += snprintf(context->where + whereLength, sizeof(context->where) - whereLength, "/%.*s", (int)key->data.scalar.length, (const char*)key->data.scalar.value);
+                if ( context->whereLength >= sizeof(context->where) ) context->whereLength = sizeof(context->where) - 1;
+                isSame = checkNodesAlongKeyPaths(context, node0->data.mapping.pairs.start[i].value, yamlConfigFileGetNodeAtPath(context->configFile[1], keyPath, node1, NULL, NULL));
+                yamlKeyPathRelease(keyPath);
+                context->whereLength = whereLength;
+                context->where[whereLength] = '\0';
+            }
+            break;
+
+        default:
+            break;
+    }
+    return isSame;
+}
+
+//
+
+bool
+checkFilteredNodes(
+    checkContext                    *context,
+    int                             nodeId0,
+    int                             nodeId1,
+    const yamlKeyPathNodeMatchType  *match,
+    bool                            isIncluded
+)
+{
+    yaml_node_t                     *node0 = checkContextGetNode(context, 0, nodeId0);
+    yaml_node_t                     *node1 = checkContextGetNode(context, 1, nodeId1);
+    size_t                          whereLength = context->whereLength;
+    bool                            isSame = true;
+    long                            i, i1, count;
+
+    // node0 lies on the filter's (single) include or exclude path and match
+    // is the element its children must match to stay on it.  A child that
+    // matches the last element is the one included (everything else is
+    // discarded) or excluded (everything else is kept whole); one that
+    // matches an earlier element is on the way and is filtered in turn.
+    // Discarded mapping pairs are absent, discarded sequence items are null
+    // scalars.  (An anchored node on the way would be composed whole, so
+    // the paths chosen must not pass through one.)
+    if ( ! node0 || ! node1 ) return checkMismatch(context, ( node0 || node1 ) ? "node present in only one document" : "missing node");
+    if ( node0->type != node1->type ) return checkMismatch(context, "node types differ");
+    if ( ! node0->tag != ! node1->tag ) return checkMismatch(context, "tag present in only one document");
+    if ( node0->tag && strcmp((const char*)node0->tag, (const char*)node1->tag) ) return checkMismatch(context, "tags differ");
+    switch ( node0->type ) {
+        case YAML_SEQUENCE_NODE:
+            if ( node0->data.sequence.style != node1->data.sequence.style ) return checkMismatch(context, "sequence styles differ");
+            count = node0->data.sequence.items.top - node0->data.sequence.items.start;
+            if ( count != node1->data.sequence.items.top - node1->data.sequence.items.start ) return checkMismatch(context, "sequence lengths differ");
+            for ( i = 0; isSame && (i < count); i++ ) {
+                bool            isMatch = ( (match->type == YAML_SEQUENCE_NODE) && (match->parameter.index == i) );
+                const yamlKeyPathNodeMatchType  *nextMatch = isMatch ? yamlKeyPathGetNextNodeMatch((yamlKeyPathNodeMatchType*)match) : NULL;
+
+                context->whereLength += snprintf(context->where + whereLength, sizeof(context->where) - whereLength, "[%ld]", i);
+                if ( context->whereLength >= sizeof(context->where) ) context->whereLength = sizeof(context->where) - 1;
+                if ( nextMatch ) {
+                    isSame = checkFilteredNodes(context, node0->data.sequence.items.start[i], node1->data.sequence.items.start[i], nextMatch, isIncluded);
+                } else if ( isMatch == isIncluded ) {
+                    isSame = checkNodes(context, node0->data.sequence.items.start[i], node1->data.sequence.items.start[i]);
+                } else {
+                    yaml_node_t *item = checkContextGetNode(context, 1, node1->data.sequence.items.start[i]);
+
+                    // libyaml gives an untagged plain scalar the default tag:
+                    if ( ! item || (item->type != YAML_SCALAR_NODE) || (item->tag && strcmp((const char*)item->tag, YAML_DEFAULT_SCALAR_TAG)) || (item->data.scalar.style != YAML_PLAIN_SCALAR_STYLE) || (item->data.scalar.length != 1) || (item->data.scalar.value[0] != '~') ) isSame = checkMismatch(context, "discarded item is not a null scalar");
+                }
+                context->whereLength = whereLength;
+                context->where[whereLength] = '\0';
+            }
+            break;
+
+        case YAML_MAPPING_NODE:
+            if ( node0->data.mapping.style != node1->data.mapping.style ) return checkMismatch(context, "mapping styles differ");
+            count = node0->data.mapping.pairs.top - node0->data.mapping.pairs.start;
+            for ( i = i1 = 0; isSame && (i < count); i++ ) {
+                yaml_node_t     *key = checkContextGetNode(context, 0, node0->data.mapping.pairs.start[i].key);
+                bool            isMatch = ( (match->type == YAML_MAPPING_NODE) && key && (key->type == YAML_SCALAR_NODE) && (strlen(match->parameter.key) == key->data.scalar.length) && ! memcmp(match->parameter.key, key->data.scalar.value, key->data.scalar.length) );
+                const yamlKeyPathNodeMatchType  *nextMatch = isMatch ? yamlKeyPathGetNextNodeMatch((yamlKeyPathNodeMatchType*)match) : NULL;
+
+                if ( ! nextMatch && (isMatch != isIncluded) ) continue;
+                if ( key && (key->type == YAML_SCALAR_NODE) ) {
+                    context->whereLength += snprintf(context->where + whereLength, sizeof(context->where) - whereLength, "/%.*s", (int)key->data.scalar.length, (const char*)key->data.scalar.value);
+                } else {
+                    context->whereLength += snprintf(context->where + whereLength, sizeof(context->where) - whereLength, "/<pair %ld>", i);
+                }
+                if ( context->whereLength >= sizeof(context->where) ) context->whereLength = sizeof(context->where) - 1;
+                if ( i1 >= node1->data.mapping.pairs.top - node1->data.mapping.pairs.start ) {
+                    isSame = checkMismatch(context, "pair missing from the filtered document");
+                } else if ( ! checkNodes(context, node0->data.mapping.pairs.start[i].key, node1->data.mapping.pairs.start[i1].key) ) {
+                    isSame = false;
+                } else if ( nextMatch ) {
+                    isSame = checkFilteredNodes(context, node0->data.mapping.pairs.start[i].value, node1->data.mapping.pairs.start[i1].value, nextMatch, isIncluded);
+                } else {
+                    isSame = checkNodes(context, node0->data.mapping.pairs.start[i].value, node1->data.mapping.pairs.start[i1].value);
+                }
+                context->whereLength = whereLength;
+                context->where[whereLength] = '\0';
+                i1++;
+            }
+            if ( isSame && (i1 != node1->data.mapping.pairs.top - node1->data.mapping.pairs.start) ) isSame = checkMismatch(context, "filtered document has extra pairs");
+            break;
+
+        default:
+            // A scalar on the way is kept:
+            isSame = checkNodes(context, nodeId0, nodeId1);
+            break;
+    }
+    return isSame;
+}
+
+//
+
+bool
+hasSurrogateEscape(
+    const char              *text,
+    size_t                  length
+)
+{
+    const char              *textEnd = text + length;
+
+    while ( (text = memchr(text, '\\', textEnd - text)) && (textEnd - text >= 4) ) {
+        if ( (text[1] == 'u') && ((text[2] == 'd') || (text[2] == 'D')) && strchr("89abAB", text[3]) ) return true;
+        text += 2;
+    }
+    return false;
+}
+
+//
+
+bool
+checkContextCompare(
+    checkContext            *context
+)
+{
+    bool                    isLoaded0 = ( context->configFile[0] || context->document[0] );
+    bool                    isLoaded1 = ( context->configFile[1] || context->document[1] );
+    bool                    isSame;
+
+    // Side 0 is the serial load; a side that is neither a yamlConfigFile
+    // nor a document failed to load:
+    if ( ! isLoaded0 || ! isLoaded1 ) {
+        isSame = ( ! isLoaded0 && ! isLoaded1 );
+        if ( ! isSame ) checkMismatch(context, isLoaded0 ? "load failed" : "load succeeded where the serial load failed");
+    } else if ( ! checkContextGetNode(context, 0, 1) && ! checkContextGetNode(context, 1, 1) ) {
+        // Both documents are empty:
+        isSame = true;
+    } else {
+        isSame = checkNodes(context, 1, 1);
+    }
+    checkContextResetNodeMaps(context);
+    return isSame;
+}
+
+//
+
+yamlConfigFileRef
+createSerialLoad(
+    const char              *path,
+    const char              *text,
+    size_t                  length
+)
+{
+    yamlOptionsBitvec       options = yamlConfigFileOptions_doNotCache | yamlConfigFileOptions_noParseCache;
+
+    // The text is loaded from memory if no path is given:
+    if ( path ) return yamlConfigFileCreateWithFileAtPath(path, options);
+    return yamlConfigFileCreateWithInputString(text, length, options);
+}
+
+//
+
+bool
+checkLoad(
+    const checkMode         *mode,
+    const char              *path,
+    const char              *text,
+    size_t                  length
+)
+{
+    checkContext            context;
+    yamlOptionsBitvec       options = yamlConfigFileOptions_doNotCache | yamlConfigFileOptions_noParseCache;
+    bool                    isSame;
+
+    memset(&context, 0, sizeof(context));
+    context.checksMarks = mode->checksMarks;
+    context.configFile[0] = createSerialLoad(path, text, length);
+    if ( path ) {
+        context.configFile[1] = yamlConfigFileCreateWithFileAtPath(path, mode->options | options);
+    } else {
+        context.configFile[1] = yamlConfigFileCreateWithInputString(text, length, mode->options | options);
+    }
+    if ( ! context.configFile[0] && context.configFile[1] && mode->decodesSurrogatePairs && hasSurrogateEscape(text, length) ) {
+        isSame = true;
+    } else {
+        isSame = checkContextCompare(&context);
+    }
+    if ( context.configFile[0] ) yamlConfigFileRelease(context.configFile[0]);
+    if ( context.configFile[1] ) yamlConfigFileRelease(context.configFile[1]);
+    return isSame;
+}
+
+//
+
+bool
+checkStream(
+    const checkMode         *mode,
+    const char              *path,
+    const char              *text,
+    size_t                  length
+)
+{
+    checkContext            context;
+    yamlConfigFileStreamRef stream;
+    yaml_parser_t           parser;
+    yamlErrorCode           streamError = 0;
+    unsigned int            documentIndex = 0;
+    bool                    isSame = true, isAtEnd = false;
+
+    // The documents libyaml produces one after another from the text are
+    // the reference:
+    memset(&context, 0, sizeof(context));
+    if ( path ) {
+        stream = yamlConfigFileStreamCreateWithFileAtPath(path, mode->options);
+    } else {
+        stream = yamlConfigFileStreamCreateWithInputString(text, length, mode->options);
+    }
+    if ( ! stream ) return checkMismatch(&context, "unable to create the stream");
+    if ( ! yaml_parser_initialize(&parser) ) {
+        yamlConfigFileStreamRelease(stream);
+        return checkMismatch(&context, "unable to create a parser");
+    }
+    yaml_parser_set_input_string(&parser, (const unsigned char*)text, length);
+    while ( isSame && ! isAtEnd ) {
+        yaml_document_t     document;
+        bool                isLoaded = yaml_parser_load(&parser, &document);
+
+        context.configFile[1] = yamlConfigFileStreamNextDocument(stream, &streamError);
+        context.whereLength = snprintf(context.where, sizeof(context.where), "<document %u>", documentIndex++);
+        if ( isLoaded && ! yaml_document_get_root_node(&document) ) {
+            isSame = ( ! context.configFile[1] && ! streamError );
+            if ( ! isSame ) checkMismatch(&context, context.configFile[1] ? "document beyond the end of the stream" : "stream failed at its end");
+            isAtEnd = true;
+        } else if ( ! isLoaded && ! context.configFile[1] && ! streamError ) {
+            isSame = checkMismatch(&context, "stream ended where the serial load failed");
+        } else {
+            if ( isLoaded ) context.document[0] = &document;
+            isSame = checkContextCompare(&context);
+            isAtEnd = ! isLoaded;
+        }
+        if ( isLoaded ) yaml_document_delete(&document);
+        if ( context.configFile[1] ) yamlConfigFileRelease(context.configFile[1]);
+        context.configFile[1] = NULL;
+        context.document[0] = NULL;
+    }
+
+    // Once it has failed, the stream keeps failing:
+    if ( isSame && streamError ) {
+        yamlErrorCode       nextError = 0;
+
+        if ( (context.configFile[1] = yamlConfigFileStreamNextDocument(stream, &nextError)) ) yamlConfigFileRelease(context.configFile[1]);
+        if ( context.configFile[1] || ! nextError ) isSame = checkMismatch(&context, "stream recovered after failing");
+    }
+    yaml_parser_delete(&parser);
+    yamlConfigFileStreamRelease(stream);
+    return isSame;
+}
+
+//
+
+char*
+readFixture(
+    const char              *path,
+    size_t                  *length
+)
+{
+    FILE                    *fptr = fopen(path, "rb");
+    char                    *text = NULL;
+    size_t                  capacity = 0;
+
+    *length = 0;
+    if ( ! fptr ) return NULL;
+    while ( 1 ) {
+        size_t              n;
+
+        if ( *length + 4096 > capacity ) {
+            char            *newText = realloc(text, (capacity = 2 * capacity + 4096) + 1);
+
+            if ( ! newText ) {
+                free((void*)text);
+                text = NULL;
+                break;
+            }
+            text = newText;
+        }
+        if ( (n = fread(text + *length, 1, capacity - *length, fptr)) == 0 ) break;
+        *length += n;
+    }
+    fclose(fptr);
+    if ( text ) text[*length] = '\0';
+    return text;
+}
+
+//
+
+size_t
+writeText(
+    FILE                    *fptr,
+    const char              *text,
+    const char              *textEnd,
+    const char              *copyNumber,
+    bool                    useCRLF
+)
+{
+    size_t                  size = 0;
+
+    while ( text < textEnd ) {
+        if ( copyNumber && (strncmp(text, "@N@", 3) == 0) ) {
+            size += fwrite(copyNumber, 1, strlen(copyNumber), fptr);
+            text += 3;
+            continue;
+        }
+        if ( useCRLF && (*text == '\n') ) size += fwrite("\r", 1, 1, fptr);
+        size += fwrite(text++, 1, 1, fptr);
+    }
+    return size;
+}
+
+//
+
+bool
+writeFixture(
+    const char              *path,
+    const char              *text,
+    size_t                  length,
+    size_t                  targetSize,
+    bool                    useCRLF
+)
+{
+    FILE                    *fptr = fopen(path, "wb");
+    const char              *body = strstr(text, "#--- repeat ---\n");
+    size_t                  size = 0;
+    unsigned int            copyIndex = 0;
+
+    if ( ! fptr ) return false;
+    if ( body ) {
+        size += writeText(fptr, text, body, NULL, useCRLF);
+        body += strlen("#--- repeat ---\n");
+    } else {
+        body = text;
+    }
+    do {
+        char                copyNumber[16];
+
+        snprintf(copyNumber, sizeof(copyNumber), "%u", copyIndex++);
+        size += writeText(fptr, body, text + length, copyNumber, useCRLF);
+    } while ( size < targetSize );
+    return ( fclose(fptr) == 0 );
+}
+
+//
+
+uint64_t
+nextRandom(
+    uint64_t                *state
+)
+{
+    *state ^= *state << 13; *state ^= *state >> 7; *state ^= *state << 17;
+    return *state;
+}
+
+//
+
+size_t
+mutateText(
+    const char              *text,
+    size_t                  length,
+    char                    *mutated,
+    size_t                  capacity,
+    uint64_t                *state
+)
+{
+    static const char       indicators[] = " \t\n\r:-#'\"[]{},&*!|>?%@`\\u0.eZ\xc3";
+    unsigned int            mutationCount = 1 + nextRandom(state) % 3;
+
+    // Mutations that would not fit in capacity bytes are skipped:
+    memcpy(mutated, text, length);
+    while ( length && mutationCount-- ) {
+        size_t              at = nextRandom(state) % length, lineStart = at, lineEnd = at;
+        char                c = indicators[nextRandom(state) % (sizeof(indicators) - 1)];
+
+        while ( (lineStart > 0) && (mutated[lineStart - 1] != '\n') ) lineStart--;
+        while ( (lineEnd < length) && (mutated[lineEnd++] != '\n') );
+        switch ( nextRandom(state) % 7 ) {
+            case 0:
+                memmove(mutated + at, mutated + at + 1, length - at - 1);
+                length--;
+                break;
+            case 1:
+                if ( length + 1 > capacity ) break;
+                memmove(mutated + at + 1, mutated + at, length - at);
+                mutated[at] = c;
+                length++;
+                break;
+            case 2:
+                mutated[at] = c;
+                break;
+            case 3:
+                if ( length + (lineEnd - lineStart) > capacity ) break;
+                memmove(mutated + lineEnd + (lineEnd - lineStart), mutated + lineEnd, length - lineEnd);
+                memcpy(mutated + lineEnd, mutated + lineStart, lineEnd - lineStart);
+                length += lineEnd - lineStart;
+                break;
+            case 4:
+                if ( length + 2 > capacity ) break;
+                memmove(mutated + lineStart + 2, mutated + lineStart, length - lineStart);
+                mutated[lineStart] = mutated[lineStart + 1] = ' ';
+                length += 2;
+                break;
+            case 5:
+                if ( mutated[lineStart] == ' ' ) {
+                    memmove(mutated + lineStart, mutated + lineStart + 1, length - lineStart - 1);
+                    length--;
+                }
+                break;
+            case 6:
+                length = at;
+                break;
+        }
+    }
+    return length;
+}
+
+//
+
+void
+printInput(
+    const char              *text,
+    size_t                  length
+)
+{
+    printf("---- SNIP ----\n%.*s\n---- SNIP ----\n", (int)length, text);
+}
+
+//
+
+bool
+checkLazyLoad(
+    const checkMode         *mode,
+    const char              *path,
+    const char              *text,
+    size_t                  length
+)
+{
+    checkContext            context;
+    yamlOptionsBitvec       options = yamlConfigFileOptions_doNotCache | yamlConfigFileOptions_noParseCache;
+    bool                    isSame;
+
+    // Deferred subtrees are only materialized by key paths, so the lazy
+    // load is walked along key paths from its root:
+    memset(&context, 0, sizeof(context));
+    context.configFile[0] = createSerialLoad(path, text, length);
+    context.configFile[1] = yamlConfigFileCreateWithFileAtPath(path, mode->options | options);
+    if ( ! context.configFile[0] || ! context.configFile[1] ) {
+        isSame = checkContextCompare(&context);
+    } else if ( ! yamlConfigFileGetRootNode(context.configFile[0]) && ! yamlConfigFileGetRootNode(context.configFile[1]) ) {
+        isSame = true;
+    } else {
+        isSame = checkNodesAlongKeyPaths(&context, 1, yamlConfigFileGetRootNode(context.configFile[1]));
+        checkContextResetNodeMaps(&context);
+    }
+    if ( context.configFile[0] ) yamlConfigFileRelease(context.configFile[0]);
+    if ( context.configFile[1] ) yamlConfigFileRelease(context.configFile[1]);
+    return isSame;
+}
+
+//
+
+bool
+isSharedNode(
+    yamlConfigFileRef       configFile,
+    yaml_node_t             *aNode
+)
+{
+    int                     nodeId = aNode - yamlConfigFileGetNodeWithId(configFile, 1) + 1, i;
+    unsigned int            referenceCount = 0;
+    yaml_node_t             *node;
+
+    // Is aNode the target of an alias, i.e. referenced more than once?
+    for ( i = 1; (node = yamlConfigFileGetNodeWithId(configFile, i)); i++ ) {
+        if ( node->type == YAML_SEQUENCE_NODE ) {
+            yaml_node_item_t    *item;
+
+            for ( item = node->data.sequence.items.start; item < node->data.sequence.items.top; item++ ) if ( *item == nodeId ) referenceCount++;
+        } else if ( node->type == YAML_MAPPING_NODE ) {
+            yaml_node_pair_t    *pair;
+
+            for ( pair = node->data.mapping.pairs.start; pair < node->data.mapping.pairs.top; pair++ ) {
+                if ( pair->key == nodeId ) referenceCount++;
+                if ( pair->value == nodeId ) referenceCount++;
+            }
+        }
+    }
+    return ( referenceCount > 1 );
+}
+
+//
+
+yamlKeyPathRef
+createChildKeyPath(
+    yamlConfigFileRef       configFile,
+    yaml_node_t             *parentNode,
+    bool                    isLastChild,
+    yamlKeyPathRef          parentKeyPath
+)
+{
+    yamlKeyPathNodeMatchType    *parentMatch = parentKeyPath ? yamlKeyPathGetFirstNodeMatch(parentKeyPath) : NULL;
+    long                    count;
+
+    // The key path to the first or last child of parentNode (a scalar key
+    // in a mapping), appended to the one-element parentKeyPath:
+    if ( ! parentNode ) return NULL;
+    if ( parentNode->type == YAML_SEQUENCE_NODE ) {
+        int                 index;
+
+        if ( ! (count = parentNode->data.sequence.items.top - parentNode->data.sequence.items.start) ) return NULL;
+        index = isLastChild ? (int)count - 1 : 0;
+        if ( ! parentMatch ) return yamlKeyPathCreate(0, NULL, YAML_SEQUENCE_NODE, index, YAML_NO_NODE);
+        if ( parentMatch->type == YAML_SEQUENCE_NODE ) return yamlKeyPathCreate(0, NULL, YAML_SEQUENCE_NODE, parentMatch->parameter.index, YAML_SEQUENCE_NODE, index, YAML_NO_NODE);
+        return yamlKeyPathCreate(0, NULL, YAML_MAPPING_NODE, parentMatch->parameter.key, YAML_SEQUENCE_NODE, index, YAML_NO_NODE);
+    }
+    if ( parentNode->type == YAML_MAPPING_NODE ) {
+        yaml_node_pair_t    *pair;
+
+        if ( ! (count = parentNode->data.mapping.pairs.top - parentNode->data.mapping.pairs.start) ) return NULL;
+        pair = isLastChild ? parentNode->data.mapping.pairs.top - 1 : parentNode->data.mapping.pairs.start;
+        while ( (pair >= parentNode->data.mapping.pairs.start) && (pair < parentNode->data.mapping.pairs.top) ) {
+            yaml_node_t     *key = yamlConfigFileGetNodeWithId(configFile, pair->key);
+
+            if ( key && (key->type == YAML_SCALAR_NODE) && ! memchr(key->data.scalar.value, '\0', key->data.scalar.length) ) {
+                if ( ! parentMatch ) return yamlKeyPathCreate(0, NULL, YAML_MAPPING_NODE, (const char*)key->data.scalar.value, YAML_NO_NODE);
+                if ( parentMatch->type == YAML_SEQUENCE_NODE ) return yamlKeyPathCreate(0, NULL, YAML_SEQUENCE_NODE, parentMatch->parameter.index, YAML_MAPPING_NODE, (const char*)key->data.scalar.value, YAML_NO_NODE);
+                return yamlKeyPathCreate(0, NULL, YAML_MAPPING_NODE, parentMatch->parameter.key, YAML_MAPPING_NODE, (const char*)key->data.scalar.value, YAML_NO_NODE);
+            }
+            pair += isLastChild ? -1 : 1;
+        }
+    }
+    return NULL;
+}
+
+//
+
+bool
+checkFilteredLoad(
+    const checkMode         *mode,
+    const char              *path,
+    const char              *text,
+    size_t                  length
+)
+{
+    checkContext            context;
+    yamlOptionsBitvec       options = yamlConfigFileOptions_doNotCache | yamlConfigFileOptions_noParseCache;
+    yamlKeyPathRef          keyPaths[4];
+    unsigned int            keyPathIndex;
+    yaml_node_t             *rootNode;
+    bool                    isSame = true;
+
+    // The paths are those to the last top-level value (whole, and its last
+    // child) and to the first top-level value (whole, and its first child);
+    // the former are included, the latter excluded.  An anchored value is
+    // composed whole, so there is no path through one that is aliased:
+    memset(&context, 0, sizeof(context));
+    memset(keyPaths, 0, sizeof(keyPaths));
+    if ( ! (context.configFile[0] = createSerialLoad(path, text, length)) ) {
+        // Then no filter can help:
+        yamlConfigFileFilter    filter = { NULL, 0, NULL, 0 };
+
+        if ( path ) {
+            context.configFile[1] = yamlConfigFileCreateWithFileAtPathAndFilter(path, mode->options | options, &filter);
+        } else {
+            context.configFile[1] = yamlConfigFileCreateWithInputStringAndFilter(text, length, mode->options | options, &filter);
+        }
+        isSame = checkContextCompare(&context);
+        if ( context.configFile[1] ) yamlConfigFileRelease(context.configFile[1]);
+        return isSame;
+    }
+    if ( (rootNode = yamlConfigFileGetRootNode(context.configFile[0])) ) {
+        yaml_node_t         *valueNode;
+
+        if ( (keyPaths[0] = createChildKeyPath(context.configFile[0], rootNode, true, NULL)) ) {
+            valueNode = yamlConfigFileGetNodeAtPath(context.configFile[0], keyPaths[0], NULL, NULL, NULL);
+            if ( valueNode && ! isSharedNode(context.configFile[0], valueNode) ) keyPaths[1] = createChildKeyPath(context.configFile[0], valueNode, true, keyPaths[0]);
+        }
+        if ( (keyPaths[2] = createChildKeyPath(context.configFile[0], rootNode, false, NULL)) ) {
+            valueNode = yamlConfigFileGetNodeAtPath(context.configFile[0], keyPaths[2], NULL, NULL, NULL);
+            if ( valueNode && ! isSharedNode(context.configFile[0], valueNode) ) keyPaths[3] = createChildKeyPath(context.configFile[0], valueNode, false, keyPaths[2]);
+        }
+    }
+    for ( keyPathIndex = 0; isSame && (keyPathIndex < 4); keyPathIndex++ ) {
+        yamlConfigFileFilter    filter = { NULL, 0, NULL, 0 };
+        bool                isIncluded = ( keyPathIndex < 2 );
+        char                keyPathString[256];
+
+        if ( ! keyPaths[keyPathIndex] ) continue;
+        if ( isIncluded ) {
+            filter.includePaths = &keyPaths[keyPathIndex];
+            filter.includePathCount = 1;
+        } else {
+            filter.excludePaths = &keyPaths[keyPathIndex];
+            filter.excludePathCount = 1;
+        }
+        yamlKeyPathSprintf(keyPaths[keyPathIndex], keyPathString, sizeof(keyPathString));
+        context.whereLength = snprintf(context.where, sizeof(context.where), "<%s %s>", isIncluded ? "include" : "exclude", keyPathString);
+        if ( context.whereLength >= sizeof(context.where) ) context.whereLength = sizeof(context.where) - 1;
+        if ( path ) {
+            context.configFile[1] = yamlConfigFileCreateWithFileAtPathAndFilter(path, mode->options | options, &filter);
+        } else {
+            context.configFile[1] = yamlConfigFileCreateWithInputStringAndFilter(text, length, mode->options | options, &filter);
+        }
+        if ( ! context.configFile[1] ) {
+            isSame = checkMismatch(&context, "filtered load failed");
+        } else {
+            isSame = checkFilteredNodes(&context, 1, 1, yamlKeyPathGetFirstNodeMatch(keyPaths[keyPathIndex]), isIncluded);
+            yamlConfigFileRelease(context.configFile[1]);
+        }
+        checkContextResetNodeMaps(&context);
+    }
+    for ( keyPathIndex = 0; keyPathIndex < 4; keyPathIndex++ ) if ( keyPaths[keyPathIndex] ) yamlKeyPathRelease(keyPaths[keyPathIndex]);
+    yamlConfigFileRelease(context.configFile[0]);
+    return isSame;
+}
+
+//
+
+bool
+isRootSequenceParsed(
+    const char              *text,
+    size_t                  length
+)
+{
+    yaml_parser_t           parser;
+    yaml_event_t            event;
+    int                     depth = 0;
+    bool                    isParsed = false, isDone = false;
+
+    // Does libyaml parse the text up to the end of a root sequence (any
+    // error lying beyond it)?
+    if ( ! yaml_parser_initialize(&parser) ) return false;
+    yaml_parser_set_input_string(&parser, (const unsigned char*)text, length);
+    while ( ! isDone && yaml_parser_parse(&parser, &event) ) {
+        switch ( event.type ) {
+            case YAML_SEQUENCE_START_EVENT:
+            case YAML_MAPPING_START_EVENT:
+                depth++;
+                break;
+            case YAML_SEQUENCE_END_EVENT:
+            case YAML_MAPPING_END_EVENT:
+                if ( --depth == 0 ) isParsed = isDone = true;
+                break;
+            case YAML_SCALAR_EVENT:
+            case YAML_ALIAS_EVENT:
+            case YAML_STREAM_END_EVENT:
+                if ( depth == 0 ) isDone = true;
+                break;
+            default:
+                break;
+        }
+        yaml_event_delete(&event);
+    }
+    yaml_parser_delete(&parser);
+    return isParsed;
+}
+
+//
+
+bool
+checkRecords(
+    const checkMode         *mode,
+    const char              *path,
+    const char              *text,
+    size_t                  length
+)
+{
+    checkContext            context;
+    yamlConfigFileRecordIteratorRef iterator;
+    yamlErrorCode           recordError = 0;
+    yaml_node_t             *rootNode = NULL;
+    unsigned int            recordIndex = 0;
+    bool                    isSame = true;
+
+    // Each record must match the corresponding item of the serial load's
+    // root sequence:
+    memset(&context, 0, sizeof(context));
+    if ( path ) {
+        iterator = yamlConfigFileRecordIteratorCreateWithFileAtPath(path, mode->options);
+    } else {
+        iterator = yamlConfigFileRecordIteratorCreateWithInputString(text, length, mode->options);
+    }
+    if ( ! iterator ) return checkMismatch(&context, "unable to create the record iterator");
+    if ( (context.configFile[0] = createSerialLoad(path, text, length)) ) rootNode = yamlConfigFileGetRootNode(context.configFile[0]);
+    if ( ! context.configFile[0] ) {
+        // Records are composed as they are read, so some may be produced
+        // before the iteration fails; it only ends cleanly if libyaml
+        // failed beyond the end of the root sequence:
+        while ( yamlConfigFileRecordIteratorNextRecord(iterator, &recordError) );
+        if ( ! recordError && ! isRootSequenceParsed(text, length) ) isSame = checkMismatch(&context, "records ended where the serial load failed");
+    } else if ( ! rootNode ) {
+        // An empty stream has no records:
+        if ( yamlConfigFileRecordIteratorNextRecord(iterator, &recordError) || recordError ) isSame = checkMismatch(&context, "record produced from an empty document");
+    } else if ( rootNode->type != YAML_SEQUENCE_NODE ) {
+        if ( yamlConfigFileRecordIteratorNextRecord(iterator, &recordError) || (recordError != yamlConfigFileError_invalidType) ) isSame = checkMismatch(&context, "root node is not a sequence but no yamlConfigFileError_invalidType");
+    } else {
+        yaml_node_item_t    *item;
+
+        for ( item = rootNode->data.sequence.items.start; isSame && (item < rootNode->data.sequence.items.top); item++ ) {
+            context.whereLength = snprintf(context.where, sizeof(context.where), "<record %u>", recordIndex++);
+            if ( ! (context.configFile[1] = yamlConfigFileRecordIteratorNextRecord(iterator, &recordError)) ) {
+                isSame = checkMismatch(&context, recordError ? "record iteration failed" : "records ended early");
+            } else {
+                isSame = checkNodes(&context, *item, 1);
+            }
+            checkContextResetNodeMaps(&context);
+        }
+        context.whereLength = 0;
+        if ( isSame ) {
+            if ( (context.configFile[1] = yamlConfigFileRecordIteratorNextRecord(iterator, &recordError)) || recordError ) {
+                isSame = checkMismatch(&context, recordError ? "record iteration failed at its end" : "record beyond the end of the root sequence");
+            } else if ( ! yamlConfigFileRecordIteratorIsAtEnd(iterator) ) {
+                isSame = checkMismatch(&context, "iterator not at its end");
+            } else if ( yamlConfigFileRecordIteratorGetRecordCount(iterator) != recordIndex ) {
+                isSame = checkMismatch(&context, "wrong record count");
+            }
+        }
+        context.configFile[1] = NULL;
+    }
+
+    // Once it has failed, the iterator keeps failing:
+    if ( isSame && recordError ) {
+        yamlErrorCode       nextError = 0;
+
+        if ( yamlConfigFileRecordIteratorNextRecord(iterator, &nextError) || (nextError != recordError) ) isSame = checkMismatch(&context, "record iteration recovered after failing");
+    }
+    if ( context.configFile[0] ) yamlConfigFileRelease(context.configFile[0]);
+    yamlConfigFileRecordIteratorRelease(iterator);
+    return isSame;
+}
+
+//
+
+bool
+checkBatchLoad(
+    const checkMode         *mode,
+    const char              *path,
+    const char              *text,
+    size_t                  length
+)
+{
+    checkContext            context;
+    char                    missingPath[4096];
+    const char              *paths[4] = { path, missingPath, path, path };
+    yamlConfigFileRef       configFiles[4];
+    yamlErrorCode           errors[4];
+    yamlOptionsBitvec       options[2] = {
+                                yamlConfigFileOptions_doNotCache | yamlConfigFileOptions_noParseCache,
+                                yamlConfigFileOptions_noParseCache
+                            };
+    unsigned int            pass, i, loadCount;
+    bool                    isSame = true;
+
+    // The same file three times and a missing one, first uncached (each
+    // copy is loaded on its own) then cached (every copy receives the
+    // first):
+    memset(&context, 0, sizeof(context));
+    snprintf(missingPath, sizeof(missingPath), "%s.missing", path);
+    context.configFile[0] = createSerialLoad(path, text, length);
+    for ( pass = 0; isSame && (pass < 2); pass++ ) {
+        yamlConfigFileCacheFlush();
+        loadCount = yamlConfigFileCreateWithFilesAtPaths(paths, 4, mode->options | options[pass], 4, configFiles, errors);
+        for ( i = 0; i < 4; i++ ) {
+            context.whereLength = snprintf(context.where, sizeof(context.where), "<%s file %u>", pass ? "cached" : "uncached", i);
+            if ( isSame && (paths[i] == missingPath) ) {
+                if ( configFiles[i] || (errors[i] != yamlConfigFileError_fileNotReadable) ) isSame = checkMismatch(&context, "missing file not refused with yamlConfigFileError_fileNotReadable");
+            } else if ( isSame && ((configFiles[i] != NULL) != (errors[i] == 0)) ) {
+                isSame = checkMismatch(&context, "error code does not agree with the result");
+            } else if ( isSame && ! configFiles[i] && (errors[i] != yamlConfigFileError_parseFailed) ) {
+                isSame = checkMismatch(&context, "failed load not reported as yamlConfigFileError_parseFailed");
+            } else if ( isSame && pass && (i > 0) && (configFiles[i] != configFiles[0]) ) {
+                isSame = checkMismatch(&context, "repeated path did not receive the cached copy");
+            } else if ( isSame ) {
+                context.configFile[1] = configFiles[i];
+                isSame = checkContextCompare(&context);
+            }
+            if ( configFiles[i] ) yamlConfigFileRelease(configFiles[i]);
+        }
+        context.whereLength = 0;
+        if ( isSame && (loadCount != (context.configFile[0] ? 3 : 0)) ) isSame = checkMismatch(&context, "wrong count of files loaded");
+    }
+    yamlConfigFileCacheFlush();
+    if ( context.configFile[0] ) yamlConfigFileRelease(context.configFile[0]);
+    return isSame;
+}
+
+//
+
+void
+countAsyncLoadCallback(
+    yamlConfigFileAsyncLoadRef  aLoad,
+    void                    *context
+)
+{
+    (*(unsigned int*)context)++;
+}
+
+//
+
+bool
+checkAsyncLoad(
+    const checkMode         *mode,
+    const char              *path,
+    const char              *text,
+    size_t                  length
+)
+{
+    static const char       *loadNames[] = { "plain", "cancelled", "deadline", "missing" };
+    checkContext            context;
+    yamlOptionsBitvec       options = yamlConfigFileOptions_doNotCache | yamlConfigFileOptions_noParseCache;
+    char                    missingPath[4096];
+    unsigned int            loadIndex;
+    bool                    isSame = true;
+
+    // A plain load, one cancelled as soon as it starts, one with a deadline
+    // that expires almost immediately and one of a missing file; the
+    // cancelled and expired loads may still finish first, in which case
+    // they must match the serial load like the plain one:
+    memset(&context, 0, sizeof(context));
+    snprintf(missingPath, sizeof(missingPath), "%s.missing", path);
+    context.configFile[0] = createSerialLoad(path, text, length);
+    for ( loadIndex = 0; isSame && (loadIndex < 4); loadIndex++ ) {
+        yamlConfigFileAsyncLoadRef  load;
+        yamlErrorCode       loadError = 0;
+        unsigned int        callbackCount = 0;
+        struct pollfd       pollFd;
+        bool                isStopped;
+
+        context.whereLength = snprintf(context.where, sizeof(context.where), "<%s load>", loadNames[loadIndex]);
+        load = yamlConfigFileAsyncLoadCreateWithFileAtPath((loadIndex == 3) ? missingPath : path, mode->options | options, (loadIndex == 2) ? 1e-6 : 0, countAsyncLoadCallback, &callbackCount);
+        if ( ! load ) {
+            isSame = checkMismatch(&context, "unable to start the load");
+            continue;
+        }
+        if ( loadIndex == 1 ) yamlConfigFileAsyncLoadCancel(load);
+        if ( ! yamlConfigFileAsyncLoadWait(load, -1) || ! yamlConfigFileAsyncLoadIsComplete(load) ) {
+            isSame = checkMismatch(&context, "load did not complete");
+            yamlConfigFileAsyncLoadCancel(load);
+            yamlConfigFileAsyncLoadRelease(load);
+            continue;
+        }
+        context.configFile[1] = yamlConfigFileAsyncLoadGetConfigFile(load, &loadError);
+        pollFd.fd = yamlConfigFileAsyncLoadGetFileDescriptor(load);
+        pollFd.events = POLLIN;
+        isStopped = ( ((loadIndex == 1) && (loadError == yamlConfigFileError_loadCancelled)) || ((loadIndex == 2) && (loadError == yamlConfigFileError_loadDeadlineExpired)) );
+        if ( callbackCount != 1 ) {
+            isSame = checkMismatch(&context, "callback not called exactly once");
+        } else if ( (pollFd.fd < 0) || (poll(&pollFd, 1, 0) != 1) || ! (pollFd.revents & POLLIN) ) {
+            isSame = checkMismatch(&context, "file descriptor not readable");
+        } else if ( (context.configFile[1] != NULL) != (loadError == 0) ) {
+            isSame = checkMismatch(&context, "error code does not agree with the result");
+        } else if ( loadIndex == 3 ) {
+            if ( context.configFile[1] || (loadError != yamlConfigFileError_fileNotReadable) ) isSame = checkMismatch(&context, "missing file not refused with yamlConfigFileError_fileNotReadable");
+        } else if ( loadError && ! isStopped && (loadError != yamlConfigFileError_parseFailed) ) {
+            isSame = checkMismatch(&context, "failed load not reported as yamlConfigFileError_parseFailed");
+        } else if ( ! isStopped ) {
+            isSame = checkContextCompare(&context);
+        }
+        context.configFile[1] = NULL;
+        yamlConfigFileAsyncLoadRelease(load);
+    }
+    if ( context.configFile[0] ) yamlConfigFileRelease(context.configFile[0]);
+    return isSame;
+}
+
+//
+
+bool
+checkPushParser(
+    const checkMode         *mode,
+    const char              *path,
+    const char              *text,
+    size_t                  length
+)
+{
+    checkContext            context;
+    yamlConfigFilePushParserRef pushParser;
+    yamlErrorCode           pushError = 0, finishError = 0;
+    uint64_t                state = 0x9E3779B97F4A7C15ULL ^ length;
+    size_t                  offset = 0, maxPieceLength = length / 64 + 16;
+    bool                    isSame = true;
+
+    // The text is fed in pieces of random length (reproducible for a given
+    // length), so pieces end at arbitrary points within tokens and line
+    // breaks:
+    memset(&context, 0, sizeof(context));
+    if ( ! (pushParser = yamlConfigFilePushParserCreate(mode->options)) ) return checkMismatch(&context, "unable to create the push parser");
+    context.configFile[0] = createSerialLoad(path, text, length);
+    while ( offset < length ) {
+        size_t              pieceLength = 1 + nextRandom(&state) % maxPieceLength;
+
+        if ( pieceLength > length - offset ) pieceLength = length - offset;
+        if ( ! yamlConfigFilePushParserFeed(pushParser, text + offset, pieceLength, &pushError) ) break;
+        offset += pieceLength;
+    }
+    context.configFile[1] = yamlConfigFilePushParserFinish(pushParser, &finishError);
+    if ( pushError && (pushError != yamlConfigFileError_parseFailed) ) {
+        isSame = checkMismatch(&context, "failed feed not reported as yamlConfigFileError_parseFailed");
+    } else if ( pushError && context.configFile[0] ) {
+        isSame = checkMismatch(&context, "feed failed where the serial load succeeded");
+    } else if ( pushError && ! finishError ) {
+        isSame = checkMismatch(&context, "push parser finished after a feed failed");
+    } else if ( (context.configFile[1] != NULL) != (finishError == 0) ) {
+        isSame = checkMismatch(&context, "error code does not agree with the result");
+    } else {
+        isSame = checkContextCompare(&context);
+    }
+
+    // Finishing again returns the same document, and no more input is
+    // accepted:
+    if ( isSame ) {
+        yamlConfigFileRef   again = yamlConfigFilePushParserFinish(pushParser, &pushError);
+
+        if ( (again != context.configFile[1]) || (pushError != finishError) ) isSame = checkMismatch(&context, "finishing again produced a different result");
+        if ( again ) yamlConfigFileRelease(again);
+    }
+    if ( isSame && (yamlConfigFilePushParserFeed(pushParser, text, length, &pushError) || (pushError != yamlConfigFileError_invalidState)) ) {
+        isSame = checkMismatch(&context, "finished push parser accepted more input");
+    }
+    if ( context.configFile[0] ) yamlConfigFileRelease(context.configFile[0]);
+    if ( context.configFile[1] ) yamlConfigFileRelease(context.configFile[1]);
+    yamlConfigFilePushParserRelease(pushParser);
+    return isSame;
+}
+
+//
+
+bool
+checkIncrementalLoad(
+    const checkMode         *mode,
+    const char              *path,
+    const char              *text,
+    size_t                  length
+)
+{
+    checkContext            context;
+    yamlConfigFileIncrementalLoadRef    load;
+    yamlOptionsBitvec       options = yamlConfigFileOptions_doNotCache | yamlConfigFileOptions_noParseCache;
+    yamlErrorCode           stepError = 0, loadError = 0;
+    uint64_t                state = 0x9E3779B97F4A7C15ULL ^ length;
+    unsigned long           eventCount = 0;
+    bool                    isSame = true, isFinished = false;
+
+    // Steps of a random number of events (reproducible for a given length)
+    // until the load finishes; each unfinished step must consume at least
+    // one event and no more than its budget:
+    memset(&context, 0, sizeof(context));
+    if ( path ) {
+        load = yamlConfigFileIncrementalLoadCreateWithFileAtPath(path, mode->options | options);
+    } else {
+        load = yamlConfigFileIncrementalLoadCreateWithInputString(text, length, mode->options | options);
+    }
+    if ( ! load ) return checkMismatch(&context, "unable to create the incremental load");
+    context.configFile[0] = createSerialLoad(path, text, length);
+    while ( isSame && ! isFinished ) {
+        unsigned int        eventBudget = 1 + nextRandom(&state) % 64;
+        unsigned long       stepEventCount;
+
+        isFinished = yamlConfigFileIncrementalLoadStep(load, 0, eventBudget, &stepError);
+        stepEventCount = yamlConfigFileIncrementalLoadGetEventCount(load) - eventCount;
+        eventCount += stepEventCount;
+        if ( isFinished ) break;
+        if ( stepError ) {
+            isSame = checkMismatch(&context, "unfinished load reported an error");
+        } else if ( ! stepEventCount || (stepEventCount > eventBudget) ) {
+            isSame = checkMismatch(&context, "step did not respect its event budget");
+        } else if ( yamlConfigFileIncrementalLoadGetConfigFile(load, &loadError) || (loadError != yamlConfigFileError_loadNotComplete) ) {
+            isSame = checkMismatch(&context, "unfinished load not reported as yamlConfigFileError_loadNotComplete");
+        }
+    }
+    if ( isSame ) {
+        context.configFile[1] = yamlConfigFileIncrementalLoadGetConfigFile(load, &loadError);
+        if ( (context.configFile[1] != NULL) != (loadError == 0) ) {
+            isSame = checkMismatch(&context, "error code does not agree with the result");
+        } else if ( loadError != stepError ) {
+            isSame = checkMismatch(&context, "load and step errors differ");
+        } else if ( loadError && (loadError != yamlConfigFileError_parseFailed) ) {
+            isSame = checkMismatch(&context, "failed load not reported as yamlConfigFileError_parseFailed");
+        } else {
+            isSame = checkContextCompare(&context);
+        }
+    }
+
+    // A finished load stays finished:
+    if ( isSame && (! yamlConfigFileIncrementalLoadStep(load, 0, 1, &stepError) || (stepError != loadError) || (yamlConfigFileIncrementalLoadGetEventCount(load) != eventCount)) ) {
+        isSame = checkMismatch(&context, "finished load stepped again");
+    }
+    if ( context.configFile[0] ) yamlConfigFileRelease(context.configFile[0]);
+    yamlConfigFileIncrementalLoadRelease(load);
+    return isSame;
+}
+
+//
+
+bool
+writeBytes(
+    const char              *path,
+    const char              *bytes,
+    size_t                  length
+)
+{
+    FILE                    *fptr = fopen(path, "wb");
+    bool                    isWritten;
+
+    if ( ! fptr ) return false;
+    isWritten = ( fwrite(bytes, 1, length, fptr) == length );
+    return ( (fclose(fptr) == 0) && isWritten );
+}
+
+//
+
+bool
+checkSnapshotAlongKeyPaths(
+    checkContext            *context
+)
+{
+    yaml_node_t             *rootNode = yamlConfigFileGetRootNode(context->configFile[1]);
+    bool                    isSame;
+
+    if ( ! rootNode && ! yamlConfigFileGetRootNode(context->configFile[0]) ) return true;
+    isSame = checkNodesAlongKeyPaths(context, 1, rootNode);
+    checkContextResetNodeMaps(context);
+    return isSame;
+}
+
+//
+
+bool
+checkSnapshot(
+    const checkMode         *mode,
+    const char              *path,
+    const char              *text,
+    size_t                  length
+)
+{
+    checkContext            context;
+    yamlOptionsBitvec       options = yamlConfigFileOptions_doNotCache | yamlConfigFileOptions_noParseCache;
+    yamlOptionsBitvec       caselessOptions = yamlConfigFileOptions_oneBasedIndices | yamlConfigFileOptions_caseFoldKeys;
+    yamlConfigFileRef       serialLoad;
+    yamlErrorCode           snapshotError = 0;
+    char                    snapshotPath[4096], corruptPath[4096];
+    char                    *snapshot = NULL;
+    size_t                  snapshotLength, corruptLengths[5];
+    uint64_t                state = 0x9E3779B97F4A7C15ULL ^ length;
+    unsigned int            i;
+    bool                    isSame = true;
+
+    memset(&context, 0, sizeof(context));
+    snprintf(snapshotPath, sizeof(snapshotPath), "%s.snapshot", path);
+    snprintf(corruptPath, sizeof(corruptPath), "%s.corrupt", path);
+
+    // YAML text is not a snapshot:
+    if ( (context.configFile[1] = yamlConfigFileCreateWithSnapshotAtPath(path, mode->options | options, &snapshotError)) || (snapshotError != yamlConfigFileError_invalidSnapshot) ) {
+        isSame = checkMismatch(&context, "YAML text not refused with yamlConfigFileError_invalidSnapshot");
+        if ( context.configFile[1] ) yamlConfigFileRelease(context.configFile[1]);
+    }
+    if ( ! (serialLoad = createSerialLoad(path, text, length)) ) return isSame;
+    if ( ! yamlConfigFileWriteSnapshotToPath(serialLoad, snapshotPath, &snapshotError) || ! (snapshot = readFixture(snapshotPath, &snapshotLength)) ) {
+        isSame = checkMismatch(&context, "unable to write the snapshot");
+        goto cleanup;
+    }
+
+    // The snapshot is walked along key paths (exact, and then caseless
+    // against a caseless serial load) before anything else has filled-in
+    // its nodes, and then by id:
+    context.configFile[0] = serialLoad;
+    context.whereLength = snprintf(context.where, sizeof(context.where), "<snapshot>");
+    if ( (context.configFile[1] = yamlConfigFileCreateWithSnapshotAtPath(snapshotPath, mode->options | options, &snapshotError)) ) {
+        isSame = checkSnapshotAlongKeyPaths(&context) && checkContextCompare(&context);
+        yamlConfigFileRelease(context.configFile[1]);
+    } else {
+        isSame = checkMismatch(&context, "snapshot refused");
+    }
+    context.whereLength = snprintf(context.where, sizeof(context.where), "<caseless snapshot>");
+    if ( isSame && (context.configFile[0] = yamlConfigFileCreateWithFileAtPath(path, caselessOptions | options)) ) {
+        if ( (context.configFile[1] = yamlConfigFileCreateWithSnapshotAtPath(snapshotPath, mode->options | caselessOptions | options, &snapshotError)) ) {
+            isSame = checkSnapshotAlongKeyPaths(&context);
+            yamlConfigFileRelease(context.configFile[1]);
+        } else {
+            isSame = checkMismatch(&context, "snapshot refused");
+        }
+        yamlConfigFileRelease(context.configFile[0]);
+    }
+    context.configFile[0] = serialLoad;
+    context.configFile[1] = NULL;
+
+    // Truncated copies, one with a byte appended (the NUL readFixture()
+    // leaves after the text) and one with a damaged magic number must be
+    // refused:
+    corruptLengths[0] = 0;
+    corruptLengths[1] = 16;
+    corruptLengths[2] = snapshotLength / 2;
+    corruptLengths[3] = snapshotLength - 1;
+    corruptLengths[4] = snapshotLength + 1;
+    for ( i = 0; isSame && (i < 6); i++ ) {
+        context.whereLength = snprintf(context.where, sizeof(context.where), "<corrupt snapshot %u>", i);
+        if ( i == 5 ) snapshot[0] ^= 0xFF;
+        if ( ! writeBytes(corruptPath, snapshot, (i < 5) ? corruptLengths[i] : snapshotLength) ) {
+            isSame = checkMismatch(&context, "unable to write the corrupt snapshot");
+        } else if ( (context.configFile[1] = yamlConfigFileCreateWithSnapshotAtPath(corruptPath, mode->options | options, &snapshotError)) || (snapshotError != yamlConfigFileError_invalidSnapshot) ) {
+            isSame = checkMismatch(&context, "corrupt snapshot not refused with yamlConfigFileError_invalidSnapshot");
+            if ( context.configFile[1] ) yamlConfigFileRelease(context.configFile[1]);
+        }
+        if ( i == 5 ) snapshot[0] ^= 0xFF;
+    }
+
+    // A snapshot with a flipped bit may be accepted (node records are only
+    // checked as they are reached), but walking it must not crash; each
+    // walk of a large snapshot is slow, so only small ones are damaged:
+    for ( i = 0; isSame && (snapshotLength <= 64 * 1024) && (i < 64); i++ ) {
+        size_t              flipAt = nextRandom(&state) % snapshotLength;
+        char                flipMask = 1 << (nextRandom(&state) % 8);
+
+        context.whereLength = snprintf(context.where, sizeof(context.where), "<snapshot with byte %zu flipped>", flipAt);
+        snapshot[flipAt] ^= flipMask;
+        if ( ! writeBytes(corruptPath, snapshot, snapshotLength) ) {
+            isSame = checkMismatch(&context, "unable to write the corrupt snapshot");
+        } else if ( (context.configFile[1] = yamlConfigFileCreateWithSnapshotAtPath(corruptPath, mode->options | options, &snapshotError)) ) {
+            context.isQuiet = true;
+            checkSnapshotAlongKeyPaths(&context);
+            checkContextCompare(&context);
+            context.isQuiet = false;
+            yamlConfigFileRelease(context.configFile[1]);
+        } else if ( snapshotError != yamlConfigFileError_invalidSnapshot ) {
+            isSame = checkMismatch(&context, "corrupt snapshot not refused with yamlConfigFileError_invalidSnapshot");
+        }
+        snapshot[flipAt] ^= flipMask;
+    }
+
+cleanup:
+    free((void*)snapshot);
+    unlink(snapshotPath);
+    unlink(corruptPath);
+    yamlConfigFileRelease(serialLoad);
+    return isSame;
+}
+
+//
+
+ino_t
+getParseCacheEntryInode(
+    const char              *directoryPath,
+    bool                    shouldRemove
+)
+{
+    DIR                     *directory = opendir(directoryPath);
+    struct dirent           *entry;
+    ino_t                   inode = 0;
+
+    // The inode of the entry (the only file in the directory), which is
+    // replaced whenever the entry is rewritten:
+    if ( ! directory ) return 0;
+    while ( (entry = readdir(directory)) ) {
+        char                entryPath[4096];
+        struct stat         finfo;
+
+        if ( entry->d_name[0] == '.' ) continue;
+        snprintf(entryPath, sizeof(entryPath), "%s/%s", directoryPath, entry->d_name);
+        if ( (lstat(entryPath, &finfo) == 0) && S_ISREG(finfo.st_mode) ) inode = finfo.st_ino;
+        if ( shouldRemove ) unlink(entryPath);
+    }
+    closedir(directory);
+    return inode;
+}
+
+//
+
+bool
+checkParseCache(
+    const checkMode         *mode,
+    const char              *path,
+    const char              *text,
+    size_t                  length
+)
+{
+    static const char       *loadNames[] = { "first", "second", "touched", "edited" };
+    checkContext            context;
+    char                    directoryPath[] = "load_differential_check.cache.XXXXXX";
+    char                    *editedText = NULL;
+    ino_t                   entryInode = 0;
+    unsigned int            loadIndex;
+    bool                    isSame = true;
+
+    // The first load of the file misses and writes an entry, the second
+    // hits it; touching the file, and then changing one character while
+    // keeping its size and modification time, must each miss again:
+    memset(&context, 0, sizeof(context));
+    if ( ! mkdtemp(directoryPath) ) return checkMismatch(&context, "unable to create the parse cache directory");
+    if ( ! yamlConfigFileSetParseCacheDirectory(directoryPath) ) {
+        rmdir(directoryPath);
+        return checkMismatch(&context, "unable to set the parse cache directory");
+    }
+    context.configFile[0] = createSerialLoad(path, text, length);
+    for ( loadIndex = 0; isSame && (loadIndex < 4); loadIndex++ ) {
+        ino_t               newEntryInode;
+        bool                isHitExpected = ( loadIndex == 1 );
+
+        context.whereLength = snprintf(context.where, sizeof(context.where), "<%s load>", loadNames[loadIndex]);
+        if ( loadIndex >= 2 ) {
+            struct stat     finfo;
+            struct timespec times[2];
+            char            *p;
+
+            if ( stat(path, &finfo) != 0 ) {
+                isSame = checkMismatch(&context, "unable to stat the file");
+                break;
+            }
+            times[0].tv_sec = 0;
+            times[0].tv_nsec = UTIME_OMIT;
+            times[1].tv_sec = finfo.st_mtime;
+#if defined(HAVE_STRUCT_STAT_ST_MTIM)
+            times[1].tv_nsec = finfo.st_mtim.tv_nsec;
+#elif defined(HAVE_STRUCT_STAT_ST_MTIMESPEC)
+            times[1].tv_nsec = finfo.st_mtimespec.tv_nsec;
+#else
+            times[1].tv_nsec = 0;
+#endif
+            if ( loadIndex == 2 ) {
+                times[1].tv_sec++;
+            } else {
+                // Replace the last letter or digit with another of its kind
+                // and restore the modification time:
+                if ( ! (editedText = malloc(length + 1)) ) {
+                    isSame = checkMismatch(&context, "out of memory");
+                    break;
+                }
+                memcpy(editedText, text, length + 1);
+                for ( p = editedText + length; (p > editedText) && ! isalnum((unsigned char)p[-1]); p-- );
+                if ( p == editedText ) break;
+                p--;
+                *p = ( *p == 'z' || *p == 'Z' || *p == '9' ) ? *p - 1 : *p + 1;
+                if ( ! writeBytes(path, editedText, length) ) {
+                    isSame = checkMismatch(&context, "unable to edit the file");
+                    break;
+                }
+                if ( context.configFile[0] ) yamlConfigFileRelease(context.configFile[0]);
+                context.configFile[0] = createSerialLoad(path, editedText, length);
+            }
+            if ( utimensat(AT_FDCWD, path, times, 0) != 0 ) {
+                isSame = checkMismatch(&context, "unable to set the modification time of the file");
+                break;
+            }
+        }
+        context.configFile[1] = yamlConfigFileCreateWithFileAtPath(path, mode->options | yamlConfigFileOptions_doNotCache);
+        newEntryInode = getParseCacheEntryInode(directoryPath, false);
+        if ( ! (isSame = checkContextCompare(&context)) ) {
+            // Already reported
+        } else if ( ! context.configFile[0] ) {
+            // Nothing is written for a file that fails to parse:
+            if ( newEntryInode != entryInode ) isSame = checkMismatch(&context, "parse cache entry written for a file that failed to parse");
+        } else if ( ! newEntryInode ) {
+            isSame = checkMismatch(&context, "no parse cache entry written");
+        } else if ( isHitExpected != (newEntryInode == entryInode) ) {
+            isSame = checkMismatch(&context, isHitExpected ? "parse cache entry rewritten by a hit" : "parse cache entry not rewritten by a miss");
+        }
+        entryInode = newEntryInode;
+        if ( context.configFile[1] ) yamlConfigFileRelease(context.configFile[1]);
+        context.configFile[1] = NULL;
+    }
+    if ( context.configFile[0] ) yamlConfigFileRelease(context.configFile[0]);
+    yamlConfigFileSetParseCacheDirectory(NULL);
+    getParseCacheEntryInode(directoryPath, true);
+    rmdir(directoryPath);
+    free((void*)editedText);
+    return isSame;
+}
+
+#ifdef HAVE_ZLIB
+//
+
+char*
+gzipBytes(
+    const char              *bytes,
+    size_t                  length,
+    size_t                  *outLength
+)
+{
+    z_stream                zStream;
+    char                    *compressed = NULL;
+
+    // A single gzip member holding the bytes:
+    memset(&zStream, 0, sizeof(zStream));
+    if ( deflateInit2(&zStream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 16 + MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK ) return NULL;
+    *outLength = deflateBound(&zStream, length);
+    if ( (compressed = malloc(*outLength)) ) {
+        zStream.next_in = (Bytef*)bytes;
+        zStream.avail_in = length;
+        zStream.next_out = (Bytef*)compressed;
+        zStream.avail_out = *outLength;
+        if ( deflate(&zStream, Z_FINISH) == Z_STREAM_END ) {
+            *outLength = zStream.total_out;
+        } else {
+            free((void*)compressed);
+            compressed = NULL;
+        }
+    }
+    deflateEnd(&zStream);
+    return compressed;
+}
+
+//
+
+yamlErrorCode
+getStreamEndError(
+    const checkMode         *mode,
+    const char              *path
+)
+{
+    yamlConfigFileStreamRef stream = yamlConfigFileStreamCreateWithFileAtPath(path, mode->options);
+    yamlConfigFileRef       document;
+    yamlErrorCode           streamError = 0;
+
+    // Read every document of the stream; how did it end?
+    if ( ! stream ) return yamlConfigFileError_fileNotReadable;
+    while ( (document = yamlConfigFileStreamNextDocument(stream, &streamError)) ) yamlConfigFileRelease(document);
+    yamlConfigFileStreamRelease(stream);
+    return streamError;
+}
+
+//
+
+bool
+checkGzipInput(
+    const checkMode         *mode,
+    const char              *path,
+    const char              *text,
+    size_t                  length
+)
+{
+    static const char       *inputNames[] = { "one member", "two members", "truncated", "trailing junk" };
+    checkContext            context;
+    yamlOptionsBitvec       options = yamlConfigFileOptions_doNotCache | yamlConfigFileOptions_noParseCache;
+    char                    gzipPath[4096];
+    char                    *members[2], *input = NULL;
+    size_t                  memberLengths[2], inputLength = 0;
+    unsigned int            inputIndex;
+    bool                    isSame = true;
+
+    // The text as one gzip member, split between two, truncated and
+    // followed by bytes that are not a gzip member:
+    memset(&context, 0, sizeof(context));
+    snprintf(gzipPath, sizeof(gzipPath), "%s.gz", path);
+    members[0] = gzipBytes(text, length / 2, &memberLengths[0]);
+    members[1] = gzipBytes(text + length / 2, length - length / 2, &memberLengths[1]);
+    if ( ! members[0] || ! members[1] || ! (input = malloc(memberLengths[0] + memberLengths[1] + length + 16)) ) {
+        isSame = checkMismatch(&context, "unable to compress the text");
+        goto cleanup;
+    }
+    context.configFile[0] = createSerialLoad(path, text, length);
+    for ( inputIndex = 0; isSame && (inputIndex < 4); inputIndex++ ) {
+        bool                isDamaged = ( inputIndex >= 2 );
+
+        context.whereLength = snprintf(context.where, sizeof(context.where), "<%s>", inputNames[inputIndex]);
+        if ( inputIndex == 1 ) {
+            memcpy(input, members[0], memberLengths[0]);
+            memcpy(input + memberLengths[0], members[1], memberLengths[1]);
+            inputLength = memberLengths[0] + memberLengths[1];
+        } else {
+            char            *member = gzipBytes(text, length, &inputLength);
+
+            if ( ! member ) {
+                isSame = checkMismatch(&context, "unable to compress the text");
+                break;
+            }
+            memcpy(input, member, inputLength);
+            free((void*)member);
+            if ( inputIndex == 2 ) inputLength /= 2;
+            if ( inputIndex == 3 ) inputLength += snprintf(input + inputLength, 16, "not gzip\n");
+        }
+        if ( ! writeBytes(gzipPath, input, inputLength) ) {
+            isSame = checkMismatch(&context, "unable to write the compressed file");
+            break;
+        }
+
+        // Damaged input may fail the load (libyaml may be done with the
+        // first document before reaching the damage) but must fail the
+        // stream:
+        context.configFile[1] = yamlConfigFileCreateWithFileAtPath(gzipPath, mode->options | options);
+        if ( ! isDamaged || context.configFile[1] ) isSame = checkContextCompare(&context);
+        if ( context.configFile[1] ) yamlConfigFileRelease(context.configFile[1]);
+        context.configFile[1] = NULL;
+        if ( isSame && isDamaged ) {
+            if ( ! getStreamEndError(mode, gzipPath) ) isSame = checkMismatch(&context, "stream of damaged input ended cleanly");
+        } else if ( isSame ) {
+            isSame = checkStream(mode, gzipPath, text, length);
+        }
+
+        // The other ways in are only checked with the single member:
+        if ( isSame && (inputIndex == 0) ) {
+            context.configFile[1] = yamlConfigFileCreateWithInputString(input, inputLength, mode->options | options);
+            isSame = checkContextCompare(&context);
+            if ( context.configFile[1] ) yamlConfigFileRelease(context.configFile[1]);
+            context.configFile[1] = NULL;
+            if ( isSame ) isSame = checkRecords(mode, gzipPath, text, length);
+        }
+    }
+    if ( context.configFile[0] ) yamlConfigFileRelease(context.configFile[0]);
+
+cleanup:
+    free((void*)members[0]);
+    free((void*)members[1]);
+    free((void*)input);
+    unlink(gzipPath);
+    return isSame;
+}
+#endif
+
+//
+
+static const checkMode      checkModes[] = {
+                                { "parallel", yamlConfigFileOptions_parallelLoad, true, false, false, true, checkLoad },
+                                { "fast", yamlConfigFileOptions_fastParse, false, true, false, false, checkLoad },
+                                { "json", yamlConfigFileOptions_jsonInput, false, true, true, false, checkLoad },
+                                { "stream", yamlConfigFileOptions_mapInputFile, true, true, false, false, checkStream },
+                                { "lazy", yamlConfigFileOptions_lazySubtrees, true, false, false, false, checkLazyLoad },
+                                { "filter", 0, true, false, false, false, checkFilteredLoad },
+                                { "records", yamlConfigFileOptions_mapInputFile, true, true, false, false, checkRecords },
+                                { "batch", 0, true, false, false, false, checkBatchLoad },
+                                { "async", 0, true, false, false, false, checkAsyncLoad },
+                                { "push", 0, true, true, false, false, checkPushParser },
+                                { "incremental", yamlConfigFileOptions_mapInputFile, true, true, false, false, checkIncrementalLoad },
+                                { "snapshot", 0, true, false, false, false, checkSnapshot },
+                                { "parsecache", 0, true, false, false, false, checkParseCache },
+#ifdef HAVE_ZLIB
+                                { "gzip", yamlConfigFileOptions_mapInputFile, true, false, false, false, checkGzipInput },
+#endif
+                                { NULL, 0, false, false, false, false, NULL }
+                            };
+
+//
+
+int
+main(
+    int                     argc,
+    const char*             argv[]
+)
+{
+    const checkMode         *mode = &checkModes[0];
+    size_t                  repeatSizeInMB = 4;
+    unsigned int            fuzzCount = 0;
+    uint64_t                seed = 1;
+    char                    path[] = "load_differential_check.XXXXXX";
+    int                     argi = 1, fd;
+    unsigned int            checkCount = 0, mismatchCount = 0;
+
+    while ( (argi < argc) && (argv[argi][0] == '-') ) {
+        if ( (strcmp(argv[argi], "-m") == 0) && (argi + 1 < argc) ) {
+            for ( mode = &checkModes[0]; mode->name && strcmp(mode->name, argv[argi + 1]); mode++ );
+            if ( ! mode->name ) {
+                fprintf(stderr, "ERROR:  unknown mode %s\n", argv[argi + 1]);
+                return EINVAL;
+            }
+            argi += 2;
+        } else if ( (strcmp(argv[argi], "-r") == 0) && (argi + 1 < argc) ) {
+            repeatSizeInMB = strtoul(argv[argi + 1], NULL, 0);
+            argi += 2;
+        } else if ( (strcmp(argv[argi], "-z") == 0) && (argi + 1 < argc) ) {
+            fuzzCount = strtoul(argv[argi + 1], NULL, 0);
+            argi += 2;
+        } else if ( (strcmp(argv[argi], "-s") == 0) && (argi + 1 < argc) ) {
+            if ( (seed = strtoull(argv[argi + 1], NULL, 0)) == 0 ) seed = 1;
+            argi += 2;
+        } else {
+            fprintf(stderr, "ERROR:  unknown option %s\n", argv[argi]);
+            return EINVAL;
+        }
+    }
+    if ( argi >= argc ) {
+        fprintf(stderr, "usage:  %s {-m <mode>} {-r <size-in-MB>} {-z <count> {-s <seed>}} <fixture> {<fixture> ..}\n", argv[0]);
+        return EINVAL;
+    }
+
+    yamlConfigFileSetParallelLoadThreadCount(4);
+    if ( (fd = mkstemp(path)) < 0 ) {
+        fprintf(stderr, "ERROR:  unable to create a temporary file\n");
+        return EIO;
+    }
+    close(fd);
+
+    for ( ; argi < argc; argi++ ) {
+        size_t              length;
+        char                *text = readFixture(argv[argi], &length);
+        int                 variant;
+
+        if ( ! text ) {
+            fprintf(stderr, "ERROR:  unable to read %s\n", argv[argi]);
+            mismatchCount++;
+            continue;
+        }
+        printf("%s (%s):\n", argv[argi], mode->name);
+        for ( variant = 0; variant < (mode->shouldRepeat ? 4 : 2); variant++ ) {
+            bool            useCRLF = ( variant & 1 );
+            size_t          targetSize = ( variant & 2 ) ? repeatSizeInMB * 1024 * 1024 : 0;
+
+            char            *variantText;
+            size_t          variantLength;
+
+            printf("  %s, %s\n", useCRLF ? "CRLF" : "LF", targetSize ? "repeated" : "as-is");
+            checkCount++;
+            if ( ! writeFixture(path, text, length, targetSize, useCRLF) || ! (variantText = readFixture(path, &variantLength)) ) {
+                fprintf(stderr, "ERROR:  unable to write %s\n", path);
+                mismatchCount++;
+                continue;
+            }
+            if ( ! mode->check(mode, path, variantText, variantLength) ) mismatchCount++;
+            if ( mode->canFuzz && fuzzCount && ! targetSize ) {
+                size_t      mutatedCapacity = 2 * variantLength + 16;
+                char        *mutated = malloc(mutatedCapacity);
+                unsigned int    fuzzIndex, fuzzMismatchCount = 0;
+
+                for ( fuzzIndex = 0; mutated && (fuzzIndex < fuzzCount); fuzzIndex++ ) {
+                    size_t  mutatedLength = mutateText(variantText, variantLength, mutated, mutatedCapacity, &seed);
+
+                    checkCount++;
+                    if ( ! mode->check(mode, NULL, mutated, mutatedLength) ) {
+                        printInput(mutated, mutatedLength);
+                        fuzzMismatchCount++;
+                    }
+                }
+                printf("  %s, %u mutations, %u mismatches\n", useCRLF ? "CRLF" : "LF", fuzzCount, fuzzMismatchCount);
+                mismatchCount += fuzzMismatchCount;
+                free((void*)mutated);
+            }
+            free((void*)variantText);
+        }
+        free((void*)text);
+    }
+    unlink(path);
+    printf("%u checks, %u mismatches\n", checkCount, mismatchCount);
+    return ( mismatchCount ? 1 : 0 );
+}
@@ -0,0 +1,152 @@
+#include "yamlScalar.h"
+#include <time.h>
+
+//
+// Compare the throughput of the yamlScalarStringTo*() parsers against
+// the previous approach of copying each scalar into a NUL-terminated
+// buffer and calling strtod()/strtoll(), and confirm both produce
+// identical results.
+//
+// usage:  scalar_parse_benchmark {<value-count> {<repeat-count>}}
+//
+
+double
+now()
+{
+    struct timespec         t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (double)t.tv_sec + 1e-9 * (double)t.tv_nsec;
+}
+
+//
+
+typedef struct {
+    char                    *text;
+    size_t                  length;
+} scalarText;
+
+//
+
+scalarText*
+generateScalars(
+    unsigned int            count,
+    bool                    isInteger
+)
+{
+    scalarText              *scalars = malloc(count * sizeof(scalarText));
+    uint64_t                state = 0x2545F4914F6CDD1DULL;
+    unsigned int            i;
+
+    for ( i = 0; i < count; i++ ) {
+        char                buffer[64];
+        uint64_t            r;
+
+        state ^= state << 13; state ^= state >> 7; state ^= state << 17;
+        r = state;
+        if ( isInteger ) {
+            snprintf(buffer, sizeof(buffer), "%lld", (long long int)(r % 2000000001ULL) - 1000000000LL);
+        } else {
+            double          v = (double)(r >> 11) / (double)(1ULL << 53) * 1000.0 - 500.0;
+
+            switch ( i % 4 ) {
+                case 0: snprintf(buffer, sizeof(buffer), "%.9e", v * 1e-3); break;
+                case 1: snprintf(buffer, sizeof(buffer), "%.17g", v); break;
+                case 2: snprintf(buffer, sizeof(buffer), "%.4f", v); break;
+                case 3: snprintf(buffer, sizeof(buffer), "%.6g", v * 1e12); break;
+            }
+        }
+        scalars[i].length = strlen(buffer);
+        scalars[i].text = strdup(buffer);
+    }
+    return scalars;
+}
+
+//
+
+bool
+strtodCopyPath(
+    const scalarText        *scalar,
+    double                  *outValue
+)
+{
+    char                    buffer[48];
+    char                    *endPtr;
+
+    if ( scalar->length >= sizeof(buffer) ) return false;
+    memcpy(buffer, scalar->text, scalar->length);
+    buffer[scalar->length] = '\0';
+    *outValue = strtod(buffer, &endPtr);
+    return ( endPtr > buffer ) && ! *endPtr;
+}
+
+//
+
+bool
+strtollCopyPath(
+    const scalarText        *scalar,
+    long long int           *outValue
+)
+{
+    char                    buffer[48];
+    char                    *endPtr;
+
+    if ( scalar->length >= sizeof(buffer) ) return false;
+    memcpy(buffer, scalar->text, scalar->length);
+    buffer[scalar->length] = '\0';
+    *outValue = strtoll(buffer, &endPtr, 0);
+    return ( endPtr > buffer ) && ! *endPtr;
+}
+
+//
+
+int
+main(
+    int                     argc,
+    const char*             argv[]
+)
+{
+    unsigned int            count = 1000000, repeatCount = 5, i, r, mismatches = 0;
+    scalarText              *reals, *integers;
+    double                  t0, tStrtod, tReal, tStrtoll, tInteger, sum = 0.0;
+    long long int           isum = 0;
+
+    if ( argc > 1 ) count = strtoul(argv[1], NULL, 0);
+    if ( argc > 2 ) repeatCount = strtoul(argv[2], NULL, 0);
+    if ( count == 0 ) count = 1;
+    if ( repeatCount == 0 ) repeatCount = 1;
+
+    reals = generateScalars(count, false);
+    integers = generateScalars(count, true);
+
+    // Confirm identical results:
+    for ( i = 0; i < count; i++ ) {
+        double              d1 = 0.0, d2 = 1.0;
+        long long int       l1 = 0, l2 = 1;
+
+        if ( ! strtodCopyPath(&reals[i], &d1) || ! yamlScalarStringToDouble(reals[i].text, reals[i].length, &d2) || memcmp(&d1, &d2, sizeof(double)) ) mismatches++;
+        if ( ! strtollCopyPath(&integers[i], &l1) || ! yamlScalarStringToSignedInt(integers[i].text, integers[i].length, &l2) || (l1 != l2) ) mismatches++;
+    }
+
+    t0 = now();
+    for ( r = 0; r < repeatCount; r++ ) for ( i = 0; i < count; i++ ) { double d; if ( strtodCopyPath(&reals[i], &d) ) sum += d; }
+    tStrtod = now() - t0;
+    t0 = now();
+    for ( r = 0; r < repeatCount; r++ ) for ( i = 0; i < count; i++ ) { double d; if ( yamlScalarStringToDouble(reals[i].text, reals[i].length, &d) ) sum += d; }
+    tReal = now() - t0;
+    t0 = now();
+    for ( r = 0; r < repeatCount; r++ ) for ( i = 0; i < count; i++ ) { long long int l; if ( strtollCopyPath(&integers[i], &l) ) isum += l; }
+    tStrtoll = now() - t0;
+    t0 = now();
+    for ( r = 0; r < repeatCount; r++ ) for ( i = 0; i < count; i++ ) { long long int l; if ( yamlScalarStringToSignedInt(integers[i].text, integers[i].length, &l) ) isum += l; }
+    tInteger = now() - t0;
+
+    printf("%-32s %12s\n", "parser", "Mvalues/s");
+    printf("%-32s %12.2f\n", "copy + strtod", 1e-6 * count * repeatCount / tStrtod);
+    printf("%-32s %12.2f\n", "yamlScalarStringToDouble", 1e-6 * count * repeatCount / tReal);
+    printf("%-32s %12.2f\n", "copy + strtoll", 1e-6 * count * repeatCount / tStrtoll);
+    printf("%-32s %12.2f\n", "yamlScalarStringToSignedInt", 1e-6 * count * repeatCount / tInteger);
+    printf("double speedup: %.2fx, integer speedup: %.2fx\n", tStrtod / tReal, tStrtoll / tInteger);
+    printf("mismatched results: %u (checksums %g %lld)\n", mismatches, sum, isum);
+    return ( mismatches ? 1 : 0 );
+}
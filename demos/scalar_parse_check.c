@@ -0,0 +1,294 @@
+#ifndef _GNU_SOURCE
+# define _GNU_SOURCE    /* strtod_l() et al. on glibc */
+#endif
+
+#include "yamlScalar.h"
+#include <unistd.h>
+#include <errno.h>
+#include <math.h>
+#include <locale.h>
+#ifdef HAVE_XLOCALE_H
+# include <xlocale.h>
+#endif
+
+//
+// Correctness check of the yamlScalarStringTo*() number parsers.  Real
+// values must be rounded exactly as the C library's strtod_l() and
+// strtof_l() (in the "C" locale) round the same text with its underscores
+// removed:  a fixed list of hard cases (halfway points, the limits of the
+// exact fast paths, subnormals, overflow) is checked along with randomly
+// generated decimal strings of every length and exponent, some with digit
+// separators.  Underscores must only be accepted between two digits.
+//
+// usage:  scalar_parse_check {-n <random-count>} {-s <seed>}
+//
+// The exit status is non-zero if any check failed.
+//
+
+static const char           *roundingCases[] = {
+                                "0", "-0", "0.0", "0e999", "1", "-1", "0.1", "0.2", "0.3",
+                                "1e22", "1e23", "9007199254740992", "9007199254740993", "9007199254740994",
+                                "9007199254740995", "18014398509481985", "1e-22", "1e-23",
+                                "123456789012345678", "1234567890123456789", "12345678901234567890123",
+                                "2.2250738585072011e-308", "2.2250738585072014e-308", "4.9406564584124654e-324",
+                                "2.4703282292062327e-324", "2.4703282292062328e-324", "1e-400",
+                                "1.7976931348623157e308", "1.7976931348623158e308", "1.7976931348623159e308", "1e309",
+                                "7.038531e-26", "8.589973e9", "16777216", "16777217", "16777219", "3.4028235e38",
+                                "3.4028236e38", "1.17549435e-38", "1.4e-45", "7e-46", "1e10", "1e11", "1.00000005960464477539",
+                                "0.500000000000000166533453693773481063544750213623046875",
+                                "0.5000000000000001665334536937734810635447502136230468749",
+                                "1_000_000.000_001", "3.141_592_653_589_793_238_462_643", "0x1p-1074", "0x1.fffffffffffffp1023",
+                                "0x1_8p3", "0x10", ".5", "5.", "+.5e1", "1e+0", "1E-0",
+                                NULL
+                            };
+
+static const char           *rejectedCases[] = {
+                                "_1", "1_", "1__0", "_", "1_.5", "1._5", "1.5_", "1_e5", "1e_5", "1e5_", "1e1_0",
+                                "0x_", "0x_1", "0x1_", "0x1__2", "0o_7", "0b_1", "0b1_", "0x_1p3", "0x1p_3", "0x1p1_0",
+                                "-_1", "+1_", "1 _0", ".", "e5", "1e", "0x", "--1",
+                                NULL
+                            };
+
+static const char           *integerCases[] = {
+                                "1_000", "0x1_F", "0o7_7", "0b1_0_1", "-9_223_372_036_854_775_808", "010", "0_10",
+                                NULL
+                            };
+
+//
+
+#ifdef HAVE_STRTOD_L
+static locale_t             cLocale = (locale_t)0;
+#endif
+
+bool
+referenceParse(
+    const char              *text,
+    double                  *outDouble,
+    float                   *outFloat
+)
+{
+    char                    buffer[512];
+    char                    *p = buffer, *endPtr;
+    bool                    isDoubleOkay, isFloatOkay;
+
+    while ( *text && (p < buffer + sizeof(buffer) - 1) ) {
+        if ( *text != '_' ) *p++ = *text;
+        text++;
+    }
+    *p = '\0';
+#ifdef HAVE_STRTOD_L
+    *outDouble = strtod_l(buffer, &endPtr, cLocale);
+    isDoubleOkay = ( (endPtr > buffer) && ! *endPtr );
+    *outFloat = strtof_l(buffer, &endPtr, cLocale);
+    isFloatOkay = ( (endPtr > buffer) && ! *endPtr );
+#else
+    // The program never calls setlocale(), so it runs in the "C" locale:
+    *outDouble = strtod(buffer, &endPtr);
+    isDoubleOkay = ( (endPtr > buffer) && ! *endPtr );
+    *outFloat = strtof(buffer, &endPtr);
+    isFloatOkay = ( (endPtr > buffer) && ! *endPtr );
+#endif
+    return isDoubleOkay && isFloatOkay;
+}
+
+//
+
+bool
+isSameDouble(
+    double                  d1,
+    double                  d2
+)
+{
+    if ( isnan(d1) || isnan(d2) ) return ( isnan(d1) && isnan(d2) );
+    return ( memcmp(&d1, &d2, sizeof(double)) == 0 );
+}
+
+//
+
+bool
+isSameFloat(
+    float                   f1,
+    float                   f2
+)
+{
+    if ( isnan(f1) || isnan(f2) ) return ( isnan(f1) && isnan(f2) );
+    return ( memcmp(&f1, &f2, sizeof(float)) == 0 );
+}
+
+//
+
+bool
+checkRounding(
+    const char              *text
+)
+{
+    double                  expectedDouble, actualDouble;
+    float                   expectedFloat, actualFloat;
+    bool                    isOkay = true;
+
+    if ( ! referenceParse(text, &expectedDouble, &expectedFloat) ) {
+        printf("    SKIPPED \"%s\":  not accepted by the C library\n", text);
+        return true;
+    }
+    if ( ! yamlScalarStringToDouble(text, yamlCStringFullLength, &actualDouble) ) {
+        printf("    FAILED \"%s\":  rejected as double\n", text);
+        isOkay = false;
+    } else if ( ! isSameDouble(actualDouble, expectedDouble) ) {
+        printf("    FAILED \"%s\":  double %.17g, expected %.17g\n", text, actualDouble, expectedDouble);
+        isOkay = false;
+    }
+    if ( ! yamlScalarStringToFloat(text, yamlCStringFullLength, &actualFloat) ) {
+        printf("    FAILED \"%s\":  rejected as float\n", text);
+        isOkay = false;
+    } else if ( ! isSameFloat(actualFloat, expectedFloat) ) {
+        printf("    FAILED \"%s\":  float %.9g, expected %.9g\n", text, (double)actualFloat, (double)expectedFloat);
+        isOkay = false;
+    }
+    return isOkay;
+}
+
+//
+
+bool
+checkRejected(
+    const char              *text
+)
+{
+    double                  d;
+    float                   f;
+    long long int           i;
+    unsigned long long int  u;
+    bool                    isOkay = true;
+
+    if ( yamlScalarStringToDouble(text, yamlCStringFullLength, &d) ) {
+        printf("    FAILED \"%s\":  accepted as double %.17g\n", text, d);
+        isOkay = false;
+    }
+    if ( yamlScalarStringToFloat(text, yamlCStringFullLength, &f) ) {
+        printf("    FAILED \"%s\":  accepted as float %.9g\n", text, (double)f);
+        isOkay = false;
+    }
+    if ( yamlScalarStringToSignedInt(text, yamlCStringFullLength, &i) ) {
+        printf("    FAILED \"%s\":  accepted as signed integer %lld\n", text, i);
+        isOkay = false;
+    }
+    if ( yamlScalarStringToUnsignedInt(text, yamlCStringFullLength, &u) ) {
+        printf("    FAILED \"%s\":  accepted as unsigned integer %llu\n", text, u);
+        isOkay = false;
+    }
+    return isOkay;
+}
+
+//
+
+bool
+checkInteger(
+    const char              *text
+)
+{
+    long long int           i;
+
+    if ( ! yamlScalarStringToSignedInt(text, yamlCStringFullLength, &i) ) {
+        printf("    FAILED \"%s\":  rejected as signed integer\n", text);
+        return false;
+    }
+    return true;
+}
+
+//
+
+uint64_t
+nextRandom(
+    uint64_t                *state
+)
+{
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+//
+
+void
+randomDecimal(
+    char                    *buffer,
+    size_t                  capacity,
+    uint64_t                *state
+)
+{
+    char                    *p = buffer, *end = buffer + capacity - 16;
+    unsigned int            digitCount = 1 + nextRandom(state) % 40;
+    unsigned int            pointAt = nextRandom(state) % (digitCount + 1);
+    unsigned int            i;
+    bool                    hasSeparators = ( nextRandom(state) % 4 == 0 );
+
+    if ( nextRandom(state) % 2 ) *p++ = '-';
+    for ( i = 0; (i < digitCount) && (p < end); i++ ) {
+        if ( i == pointAt ) *p++ = '.';
+        else if ( hasSeparators && i && (nextRandom(state) % 3 == 0) ) *p++ = '_';
+
+        // Runs of zeroes and nines reach the halfway and carry cases:
+        switch ( nextRandom(state) % 8 ) {
+            case 0: *p++ = '0'; break;
+            case 1: *p++ = '9'; break;
+            default: *p++ = '0' + nextRandom(state) % 10; break;
+        }
+    }
+    if ( pointAt == digitCount ) *p++ = '.';
+    if ( nextRandom(state) % 4 ) p += snprintf(p, 16, "e%d", (int)(nextRandom(state) % 700) - 350);
+    *p = '\0';
+}
+
+//
+
+int
+main(
+    int                     argc,
+    char                    **argv
+)
+{
+    unsigned long           randomCount = 1000000, failureCount = 0, checkCount = 0, i;
+    uint64_t                state = 0x9E3779B97F4A7C15ULL;
+    int                     opt;
+
+    while ( (opt = getopt(argc, argv, "n:s:")) != -1 ) {
+        switch ( opt ) {
+            case 'n':
+                randomCount = strtoul(optarg, NULL, 0);
+                break;
+            case 's':
+                state = strtoull(optarg, NULL, 0);
+                if ( ! state ) state = 1;
+                break;
+            default:
+                fprintf(stderr, "usage:  %s {-n <random-count>} {-s <seed>}\n", argv[0]);
+                return EINVAL;
+        }
+    }
+#ifdef HAVE_STRTOD_L
+    if ( ! (cLocale = newlocale(LC_ALL_MASK, "C", (locale_t)0)) ) {
+        fprintf(stderr, "ERROR:  unable to create the C locale\n");
+        return ENOMEM;
+    }
+#endif
+
+    printf("fixed rounding cases\n");
+    for ( i = 0; roundingCases[i]; i++, checkCount++ ) if ( ! checkRounding(roundingCases[i]) ) failureCount++;
+    printf("rejected cases\n");
+    for ( i = 0; rejectedCases[i]; i++, checkCount++ ) if ( ! checkRejected(rejectedCases[i]) ) failureCount++;
+    printf("integer cases\n");
+    for ( i = 0; integerCases[i]; i++, checkCount++ ) if ( ! checkInteger(integerCases[i]) ) failureCount++;
+    printf("%lu random decimal strings\n", randomCount);
+    for ( i = 0; i < randomCount; i++, checkCount++ ) {
+        char                buffer[128];
+
+        randomDecimal(buffer, sizeof(buffer), &state);
+        if ( ! checkRounding(buffer) ) failureCount++;
+    }
+    printf("%lu checks, %lu failures\n", checkCount, failureCount);
+#ifdef HAVE_STRTOD_L
+    freelocale(cLocale);
+#endif
+    return ( failureCount ? 1 : 0 );
+}
@@ -11,11 +11,15 @@
 #define __YAMLCONFIGFILE_H__
 
 #include "yamlBaseTypes.h"
+#include "yamlScalar.h"
 #include "yamlKeyPath.h"
 
 /*!
     @enum yamlConfigFileError
-    Error codes associated with the yamlConfigFile API.
+    Error codes associated with the yamlConfigFile API.  The
+    yamlConfigFileError_invalidState code indicates an object was used in a
+    way its current state does not allow (e.g. feeding a push parser that
+    has been finished).
 */
 enum {
     yamlConfigFileError_min = 200,
@@ -25,6 +29,15 @@ enum {
     yamlConfigFileError_internalError,
     yamlConfigFileError_numberOutOfRange,
     yamlConfigFileError_invalidSequenceIndex,
+    yamlConfigFileError_parseFailed,
+    yamlConfigFileError_invalidDocumentIndex,
+    yamlConfigFileError_fileNotReadable,
+    yamlConfigFileError_loadCancelled,
+    yamlConfigFileError_loadDeadlineExpired,
+    yamlConfigFileError_loadNotComplete,
+    yamlConfigFileError_invalidSnapshot,
+    yamlConfigFileError_fileNotWritable,
+    yamlConfigFileError_invalidState,
     yamlConfigFileError_max
 };
 
@@ -70,6 +83,59 @@ typedef struct __yamlConfigFile * yamlConfigFileRef;
     @constant yamlConfigFileOptions_noKeyPathCache
         Do not use a yamlKeyPath cache to accelerate path-to-node
         resolution
+    @constant yamlConfigFileOptions_mapInputFile
+        When creating a new object by filename, memory-map the file (or
+        read() it in its entirety if it cannot be mapped, e.g. a pipe)
+        and parse it in-place rather than through a stdio stream
+    @constant yamlConfigFileOptions_indexDocuments
+        When creating a new object by filename, read the file as with
+        yamlConfigFileOptions_mapInputFile, record the byte offset of every
+        document in the (multi-document) stream, and retain the file content
+        so that yamlConfigFileGetDocumentAtIndex() can parse any document
+        on demand
+    @constant yamlConfigFileOptions_lazySubtrees
+        When creating a new object by filename, read the file as with
+        yamlConfigFileOptions_mapInputFile and, if the document is a block
+        mapping with plain top-level keys, defer parsing of each large
+        top-level value until a key path first descends into it; until then,
+        the value appears as a null scalar to code that walks the document
+        directly rather than by key path
+    @constant yamlConfigFileOptions_parallelLoad
+        When creating a new object by filename or from an input string, and
+        the document is a large block mapping with plain top-level keys,
+        split it between top-level entries and parse the pieces on multiple
+        threads (see yamlConfigFileSetParallelLoadThreadCount()); documents
+        that cannot be split safely are parsed serially.  Implies
+        yamlConfigFileOptions_mapInputFile when creating by filename
+    @constant yamlConfigFileOptions_fastParse
+        When creating a new object by filename or from an input string,
+        first attempt the document with a native parser that handles only
+        the common configuration subset of YAML (block mappings and
+        sequences, single-line plain and quoted scalars without escapes,
+        single-line flow sequences of scalars, comments) but does so much
+        faster than libyaml, producing an identical document; anything
+        outside that subset is parsed by libyaml as usual.  Implies
+        yamlConfigFileOptions_mapInputFile when creating by filename
+    @constant yamlConfigFileOptions_jsonInput
+        When creating a new object by filename or from an input string, and
+        the first character other than whitespace opens a JSON object or
+        array, parse the text with a native JSON parser rather than
+        libyaml's YAML scanner; the document is identical to the one libyaml
+        produces (flow-style collections, double-quoted strings, plain
+        numbers and literals), so key paths and scalar coercions behave
+        the same.  Text that turns out not to be JSON (e.g. a YAML flow
+        collection) is parsed by libyaml as usual.  Implies
+        yamlConfigFileOptions_mapInputFile when creating by filename
+    @constant yamlConfigFileOptions_noParseCache
+        When creating a new object by filename, neither consult nor update
+        the on-disk parse cache (see yamlConfigFileSetParseCacheDirectory())
+    @constant yamlConfigFileOptions_internKeyPaths
+        The *AtPathString() getters and coercion functions obtain compiled
+        key paths from the process-wide key path intern table (see
+        yamlKeyPathCreateWithStringInterned()) rather than compiling them
+        on every call.  The intern table and the key paths it shares are not
+        thread-safe, so only set this option when every object carrying it
+        is read by one thread at a time
 */
 enum {
     yamlConfigFileOptions_none = 0,
@@ -77,6 +143,14 @@ enum {
     yamlConfigFileOptions_caseFoldFilename = 1 << 1,
     yamlConfigFileOptions_doNotCache = 1 << 2,
     yamlConfigFileOptions_noKeyPathCache = 1 << 3,
+    yamlConfigFileOptions_mapInputFile = 1 << 4,
+    yamlConfigFileOptions_indexDocuments = 1 << 5,
+    yamlConfigFileOptions_lazySubtrees = 1 << 6,
+    yamlConfigFileOptions_parallelLoad = 1 << 7,
+    yamlConfigFileOptions_fastParse = 1 << 8,
+    yamlConfigFileOptions_jsonInput = 1 << 9,
+    yamlConfigFileOptions_noParseCache = 1 << 10,
+    yamlConfigFileOptions_internKeyPaths = 1 << 11,
     //
     yamlConfigFileOptions_keyPathOptionShift = 16,
     yamlConfigFileOptions_oneBasedIndices = 1 << yamlConfigFileOptions_keyPathOptionShift,
@@ -96,6 +170,9 @@ enum {
     Create a new YAML file wrapper using the contents of an in-memory string
     buffer.  Since no filename is present in this form, the resulting
     yamlConfigFile has an implied yamlConfigFileOptions_doNotCache option.
+
+    A compressed inputString is decompressed as it is parsed (see
+    yamlConfigFileCreateWithFileAtPath()).
  
     @param inputString
         Character array containing the YAML document to be parsed
@@ -118,6 +195,10 @@ yamlConfigFileCreateWithInputString(
     Create a new YAML file wrapper using an open file stream.  Since no
     filename is present in this form, the resulting yamlConfigFile has an
     implied yamlConfigFileOptions_doNotCache option.
+
+    A compressed stream is decompressed as it is read (see
+    yamlConfigFileCreateWithFileAtPath()); pipes are fine, since the
+    stream is never rewound.
  
     @param sourceFilePtr
         File stream containing the YAML document to be read
@@ -137,6 +218,18 @@ yamlConfigFileCreateWithFilePointer(
     Create a new YAML file wrapper using an open file stream.  Since no
     filename is present in this form, the resulting yamlConfigFile has an
     implied yamlConfigFileOptions_doNotCache option.
+
+    A file compressed with gzip (when the library is built with zlib) or
+    zstd (when built with libzstd) is recognized by its leading magic bytes,
+    whatever its filename, and decompressed in fixed-size chunks as libyaml
+    parses it, so the decompressed text is never held in memory in full.
+    Concatenated gzip members or zstd frames are read in turn.  The native
+    fast-path, JSON and parallel parsers, yamlConfigFileOptions_lazySubtrees
+    and yamlConfigFileOptions_indexDocuments do not apply to compressed
+    input:  the document is parsed by libyaml in one pass (and only its
+    first document is loaded).  Streams, record iterators, asynchronous and
+    incremental loads decompress their input the same way; the push parser
+    does not, since the caller supplies its input.
  
     @param sourceFilePtr
         File stream containing the YAML document to be read
@@ -151,6 +244,298 @@ yamlConfigFileCreateWithFileAtPath(
     yamlOptionsBitvec   options
 );
 
+/*!
+    @typedef yamlConfigFileFilter
+    Selects the parts of a document that a filtered create function
+    composes.  A node is kept if its key path lies on or under one of the
+    include paths (or if there are no include paths) and not on or under
+    any of the exclude paths; everything else is discarded as the parser
+    streams past it, so peak memory and load time scale with the part of
+    the document that is kept.
+
+    Mappings and sequences on the way to a kept node are present with
+    only their kept children; unselected items of such a sequence appear
+    as null scalars so that the indices of the kept items are unchanged.
+    Anchored nodes are composed in their entirety wherever an alias refers
+    to them.  Mapping keys are compared using the key-path options in the
+    create function's options argument.  An empty include path selects the
+    whole document; an empty exclude path is ignored.
+
+    @field includePaths
+        Array of includePathCount key paths
+    @field includePathCount
+        Number of key paths in includePaths
+    @field excludePaths
+        Array of excludePathCount key paths
+    @field excludePathCount
+        Number of key paths in excludePaths
+*/
+typedef struct {
+    yamlKeyPathRef      *includePaths;
+    unsigned int        includePathCount;
+    yamlKeyPathRef      *excludePaths;
+    unsigned int        excludePathCount;
+} yamlConfigFileFilter;
+
+/*!
+    @function yamlConfigFileCreateWithInputStringAndFilter
+    Variant of yamlConfigFileCreateWithInputString() that composes only the
+    parts of the document selected by aFilter.  Passing NULL (or a filter
+    with no key paths) is equivalent to yamlConfigFileCreateWithInputString().
+ 
+    @return A newly-initialized yamlConfigFile, or NULL on error
+*/
+yamlConfigFileRef
+yamlConfigFileCreateWithInputStringAndFilter(
+    const char                  *inputString,
+    size_t                      inputStringLength,
+    yamlOptionsBitvec           options,
+    const yamlConfigFileFilter  *aFilter
+);
+
+/*!
+    @function yamlConfigFileCreateWithFilePointerAndFilter
+    Variant of yamlConfigFileCreateWithFilePointer() that composes only the
+    parts of the document selected by aFilter.
+ 
+    @return A newly-initialized yamlConfigFile, or NULL on error
+*/
+yamlConfigFileRef
+yamlConfigFileCreateWithFilePointerAndFilter(
+    FILE                        *sourceFilePtr,
+    yamlOptionsBitvec           options,
+    const yamlConfigFileFilter  *aFilter
+);
+
+/*!
+    @function yamlConfigFileCreateWithFileAtPathAndFilter
+    Variant of yamlConfigFileCreateWithFileAtPath() that composes only the
+    parts of the document selected by aFilter.
+
+    A filtered document is never added to the cache, but a cached copy of
+    the whole file is returned (unless yamlConfigFileOptions_ignoreCachedCopy
+    is present) since it satisfies any filter.  The
+    yamlConfigFileOptions_lazySubtrees option is ignored when a filter is
+    present.  With yamlConfigFileOptions_indexDocuments, only the first
+    document is filtered; those returned by yamlConfigFileGetDocumentAtIndex()
+    are complete.
+ 
+    @return A newly-initialized yamlConfigFile, or NULL on error
+*/
+yamlConfigFileRef
+yamlConfigFileCreateWithFileAtPathAndFilter(
+    const char                  *sourceFilePath,
+    yamlOptionsBitvec           options,
+    const yamlConfigFileFilter  *aFilter
+);
+
+/*!
+    @function yamlConfigFileCreateWithSnapshotAtPath
+    Create a new YAML file wrapper from a snapshot file written by
+    yamlConfigFileWriteSnapshotToPath().  The snapshot is memory-mapped and
+    only its header is examined, so the cost of the load does not depend on
+    the size of the document:  nodes are filled-in from the mapped file as
+    key paths reach them, and keys in larger mappings are found via the
+    perfect hashes stored in the snapshot (for lookups with or without
+    yamlConfigFileOptions_caseFoldKeys, unless two keys of a mapping differ
+    only in case, in which case only case-sensitive lookups use the hash).
+    Key path resolution and coercion behave exactly as they do for the
+    document the snapshot was written from, but the nodes carry no source
+    marks.
+
+    Snapshots are specific to the byte order of the host that wrote them and
+    to the snapshot format version; any other snapshot (or a file that is
+    not a snapshot) is refused with yamlConfigFileError_invalidSnapshot.
+
+    The snapshotPath is used for the cache exactly as the sourceFilePath of
+    yamlConfigFileCreateWithFileAtPath() is.  Option bits that select how a
+    YAML file is read and parsed have no effect.
+
+    @param snapshotPath
+        Filesystem path to the snapshot file
+    @param options
+        Optional behaviors from the yamlConfigFileOptions enumeration
+    @param outError
+        If not NULL, set to zero on success or to the error that occurred
+        (e.g. yamlConfigFileError_fileNotReadable or
+        yamlConfigFileError_invalidSnapshot)
+
+    @return A newly-initialized yamlConfigFile, or NULL on error
+*/
+yamlConfigFileRef
+yamlConfigFileCreateWithSnapshotAtPath(
+    const char          *snapshotPath,
+    yamlOptionsBitvec   options,
+    yamlErrorCode       *outError
+);
+
+/*!
+    @function yamlConfigFileWriteSnapshotToPath
+    Compile the document wrapped by aConfigFile to a snapshot file that
+    yamlConfigFileCreateWithSnapshotAtPath() can load without parsing.  The
+    snapshot is written to a temporary file in the same directory and then
+    renamed to snapshotPath, so a concurrent reader sees either the old file
+    or the complete new one.
+
+    Only the document wrapped by aConfigFile is written:  for a filtered
+    load that is the filtered document, and for a multi-document stream
+    that is the first document.  The deferred subtrees of a
+    yamlConfigFileOptions_lazySubtrees file are parsed so that the whole
+    document is written.
+
+    @param aConfigFile
+        The yamlConfigFile to write
+    @param snapshotPath
+        Filesystem path to which the snapshot is written
+    @param outError
+        If not NULL, set to zero on success or to the error that occurred
+        (e.g. yamlConfigFileError_fileNotWritable)
+
+    @return Boolean true if the snapshot was written
+*/
+bool
+yamlConfigFileWriteSnapshotToPath(
+    yamlConfigFileRef   aConfigFile,
+    const char          *snapshotPath,
+    yamlErrorCode       *outError
+);
+
+/*!
+    @function yamlConfigFileCreateWithFilesAtPaths
+    Create YAML file wrappers for many files at once, reading and parsing
+    them concurrently on up to threadCount threads.  The result for
+    sourceFilePaths[i] is returned in outConfigFiles[i] (NULL on error) and
+    the caller must release each non-NULL object.
+
+    Each file is treated as by yamlConfigFileCreateWithFileAtPath() with
+    the same options:  a file already present in the cache is returned from
+    the cache (unless yamlConfigFileOptions_ignoreCachedCopy is present),
+    and newly-loaded files are added to the cache (unless
+    yamlConfigFileOptions_doNotCache is present).  Cache insertion happens
+    on the calling thread after all files are loaded, in the order of
+    sourceFilePaths, so file ids are assigned deterministically regardless
+    of which thread loaded which file.  A path repeated in the batch is
+    loaded again, but only the first copy is cached and every occurrence
+    receives that copy.
+
+    @param sourceFilePaths
+        Array of sourceFileCount filesystem paths
+    @param sourceFileCount
+        Number of paths in sourceFilePaths
+    @param options
+        Optional behaviors from the yamlConfigFileOptions enumeration
+    @param threadCount
+        Maximum number of threads to use (including the calling thread);
+        zero selects the number of online processors
+    @param outConfigFiles
+        Array of sourceFileCount elements to fill-in
+    @param outErrors
+        If not NULL, an array of sourceFileCount elements set to zero for
+        each file that was loaded, yamlConfigFileError_fileNotReadable for
+        a file that could not be read, or yamlConfigFileError_parseFailed
+        for one that could not be parsed
+
+    @return The number of files successfully loaded
+*/
+unsigned int
+yamlConfigFileCreateWithFilesAtPaths(
+    const char* const   *sourceFilePaths,
+    unsigned int        sourceFileCount,
+    yamlOptionsBitvec   options,
+    unsigned int        threadCount,
+    yamlConfigFileRef   *outConfigFiles,
+    yamlErrorCode       *outErrors
+);
+
+/*!
+    @function yamlConfigFileGetParallelLoadThreadCount
+    Returns the number of threads a yamlConfigFileOptions_parallelLoad load
+    may use:  the value set by yamlConfigFileSetParallelLoadThreadCount()
+    or, by default, the number of online processors.  Always 1 if the
+    library was built without thread support.
+*/
+unsigned int
+yamlConfigFileGetParallelLoadThreadCount();
+
+/*!
+    @function yamlConfigFileSetParallelLoadThreadCount
+    Set the number of threads a yamlConfigFileOptions_parallelLoad load may
+    use; zero selects the number of online processors.  Documents are only
+    split into pieces of at least 1 MiB, so smaller documents use fewer
+    threads.
+*/
+void
+yamlConfigFileSetParallelLoadThreadCount(
+    unsigned int        threadCount
+);
+
+/*!
+    @defined YAMLCONFIGFILE_PARSE_CACHE_DIR_ENV_VAR
+    Name of the environment variable that, if set, provides the initial
+    parse cache directory (see yamlConfigFileSetParseCacheDirectory()).
+*/
+#define YAMLCONFIGFILE_PARSE_CACHE_DIR_ENV_VAR "YAMLCONFIGFILE_PARSE_CACHE_DIR"
+
+/*!
+    @function yamlConfigFileGetParseCacheDirectory
+    Returns the directory used for the on-disk parse cache, or NULL if the
+    parse cache is disabled.  On first use the directory is read from the
+    YAMLCONFIGFILE_PARSE_CACHE_DIR_ENV_VAR environment variable.  The string
+    returned is shared, not copied, and remains valid only until the next
+    call to yamlConfigFileSetParseCacheDirectory(), so this function must
+    not be used while another thread may change the directory.
+*/
+const char*
+yamlConfigFileGetParseCacheDirectory();
+
+/*!
+    @function yamlConfigFileSetParseCacheDirectory
+    Set the directory used for the on-disk parse cache; NULL (or an empty
+    string) disables the parse cache.
+
+    While a parse cache directory is set, yamlConfigFileCreateWithFileAtPath()
+    and yamlConfigFileCreateWithFileAtPathAndFilter() look for a snapshot of
+    a regular file in that directory (named for a hash of the file's
+    canonical path) before parsing it.  The snapshot is loaded in place of
+    the file only if the size, modification time and content hash of the
+    file recorded in it all match the file as it is now; otherwise the file
+    is parsed and, unless a filter was applied, a new snapshot is written to
+    the directory (which is created if necessary).  Snapshots are written
+    to a temporary file and renamed into place, so any number of processes
+    can share the directory:  concurrent writers replace one another's
+    complete entries and a reader never sees a partial one.  Failing to
+    write an entry does not fail the load.
+
+    The file is still read in full to compute its content hash, but not
+    parsed, so a load from the parse cache costs about as much as reading
+    the file.  A file loaded from the parse cache otherwise behaves as one
+    loaded with yamlConfigFileCreateWithSnapshotAtPath() (its
+    sourceFilePath is that of the YAML file, though), and
+    yamlConfigFileOptions_lazySubtrees has no effect.  Files loaded with
+    yamlConfigFileOptions_indexDocuments or
+    yamlConfigFileOptions_noParseCache bypass the parse cache.
+
+    The directory must be private to the user:  entry names are derived
+    from the canonical path of each file with a fixed hash, so anyone able
+    to write to the directory could plant an entry for a file they cannot
+    modify.  The directory is created with mode 0700 if it does not exist;
+    an existing directory is ignored, and the parse cache bypassed, unless
+    it is owned by the effective user and is not group- or world-writable.
+    Likewise, an entry is only loaded if it is a regular file (not a
+    symbolic link) owned by the effective user and not group- or
+    world-writable.
+
+    Entries are never removed by the library; the directory can be cleared
+    at any time.  The directory may be changed while loads are in progress
+    on other threads; each load uses the directory set when it started.
+
+    @return Boolean false if the directory path could not be copied
+*/
+bool
+yamlConfigFileSetParseCacheDirectory(
+    const char          *directoryPath
+);
+
 /*!
     @function yamlConfigFileGetRefCount
     Returns the reference count of aConfigFile.
@@ -210,6 +595,75 @@ yamlConfigFileGetRootNode(
     yamlConfigFileRef   aConfigFile
 );
 
+/*!
+    @function yamlConfigFileGetNodeWithId
+    Returns the node with the given (1-based) id in the YAML document
+    wrapped by aConfigFile, e.g. a sequence item or a mapping key or value
+    of a node already in hand.  The deferred subtrees of an object loaded
+    with yamlConfigFileOptions_lazySubtrees are not reachable this way.
+
+    @return NULL if nodeId is out of range, otherwise the YAML document node
+*/
+yaml_node_t*
+yamlConfigFileGetNodeWithId(
+    yamlConfigFileRef   aConfigFile,
+    int                 nodeId
+);
+
+/*!
+    @function yamlConfigFileGetMappingIndexThreshold
+    Returns the minimum number of key-value pairs a mapping node in
+    aConfigFile must have before key lookups in it are resolved via a
+    hash index rather than a linear scan.  Defaults to
+    YAMLKEYPATH_MAPPINGINDEX_DEFAULT_MINIMUM_KEYCOUNT; zero indicates
+    that indexing is disabled.
+*/
+unsigned int
+yamlConfigFileGetMappingIndexThreshold(
+    yamlConfigFileRef   aConfigFile
+);
+
+/*!
+    @function yamlConfigFileSetMappingIndexThreshold
+    Set the minimum number of key-value pairs a mapping node in aConfigFile
+    must have before key lookups in it are resolved via a hash index.  The
+    index for a mapping node is built on the first lookup in it and is
+    retained until aConfigFile is deallocated.  Pass zero to disable
+    indexing of any further mapping nodes.
+*/
+void
+yamlConfigFileSetMappingIndexThreshold(
+    yamlConfigFileRef   aConfigFile,
+    unsigned int        minimumKeyCount
+);
+
+/*!
+    @function yamlConfigFileGetKeyPathCacheStats
+    If aConfigFile has a key path cache, fill-in stats with its counters
+    and occupancy.
+ 
+    @return Boolean false if aConfigFile was created with the
+        yamlConfigFileOptions_noKeyPathCache option
+*/
+bool
+yamlConfigFileGetKeyPathCacheStats(
+    yamlConfigFileRef       aConfigFile,
+    yamlKeyPathCacheStats   *stats
+);
+
+/*!
+    @function yamlConfigFileSetKeyPathCacheCapacity
+    Set the maximum number of key paths whose nodes are cached by
+    aConfigFile (see yamlKeyPathCacheSetCapacity()).  Has no effect if
+    aConfigFile was created with the yamlConfigFileOptions_noKeyPathCache
+    option.
+*/
+void
+yamlConfigFileSetKeyPathCacheCapacity(
+    yamlConfigFileRef   aConfigFile,
+    unsigned int        capacity
+);
+
 /*!
     @function yamlConfigFileGetNodeAtPath
     Starting from an arbitrary node in the YAML document wrapped by aConfigFile,
@@ -241,6 +695,37 @@ yamlConfigFileGetNodeAtPath(
     yamlKeyPathNodeMatchType*   *failedAtMatchElement
 );
 
+/*!
+    @function yamlConfigFileGetCachedNodeAtPath
+    Return the node previously resolved for theKeyPath (relative to the
+    document root) if it is present in the key path cache of aConfigFile.
+    The document is never traversed.
+ 
+    @return NULL if aConfigFile has no key path cache or theKeyPath is not
+        cached, otherwise the cached YAML document node
+*/
+yaml_node_t*
+yamlConfigFileGetCachedNodeAtPath(
+    yamlConfigFileRef           aConfigFile,
+    yamlKeyPathRef              theKeyPath
+);
+
+/*!
+    @function yamlConfigFileResolveNodeAtPath
+    Traverse theKeyPath from the root of the YAML document wrapped by
+    aConfigFile without first consulting the key path cache; a node that is
+    found is added to the cache.  Intended as the slow path following a
+    yamlConfigFileGetCachedNodeAtPath() miss.
+ 
+    @return NULL if theKeyPath could not be resolved, otherwise the YAML
+        document node associated with theKeyPath
+*/
+yaml_node_t*
+yamlConfigFileResolveNodeAtPath(
+    yamlConfigFileRef           aConfigFile,
+    yamlKeyPathRef              theKeyPath
+);
+
 /*!
     @function yamlConfigFileGetNodeAtPathIsType
     Starting from an arbitrary node in the YAML document wrapped by aConfigFile,
@@ -606,7 +1091,9 @@ yamlConfigFileCoerceScalarAtPath(
     but handles compilation of the key path string itself.
     
     The key is compiled using the key path options that were passed to
-    aConfigFile when it was created.
+    aConfigFile when it was created (or obtained from the key path intern
+    table if aConfigFile has the yamlConfigFileOptions_internKeyPaths
+    option).
     
     @param outErrorAtChar
         If not NULL and a key path compilation error occurs, points to the
@@ -681,7 +1168,9 @@ yamlConfigFileCoerceSequenceAtPath(
     but handles compilation of the key path string itself.
     
     The key is compiled using the key path options that were passed to
-    aConfigFile when it was created.
+    aConfigFile when it was created (or obtained from the key path intern
+    table if aConfigFile has the yamlConfigFileOptions_internKeyPaths
+    option).
     
     @param outErrorAtChar
         If not NULL and a key path compilation error occurs, points to the
@@ -703,6 +1192,268 @@ yamlConfigFileCoerceSequenceAtPathString(
 );
 
 
+/*!
+    @function yamlConfigFileTryGetBool
+    Resolve theKeyPath relative to the root of the YAML document wrapped by
+    aConfigFile and, if it is a scalar node with a boolean value, set
+    *outValue.  Unlike yamlConfigFileCoerceScalarAtPath() there is no
+    variadic type dispatch or error reporting; a node already in the key path
+    cache is converted without leaving the inline function.
+ 
+    @return Boolean true if *outValue was set, false otherwise (*outValue is
+        left unchanged)
+*/
+static inline bool
+yamlConfigFileTryGetBool(
+    yamlConfigFileRef           aConfigFile,
+    yamlKeyPathRef              theKeyPath,
+    bool                        *outValue
+)
+{
+    yaml_node_t                 *node = yamlConfigFileGetCachedNodeAtPath(aConfigFile, theKeyPath);
+    bool                        value;
+    
+    if ( ! node && ! (node = yamlConfigFileResolveNodeAtPath(aConfigFile, theKeyPath)) ) return false;
+    if ( (node->type != YAML_SCALAR_NODE) || ! yamlScalarStringToBool((const char*)node->data.scalar.value, node->data.scalar.length, &value) ) return false;
+    *outValue = value;
+    return true;
+}
+
+/*!
+    @function yamlConfigFileTryGetInt64
+    Variant of yamlConfigFileTryGetBool() for a signed 64-bit integer value.
+*/
+static inline bool
+yamlConfigFileTryGetInt64(
+    yamlConfigFileRef           aConfigFile,
+    yamlKeyPathRef              theKeyPath,
+    int64_t                     *outValue
+)
+{
+    yaml_node_t                 *node = yamlConfigFileGetCachedNodeAtPath(aConfigFile, theKeyPath);
+    long long int               value;
+    
+    if ( ! node && ! (node = yamlConfigFileResolveNodeAtPath(aConfigFile, theKeyPath)) ) return false;
+    if ( (node->type != YAML_SCALAR_NODE) || ! yamlScalarStringToSignedInt((const char*)node->data.scalar.value, node->data.scalar.length, &value) ) return false;
+    *outValue = (int64_t)value;
+    return true;
+}
+
+/*!
+    @function yamlConfigFileTryGetUInt64
+    Variant of yamlConfigFileTryGetBool() for an unsigned 64-bit integer value.
+*/
+static inline bool
+yamlConfigFileTryGetUInt64(
+    yamlConfigFileRef           aConfigFile,
+    yamlKeyPathRef              theKeyPath,
+    uint64_t                    *outValue
+)
+{
+    yaml_node_t                 *node = yamlConfigFileGetCachedNodeAtPath(aConfigFile, theKeyPath);
+    unsigned long long int      value;
+    
+    if ( ! node && ! (node = yamlConfigFileResolveNodeAtPath(aConfigFile, theKeyPath)) ) return false;
+    if ( (node->type != YAML_SCALAR_NODE) || ! yamlScalarStringToUnsignedInt((const char*)node->data.scalar.value, node->data.scalar.length, &value) ) return false;
+    *outValue = (uint64_t)value;
+    return true;
+}
+
+/*!
+    @function yamlConfigFileTryGetDouble
+    Variant of yamlConfigFileTryGetBool() for a double-precision value.
+*/
+static inline bool
+yamlConfigFileTryGetDouble(
+    yamlConfigFileRef           aConfigFile,
+    yamlKeyPathRef              theKeyPath,
+    double                      *outValue
+)
+{
+    yaml_node_t                 *node = yamlConfigFileGetCachedNodeAtPath(aConfigFile, theKeyPath);
+    double                      value;
+    
+    if ( ! node && ! (node = yamlConfigFileResolveNodeAtPath(aConfigFile, theKeyPath)) ) return false;
+    if ( (node->type != YAML_SCALAR_NODE) || ! yamlScalarStringToDouble((const char*)node->data.scalar.value, node->data.scalar.length, &value) ) return false;
+    *outValue = value;
+    return true;
+}
+
+/*!
+    @function yamlConfigFileGetBool
+    Return the boolean value at theKeyPath, or defaultValue if the key path
+    does not resolve to a scalar with a boolean value.
+*/
+static inline bool
+yamlConfigFileGetBool(
+    yamlConfigFileRef           aConfigFile,
+    yamlKeyPathRef              theKeyPath,
+    bool                        defaultValue
+)
+{
+    yamlConfigFileTryGetBool(aConfigFile, theKeyPath, &defaultValue);
+    return defaultValue;
+}
+
+/*!
+    @function yamlConfigFileGetInt64
+    Return the signed 64-bit integer value at theKeyPath, or defaultValue if
+    the key path does not resolve to a scalar with an integer value in range.
+*/
+static inline int64_t
+yamlConfigFileGetInt64(
+    yamlConfigFileRef           aConfigFile,
+    yamlKeyPathRef              theKeyPath,
+    int64_t                     defaultValue
+)
+{
+    yamlConfigFileTryGetInt64(aConfigFile, theKeyPath, &defaultValue);
+    return defaultValue;
+}
+
+/*!
+    @function yamlConfigFileGetUInt64
+    Return the unsigned 64-bit integer value at theKeyPath, or defaultValue if
+    the key path does not resolve to a scalar with a non-negative integer value
+    in range.
+*/
+static inline uint64_t
+yamlConfigFileGetUInt64(
+    yamlConfigFileRef           aConfigFile,
+    yamlKeyPathRef              theKeyPath,
+    uint64_t                    defaultValue
+)
+{
+    yamlConfigFileTryGetUInt64(aConfigFile, theKeyPath, &defaultValue);
+    return defaultValue;
+}
+
+/*!
+    @function yamlConfigFileGetDouble
+    Return the double-precision value at theKeyPath, or defaultValue if the
+    key path does not resolve to a scalar with a floating-point value.
+*/
+static inline double
+yamlConfigFileGetDouble(
+    yamlConfigFileRef           aConfigFile,
+    yamlKeyPathRef              theKeyPath,
+    double                      defaultValue
+)
+{
+    yamlConfigFileTryGetDouble(aConfigFile, theKeyPath, &defaultValue);
+    return defaultValue;
+}
+
+/*!
+    @function yamlConfigFileGetBoolAtPathString
+    A convenience function that behaves like yamlConfigFileGetBool but
+    compiles pathString with the key path options that were passed to
+    aConfigFile when it was created (obtaining it from the key path intern
+    table if aConfigFile has the yamlConfigFileOptions_internKeyPaths
+    option).  An invalid pathString yields defaultValue.
+*/
+bool
+yamlConfigFileGetBoolAtPathString(
+    yamlConfigFileRef           aConfigFile,
+    const char                  *pathString,
+    size_t                      pathStringLen,
+    bool                        defaultValue
+);
+
+/*!
+    @function yamlConfigFileGetInt64AtPathString
+    Path string variant of yamlConfigFileGetInt64; see
+    yamlConfigFileGetBoolAtPathString.
+*/
+int64_t
+yamlConfigFileGetInt64AtPathString(
+    yamlConfigFileRef           aConfigFile,
+    const char                  *pathString,
+    size_t                      pathStringLen,
+    int64_t                     defaultValue
+);
+
+/*!
+    @function yamlConfigFileGetUInt64AtPathString
+    Path string variant of yamlConfigFileGetUInt64; see
+    yamlConfigFileGetBoolAtPathString.
+*/
+uint64_t
+yamlConfigFileGetUInt64AtPathString(
+    yamlConfigFileRef           aConfigFile,
+    const char                  *pathString,
+    size_t                      pathStringLen,
+    uint64_t                    defaultValue
+);
+
+/*!
+    @function yamlConfigFileGetDoubleAtPathString
+    Path string variant of yamlConfigFileGetDouble; see
+    yamlConfigFileGetBoolAtPathString.
+*/
+double
+yamlConfigFileGetDoubleAtPathString(
+    yamlConfigFileRef           aConfigFile,
+    const char                  *pathString,
+    size_t                      pathStringLen,
+    double                      defaultValue
+);
+
+/*!
+    @function yamlConfigFileGetDocumentCount
+    Returns the number of documents in the YAML stream from which aConfigFile
+    was loaded.  The stream is scanned for document boundaries (without being
+    parsed) on first use unless aConfigFile was created with the
+    yamlConfigFileOptions_indexDocuments option.  The scan only happens for
+    objects loaded from a whole file by path, and only if the file's size
+    and modification time are unchanged since it was loaded; otherwise (and
+    for objects from a string, stream, record iterator or snapshot) only
+    aConfigFile's own document is reported.
+*/
+unsigned int
+yamlConfigFileGetDocumentCount(
+    yamlConfigFileRef           aConfigFile
+);
+
+/*!
+    @function yamlConfigFileGetDocumentAtIndex
+    Return the document at (zero-based) documentIndex in the YAML stream from
+    which aConfigFile was loaded, without parsing any other document.  Document
+    zero is aConfigFile itself; others are parsed on demand and wrapped in new
+    (uncached) yamlConfigFile objects, the most-recently used of which are
+    retained by aConfigFile so repeated requests are not re-parsed.
+ 
+    @param aConfigFile
+        The yamlConfigFile loaded from a multi-document stream
+    @param documentIndex
+        Zero-based index of the document to return
+    @param outError
+        If not NULL and an error occurs, set to the applicable error code
+        (yamlConfigFileError_invalidDocumentIndex or
+        yamlConfigFileError_parseFailed)
+ 
+    @return NULL on error, otherwise a reference to the document which the
+        caller must release
+*/
+yamlConfigFileRef
+yamlConfigFileGetDocumentAtIndex(
+    yamlConfigFileRef           aConfigFile,
+    unsigned int                documentIndex,
+    yamlErrorCode               *outError
+);
+
+/*!
+    @function yamlConfigFileSetDocumentCacheCapacity
+    Set the number of parsed documents retained by aConfigFile for
+    yamlConfigFileGetDocumentAtIndex() (default 16); zero disables the
+    document cache.  Any currently-cached documents are released.
+*/
+void
+yamlConfigFileSetDocumentCacheCapacity(
+    yamlConfigFileRef           aConfigFile,
+    unsigned int                capacity
+);
+
 /*!
     @function yamlConfigFileCacheGetId
     Check the yamlConfigFile cache for a file with the given id.
@@ -759,4 +1510,766 @@ yamlConfigFileCacheEvict(
 void
 yamlConfigFileCacheFlush();
 
+/*!
+    @typedef yamlConfigFileStreamRef
+    Type of a reference to a yamlConfigFileStream object, which presents a
+    (possibly "---"-separated, multi-document) YAML stream one document at a
+    time.  Only the document currently being composed is held in memory by
+    the stream itself, so arbitrarily long streams can be processed in
+    memory bounded by the largest document (plus any documents the caller
+    chooses to retain).
+*/
+typedef struct __yamlConfigFileStream * yamlConfigFileStreamRef;
+
+/*!
+    @function yamlConfigFileStreamCreateWithInputString
+    Create a new YAML stream reading from an in-memory string buffer.  The
+    buffer must remain valid until the stream is deallocated.
+ 
+    @param inputString
+        Character array containing the YAML stream to be parsed
+    @param inputStringLength
+        Maximum number of characters to be parsed from inputString, or
+        yamlCStringFullLength if inputString is NUL-terminated
+    @param options
+        Optional behaviors from the yamlConfigFileOptions enumeration; they
+        are applied to each document produced
+ 
+    @return A newly-initialized yamlConfigFileStream, or NULL on error
+*/
+yamlConfigFileStreamRef
+yamlConfigFileStreamCreateWithInputString(
+    const char          *inputString,
+    size_t              inputStringLength,
+    yamlOptionsBitvec   options
+);
+
+/*!
+    @function yamlConfigFileStreamCreateWithFilePointer
+    Create a new YAML stream reading from an open file stream.  The file
+    stream must remain open until the stream is deallocated (it is not
+    closed by the stream).
+ 
+    @param sourceFilePtr
+        The open file stream from which to read the YAML stream
+    @param options
+        Optional behaviors from the yamlConfigFileOptions enumeration
+ 
+    @return A newly-initialized yamlConfigFileStream, or NULL on error
+*/
+yamlConfigFileStreamRef
+yamlConfigFileStreamCreateWithFilePointer(
+    FILE                *sourceFilePtr,
+    yamlOptionsBitvec   options
+);
+
+/*!
+    @function yamlConfigFileStreamCreateWithFileAtPath
+    Create a new YAML stream reading from the file at sourceFilePath.  The
+    yamlConfigFileOptions_mapInputFile option is honoured; note that for a
+    file that cannot be mapped (e.g. a pipe) the entire file is then read
+    into memory up front.
+ 
+    Documents produced by the stream report sourceFilePath as their source
+    file path but are never added to the yamlConfigFile cache.
+ 
+    @param sourceFilePath
+        Filesystem path to the YAML stream to be parsed
+    @param options
+        Optional behaviors from the yamlConfigFileOptions enumeration
+ 
+    @return A newly-initialized yamlConfigFileStream, or NULL on error
+*/
+yamlConfigFileStreamRef
+yamlConfigFileStreamCreateWithFileAtPath(
+    const char          *sourceFilePath,
+    yamlOptionsBitvec   options
+);
+
+/*!
+    @function yamlConfigFileStreamGetRefCount
+    Returns the reference count of aStream.
+*/
+unsigned int
+yamlConfigFileStreamGetRefCount(
+    yamlConfigFileStreamRef aStream
+);
+
+/*!
+    @function yamlConfigFileStreamRetain
+    Returns a reference to an extant yamlConfigFileStream object.
+*/
+yamlConfigFileStreamRef
+yamlConfigFileStreamRetain(
+    yamlConfigFileStreamRef aStream
+);
+
+/*!
+    @function yamlConfigFileStreamRelease
+    Release a reference to a yamlConfigFileStream object.  When the reference
+    count reaches zero, the object is deallocated.  Documents previously
+    returned by the stream remain valid.
+*/
+void
+yamlConfigFileStreamRelease(
+    yamlConfigFileStreamRef aStream
+);
+
+/*!
+    @function yamlConfigFileStreamNextDocument
+    Parse the next document in aStream and return it wrapped in a new
+    yamlConfigFile object, which the caller must release.
+ 
+    @param aStream
+        The yamlConfigFileStream to read from
+    @param outError
+        If not NULL, set to zero at the end of the stream or to the applicable
+        error code (e.g. yamlConfigFileError_parseFailed) if the document
+        could not be parsed; once parsing has failed, every subsequent call
+        fails as well
+ 
+    @return NULL at the end of the stream or on error, otherwise a
+        yamlConfigFile object wrapping the next document
+*/
+yamlConfigFileRef
+yamlConfigFileStreamNextDocument(
+    yamlConfigFileStreamRef aStream,
+    yamlErrorCode           *outError
+);
+
+/*!
+    @function yamlConfigFileStreamGetDocumentCount
+    Returns the number of documents aStream has produced so far.
+*/
+unsigned int
+yamlConfigFileStreamGetDocumentCount(
+    yamlConfigFileStreamRef aStream
+);
+
+/*!
+    @function yamlConfigFileStreamIsAtEnd
+    Returns boolean true once aStream has reached the end of its input.
+*/
+bool
+yamlConfigFileStreamIsAtEnd(
+    yamlConfigFileStreamRef aStream
+);
+
+/*!
+    @typedef yamlConfigFileRecordIteratorRef
+    Type of a reference to a yamlConfigFileRecordIterator object, which
+    presents the items of a document's root sequence (e.g. millions of
+    small mappings) one at a time, each as the root node of a standalone
+    yamlConfigFile "record" so that the usual key path and coercion
+    functions apply to it.  The document is consumed as a stream of parser
+    events, so memory is bounded by the largest record rather than by the
+    size of the document.
+
+    Only the first document of the input is iterated.  An alias in a record
+    must refer to an anchor within the same record.
+*/
+typedef struct __yamlConfigFileRecordIterator * yamlConfigFileRecordIteratorRef;
+
+/*!
+    @function yamlConfigFileRecordIteratorCreateWithInputString
+    Create a new record iterator reading from an in-memory string buffer.
+    The buffer must remain valid until the iterator is deallocated.
+ 
+    @param inputString
+        Character array containing the YAML document to be parsed
+    @param inputStringLength
+        Maximum number of characters to be parsed from inputString, or
+        yamlCStringFullLength if inputString is NUL-terminated
+    @param options
+        Optional behaviors from the yamlConfigFileOptions enumeration; they
+        are applied to each record produced
+ 
+    @return A newly-initialized yamlConfigFileRecordIterator, or NULL on
+        error
+*/
+yamlConfigFileRecordIteratorRef
+yamlConfigFileRecordIteratorCreateWithInputString(
+    const char          *inputString,
+    size_t              inputStringLength,
+    yamlOptionsBitvec   options
+);
+
+/*!
+    @function yamlConfigFileRecordIteratorCreateWithFilePointer
+    Create a new record iterator reading from an open file stream.  The
+    file stream must remain open until the iterator is deallocated (it is
+    not closed by the iterator).
+ 
+    @param sourceFilePtr
+        The open file stream from which to read the YAML document
+    @param options
+        Optional behaviors from the yamlConfigFileOptions enumeration
+ 
+    @return A newly-initialized yamlConfigFileRecordIterator, or NULL on
+        error
+*/
+yamlConfigFileRecordIteratorRef
+yamlConfigFileRecordIteratorCreateWithFilePointer(
+    FILE                *sourceFilePtr,
+    yamlOptionsBitvec   options
+);
+
+/*!
+    @function yamlConfigFileRecordIteratorCreateWithFileAtPath
+    Create a new record iterator reading from the file at sourceFilePath.
+    The yamlConfigFileOptions_mapInputFile option is honoured, and mapped
+    pages are released as the iterator advances.
+ 
+    Records report sourceFilePath as their source file path but are never
+    added to the yamlConfigFile cache.
+ 
+    @param sourceFilePath
+        Filesystem path to the YAML document to be parsed
+    @param options
+        Optional behaviors from the yamlConfigFileOptions enumeration
+ 
+    @return A newly-initialized yamlConfigFileRecordIterator, or NULL on
+        error
+*/
+yamlConfigFileRecordIteratorRef
+yamlConfigFileRecordIteratorCreateWithFileAtPath(
+    const char          *sourceFilePath,
+    yamlOptionsBitvec   options
+);
+
+/*!
+    @function yamlConfigFileRecordIteratorGetRefCount
+    Returns the reference count of anIterator.
+*/
+unsigned int
+yamlConfigFileRecordIteratorGetRefCount(
+    yamlConfigFileRecordIteratorRef anIterator
+);
+
+/*!
+    @function yamlConfigFileRecordIteratorRetain
+    Returns a reference to an extant yamlConfigFileRecordIterator object.
+*/
+yamlConfigFileRecordIteratorRef
+yamlConfigFileRecordIteratorRetain(
+    yamlConfigFileRecordIteratorRef anIterator
+);
+
+/*!
+    @function yamlConfigFileRecordIteratorRelease
+    Release a reference to a yamlConfigFileRecordIterator object.  When the
+    reference count reaches zero, the object is deallocated.  Records the
+    caller has retained remain valid.
+*/
+void
+yamlConfigFileRecordIteratorRelease(
+    yamlConfigFileRecordIteratorRef anIterator
+);
+
+/*!
+    @function yamlConfigFileRecordIteratorNextRecord
+    Compose the next item of the root sequence and return it as the root
+    node of a yamlConfigFile.
+
+    The returned object belongs to the iterator:  it is valid until the next
+    call to this function or until the iterator is deallocated, and (unless
+    the caller has retained it in the meantime) it is reused for the next
+    record.  Node pointers obtained from a record are only valid for as
+    long as the record is.  Call yamlConfigFileRetain() to keep a record
+    and yamlConfigFileRelease() when done with it.
+ 
+    @param anIterator
+        The yamlConfigFileRecordIterator to read from
+    @param outError
+        If not NULL, set to zero at the end of the sequence or to the
+        applicable error code if the next record could not be produced:
+        yamlConfigFileError_invalidType if the root node is not a sequence,
+        yamlConfigFileError_parseFailed if the document could not be
+        parsed; once iteration has failed, every subsequent call fails as
+        well
+ 
+    @return NULL at the end of the root sequence or on error, otherwise a
+        yamlConfigFile object wrapping the next record
+*/
+yamlConfigFileRef
+yamlConfigFileRecordIteratorNextRecord(
+    yamlConfigFileRecordIteratorRef anIterator,
+    yamlErrorCode                   *outError
+);
+
+/*!
+    @function yamlConfigFileRecordIteratorGetRecordCount
+    Returns the number of records anIterator has produced so far.
+*/
+unsigned int
+yamlConfigFileRecordIteratorGetRecordCount(
+    yamlConfigFileRecordIteratorRef anIterator
+);
+
+/*!
+    @function yamlConfigFileRecordIteratorIsAtEnd
+    Returns boolean true once anIterator has reached the end of the root
+    sequence.
+*/
+bool
+yamlConfigFileRecordIteratorIsAtEnd(
+    yamlConfigFileRecordIteratorRef anIterator
+);
+
+/*!
+    @typedef yamlConfigFileAsyncLoadRef
+    Type of a reference to a yamlConfigFileAsyncLoad object, which reads
+    and parses a file on a library-managed pool of worker threads so that
+    the caller (e.g. an event loop) never blocks on disk or parse work.
+
+    Completion is signalled in up to three ways:  a callback invoked on the
+    worker thread, a file descriptor that becomes readable (suitable for
+    poll(), select() or epoll()), and yamlConfigFileAsyncLoadWait().  The
+    yamlConfigFile cache is not thread-safe, so a successfully-loaded file
+    is only added to it when the result is collected with
+    yamlConfigFileAsyncLoadGetConfigFile(), which should be called on the
+    thread that otherwise uses the cache.
+
+    If the library was built without thread support the load runs to
+    completion inside yamlConfigFileAsyncLoadCreateWithFileAtPath().
+*/
+typedef struct __yamlConfigFileAsyncLoad * yamlConfigFileAsyncLoadRef;
+
+/*!
+    @typedef yamlConfigFileAsyncLoadCallback
+    Type of the function called when an asynchronous load completes
+    (successfully or not).  It runs on a worker thread, so it should do no
+    more than wake the thread that owns aLoad.  aLoad remains valid for the
+    duration of the call, but the callback must not call
+    yamlConfigFileAsyncLoadGetConfigFile() (which waits for the callback to
+    return).
+*/
+typedef void (*yamlConfigFileAsyncLoadCallback)(yamlConfigFileAsyncLoadRef aLoad, void *context);
+
+/*!
+    @function yamlConfigFileAsyncLoadCreateWithFileAtPath
+    Start loading the file at sourceFilePath in the background, returning
+    immediately.  The options are handled as by
+    yamlConfigFileCreateWithFileAtPath():  a file already present in the
+    cache completes the load with the cached copy (unless
+    yamlConfigFileOptions_ignoreCachedCopy is present) before this function
+    returns, so in that case callback runs on the calling thread.
+
+    Cancellation and the deadline are checked when a worker picks up the
+    load and as the file's content is read by the parser, so a large load
+    stops promptly; with the yamlConfigFileOptions_indexDocuments,
+    yamlConfigFileOptions_lazySubtrees or yamlConfigFileOptions_parallelLoad
+    options they are only checked before and after the load.
+
+    @param sourceFilePath
+        Filesystem path to the YAML document to be parsed
+    @param options
+        Optional behaviors from the yamlConfigFileOptions enumeration
+    @param timeout
+        Number of seconds after which the load fails with
+        yamlConfigFileError_loadDeadlineExpired; zero or a negative value
+        for no deadline
+    @param callback
+        If not NULL, the function to call once the load completes
+    @param context
+        Pointer passed to callback
+
+    @return A newly-initialized yamlConfigFileAsyncLoad, or NULL on error
+*/
+yamlConfigFileAsyncLoadRef
+yamlConfigFileAsyncLoadCreateWithFileAtPath(
+    const char                      *sourceFilePath,
+    yamlOptionsBitvec               options,
+    double                          timeout,
+    yamlConfigFileAsyncLoadCallback callback,
+    void                            *context
+);
+
+/*!
+    @function yamlConfigFileAsyncLoadGetRefCount
+    Returns the reference count of aLoad.
+*/
+unsigned int
+yamlConfigFileAsyncLoadGetRefCount(
+    yamlConfigFileAsyncLoadRef  aLoad
+);
+
+/*!
+    @function yamlConfigFileAsyncLoadRetain
+    Returns a reference to an extant yamlConfigFileAsyncLoad object.  Safe
+    to call from any thread.
+*/
+yamlConfigFileAsyncLoadRef
+yamlConfigFileAsyncLoadRetain(
+    yamlConfigFileAsyncLoadRef  aLoad
+);
+
+/*!
+    @function yamlConfigFileAsyncLoadRelease
+    Release a reference to a yamlConfigFileAsyncLoad object.  Safe to call
+    from any thread.  A load that is still running holds its own reference,
+    so releasing an unfinished load does not stop it; call
+    yamlConfigFileAsyncLoadCancel() first to do so.
+*/
+void
+yamlConfigFileAsyncLoadRelease(
+    yamlConfigFileAsyncLoadRef  aLoad
+);
+
+/*!
+    @function yamlConfigFileAsyncLoadGetFileDescriptor
+    Returns a file descriptor that becomes readable once aLoad completes
+    and stays readable thereafter (an eventfd where available, otherwise
+    the read end of a pipe).  The descriptor belongs to aLoad:  do not read
+    from or close it.  Returns -1 if no descriptor could be created.
+*/
+int
+yamlConfigFileAsyncLoadGetFileDescriptor(
+    yamlConfigFileAsyncLoadRef  aLoad
+);
+
+/*!
+    @function yamlConfigFileAsyncLoadIsComplete
+    Returns boolean true once aLoad has completed, successfully or not.
+*/
+bool
+yamlConfigFileAsyncLoadIsComplete(
+    yamlConfigFileAsyncLoadRef  aLoad
+);
+
+/*!
+    @function yamlConfigFileAsyncLoadWait
+    Block until aLoad completes or timeout seconds elapse (a negative
+    timeout waits indefinitely).
+
+    @return Boolean true if aLoad has completed
+*/
+bool
+yamlConfigFileAsyncLoadWait(
+    yamlConfigFileAsyncLoadRef  aLoad,
+    double                      timeout
+);
+
+/*!
+    @function yamlConfigFileAsyncLoadCancel
+    Ask aLoad to stop.  Unless it has already finished, the load completes
+    (notifying as usual) with yamlConfigFileError_loadCancelled.  A load
+    still waiting for a worker completes before this function returns, its
+    callback running on the calling thread; a running load stops the next
+    time the parser needs input.
+*/
+void
+yamlConfigFileAsyncLoadCancel(
+    yamlConfigFileAsyncLoadRef  aLoad
+);
+
+/*!
+    @function yamlConfigFileAsyncLoadGetConfigFile
+    Returns the yamlConfigFile produced by a completed load.  The first
+    call adds it to the cache (unless yamlConfigFileOptions_doNotCache was
+    present); if the same path was cached in the meantime, the cached copy
+    is returned instead.
+
+    The returned object belongs to aLoad; call yamlConfigFileRetain() to
+    keep it beyond the lifetime of aLoad.
+
+    @param aLoad
+        The completed yamlConfigFileAsyncLoad
+    @param outError
+        If not NULL, set to zero on success or to the applicable error
+        code:  yamlConfigFileError_loadNotComplete,
+        yamlConfigFileError_loadCancelled,
+        yamlConfigFileError_loadDeadlineExpired,
+        yamlConfigFileError_fileNotReadable or
+        yamlConfigFileError_parseFailed
+
+    @return NULL if the load has not completed or failed, otherwise the
+        loaded yamlConfigFile
+*/
+yamlConfigFileRef
+yamlConfigFileAsyncLoadGetConfigFile(
+    yamlConfigFileAsyncLoadRef  aLoad,
+    yamlErrorCode               *outError
+);
+
+/*!
+    @function yamlConfigFileGetAsyncLoadThreadCount
+    Returns the maximum number of worker threads used for asynchronous
+    loads:  the value set by yamlConfigFileSetAsyncLoadThreadCount() or,
+    by default, the number of online processors.  Workers are started as
+    loads are queued and persist once started.
+*/
+unsigned int
+yamlConfigFileGetAsyncLoadThreadCount();
+
+/*!
+    @function yamlConfigFileSetAsyncLoadThreadCount
+    Set the maximum number of worker threads used for asynchronous loads;
+    zero selects the number of online processors.  Workers already started
+    are not stopped.
+*/
+void
+yamlConfigFileSetAsyncLoadThreadCount(
+    unsigned int        threadCount
+);
+
+/*!
+    @typedef yamlConfigFilePushParserRef
+    Type of a reference to a yamlConfigFilePushParser object, which accepts
+    a YAML document in arbitrary pieces (e.g. as they arrive over a pipe or
+    socket) and parses it while the remaining pieces are still arriving.
+
+    The bytes passed to yamlConfigFilePushParserFeed() are copied onto an
+    internal queue from which a dedicated thread feeds libyaml, so the
+    caller never blocks on parsing until yamlConfigFilePushParserFinish().
+    If the library was built without thread support the queued bytes are
+    parsed by yamlConfigFilePushParserFinish() instead.
+*/
+typedef struct __yamlConfigFilePushParser * yamlConfigFilePushParserRef;
+
+/*!
+    @function yamlConfigFilePushParserCreate
+    Create a new push parser.  The document it produces is never added to
+    the yamlConfigFile cache.
+
+    @param options
+        Optional behaviors from the yamlConfigFileOptions enumeration
+
+    @return A newly-initialized yamlConfigFilePushParser, or NULL on error
+*/
+yamlConfigFilePushParserRef
+yamlConfigFilePushParserCreate(
+    yamlOptionsBitvec   options
+);
+
+/*!
+    @function yamlConfigFilePushParserGetRefCount
+    Returns the reference count of aPushParser.
+*/
+unsigned int
+yamlConfigFilePushParserGetRefCount(
+    yamlConfigFilePushParserRef aPushParser
+);
+
+/*!
+    @function yamlConfigFilePushParserRetain
+    Returns a reference to an extant yamlConfigFilePushParser object.
+*/
+yamlConfigFilePushParserRef
+yamlConfigFilePushParserRetain(
+    yamlConfigFilePushParserRef aPushParser
+);
+
+/*!
+    @function yamlConfigFilePushParserRelease
+    Release a reference to a yamlConfigFilePushParser object.  When the
+    reference count reaches zero, an unfinished parse is abandoned and the
+    object is deallocated.
+*/
+void
+yamlConfigFilePushParserRelease(
+    yamlConfigFilePushParserRef aPushParser
+);
+
+/*!
+    @function yamlConfigFilePushParserFeed
+    Append the next length bytes of the document to aPushParser's input.
+    The bytes are copied, so the caller may reuse its buffer immediately.
+
+    A syntax error is detected as soon as the parser reaches it, so a
+    caller can stop reading input once this function fails.
+
+    @param aPushParser
+        The yamlConfigFilePushParser to feed
+    @param bytes
+        The next piece of the document
+    @param length
+        Number of bytes at bytes
+    @param outError
+        If not NULL, set to zero on success or to the applicable error
+        code:  yamlConfigFileError_parseFailed if the input received so far
+        is not valid YAML, yamlConfigFileError_outOfMemory if the bytes
+        could not be queued, or yamlConfigFileError_invalidState if
+        aPushParser has already been finished
+
+    @return Boolean false if the bytes were not accepted
+*/
+bool
+yamlConfigFilePushParserFeed(
+    yamlConfigFilePushParserRef aPushParser,
+    const void                  *bytes,
+    size_t                      length,
+    yamlErrorCode               *outError
+);
+
+/*!
+    @function yamlConfigFilePushParserFinish
+    Mark the end of aPushParser's input and wait for the parse to complete.
+    May be called more than once; each call returns the same document.
+
+    @param aPushParser
+        The yamlConfigFilePushParser to finish
+    @param outError
+        If not NULL, set to zero on success or to the applicable error code
+        (e.g. yamlConfigFileError_parseFailed)
+
+    @return NULL on error, otherwise a yamlConfigFile wrapping the parsed
+        document; the caller must release it
+*/
+yamlConfigFileRef
+yamlConfigFilePushParserFinish(
+    yamlConfigFilePushParserRef aPushParser,
+    yamlErrorCode               *outError
+);
+
+/*!
+    @typedef yamlConfigFileIncrementalLoadRef
+    Type of a reference to a yamlConfigFileIncrementalLoad object, which
+    parses a document a slice at a time for callers (e.g. fixed-rate control
+    loops) that cannot afford to block for an entire load.  Each call to
+    yamlConfigFileIncrementalLoadStep() consumes parser events and composes
+    their nodes until a time or event budget is exhausted; once the
+    document is complete, yamlConfigFileIncrementalLoadGetConfigFile()
+    returns an ordinary yamlConfigFile.
+
+    The budget is checked between events, so a single very long scalar
+    (or the occasional growth of the node array) can overrun it.
+*/
+typedef struct __yamlConfigFileIncrementalLoad * yamlConfigFileIncrementalLoadRef;
+
+/*!
+    @function yamlConfigFileIncrementalLoadCreateWithInputString
+    Begin an incremental load of an in-memory string buffer.  The buffer
+    must remain valid until the load is complete.
+
+    @param inputString
+        Character array containing the YAML document to be parsed
+    @param inputStringLength
+        Maximum number of characters to be parsed from inputString, or
+        yamlCStringFullLength if inputString is NUL-terminated
+    @param options
+        Optional behaviors from the yamlConfigFileOptions enumeration
+
+    @return A newly-initialized yamlConfigFileIncrementalLoad, or NULL on
+        error
+*/
+yamlConfigFileIncrementalLoadRef
+yamlConfigFileIncrementalLoadCreateWithInputString(
+    const char          *inputString,
+    size_t              inputStringLength,
+    yamlOptionsBitvec   options
+);
+
+/*!
+    @function yamlConfigFileIncrementalLoadCreateWithFileAtPath
+    Begin an incremental load of the file at sourceFilePath.  The file is
+    opened (or, with yamlConfigFileOptions_mapInputFile, mapped)
+    immediately but read as the load proceeds.  The options are handled as
+    by yamlConfigFileCreateWithFileAtPath():  a file already present in the
+    cache completes the load immediately with the cached copy (unless
+    yamlConfigFileOptions_ignoreCachedCopy is present), and the loaded
+    file is added to the cache once complete (unless
+    yamlConfigFileOptions_doNotCache is present).
+
+    @param sourceFilePath
+        Filesystem path to the YAML document to be parsed
+    @param options
+        Optional behaviors from the yamlConfigFileOptions enumeration
+
+    @return A newly-initialized yamlConfigFileIncrementalLoad, or NULL on
+        error (e.g. if the file cannot be opened)
+*/
+yamlConfigFileIncrementalLoadRef
+yamlConfigFileIncrementalLoadCreateWithFileAtPath(
+    const char          *sourceFilePath,
+    yamlOptionsBitvec   options
+);
+
+/*!
+    @function yamlConfigFileIncrementalLoadGetRefCount
+    Returns the reference count of aLoad.
+*/
+unsigned int
+yamlConfigFileIncrementalLoadGetRefCount(
+    yamlConfigFileIncrementalLoadRef    aLoad
+);
+
+/*!
+    @function yamlConfigFileIncrementalLoadRetain
+    Returns a reference to an extant yamlConfigFileIncrementalLoad object.
+*/
+yamlConfigFileIncrementalLoadRef
+yamlConfigFileIncrementalLoadRetain(
+    yamlConfigFileIncrementalLoadRef    aLoad
+);
+
+/*!
+    @function yamlConfigFileIncrementalLoadRelease
+    Release a reference to a yamlConfigFileIncrementalLoad object.  When the
+    reference count reaches zero, an unfinished load is abandoned and the
+    object is deallocated.
+*/
+void
+yamlConfigFileIncrementalLoadRelease(
+    yamlConfigFileIncrementalLoadRef    aLoad
+);
+
+/*!
+    @function yamlConfigFileIncrementalLoadStep
+    Continue the load until the document is complete or the budget is
+    exhausted, whichever comes first.  With neither budget the load runs to
+    completion.
+
+    @param aLoad
+        The yamlConfigFileIncrementalLoad to advance
+    @param timeBudget
+        Number of seconds the step may take (e.g. 200.0e-6); zero or a
+        negative value for no time limit
+    @param eventBudget
+        Maximum number of parser events to consume; zero for no limit
+    @param outError
+        If not NULL, set to zero or, once the load has failed, to
+        yamlConfigFileError_parseFailed
+
+    @return Boolean true once the load has finished (successfully or not)
+*/
+bool
+yamlConfigFileIncrementalLoadStep(
+    yamlConfigFileIncrementalLoadRef    aLoad,
+    double                              timeBudget,
+    unsigned int                        eventBudget,
+    yamlErrorCode                       *outError
+);
+
+/*!
+    @function yamlConfigFileIncrementalLoadGetEventCount
+    Returns the number of parser events aLoad has consumed so far.
+*/
+unsigned long
+yamlConfigFileIncrementalLoadGetEventCount(
+    yamlConfigFileIncrementalLoadRef    aLoad
+);
+
+/*!
+    @function yamlConfigFileIncrementalLoadGetConfigFile
+    Returns the yamlConfigFile produced by a finished load.  The returned
+    object belongs to aLoad; call yamlConfigFileRetain() to keep it beyond
+    the lifetime of aLoad.
+
+    @param aLoad
+        The yamlConfigFileIncrementalLoad
+    @param outError
+        If not NULL, set to zero on success or to the applicable error
+        code:  yamlConfigFileError_loadNotComplete if the load has not
+        finished, yamlConfigFileError_parseFailed if it failed
+
+    @return NULL if the load has not finished or failed, otherwise the
+        loaded yamlConfigFile
+*/
+yamlConfigFileRef
+yamlConfigFileIncrementalLoadGetConfigFile(
+    yamlConfigFileIncrementalLoadRef    aLoad,
+    yamlErrorCode                       *outError
+);
+
 #endif /* __YAMLCONFIGFILE_H__ */
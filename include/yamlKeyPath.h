@@ -24,6 +24,7 @@ enum {
     yamlKeyPathError_invalidKey,
     yamlKeyPathError_internalError,
     yamlKeyPathError_invalidExpression,
+    yamlKeyPathError_bufferTooSmall,
     yamlKeyPathError_max
 };
 
@@ -166,6 +167,76 @@ yamlKeyPathCreateWithString(
 );
 
 
+/*!
+    @defined YAMLKEYPATH_BUFFER_SIZE
+    Byte size of the yamlKeyPathBuffer type.  Enough for a key path of
+    a dozen or so elements with short keys.
+*/
+#define YAMLKEYPATH_BUFFER_SIZE 512
+
+
+/*!
+    @typedef yamlKeyPathBuffer
+    Suitably-aligned storage into which a key path can be compiled by
+    yamlKeyPathCreateWithStringInBuffer(), e.g. as a local variable.
+*/
+typedef union {
+    uint64_t                alignment;
+    char                    bytes[YAMLKEYPATH_BUFFER_SIZE];
+} yamlKeyPathBuffer;
+
+
+/*!
+    @function yamlKeyPathCreateWithStringInBuffer
+    Variant of yamlKeyPathCreateWithString() that compiles the key path
+    into caller-provided storage rather than allocating it on the heap,
+    e.g.
+ 
+        yamlKeyPathBuffer   keyPathBuffer;
+        yamlKeyPathRef      keyPath = yamlKeyPathCreateWithStringInBuffer(
+                                            "a.b.c[2][1]", yamlCStringFullLength, 0,
+                                            &keyPathBuffer, sizeof(keyPathBuffer),
+                                            NULL, NULL);
+ 
+    The returned key path is valid only as long as the buffer is.  It is
+    retained and released like any other key path, but releasing the last
+    reference does not deallocate it; use yamlKeyPathCopy() to obtain a
+    heap-allocated key path that can outlive the buffer.  Objects that hold
+    onto key paths (like yamlKeyPathCache) store such a copy, so adding an
+    in-buffer key path to a cache allocates; applying it does not.
+ 
+    @param keyPathString
+        The key path string to compile
+    @param keyPathStringLength
+        The length of the key path string
+    @param options
+        Optional behaviors for the compilation
+    @param buffer
+        The storage to compile into; must be aligned to 8 bytes
+    @param bufferSize
+        Byte size of buffer
+    @param outError
+        If not NULL, set to the error that occurred during compilation;
+        yamlKeyPathError_bufferTooSmall indicates the compiled key path
+        would not fit in buffer
+    @param outErrorAtChar
+        If not NULL, set to the pointer to the character at which the
+        error occurred
+ 
+    @return A compiled key path residing in buffer, or NULL on error.
+*/
+yamlKeyPathRef
+yamlKeyPathCreateWithStringInBuffer(
+    const char              *keyPathString,
+    size_t                  keyPathStringLength,
+    yamlOptionsBitvec       options,
+    void                    *buffer,
+    size_t                  bufferSize,
+    yamlErrorCode           *outError,
+    const char*             *outErrorAtChar
+);
+
+
 /*!
     @function yamlKeyPathGetRefCount
     Returns the reference count of the key path object.
@@ -176,6 +247,21 @@ yamlKeyPathGetRefCount(
 );
 
 
+/*!
+    @function yamlKeyPathCopy
+    Returns a newly-allocated copy of aKeyPath with a reference count of
+    one, e.g. to keep a key path compiled with
+    yamlKeyPathCreateWithStringInBuffer() beyond the lifetime of its buffer.
+ 
+    @return A yamlKeyPathRef that must be released with
+        yamlKeyPathRelease(), or NULL on error
+*/
+yamlKeyPathRef
+yamlKeyPathCopy(
+    yamlKeyPathRef              aKeyPath
+);
+
+
 /*!
     @function yamlKeyPathRetain
     Returns a reference to an extant key path object.
@@ -387,6 +473,192 @@ yamlKeyPathApplyToDocument(
 );
 
 
+/*!
+    @defined YAMLKEYPATH_MAPPINGINDEX_DEFAULT_MINIMUM_KEYCOUNT
+    Mapping nodes with at least this many key-value pairs are, by
+    default, resolved using a hash index rather than a linear scan.
+*/
+#define YAMLKEYPATH_MAPPINGINDEX_DEFAULT_MINIMUM_KEYCOUNT 32
+
+
+/*!
+    @typedef yamlKeyPathMappingIndexRef
+    Type of a reference to a yamlKeyPathMappingIndex.  A mapping index
+    accelerates key lookups in the large mapping nodes of a single YAML
+    document:  the first time a key is sought in a mapping node with
+    at least the minimum number of key-value pairs, a hash table of that
+    node's keys is built and retained for all subsequent lookups.
+ 
+    The index keeps a pointer to its YAML document, so the document must
+    not be altered or destroyed while the index is in use.
+*/
+typedef struct __yamlKeyPathMappingIndex * yamlKeyPathMappingIndexRef;
+
+
+/*!
+    @function yamlKeyPathMappingIndexCreate
+    Create a new (empty) mapping index for the given yamlDocument.
+    Hash tables are only built for mapping nodes having at least
+    minimumKeyCount key-value pairs; zero disables indexing altogether.
+ 
+    @param yamlDocument
+        The YAML document whose mapping nodes will be indexed
+    @param minimumKeyCount
+        The minimum number of key-value pairs for which a mapping node
+        will be indexed
+ 
+    @return A new yamlKeyPathMappingIndexRef or NULL on error
+*/
+yamlKeyPathMappingIndexRef
+yamlKeyPathMappingIndexCreate(
+    yaml_document_t     *yamlDocument,
+    unsigned int        minimumKeyCount
+);
+
+
+/*!
+    @function yamlKeyPathMappingIndexGetRefCount
+    Returns the reference count of aMappingIndex.
+ 
+    @param aMappingIndex
+        The yamlKeyPathMappingIndex to check
+ 
+    @return The reference count of aMappingIndex
+*/
+unsigned int
+yamlKeyPathMappingIndexGetRefCount(
+    yamlKeyPathMappingIndexRef  aMappingIndex
+);
+
+
+/*!
+    @function yamlKeyPathMappingIndexRetain
+    Increase the reference count of aMappingIndex by 1.
+ 
+    @param aMappingIndex
+        The yamlKeyPathMappingIndex to retain
+ 
+    @return aMappingIndex is returned to the caller
+*/
+yamlKeyPathMappingIndexRef
+yamlKeyPathMappingIndexRetain(
+    yamlKeyPathMappingIndexRef  aMappingIndex
+);
+
+
+/*!
+    @function yamlKeyPathMappingIndexRelease
+    Decrease the reference count of aMappingIndex by 1.  When the
+    reference count reaches zero, the object (and all hash tables it
+    has built) is deallocated.
+ 
+    @param aMappingIndex
+        The yamlKeyPathMappingIndex to release
+*/
+void
+yamlKeyPathMappingIndexRelease(
+    yamlKeyPathMappingIndexRef  aMappingIndex
+);
+
+
+/*!
+    @function yamlKeyPathMappingIndexGetMinimumKeyCount
+    Returns the minimum number of key-value pairs a mapping node must
+    have to be indexed by aMappingIndex.
+ 
+    @param aMappingIndex
+        The yamlKeyPathMappingIndex to check
+ 
+    @return The minimum key count; zero indicates indexing is disabled
+*/
+unsigned int
+yamlKeyPathMappingIndexGetMinimumKeyCount(
+    yamlKeyPathMappingIndexRef  aMappingIndex
+);
+
+
+/*!
+    @function yamlKeyPathMappingIndexSetMinimumKeyCount
+    Set the minimum number of key-value pairs a mapping node must have
+    to be indexed by aMappingIndex.  Hash tables that have already been
+    built are retained.
+ 
+    @param aMappingIndex
+        The yamlKeyPathMappingIndex to modify
+    @param minimumKeyCount
+        The minimum key count; zero disables indexing
+*/
+void
+yamlKeyPathMappingIndexSetMinimumKeyCount(
+    yamlKeyPathMappingIndexRef  aMappingIndex,
+    unsigned int                minimumKeyCount
+);
+
+
+/*!
+    @function yamlKeyPathApplyToDocumentWithMappingIndex
+    Variant of yamlKeyPathApplyToDocument() that resolves keys in large
+    mapping nodes using aMappingIndex (which must have been created for
+    yamlDocument).  A NULL aMappingIndex is equivalent to calling
+    yamlKeyPathApplyToDocument().
+ 
+    Hash tables are built with respect to the
+    yamlKeyPathApplyOptions_keysAreCaseless option in effect when a
+    mapping node is first indexed; lookups in that node with the other
+    case sensitivity fall back to a linear scan.  When a mapping has
+    duplicate keys the first one present in the document is matched,
+    exactly as with a linear scan.
+ 
+    @param aKeyPath
+        A compiled key path
+    @param options
+        Optional behaviors to the function
+    @param yamlDocument
+        The YAML document in which the node search will occur
+    @param rootNode
+        The YAML document node at which the search begins; NULL implies
+        the root node of the document
+    @param aMappingIndex
+        The mapping index associated with yamlDocument
+    @param failedError
+        If not NULL and the search fails, an error code will be stored here
+    @param failedAtElement
+        If not NULL and the search fails, the node-matching element where
+        the failure occured will be stored here
+ 
+    @return The resulting YAML document node or NULL on error
+*/
+yaml_node_t*
+yamlKeyPathApplyToDocumentWithMappingIndex(
+    yamlKeyPathRef              aKeyPath,
+    yamlOptionsBitvec           options,
+    yaml_document_t             *yamlDocument,
+    yaml_node_t                 *rootNode,
+    yamlKeyPathMappingIndexRef  aMappingIndex,
+    yamlErrorCode               *failedError,
+    yamlKeyPathNodeMatchType*   *failedAtElement
+);
+
+/*!
+    @function yamlKeyPathApplyToDocumentFromNodeMatch
+    Variant of yamlKeyPathApplyToDocumentWithMappingIndex() that begins the
+    descent at startingElement (a node-matching element of aKeyPath, e.g. as
+    returned by yamlKeyPathGetNextNodeMatch()) rather than at the first
+    element; rootNode is the node to which startingElement applies.  NULL
+    for startingElement implies the first element.
+*/
+yaml_node_t*
+yamlKeyPathApplyToDocumentFromNodeMatch(
+    yamlKeyPathRef              aKeyPath,
+    yamlKeyPathNodeMatchType    *startingElement,
+    yamlOptionsBitvec           options,
+    yaml_document_t             *yamlDocument,
+    yaml_node_t                 *rootNode,
+    yamlKeyPathMappingIndexRef  aMappingIndex,
+    yamlErrorCode               *failedError,
+    yamlKeyPathNodeMatchType*   *failedAtElement
+);
+
 /*!
     @typedef yamlKeyPathCacheRef
     Type of a reference to a yamlKeyPathCache
@@ -443,12 +715,51 @@ typedef struct {
 extern const yamlKeyPathCacheValueCallbacks yamlKeyPathCacheValueCStringCallbacks;
 
 
+/*!
+    @defined YAMLKEYPATH_CACHE_DEFAULT_CAPACITY
+    The maximum number of entries a yamlKeyPath cache holds when it is
+    created with a capacity of zero.
+*/
+#define YAMLKEYPATH_CACHE_DEFAULT_CAPACITY 1024
+
+
+/*!
+    @typedef yamlKeyPathCacheStats
+    Data structure filled-in by yamlKeyPathCacheGetStats().
+ 
+    @field hits
+        Number of lookups that found a cached value
+    @field misses
+        Number of lookups that did not find a cached value
+    @field evictions
+        Number of cached values that were discarded to make room for
+        another value
+    @field count
+        Number of values presently cached
+    @field size
+        Number of entries presently allocated
+    @field capacity
+        Maximum number of entries the cache will grow to
+*/
+typedef struct {
+    uint64_t        hits;
+    uint64_t        misses;
+    uint64_t        evictions;
+    unsigned int    count;
+    unsigned int    size;
+    unsigned int    capacity;
+} yamlKeyPathCacheStats;
+
+
 /*!
     @function yamlKeyPathCacheCreate
-    Create a new yamlKeyPath cache.
+    Create a new yamlKeyPath cache.  The cache is set-associative with
+    least-recently-used replacement; it starts small and grows as values
+    are added until it reaches its capacity.
  
-    @param slotCount
-        Number of cache slots to create or 0 for the default
+    @param capacity
+        Maximum number of values to cache (rounded up to a power of two)
+        or 0 for YAMLKEYPATH_CACHE_DEFAULT_CAPACITY
     @param callbacks
         Pointer to a structure containing callbacks used to copy/destroy
         values
@@ -457,7 +768,7 @@ extern const yamlKeyPathCacheValueCallbacks yamlKeyPathCacheValueCStringCallback
 */
 yamlKeyPathCacheRef
 yamlKeyPathCacheCreate(
-    unsigned int                            slotCount,
+    unsigned int                            capacity,
     const yamlKeyPathCacheValueCallbacks    *callbacks
 );
 
@@ -493,6 +804,62 @@ yamlKeyPathCacheRelease(
 );
 
 
+/*!
+    @function yamlKeyPathCacheGetCapacity
+    Returns the maximum number of values aCache will hold.
+*/
+unsigned int
+yamlKeyPathCacheGetCapacity(
+    yamlKeyPathCacheRef aCache
+);
+
+
+/*!
+    @function yamlKeyPathCacheSetCapacity
+    Change the maximum number of values aCache will hold.  If the cache
+    is presently larger than the new capacity it is shrunk immediately,
+    evicting least-recently-used values as necessary.
+ 
+    @param aCache
+        The cache to affect
+    @param capacity
+        Maximum number of values to cache (rounded up to a power of two)
+        or 0 for YAMLKEYPATH_CACHE_DEFAULT_CAPACITY
+*/
+void
+yamlKeyPathCacheSetCapacity(
+    yamlKeyPathCacheRef aCache,
+    unsigned int        capacity
+);
+
+
+/*!
+    @function yamlKeyPathCacheGetStats
+    Fill-in stats with the hit/miss/eviction counters and present
+    occupancy of aCache.
+ 
+    @param aCache
+        The cache to check
+    @param stats
+        Pointer to the structure to fill-in
+*/
+void
+yamlKeyPathCacheGetStats(
+    yamlKeyPathCacheRef     aCache,
+    yamlKeyPathCacheStats   *stats
+);
+
+
+/*!
+    @function yamlKeyPathCacheResetStats
+    Zero the hit/miss/eviction counters of aCache.
+*/
+void
+yamlKeyPathCacheResetStats(
+    yamlKeyPathCacheRef aCache
+);
+
+
 /*!
     @function yamlKeyPathCacheAdd
     Attempts to add the given cachedValue to aCache, associating it with aKeyPath.
@@ -574,4 +941,97 @@ yamlKeyPathCacheLookup(
 
 
 
+/*!
+    @defined YAMLKEYPATH_INTERN_DEFAULT_CAPACITY
+    Default number of entries in the key path intern table.
+*/
+#define YAMLKEYPATH_INTERN_DEFAULT_CAPACITY 512
+
+
+/*!
+    @function yamlKeyPathCreateWithStringInterned
+    Variant of yamlKeyPathCreateWithString() that consults a process-wide
+    table of previously-compiled key paths keyed by the key path string and
+    the compile options.  If an identical string was compiled with the same
+    options (and has not been evicted from the table) a reference to that
+    shared yamlKeyPath is returned rather than compiling a new one.
+ 
+    The returned object has been retained on behalf of the caller and must
+    be released with yamlKeyPathRelease() as usual.  Like the yamlConfigFile
+    cache, the intern table is not thread-safe:  every caller that interns
+    the same string shares one yamlKeyPath (and its reference count), so
+    code that may run on several threads should use
+    yamlKeyPathCreateWithString() instead.  The yamlConfigFile string
+    getters only intern key paths for files created with the
+    yamlConfigFileOptions_internKeyPaths option.
+ 
+    @param keyPathString
+        C string containing the key path expression
+    @param keyPathStringLength
+        The number of characters in keyPathString to consider, or
+        yamlCStringFullLength to use all characters up to the NUL
+        terminator
+    @param options
+        Options that augment the behavior of the key path compiler
+    @param outError
+        Pointer to a yamlErrorCode variable that will be set to an error
+        code if compilation fails
+    @param outErrorAtChar
+        Pointer to a C string pointer that will be set to the character
+        at which the parse failed
+ 
+    @return A yamlKeyPathRef or NULL on error
+*/
+yamlKeyPathRef
+yamlKeyPathCreateWithStringInterned(
+    const char          *keyPathString,
+    size_t              keyPathStringLength,
+    yamlOptionsBitvec   options,
+    yamlErrorCode       *outError,
+    const char*         *outErrorAtChar
+);
+
+
+/*!
+    @function yamlKeyPathInternTableFlush
+    Release all key paths held by the intern table and deallocate it.
+*/
+void
+yamlKeyPathInternTableFlush();
+
+
+/*!
+    @function yamlKeyPathInternTableGetCapacity
+    Returns the number of entries in the intern table.
+*/
+unsigned int
+yamlKeyPathInternTableGetCapacity();
+
+
+/*!
+    @function yamlKeyPathInternTableSetCapacity
+    Flush the intern table and set the number of entries it will have
+    when it is next used.
+ 
+    @param capacity
+        Number of entries (rounded up to a power of two) or 0 for
+        YAMLKEYPATH_INTERN_DEFAULT_CAPACITY
+*/
+void
+yamlKeyPathInternTableSetCapacity(
+    unsigned int            capacity
+);
+
+
+/*!
+    @function yamlKeyPathInternTableGetStats
+    Fill-in stats with the hit/miss/eviction counters and present
+    occupancy of the intern table.
+*/
+void
+yamlKeyPathInternTableGetStats(
+    yamlKeyPathCacheStats   *stats
+);
+
+
 #endif /* __YAMLKEYPATH_H__ */
@@ -0,0 +1,140 @@
+/*
+ * yamlScalar
+ * Simplified YAML interface for C/Fortran
+ *
+ * Locale-independent conversion of YAML scalar text to
+ * boolean and numeric values.
+ *
+ */
+
+#ifndef __YAMLSCALAR_H__
+#define __YAMLSCALAR_H__
+
+#include "yamlBaseTypes.h"
+
+/*!
+    @function yamlScalarStringToBool
+    Parse the boolean value represented by the first scalarLength
+    characters at scalar (or up to the first NUL character).  Leading and
+    trailing whitespace is permitted.
+
+    The words true/yes/on and false/no/off (in any case), the single
+    characters t/y/1 and f/n/0 (in any case), and decimal integers (with
+    any non-zero value being true) are accepted.
+
+    @param scalar
+        Pointer to the scalar text
+    @param scalarLength
+        Number of characters at scalar, or yamlCStringFullLength if
+        scalar is NUL-terminated
+    @param outValue
+        Pointer to the variable to set to the parsed value
+
+    @return Boolean false if the text is not a boolean value
+*/
+bool
+yamlScalarStringToBool(
+    const char              *scalar,
+    size_t                  scalarLength,
+    bool                    *outValue
+);
+
+/*!
+    @function yamlScalarStringToSignedInt
+    Parse the integer value represented by the first scalarLength
+    characters at scalar (or up to the first NUL character) without
+    copying the text.  Leading and trailing whitespace is permitted.
+
+    The following forms are accepted, each with an optional sign:
+
+        1234            decimal
+        0x4D2           hexadecimal (YAML 1.1/1.2)
+        0o2322          octal (YAML 1.2)
+        02322           octal (YAML 1.1 and C)
+        0b10011010010   binary (YAML 1.1)
+        1_234           underscores between digits are ignored (YAML 1.1)
+
+    @param scalar
+        Pointer to the scalar text
+    @param scalarLength
+        Number of characters at scalar, or yamlCStringFullLength if
+        scalar is NUL-terminated
+    @param outValue
+        Pointer to the variable to set to the parsed value
+
+    @return Boolean false if the text is not an integer or if the value
+        does not fit in a long long int
+*/
+bool
+yamlScalarStringToSignedInt(
+    const char              *scalar,
+    size_t                  scalarLength,
+    long long int           *outValue
+);
+
+/*!
+    @function yamlScalarStringToUnsignedInt
+    Parse the non-negative integer value represented by the first
+    scalarLength characters at scalar.  Accepts the same forms as
+    yamlScalarStringToSignedInt(); a leading minus sign is only permitted
+    on a zero value.
+
+    @return Boolean false if the text is not an integer or if the value
+        is negative or does not fit in an unsigned long long int
+*/
+bool
+yamlScalarStringToUnsignedInt(
+    const char              *scalar,
+    size_t                  scalarLength,
+    unsigned long long int  *outValue
+);
+
+/*!
+    @function yamlScalarStringToDouble
+    Parse the floating-point value represented by the first scalarLength
+    characters at scalar (or up to the first NUL character).  The decimal
+    point is always '.', regardless of the current locale, and the result
+    is correctly rounded.
+
+    In addition to decimal forms (with optional fraction and exponent and
+    underscores between digits), the YAML special values .inf, -.inf,
+    .nan (in any case) and the strtod() forms inf, infinity and nan are
+    accepted, as are integers in any of the forms accepted by
+    yamlScalarStringToSignedInt() other than legacy leading-zero octal
+    (a leading zero is simply a decimal digit) and hexadecimal
+    floating-point values.
+
+    Values with up to 19 significant digits and a small decimal exponent
+    are converted using exact floating-point arithmetic; anything else is
+    handed to strtod() in the C locale.
+
+    @param scalar
+        Pointer to the scalar text
+    @param scalarLength
+        Number of characters at scalar, or yamlCStringFullLength if
+        scalar is NUL-terminated
+    @param outValue
+        Pointer to the variable to set to the parsed value
+
+    @return Boolean false if the text is not a floating-point value
+*/
+bool
+yamlScalarStringToDouble(
+    const char              *scalar,
+    size_t                  scalarLength,
+    double                  *outValue
+);
+
+/*!
+    @function yamlScalarStringToFloat
+    Single-precision variant of yamlScalarStringToDouble(); the result is
+    rounded directly to single precision (not via a double).
+*/
+bool
+yamlScalarStringToFloat(
+    const char              *scalar,
+    size_t                  scalarLength,
+    float                   *outValue
+);
+
+#endif /* __YAMLSCALAR_H__ */
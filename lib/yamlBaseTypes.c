@@ -8,6 +8,198 @@
 
 #include "yamlBaseTypes.h"
 
+#include <time.h>
+#include <unistd.h>
+#ifdef HAVE_PTHREAD
+# include <pthread.h>
+#endif
+
+//
+
+static bool __yamlHashSeedIsSet = false;
+static uint64_t __yamlHashSeed = 0;
+
+#ifdef HAVE_PTHREAD
+static pthread_once_t __yamlHashSeedOnce = PTHREAD_ONCE_INIT;
+#endif
+
+//
+
+void
+__yamlHashSeedInit(void)
+{
+    // An explicit yamlHashSetSeed() takes precedence:
+    if ( ! __yamlHashSeedIsSet ) {
+        const char      *seedStr = getenv(YAML_HASH_SEED_ENV_VAR);
+        char            *endPtr;
+        uint64_t        seed = 0;
+        bool            isSeeded = false;
+        
+        if ( seedStr && *seedStr ) {
+            seed = strtoull(seedStr, &endPtr, 0);
+            if ( *endPtr == '\0' ) isSeeded = true;
+        }
+        if ( ! isSeeded ) {
+            FILE        *urandom = fopen("/dev/urandom", "rb");
+            
+            if ( urandom ) {
+                if ( fread(&seed, sizeof(seed), 1, urandom) == 1 ) isSeeded = true;
+                fclose(urandom);
+            }
+        }
+        if ( ! isSeeded ) {
+            struct timespec t;
+            
+            clock_gettime(CLOCK_REALTIME, &t);
+            seed = yamlHash64Finalize((uint64_t)t.tv_sec ^ ((uint64_t)t.tv_nsec << 20) ^ ((uint64_t)getpid() << 40) ^ (uint64_t)(uintptr_t)&t);
+        }
+        __yamlHashSeed = seed;
+        __yamlHashSeedIsSet = true;
+    }
+}
+
+//
+
+uint64_t
+yamlHashGetSeed()
+{
+#ifdef HAVE_PTHREAD
+    // Any thread may be the first to hash something:
+    pthread_once(&__yamlHashSeedOnce, __yamlHashSeedInit);
+#else
+    __yamlHashSeedInit();
+#endif
+    return __yamlHashSeed;
+}
+
+//
+
+void
+yamlHashSetSeed(
+    uint64_t        seed
+)
+{
+    __yamlHashSeed = seed;
+    __yamlHashSeedIsSet = true;
+}
+
+//
+
+#define YAMLHASH64_PRIME1   0x9E3779B185EBCA87ULL
+#define YAMLHASH64_PRIME2   0xC2B2AE3D27D4EB4FULL
+#define YAMLHASH64_PRIME3   0x165667B19E3779F9ULL
+#define YAMLHASH64_PRIME4   0x85EBCA77C2B2AE63ULL
+#define YAMLHASH64_PRIME5   0x27D4EB2F165667C5ULL
+
+#define YAMLHASH64_ROTL(X, R)   (((X) << (R)) | ((X) >> (64 - (R))))
+
+static inline uint64_t
+__yamlHash64Round(
+    uint64_t    h,
+    uint64_t    v
+)
+{
+    v *= YAMLHASH64_PRIME2;
+    v = YAMLHASH64_ROTL(v, 31);
+    v *= YAMLHASH64_PRIME1;
+    h ^= v;
+    return YAMLHASH64_ROTL(h, 27) * YAMLHASH64_PRIME1 + YAMLHASH64_PRIME4;
+}
+
+static inline uint64_t
+__yamlHash64Load(
+    const unsigned char *p,
+    size_t              n,
+    bool                isCaseless
+)
+{
+    uint64_t            v = 0;
+    
+    // Words are always assembled little-endian, so that the case-sensitive
+    // and caseless hashes of the same bytes agree on every host:
+    if ( isCaseless ) {
+        while ( n-- ) v = (v << 8) | (unsigned char)tolower(p[n]);
+#ifndef WORDS_BIGENDIAN
+    } else if ( n == sizeof(uint64_t) ) {
+        memcpy(&v, p, sizeof(uint64_t));
+#endif
+    } else {
+        while ( n-- ) v = (v << 8) | p[n];
+    }
+    return v;
+}
+
+static inline uint64_t
+__yamlHash64Bytes(
+    const void      *bytes,
+    size_t          length,
+    uint64_t        seed,
+    bool            isCaseless
+)
+{
+    const unsigned char *p = (const unsigned char*)bytes;
+    uint64_t            h = seed + YAMLHASH64_PRIME5 + (uint64_t)length;
+    
+    while ( length >= 8 ) {
+        h = __yamlHash64Round(h, __yamlHash64Load(p, 8, isCaseless));
+        p += 8, length -= 8;
+    }
+    if ( length ) h = __yamlHash64Round(h, __yamlHash64Load(p, length, isCaseless));
+    return yamlHash64Finalize(h);
+}
+
+//
+
+uint64_t
+yamlHash64(
+    const void      *bytes,
+    size_t          length,
+    uint64_t        seed
+)
+{
+    return __yamlHash64Bytes(bytes, length, seed, false);
+}
+
+//
+
+uint64_t
+yamlHash64Caseless(
+    const void      *bytes,
+    size_t          length,
+    uint64_t        seed
+)
+{
+    return __yamlHash64Bytes(bytes, length, seed, true);
+}
+
+//
+
+uint64_t
+yamlHash64Combine(
+    uint64_t        h,
+    uint64_t        v
+)
+{
+    return __yamlHash64Round(h, v);
+}
+
+//
+
+uint64_t
+yamlHash64Finalize(
+    uint64_t        h
+)
+{
+    h ^= h >> 33;
+    h *= YAMLHASH64_PRIME2;
+    h ^= h >> 29;
+    h *= YAMLHASH64_PRIME3;
+    h ^= h >> 32;
+    return h;
+}
+
+//
+
 #ifndef HAVE_STRNCPY
 char*
 strncpy(
@@ -8,13 +8,29 @@
  */
 
 #include "yamlConfigFile.h"
+#include "yamlConfigFilePrivate.h"
+#include "yamlConfigFileFilter.h"
+#include "yamlConfigFileFastParser.h"
+#include "yamlConfigFileSnapshot.h"
+#include "yamlConfigFileDecompressor.h"
 
-//
-
-#ifndef YAMLCONFIGFILE_NODE_COERCE_STACKBUFFERSIZE
-#define YAMLCONFIGFILE_NODE_COERCE_STACKBUFFERSIZE  48
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <errno.h>
+#ifdef HAVE_MMAP
+# include <sys/mman.h>
+#endif
+#include <time.h>
+#ifdef HAVE_PTHREAD
+# include <pthread.h>
+#endif
+#ifdef HAVE_EVENTFD
+# include <sys/eventfd.h>
 #endif
 
+//
+
 #ifdef YAMLCONFIGFILE_DEBUG
 #define DEBUG_PRINTF(F, ...) fprintf(stderr, "[DEBUG] " F "\n", __VA_ARGS__)
 #else
@@ -29,64 +45,7 @@ __yamlScalarNodeToBool(
     bool            *outValue
 )
 {
-	if ( node->data.scalar.length > 0 ) {
-		char		*s = (char*)node->data.scalar.value;
-		size_t		l = node->data.scalar.length;
-		
-		if ( l == 1 ) {
-			switch (*s ) {
-			
-				case 't':
-				case 'T':
-				case 'y':
-				case 'Y':
-				case '1':
-					*outValue = true;
-					return true;
-			
-				case 'f':
-				case 'F':
-				case 'n':
-				case 'N':
-				case '0':
-					*outValue = false;
-					return true;
-			
-			}
-		}
-		if ( ((l == 4) && (strncasecmp(s, "true", l) == 0)) ||
-			((l == 3) && (strncasecmp(s, "yes", l) == 0)) ||
-			((l == 2) && (strncasecmp(s, "on", l) == 0)) )
-		{
-			*outValue = true;
-			return true;
-		}
-		if ( ((l == 5) && (strncasecmp(s, "false", l) == 0)) ||
-			((l == 2) && (strncasecmp(s, "no", l) == 0)) ||
-			((l == 3) && (strncasecmp(s, "off", l) == 0)) )
-		{
-			*outValue = false;
-			return true;
-		}
-		if ( isdigit(*s) || (*s == '-') || (*s == '+') ) {
-			if ( (*s == '-') || (*s == '+') ) s++; l--;
-			if ( l > 0 ) {
-				bool	zero = (*s == '0') ? true : false;
-			
-				s++, l--;
-				while ( l ) {
-					if ( ! isdigit(*s) ) break;
-					if ( zero ) zero = (*s == '0') ? true : false;
-					s++, l--;
-				}
-				if ( l == 0 ) {
-					*outValue = ! zero;
-					return true;
-				}
-			}
-		}
-	}
-	return false;
+	return ( (node->data.scalar.length > 0) && yamlScalarStringToBool((const char*)node->data.scalar.value, node->data.scalar.length, outValue) );
 }
 
 //
@@ -97,36 +56,7 @@ __yamlScalarNodeToSignedInt(
 	long long int   *outValue
 )
 {
-    bool            okay = false;
-    
-	if ( node->data.scalar.length > 0 ) {
-        char        nodeValueOnStack[YAMLCONFIGFILE_NODE_COERCE_STACKBUFFERSIZE];
-        char        *nodeValue;
-        
-        if ( node->data.scalar.length < YAMLCONFIGFILE_NODE_COERCE_STACKBUFFERSIZE ) {
-            nodeValue = nodeValueOnStack;
-        } else {
-            nodeValue = malloc(1 + node->data.scalar.length);
-        }
-		if ( nodeValue ) {
-			long long int	ival;
-			char		*endptr = NULL;
-			
-			memcpy(nodeValue, node->data.scalar.value, node->data.scalar.length);
-			nodeValue[node->data.scalar.length] = '\0';
-			ival = strtoll(nodeValue, &endptr, 0);
-            
-            if ( endptr > nodeValue ) {
-                while ( *endptr && isspace(*endptr) ) endptr++;
-                if ( ! *endptr ) {
-                    *outValue = ival;
-                    okay = true;
-                }
-            }
-		}
-        if ( nodeValue != nodeValueOnStack ) free(nodeValue);
-	}
-	return okay;
+	return ( (node->data.scalar.length > 0) && yamlScalarStringToSignedInt((const char*)node->data.scalar.value, node->data.scalar.length, outValue) );
 }
 
 //
@@ -137,36 +67,7 @@ __yamlScalarNodeToUnsignedInt(
 	unsigned long long int  *outValue
 )
 {
-    bool            okay = false;
-    
-	if ( node->data.scalar.length > 0 ) {
-        char        nodeValueOnStack[YAMLCONFIGFILE_NODE_COERCE_STACKBUFFERSIZE];
-        char        *nodeValue;
-        
-        if ( node->data.scalar.length < YAMLCONFIGFILE_NODE_COERCE_STACKBUFFERSIZE ) {
-            nodeValue = nodeValueOnStack;
-        } else {
-            nodeValue = malloc(1 + node->data.scalar.length);
-        }
-		if ( nodeValue ) {
-			unsigned long long int  ival;
-			char                    *endptr = NULL;
-			
-			memcpy(nodeValue, node->data.scalar.value, node->data.scalar.length);
-			nodeValue[node->data.scalar.length] = '\0';
-			ival = strtoull(nodeValue, &endptr, 0);
-            
-            if ( endptr > nodeValue ) {
-                while ( *endptr && isspace(*endptr) ) endptr++;
-                if ( ! *endptr ) {
-                    *outValue = ival;
-                    okay = true;
-                }
-            }
-		}
-        if ( nodeValue != nodeValueOnStack ) free(nodeValue);
-	}
-	return okay;
+	return ( (node->data.scalar.length > 0) && yamlScalarStringToUnsignedInt((const char*)node->data.scalar.value, node->data.scalar.length, outValue) );
 }
 
 //
@@ -177,36 +78,7 @@ __yamlScalarNodeToFloat(
 	float           *outValue
 )
 {
-    bool            okay = false;
-    
-	if ( node->data.scalar.length > 0 ) {
-        char        nodeValueOnStack[YAMLCONFIGFILE_NODE_COERCE_STACKBUFFERSIZE];
-        char        *nodeValue;
-        
-        if ( node->data.scalar.length < YAMLCONFIGFILE_NODE_COERCE_STACKBUFFERSIZE ) {
-            nodeValue = nodeValueOnStack;
-        } else {
-            nodeValue = malloc(1 + node->data.scalar.length);
-        }
-		if ( nodeValue ) {
-			float           fval;
-			char            *endptr = NULL;
-			
-			memcpy(nodeValue, node->data.scalar.value, node->data.scalar.length);
-			nodeValue[node->data.scalar.length] = '\0';
-			fval = strtof(nodeValue, &endptr);
-            
-            if ( endptr > nodeValue ) {
-                while ( *endptr && isspace(*endptr) ) endptr++;
-                if ( ! *endptr ) {
-                    *outValue = fval;
-                    okay = true;
-                }
-            }
-		}
-        if ( nodeValue != nodeValueOnStack ) free(nodeValue);
-	}
-	return okay;
+	return ( (node->data.scalar.length > 0) && yamlScalarStringToFloat((const char*)node->data.scalar.value, node->data.scalar.length, outValue) );
 }
 
 //
@@ -217,36 +89,7 @@ __yamlScalarNodeToDouble(
 	double          *outValue
 )
 {
-    bool            okay = false;
-    
-	if ( node->data.scalar.length > 0 ) {
-        char        nodeValueOnStack[YAMLCONFIGFILE_NODE_COERCE_STACKBUFFERSIZE];
-        char        *nodeValue;
-        
-        if ( node->data.scalar.length < YAMLCONFIGFILE_NODE_COERCE_STACKBUFFERSIZE ) {
-            nodeValue = nodeValueOnStack;
-        } else {
-            nodeValue = malloc(1 + node->data.scalar.length);
-        }
-		if ( nodeValue ) {
-			double          dval;
-			char            *endptr = NULL;
-			
-			memcpy(nodeValue, node->data.scalar.value, node->data.scalar.length);
-			nodeValue[node->data.scalar.length] = '\0';
-			dval = strtod(nodeValue, &endptr);
-            
-            if ( endptr > nodeValue ) {
-                while ( *endptr && isspace(*endptr) ) endptr++;
-                if ( ! *endptr ) {
-                    *outValue = dval;
-                    okay = true;
-                }
-            }
-		}
-        if ( nodeValue != nodeValueOnStack ) free(nodeValue);
-	}
-	return okay;
+	return ( (node->data.scalar.length > 0) && yamlScalarStringToDouble((const char*)node->data.scalar.value, node->data.scalar.length, outValue) );
 }
 
 //
@@ -255,12 +98,101 @@ __yamlScalarNodeToDouble(
 #endif
 //
 
+/*
+ * The file cache is indexed two ways:  a dense table of yamlConfigFile
+ * references indexed by (file id - 1) gives O(1) resolution of Fortran
+ * unit numbers, and a chained hash table keyed on the source file path
+ * gives O(1) lookup by filename.  Ids are always assigned lowest-free
+ * first, so walking the dense table in order is equivalent to walking
+ * the files in ascending id order.
+ */
+
+#ifndef YAMLCONFIGFILE_CACHE_MIN_CAPACITY
+#define YAMLCONFIGFILE_CACHE_MIN_CAPACITY   16
+#endif
+
 typedef struct __yamlConfigFileCacheLine {
     struct __yamlConfigFileCacheLine    *link;
+    uint64_t                            pathHash;
     yamlConfigFileRef                   theConfigFile;
 } yamlConfigFileCacheLine;
 
-static yamlConfigFileCacheLine          *__yamlConfigFileCacheHead = NULL;
+static yamlConfigFileRef                *__yamlConfigFileCacheById = NULL;
+static unsigned int                     __yamlConfigFileCacheByIdCapacity = 0;
+static unsigned int                     __yamlConfigFileCacheByIdTop = 0;
+static unsigned int                     __yamlConfigFileCacheByIdFreeHint = 0;
+
+static yamlConfigFileCacheLine*         *__yamlConfigFileCacheByPath = NULL;
+static unsigned int                     __yamlConfigFileCacheByPathCapacity = 0;
+static unsigned int                     __yamlConfigFileCacheCount = 0;
+
+//
+
+uint64_t
+__yamlConfigFileCachePathHash(
+    const char      *sourceFilePath,
+    bool            shouldCaseFold
+)
+{
+    size_t          sourceFilePathLen = strlen(sourceFilePath);
+    
+    return ( shouldCaseFold ? yamlHash64Caseless(sourceFilePath, sourceFilePathLen, yamlHashGetSeed()) : yamlHash64(sourceFilePath, sourceFilePathLen, yamlHashGetSeed()) );
+}
+
+//
+
+bool
+__yamlConfigFileCacheGrowById(
+    unsigned int        minCapacity
+)
+{
+    unsigned int        newCapacity = ( __yamlConfigFileCacheByIdCapacity ? __yamlConfigFileCacheByIdCapacity : YAMLCONFIGFILE_CACHE_MIN_CAPACITY );
+    yamlConfigFileRef   *newTable;
+    
+    while ( newCapacity < minCapacity ) {
+        if ( newCapacity > UINT_MAX / 2 ) {
+            newCapacity = UINT_MAX;
+            break;
+        }
+        newCapacity *= 2;
+    }
+    newTable = realloc(__yamlConfigFileCacheById, newCapacity * sizeof(yamlConfigFileRef));
+    if ( ! newTable ) return false;
+    memset(newTable + __yamlConfigFileCacheByIdCapacity, 0, (newCapacity - __yamlConfigFileCacheByIdCapacity) * sizeof(yamlConfigFileRef));
+    __yamlConfigFileCacheById = newTable;
+    __yamlConfigFileCacheByIdCapacity = newCapacity;
+    return true;
+}
+
+//
+
+bool
+__yamlConfigFileCacheGrowByPath()
+{
+    unsigned int            newCapacity = ( __yamlConfigFileCacheByPathCapacity ? 2 * __yamlConfigFileCacheByPathCapacity : YAMLCONFIGFILE_CACHE_MIN_CAPACITY );
+    yamlConfigFileCacheLine **newTable = calloc(newCapacity, sizeof(yamlConfigFileCacheLine*));
+    unsigned int            i = 0;
+    
+    if ( ! newTable ) return false;
+    
+    // Rehash all extant cache lines into the new table:
+    while ( i < __yamlConfigFileCacheByPathCapacity ) {
+        yamlConfigFileCacheLine *cacheLine = __yamlConfigFileCacheByPath[i++];
+        
+        while ( cacheLine ) {
+            yamlConfigFileCacheLine *nextCacheLine = cacheLine->link;
+            unsigned int            bucket = cacheLine->pathHash & (newCapacity - 1);
+            
+            cacheLine->link = newTable[bucket];
+            newTable[bucket] = cacheLine;
+            cacheLine = nextCacheLine;
+        }
+    }
+    if ( __yamlConfigFileCacheByPath ) free((void*)__yamlConfigFileCacheByPath);
+    __yamlConfigFileCacheByPath = newTable;
+    __yamlConfigFileCacheByPathCapacity = newCapacity;
+    return true;
+}
 
 //
 
@@ -269,40 +201,42 @@ __yamlConfigFileCacheAdd(
     yamlConfigFileRef       aConfigFile
 )
 {
-    yamlConfigFileCacheLine *cacheLine = __yamlConfigFileCacheHead, *prevCacheLine = NULL, *newCacheLine;
-    yamlConfigFileId        nextFreeId = 1;
+    const char              *sourceFilePath = yamlConfigFileGetSourceFilePath(aConfigFile);
+    yamlConfigFileCacheLine *newCacheLine;
+    unsigned int            index = __yamlConfigFileCacheByIdFreeHint;
     
-    while ( cacheLine ) {
-        yamlConfigFileId    cacheLineFileId = yamlConfigFileGetId(cacheLine->theConfigFile);
-        
-        if ( cacheLineFileId == nextFreeId ) {
-            // If the id wraps to zero then the cache is 100% full:
-            if ( ++nextFreeId == 0 ) {
-                DEBUG_PRINTF("yamlConfigFileCache is full!!", NULL);
-                return YAMLCONFIGFILE_UNCACHED_ID;
-            }
-        } else if ( cacheLineFileId > nextFreeId ) {
-            break;
-        }
-        prevCacheLine = cacheLine;
-        cacheLine = cacheLine->link;
+    // Locate the lowest free id:
+    while ( (index < __yamlConfigFileCacheByIdCapacity) && __yamlConfigFileCacheById[index] ) index++;
+    
+    // If the id would wrap to zero then the cache is 100% full:
+    if ( index == UINT_MAX ) {
+        DEBUG_PRINTF("yamlConfigFileCache is full!!", NULL);
+        return YAMLCONFIGFILE_UNCACHED_ID;
     }
+    if ( (index >= __yamlConfigFileCacheByIdCapacity) && ! __yamlConfigFileCacheGrowById(index + 1) ) return YAMLCONFIGFILE_UNCACHED_ID;
+    
+    // Keep the path table's load factor at or below 1:
+    if ( (__yamlConfigFileCacheCount >= __yamlConfigFileCacheByPathCapacity) && ! __yamlConfigFileCacheGrowByPath() ) return YAMLCONFIGFILE_UNCACHED_ID;
     
     // Allocate a cache line:
     newCacheLine = malloc(sizeof(yamlConfigFileCacheLine));
     if ( newCacheLine ) {
+        unsigned int        bucket;
+        
         DEBUG_PRINTF("yamlConfigFile@%p added to yamlConfigFileCache", aConfigFile);
         newCacheLine->theConfigFile = yamlConfigFileRetain(aConfigFile);
-        newCacheLine->link = cacheLine;
-        if ( prevCacheLine ) {
-            prevCacheLine->link = newCacheLine;
-        } else {
-            __yamlConfigFileCacheHead = newCacheLine;
-        }
-    } else {
-        nextFreeId = YAMLCONFIGFILE_UNCACHED_ID;
+        newCacheLine->pathHash = ( sourceFilePath ? __yamlConfigFileCachePathHash(sourceFilePath, false) : 0 );
+        bucket = newCacheLine->pathHash & (__yamlConfigFileCacheByPathCapacity - 1);
+        newCacheLine->link = __yamlConfigFileCacheByPath[bucket];
+        __yamlConfigFileCacheByPath[bucket] = newCacheLine;
+        
+        __yamlConfigFileCacheById[index] = aConfigFile;
+        __yamlConfigFileCacheByIdFreeHint = index + 1;
+        if ( index >= __yamlConfigFileCacheByIdTop ) __yamlConfigFileCacheByIdTop = index + 1;
+        __yamlConfigFileCacheCount++;
+        return (yamlConfigFileId)(index + 1);
     }
-    return nextFreeId;
+    return YAMLCONFIGFILE_UNCACHED_ID;
 }
 
 //
@@ -313,24 +247,31 @@ __yamlConfigFileCacheLookup(
     yamlOptionsBitvec   options
 )
 {
-    yamlConfigFileCacheLine *cacheLine = __yamlConfigFileCacheHead;
+    yamlConfigFileRef       foundFile = NULL;
     
-    if ( options & yamlConfigFileOptions_caseFoldFilename ) {
-        while ( cacheLine ) {
-            const char  *s1 = sourceFilePath;
-            const char  *s2 = yamlConfigFileGetSourceFilePath(cacheLine->theConfigFile);
-            
-            while ( *s1 && *s2 && (tolower(*s1) == *s2) ) s1++, s2++;
-            if ( ! *s1 && ! *s2 ) return cacheLine->theConfigFile;
-            cacheLine = cacheLine->link;
-        }
-    } else {
+    if ( __yamlConfigFileCacheCount > 0 ) {
+        bool                    shouldCaseFold = (options & yamlConfigFileOptions_caseFoldFilename) ? true : false;
+        uint64_t                pathHash = __yamlConfigFileCachePathHash(sourceFilePath, shouldCaseFold);
+        yamlConfigFileCacheLine *cacheLine = __yamlConfigFileCacheByPath[pathHash & (__yamlConfigFileCacheByPathCapacity - 1)];
+        
+        // If the same path was cached more than once (e.g. with the ignoreCachedCopy
+        // option) the lowest id wins:
         while ( cacheLine ) {
-            if ( strcmp(sourceFilePath, yamlConfigFileGetSourceFilePath(cacheLine->theConfigFile)) == 0 ) return cacheLine->theConfigFile;
+            if ( (cacheLine->pathHash == pathHash) && (! foundFile || (yamlConfigFileGetId(cacheLine->theConfigFile) < yamlConfigFileGetId(foundFile))) ) {
+                const char  *s1 = sourceFilePath;
+                const char  *s2 = yamlConfigFileGetSourceFilePath(cacheLine->theConfigFile);
+                
+                if ( shouldCaseFold ) {
+                    while ( *s1 && *s2 && (tolower(*s1) == *s2) ) s1++, s2++;
+                } else {
+                    while ( *s1 && *s2 && (*s1 == *s2) ) s1++, s2++;
+                }
+                if ( ! *s1 && ! *s2 ) foundFile = cacheLine->theConfigFile;
+            }
             cacheLine = cacheLine->link;
         }
     }
-    return NULL;
+    return foundFile;
 }
 
 //
@@ -340,22 +281,8 @@ yamlConfigFileCacheGetId(
     yamlConfigFileId    aConfigFileId
 )
 {
-    yamlConfigFileRef       foundFile = NULL;
-    yamlConfigFileCacheLine *cacheLine = __yamlConfigFileCacheHead;
-    
-    while ( cacheLine ) {
-        yamlConfigFileId    cacheLineFileId = yamlConfigFileGetId(cacheLine->theConfigFile);
-        
-        if ( cacheLineFileId == aConfigFileId ) {
-            foundFile = cacheLine->theConfigFile;
-            break;
-        }
-        else if ( cacheLineFileId > aConfigFileId ) {
-            break;
-        }
-        cacheLine = cacheLine->link;
-    }
-    return foundFile;
+    if ( (aConfigFileId != YAMLCONFIGFILE_UNCACHED_ID) && (aConfigFileId <= __yamlConfigFileCacheByIdTop) ) return __yamlConfigFileCacheById[aConfigFileId - 1];
+    return NULL;
 }
 
 //
@@ -367,11 +294,12 @@ yamlConfigFileCacheEnumerate(
 )
 {
     bool                            okay = true;
-    yamlConfigFileCacheLine         *cacheLine = __yamlConfigFileCacheHead;
+    unsigned int                    index = 0;
     
-    while ( okay && cacheLine ) {
-        okay = enumeratorFn(cacheLine->theConfigFile, context);
-        cacheLine = cacheLine->link;
+    while ( okay && (index < __yamlConfigFileCacheByIdTop) ) {
+        yamlConfigFileRef           theConfigFile = __yamlConfigFileCacheById[index++];
+        
+        if ( theConfigFile ) okay = enumeratorFn(theConfigFile, context);
     }
     return okay;
 }
@@ -383,22 +311,35 @@ yamlConfigFileCacheEvict(
     yamlConfigFileRef   aConfigFile
 )
 {
-    yamlConfigFileCacheLine         *cacheLine = __yamlConfigFileCacheHead, *prevCacheLine = NULL;
+    yamlConfigFileId    fileId = yamlConfigFileGetId(aConfigFile);
     
-    while ( cacheLine ) {
-        if ( cacheLine->theConfigFile == aConfigFile ) {
-            DEBUG_PRINTF("evicted yamlConfigFile@%p from yamlConfigFileCache", aConfigFile);
-            yamlConfigFileRelease(aConfigFile);
+    if ( (fileId != YAMLCONFIGFILE_UNCACHED_ID) && (fileId <= __yamlConfigFileCacheByIdTop) && (__yamlConfigFileCacheById[fileId - 1] == aConfigFile) ) {
+        const char                  *sourceFilePath = yamlConfigFileGetSourceFilePath(aConfigFile);
+        unsigned int                bucket = ( sourceFilePath ? __yamlConfigFileCachePathHash(sourceFilePath, false) : 0 ) & (__yamlConfigFileCacheByPathCapacity - 1);
+        yamlConfigFileCacheLine     *cacheLine = __yamlConfigFileCacheByPath[bucket], *prevCacheLine = NULL;
+        
+        // Drop from the path table:
+        while ( cacheLine && (cacheLine->theConfigFile != aConfigFile) ) {
+            prevCacheLine = cacheLine;
+            cacheLine = cacheLine->link;
+        }
+        if ( cacheLine ) {
             if ( prevCacheLine ) {
                 prevCacheLine->link = cacheLine->link;
             } else {
-                __yamlConfigFileCacheHead = cacheLine->link;
+                __yamlConfigFileCacheByPath[bucket] = cacheLine->link;
             }
             free((void*)cacheLine);
-            break;
         }
-        prevCacheLine = cacheLine;
-        cacheLine = cacheLine->link;
+        
+        // Drop from the id table:
+        __yamlConfigFileCacheById[fileId - 1] = NULL;
+        if ( fileId - 1 < __yamlConfigFileCacheByIdFreeHint ) __yamlConfigFileCacheByIdFreeHint = fileId - 1;
+        while ( (__yamlConfigFileCacheByIdTop > 0) && ! __yamlConfigFileCacheById[__yamlConfigFileCacheByIdTop - 1] ) __yamlConfigFileCacheByIdTop--;
+        __yamlConfigFileCacheCount--;
+        
+        DEBUG_PRINTF("evicted yamlConfigFile@%p from yamlConfigFileCache", aConfigFile);
+        yamlConfigFileRelease(aConfigFile);
     }
 }
 
@@ -407,18 +348,35 @@ yamlConfigFileCacheEvict(
 void
 yamlConfigFileCacheFlush()
 {
-    yamlConfigFileCacheLine         *cacheLine = __yamlConfigFileCacheHead;
+    unsigned int                    bucket = 0;
     
     DEBUG_PRINTF("flushing yamlConfigFileCache", NULL);
-    while ( cacheLine ) {
-        yamlConfigFileCacheLine     *nextCacheLine = cacheLine->link;
+    while ( bucket < __yamlConfigFileCacheByPathCapacity ) {
+        yamlConfigFileCacheLine     *cacheLine = __yamlConfigFileCacheByPath[bucket];
+        
+        while ( cacheLine ) {
+            yamlConfigFileCacheLine *nextCacheLine = cacheLine->link;
+            
+            free((void*)cacheLine);
+            cacheLine = nextCacheLine;
+        }
+        __yamlConfigFileCacheByPath[bucket++] = NULL;
+    }
+    // Release in ascending id order, as the cache has always done:
+    bucket = 0;
+    while ( bucket < __yamlConfigFileCacheByIdTop ) {
+        yamlConfigFileRef           theConfigFile = __yamlConfigFileCacheById[bucket];
         
-        DEBUG_PRINTF("  evicted yamlConfigFile@%p from yamlConfigFileCache", cacheLine->theConfigFile);
-        yamlConfigFileRelease(cacheLine->theConfigFile);
-        free((void*)cacheLine);
-        cacheLine = nextCacheLine;
+        if ( theConfigFile ) {
+            DEBUG_PRINTF("  evicted yamlConfigFile@%p from yamlConfigFileCache", theConfigFile);
+            __yamlConfigFileCacheById[bucket] = NULL;
+            yamlConfigFileRelease(theConfigFile);
+        }
+        bucket++;
     }
-    __yamlConfigFileCacheHead = NULL;
+    __yamlConfigFileCacheByIdTop = 0;
+    __yamlConfigFileCacheByIdFreeHint = 0;
+    __yamlConfigFileCacheCount = 0;
 }
 
 //
@@ -427,813 +385,2857 @@ yamlConfigFileCacheFlush()
 #endif
 //
 
-enum {
-    yamlConfigFileState_isDocumentParsed = 1 << 0
-};
+/*
+ * An input buffer holds the entire content of a file in memory so that
+ * libyaml can consume it as a string rather than through stdio.  Regular
+ * files are memory-mapped (with a sequential-access hint to the kernel);
+ * pipes, character devices and any file that cannot be mapped are pulled
+ * in with read(2).
+ */
 
-//
+#ifndef YAMLCONFIGFILE_INPUT_READ_BLOCKSIZE
+#define YAMLCONFIGFILE_INPUT_READ_BLOCKSIZE (1024 * 1024)
+#endif
 
-typedef struct __yamlConfigFile {
-    unsigned int        refCount;
-    yamlConfigFileId    fileId;
-    const char          *sourceFilePath;
-    yamlOptionsBitvec   options;
-    yamlOptionsBitvec   state;
-    yaml_document_t		document;
-    yamlKeyPathCacheRef keyPathCache;
-} yamlConfigFile;
+typedef struct {
+    const unsigned char     *bytes;
+    size_t                  length;
+    size_t                  mappedLength;
+    unsigned char           *ownedBytes;
+} yamlConfigFileInputBuffer;
 
 //
 
-yamlConfigFile*
-__yamlConfigFileAlloc(
-    const char          *sourceFilePath,
-    yamlOptionsBitvec   options
+bool
+__yamlConfigFileInputBufferInitWithFileDescriptor(
+    yamlConfigFileInputBuffer   *inputBuffer,
+    int                         fd
 )
 {
-    size_t              sourceFilePathLen = (sourceFilePath ? (strlen(sourceFilePath) + 1) : 0);
-    yamlConfigFile      *newConfigFile = calloc(1, sizeof(yamlConfigFile) + sourceFilePathLen);
+    struct stat                 finfo;
+    unsigned char               *buffer = NULL;
+    size_t                      bufferSize = 0, bufferLength = 0;
     
-    if ( newConfigFile ) {
-        newConfigFile->refCount = 1;
-        newConfigFile->fileId = YAMLCONFIGFILE_UNCACHED_ID;
-        newConfigFile->options = options;
-        if ( sourceFilePath ) {
-            newConfigFile->sourceFilePath = (void*)newConfigFile + sizeof(yamlConfigFile);
-            if ( options & yamlConfigFileOptions_caseFoldFilename ) {
-                size_t  i = 0;
-                
-                while ( sourceFilePath[i] ) {
-                    ((char*)newConfigFile->sourceFilePath)[i] = tolower(sourceFilePath[i]);
-                    i++;
-                }
-            } else {
-                strncpy((char*)newConfigFile->sourceFilePath, sourceFilePath, sourceFilePathLen);
+    inputBuffer->bytes = (const unsigned char*)"";
+    inputBuffer->length = inputBuffer->mappedLength = 0;
+    inputBuffer->ownedBytes = NULL;
+    
+    if ( fstat(fd, &finfo) != 0 ) return false;
+    
+#ifdef HAVE_MMAP
+    if ( S_ISREG(finfo.st_mode) ) {
+        if ( finfo.st_size == 0 ) return true;
+        if ( (uint64_t)finfo.st_size <= SIZE_MAX ) {
+            void                *mapping = mmap(NULL, (size_t)finfo.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            
+            if ( mapping != MAP_FAILED ) {
+# ifdef HAVE_MADVISE
+                madvise(mapping, (size_t)finfo.st_size, MADV_SEQUENTIAL);
+                madvise(mapping, (size_t)finfo.st_size, MADV_WILLNEED);
+# endif
+                inputBuffer->bytes = (const unsigned char*)mapping;
+                inputBuffer->length = inputBuffer->mappedLength = (size_t)finfo.st_size;
+                return true;
             }
         }
-        if ( ! (options & yamlConfigFileOptions_noKeyPathCache) ) newConfigFile->keyPathCache = yamlKeyPathCacheCreate(0, NULL);
-
-#ifdef YAMLCONFIGFILE_DEBUG
-        DEBUG_PRINTF("yamlConfigFile allocated:", NULL);
-        if ( sourceFilePath ) DEBUG_PRINTF("  sourceFilePath : \"%s\"", newConfigFile->sourceFilePath);
-        DEBUG_PRINTF("  options : %08x", newConfigFile->options);
-        if ( newConfigFile->keyPathCache ) DEBUG_PRINTF("  keyPathCache : %p", newConfigFile->keyPathCache);
-#endif
+        DEBUG_PRINTF("unable to mmap() file descriptor %d, falling back to read()", fd);
     }
-    return newConfigFile;
-}
-
-//
-
-yamlConfigFileRef
-__yamlConfigFileCreate(
-    FILE                *sourceFilePtr,
-    const char          *sourceFilePath,
-    yamlOptionsBitvec   options
-)
-{
-    yamlConfigFileRef   newConfigFile = NULL;
-    yaml_parser_t       parser;
-
-    // Initialize parser:
-    if ( yaml_parser_initialize(&parser) ) {
-        // Attach our input stream:
-        yaml_parser_set_input_file(&parser, sourceFilePtr);
+#endif
+    // Size the initial buffer from the file size if we have one:
+    if ( S_ISREG(finfo.st_mode) && (finfo.st_size > 0) ) bufferSize = (size_t)finfo.st_size + 1;
+    if ( bufferSize < YAMLCONFIGFILE_INPUT_READ_BLOCKSIZE ) bufferSize = YAMLCONFIGFILE_INPUT_READ_BLOCKSIZE;
+    
+    while ( 1 ) {
+        ssize_t                 nbytes;
         
-        newConfigFile = __yamlConfigFileAlloc(sourceFilePath, options);
-        if ( newConfigFile ) {
-            // Attempt to parse the document:
-            if ( yaml_parser_load(&parser, &newConfigFile->document) ) {
-                newConfigFile->state = yamlConfigFileState_isDocumentParsed;
-                
-                // Do we need to cache it?
-                if ( sourceFilePath && ! (options & yamlConfigFileOptions_doNotCache) ) {
-                    newConfigFile->fileId = __yamlConfigFileCacheAdd(newConfigFile);
-                    DEBUG_PRINTF("file \"%s\" cached with id %u", sourceFilePath, newConfigFile->fileId);
-                }
-            } else {
-                yamlConfigFileRelease(newConfigFile);
-                newConfigFile = NULL;
+        if ( bufferLength == bufferSize || ! buffer ) {
+            unsigned char       *newBuffer;
+            
+            if ( buffer ) bufferSize *= 2;
+            newBuffer = realloc(buffer, bufferSize);
+            if ( ! newBuffer ) {
+                if ( buffer ) free((void*)buffer);
+                return false;
             }
+            buffer = newBuffer;
         }
-        yaml_parser_delete(&parser);
+        nbytes = read(fd, buffer + bufferLength, bufferSize - bufferLength);
+        if ( nbytes < 0 ) {
+            if ( errno == EINTR ) continue;
+            free((void*)buffer);
+            return false;
+        }
+        if ( nbytes == 0 ) break;
+        bufferLength += nbytes;
     }
-    return newConfigFile;
+    inputBuffer->bytes = inputBuffer->ownedBytes = buffer;
+    inputBuffer->length = bufferLength;
+    return true;
 }
 
 //
 
-yamlConfigFileRef
-yamlConfigFileCreateWithInputString(
-    const char          *inputString,
-    size_t              inputStringLength,
-    yamlOptionsBitvec   options
+bool
+__yamlConfigFileInputBufferInitWithFileAtPath(
+    yamlConfigFileInputBuffer   *inputBuffer,
+    const char                  *sourceFilePath
 )
 {
-    yamlConfigFileRef   newConfigFile = NULL;
-    yaml_parser_t       parser;
-
-    // Initialize parser:
-    if ( yaml_parser_initialize(&parser) ) {
-        // Attach our input string:
-        if ( inputStringLength == yamlCStringFullLength ) inputStringLength = strlen(inputString);
-        yaml_parser_set_input_string(&parser, (const unsigned char*)inputString, inputStringLength);
-        
-        newConfigFile = __yamlConfigFileAlloc(NULL, options | yamlConfigFileOptions_doNotCache);
-        if ( newConfigFile ) {
-            // Attempt to parse the document:
-            if ( yaml_parser_load(&parser, &newConfigFile->document) ) {
-                newConfigFile->state = yamlConfigFileState_isDocumentParsed;
-            } else {
-                yamlConfigFileRelease(newConfigFile);
-                newConfigFile = NULL;
-            }
-        }
-        yaml_parser_delete(&parser);
+    int                         fd = open(sourceFilePath, O_RDONLY);
+    bool                        okay = false;
+    
+    if ( fd >= 0 ) {
+        okay = __yamlConfigFileInputBufferInitWithFileDescriptor(inputBuffer, fd);
+        close(fd);
     }
-    return newConfigFile;
+    return okay;
 }
 
 //
 
-yamlConfigFileRef
-yamlConfigFileCreateWithFilePointer(
-    FILE                *sourceFilePtr,
-    yamlOptionsBitvec   options
+bool
+__yamlConfigFileSnapshotSourceInitWithStat(
+    yamlConfigFileSnapshotSource    *source,
+    const struct stat               *finfo
 )
 {
-    return __yamlConfigFileCreate(sourceFilePtr, NULL, options | yamlConfigFileOptions_doNotCache);
+    // Only regular files have a stable identity:
+    if ( ! S_ISREG(finfo->st_mode) ) return false;
+    memset(source, 0, sizeof(*source));
+    source->size = (uint64_t)finfo->st_size;
+    source->modificationSeconds = (int64_t)finfo->st_mtime;
+#if defined(HAVE_STRUCT_STAT_ST_MTIM)
+    source->modificationNanoseconds = (uint32_t)finfo->st_mtim.tv_nsec;
+#elif defined(HAVE_STRUCT_STAT_ST_MTIMESPEC)
+    source->modificationNanoseconds = (uint32_t)finfo->st_mtimespec.tv_nsec;
+#endif
+    return true;
 }
 
 //
 
-yamlConfigFileRef
-yamlConfigFileCreateWithFileAtPath(
-    const char          *sourceFilePath,
-    yamlOptionsBitvec   options
+bool
+__yamlConfigFileSnapshotSourceInitWithFileAtPath(
+    yamlConfigFileSnapshotSource    *source,
+    const char                      *sourceFilePath
 )
 {
-    yamlConfigFileRef   newConfigFile = NULL;
+    struct stat                     finfo;
     
-    if ( ! (options & yamlConfigFileOptions_ignoreCachedCopy) ) {
-        newConfigFile = __yamlConfigFileCacheLookup(sourceFilePath, options);
-        if ( newConfigFile ) {
-            newConfigFile = yamlConfigFileRetain(newConfigFile);
-            DEBUG_PRINTF("cached file found for \"%s\" (%p)", sourceFilePath, newConfigFile);
-        }
-    }
-    if ( ! newConfigFile ) {
-        FILE            *sourceFilePtr = fopen(sourceFilePath, "r");
-        
-        if ( sourceFilePtr ) {
-            newConfigFile = __yamlConfigFileCreate(sourceFilePtr, sourceFilePath, options);
-            fclose(sourceFilePtr);
-        }
-    }
-    return newConfigFile;
+    return ( (stat(sourceFilePath, &finfo) == 0) && __yamlConfigFileSnapshotSourceInitWithStat(source, &finfo) );
 }
 
 //
 
-unsigned int
-yamlConfigFileGetRefCount(
-    yamlConfigFileRef   aConfigFile
+void
+__yamlConfigFileInputBufferDestroy(
+    yamlConfigFileInputBuffer   *inputBuffer
 )
 {
-    return aConfigFile->refCount;
+#ifdef HAVE_MMAP
+    if ( inputBuffer->mappedLength ) {
+        munmap((void*)inputBuffer->bytes, inputBuffer->mappedLength);
+    }
+#endif
+    if ( inputBuffer->ownedBytes ) free((void*)inputBuffer->ownedBytes);
+    inputBuffer->bytes = (const unsigned char*)"";
+    inputBuffer->length = inputBuffer->mappedLength = 0;
+    inputBuffer->ownedBytes = NULL;
 }
 
 //
 
-yamlConfigFileRef
-yamlConfigFileRetain(
-    yamlConfigFileRef   aConfigFile
+void
+__yamlConfigFileInputBufferReleaseConsumed(
+    yamlConfigFileInputBuffer   *inputBuffer,
+    const unsigned char         *consumedTo,
+    size_t                      *releasedLength
 )
 {
-    aConfigFile->refCount++;
-    return aConfigFile;
+#if defined(HAVE_MMAP) && defined(HAVE_MADVISE)
+    // Drop mapped pages a parser has already consumed so a long input does
+    // not stay resident:
+    if ( inputBuffer->mappedLength ) {
+        size_t                  pageSize = (size_t)sysconf(_SC_PAGESIZE);
+        size_t                  consumed = consumedTo - inputBuffer->bytes;
+        
+        consumed -= consumed % pageSize;
+        if ( consumed > *releasedLength ) {
+            madvise((void*)(inputBuffer->bytes + *releasedLength), consumed - *releasedLength, MADV_DONTNEED);
+            *releasedLength = consumed;
+        }
+    }
+#endif
 }
 
+//
+#if 0
+#pragma mark -
+#endif
 //
 
-void
-yamlConfigFileRelease(
-    yamlConfigFileRef   aConfigFile
+/*
+ * Document boundaries in a YAML stream can be found without parsing:  the
+ * markers "---" and "..." at the start of a line (followed by whitespace or
+ * the end of the line) are forbidden inside any scalar, so they always
+ * delimit documents.  Directives ("%" lines) following the end of a document
+ * belong to the next one, as does the first content line of a bare
+ * document.  The resulting offsets are the start of each document plus a
+ * final entry holding the length of the stream.
+ */
+
+#ifndef YAMLCONFIGFILE_DOCUMENT_CACHE_DEFAULT_CAPACITY
+#define YAMLCONFIGFILE_DOCUMENT_CACHE_DEFAULT_CAPACITY 16
+#endif
+
+typedef struct {
+    unsigned int        documentIndex;
+    yamlConfigFileRef   document;
+    uint64_t            lastUse;
+} yamlConfigFileDocumentCacheEntry;
+
+typedef struct {
+    yamlConfigFileInputBuffer           inputBuffer;
+    unsigned int                        documentCount;
+    size_t                              *documentOffsets;
+    unsigned int                        cacheCapacity;
+    yamlConfigFileDocumentCacheEntry    *cache;
+    uint64_t                            useClock;
+} yamlConfigFileDocumentIndex;
+
+//
+
+static inline bool
+__yamlConfigFileIsDocumentMarker(
+    const unsigned char     *line,
+    const unsigned char     *lineEnd,
+    unsigned char           markerChar
 )
 {
-    if ( --aConfigFile->refCount == 0 ) {
-        DEBUG_PRINTF("closing yamlConfigFile@%p (path \"%s\")", aConfigFile, aConfigFile->sourceFilePath ? aConfigFile->sourceFilePath : "<n/a>", aConfigFile);
-        if ( aConfigFile->keyPathCache ) yamlKeyPathCacheRelease(aConfigFile->keyPathCache);
-        if ( aConfigFile->state & yamlConfigFileState_isDocumentParsed ) yaml_document_delete(&aConfigFile->document);
-        free((void*)aConfigFile);
+    if ( (lineEnd - line < 3) || (line[0] != markerChar) || (line[1] != markerChar) || (line[2] != markerChar) ) return false;
+    return ( (lineEnd - line == 3) || (line[3] == ' ') || (line[3] == '\t') || (line[3] == '\r') );
+}
+
+//
+
+bool
+__yamlConfigFileScanDocumentBoundaries(
+    const unsigned char     *bytes,
+    size_t                  length,
+    size_t*                 *outOffsets,
+    unsigned int            *outCount
+)
+{
+    const unsigned char     *p = bytes, *end = bytes + length;
+    size_t                  *offsets = NULL, pendingStart = SIZE_MAX;
+    unsigned int            count = 0, capacity = 0;
+    bool                    isDocumentOpen = false;
+    
+    // Skip a UTF-8 byte order mark:
+    if ( (length >= 3) && (p[0] == 0xEF) && (p[1] == 0xBB) && (p[2] == 0xBF) ) p += 3;
+    while ( p < end ) {
+        const unsigned char *lineEnd = memchr(p, '\n', end - p);
+        size_t              lineOffset = p - bytes;
+        bool                isDocumentStart = false;
+        
+        if ( ! lineEnd ) lineEnd = end;
+        if ( __yamlConfigFileIsDocumentMarker(p, lineEnd, '-') ) {
+            isDocumentStart = true;
+        }
+        else if ( __yamlConfigFileIsDocumentMarker(p, lineEnd, '.') ) {
+            isDocumentOpen = false;
+            pendingStart = SIZE_MAX;
+        }
+        else if ( ! isDocumentOpen ) {
+            const unsigned char *q = p;
+            
+            while ( (q < lineEnd) && ((*q == ' ') || (*q == '\t')) ) q++;
+            if ( (q < lineEnd) && (*q != '#') && (*q != '\r') ) {
+                if ( *p == '%' ) {
+                    if ( pendingStart == SIZE_MAX ) pendingStart = lineOffset;
+                } else {
+                    isDocumentStart = true;
+                }
+            }
+        }
+        if ( isDocumentStart ) {
+            if ( count + 1 >= capacity ) {
+                unsigned int    newCapacity = capacity ? 2 * capacity : 64;
+                size_t          *newOffsets = realloc(offsets, newCapacity * sizeof(size_t));
+                
+                if ( ! newOffsets ) {
+                    if ( offsets ) free((void*)offsets);
+                    return false;
+                }
+                offsets = newOffsets;
+                capacity = newCapacity;
+            }
+            offsets[count++] = ( pendingStart == SIZE_MAX ) ? lineOffset : pendingStart;
+            pendingStart = SIZE_MAX;
+            isDocumentOpen = true;
+        }
+        p = lineEnd + 1;
     }
+    if ( ! offsets && ! (offsets = malloc(sizeof(size_t))) ) return false;
+    offsets[count] = length;
+    *outOffsets = offsets;
+    *outCount = count;
+    return true;
 }
 
 //
 
-yamlConfigFileId
-yamlConfigFileGetId(
-    yamlConfigFileRef   aConfigFile
+yamlConfigFileDocumentIndex*
+__yamlConfigFileDocumentIndexCreate(
+    yamlConfigFileInputBuffer   *inputBuffer
 )
 {
-    return aConfigFile->fileId;
+    yamlConfigFileDocumentIndex *newIndex;
+    
+    // The boundaries of the documents in compressed input cannot be found
+    // without decompressing all of it:
+    if ( __yamlConfigFileDecompressorIsCompressed(inputBuffer->bytes, inputBuffer->length) ) return NULL;
+    
+    if ( (newIndex = calloc(1, sizeof(yamlConfigFileDocumentIndex))) ) {
+        if ( ! __yamlConfigFileScanDocumentBoundaries(inputBuffer->bytes, inputBuffer->length, &newIndex->documentOffsets, &newIndex->documentCount) ) {
+            free((void*)newIndex);
+            return NULL;
+        }
+        newIndex->cacheCapacity = YAMLCONFIGFILE_DOCUMENT_CACHE_DEFAULT_CAPACITY;
+        newIndex->cache = calloc(newIndex->cacheCapacity, sizeof(yamlConfigFileDocumentCacheEntry));
+        if ( ! newIndex->cache ) {
+            free((void*)newIndex->documentOffsets);
+            free((void*)newIndex);
+            return NULL;
+        }
+        // The index takes over the input buffer:
+        newIndex->inputBuffer = *inputBuffer;
+        DEBUG_PRINTF("document index created with %u document(s)", newIndex->documentCount);
+    }
+    return newIndex;
 }
 
 //
 
-const char*
-yamlConfigFileGetSourceFilePath(
-    yamlConfigFileRef   aConfigFile
+void
+__yamlConfigFileDocumentIndexDestroy(
+    yamlConfigFileDocumentIndex *anIndex
 )
 {
-    return aConfigFile->sourceFilePath;
+    unsigned int                i;
+    
+    for ( i = 0; i < anIndex->cacheCapacity; i++ ) {
+        if ( anIndex->cache[i].document ) yamlConfigFileRelease(anIndex->cache[i].document);
+    }
+    if ( anIndex->cache ) free((void*)anIndex->cache);
+    free((void*)anIndex->documentOffsets);
+    __yamlConfigFileInputBufferDestroy(&anIndex->inputBuffer);
+    free((void*)anIndex);
 }
 
+//
+#if 0
+#pragma mark -
+#endif
 //
 
-yaml_node_t*
-yamlConfigFileGetRootNode(
-    yamlConfigFileRef   aConfigFile
+/*
+ * A document whose root is a block mapping with plain top-level keys can be
+ * split into byte ranges, one per top-level key, with a line-oriented
+ * pre-scan:  a new entry starts on any line that begins in column zero
+ * outside of a quoted scalar, flow collection or block scalar (other than a
+ * "- " sequence entry or comment).  Anything the scan does not understand
+ * makes the document ineligible and it is parsed in full as usual.
+ *
+ * Entries of at least YAMLCONFIGFILE_LAZY_SUBTREE_MINIMUM_SIZE bytes are
+ * replaced by a null placeholder in a skeleton of the document that is
+ * parsed up front; each is parsed into a document of its own the first
+ * time a key path descends into it.
+ */
+
+#ifndef YAMLCONFIGFILE_LAZY_SUBTREE_MINIMUM_SIZE
+#define YAMLCONFIGFILE_LAZY_SUBTREE_MINIMUM_SIZE 4096
+#endif
+
+typedef struct {
+    size_t                      start, keyEnd, end;
+    bool                        isLazy;
+    bool                        hasOwnDocument;
+    yaml_document_t             ownDocument;
+    yaml_document_t             *document;
+    yaml_node_t                 *valueNode;
+    yamlKeyPathMappingIndexRef  mappingIndex;
+} yamlConfigFileLazySubtree;
+
+typedef struct {
+    yamlConfigFileInputBuffer   inputBuffer;
+    unsigned int                subtreeCount;
+    yamlConfigFileLazySubtree   *subtrees;
+    bool                        hasFullDocument;
+    yaml_document_t             fullDocument;
+    yamlKeyPathMappingIndexRef  fullMappingIndex;
+} yamlConfigFileLazyState;
+
+//
+
+typedef struct {
+    unsigned char               quoteChar;
+    unsigned int                flowDepth;
+    int                         blockScalarIndent;
+} yamlConfigFileScanState;
+
+//
+
+static inline bool
+__yamlConfigFileScanIsBreak(
+    const unsigned char         *p,
+    const unsigned char         *lineEnd
 )
 {
-    return ( (aConfigFile->state & yamlConfigFileState_isDocumentParsed) ? yaml_document_get_root_node(&aConfigFile->document) : NULL );
+    return ( (p >= lineEnd) || (*p == ' ') || (*p == '\t') || (*p == '\r') );
 }
 
 //
 
-yaml_node_t*
-yamlConfigFileGetNodeAtPath(
-    yamlConfigFileRef           aConfigFile,
-    yamlKeyPathRef              theKeyPath,
-    yaml_node_t                 *relativeToNode,
-    yamlErrorCode               *outError,
-    yamlKeyPathNodeMatchType*   *failedAtMatchElement
+void
+__yamlConfigFileScanLineTail(
+    yamlConfigFileScanState     *state,
+    const unsigned char         *p,
+    const unsigned char         *lineEnd,
+    int                         lineIndent,
+    bool                        canStartScalar
 )
 {
-    yaml_node_t                 *outNode = NULL;
-    
-    if ( outError ) *outError = 0;
-    if ( failedAtMatchElement ) *failedAtMatchElement = NULL;
+    const unsigned char         *lineStart = p;
     
-    // Do we have a key path cache?
-    if ( aConfigFile->keyPathCache ) {
-        if ( yamlKeyPathCacheLookup(aConfigFile->keyPathCache, theKeyPath, (const void**)&outNode) ) {
-            DEBUG_PRINTF("cached yaml_node_t@%p found for yamlKeyPath@%p", outNode, theKeyPath);
-            return outNode;
+    while ( p < lineEnd ) {
+        unsigned char           c = *p;
+        
+        if ( state->quoteChar == '"' ) {
+            if ( c == '\\' ) p++;
+            else if ( c == '"' ) state->quoteChar = 0;
+            p++;
+            continue;
+        }
+        if ( state->quoteChar == '\'' ) {
+            if ( c == '\'' ) {
+                if ( (p + 1 < lineEnd) && (p[1] == '\'') ) p++;
+                else state->quoteChar = 0;
+            }
+            p++;
+            continue;
+        }
+        switch ( c ) {
+            case ' ':
+            case '\t':
+            case '\r':
+                break;
+            case '#':
+                if ( (p == lineStart) || (p[-1] == ' ') || (p[-1] == '\t') ) return;
+                canStartScalar = false;
+                break;
+            case '"':
+            case '\'':
+                if ( canStartScalar ) state->quoteChar = c;
+                canStartScalar = false;
+                break;
+            case '|':
+            case '>':
+                if ( canStartScalar && ! state->flowDepth ) {
+                    state->blockScalarIndent = lineIndent;
+                    return;
+                }
+                canStartScalar = false;
+                break;
+            case '[':
+            case '{':
+                if ( canStartScalar || state->flowDepth ) {
+                    state->flowDepth++;
+                    canStartScalar = true;
+                } else {
+                    canStartScalar = false;
+                }
+                break;
+            case ']':
+            case '}':
+                if ( state->flowDepth ) state->flowDepth--;
+                canStartScalar = false;
+                break;
+            case ',':
+                canStartScalar = ( state->flowDepth > 0 );
+                break;
+            case ':':
+            case '-':
+            case '?':
+                if ( __yamlConfigFileScanIsBreak(p + 1, lineEnd) || ((c == ':') && state->flowDepth) ) {
+                    canStartScalar = true;
+                } else {
+                    canStartScalar = false;
+                }
+                break;
+            case '&':
+            case '!':
+                // Node properties precede the scalar they apply to:
+                if ( canStartScalar ) {
+                    while ( ! __yamlConfigFileScanIsBreak(p + 1, lineEnd) ) p++;
+                    break;
+                }
+                canStartScalar = false;
+                break;
+            default:
+                canStartScalar = false;
+                break;
         }
+        p++;
     }
-    // Use the key path to walk to the node:
-    outNode = yamlKeyPathApplyToDocument(
-                    theKeyPath,
-                    YAMLCONFIGFILEOPTIONS_KEYPATHOPTIONS(aConfigFile->options),
-                    &aConfigFile->document,
-                    relativeToNode,
-                    outError,
-                    failedAtMatchElement
-                );
-    if ( outNode && aConfigFile->keyPathCache ) yamlKeyPathCacheAdd(aConfigFile->keyPathCache, theKeyPath, outNode);
-    return outNode;
 }
 
 //
 
 bool
-yamlConfigFileGetNodeAtPathIsType(
-    yamlConfigFileRef           aConfigFile,
-    yamlKeyPathRef              theKeyPath,
-    yaml_node_t                 *relativeToNode,
-    yamlErrorCode               *outError,
-    yamlKeyPathNodeMatchType*   *failedAtMatchElement,
-    yaml_node_type_t            yamlNodeType
+__yamlConfigFileScanTopLevelEntries(
+    const unsigned char         *bytes,
+    size_t                      length,
+    yamlConfigFileLazySubtree*  *outSubtrees,
+    unsigned int                *outCount
 )
 {
-    bool                        success = false;
-    yaml_node_t                 *targetNode = yamlConfigFileGetNodeAtPath(aConfigFile, theKeyPath, relativeToNode, outError, failedAtMatchElement);
+    const unsigned char         *p = bytes, *end = bytes + length;
+    yamlConfigFileScanState     state = { 0, 0, -1 };
+    yamlConfigFileLazySubtree   *subtrees = NULL;
+    unsigned int                count = 0, capacity = 0;
+    bool                        hasSeenContent = false;
     
-    if ( targetNode ) {
-        if ( targetNode->type == yamlNodeType ) {
-            success = true;
-        } else {
-            if ( outError ) *outError = yamlConfigFileError_invalidType;
+    if ( (length >= 3) && (p[0] == 0xEF) && (p[1] == 0xBB) && (p[2] == 0xBF) ) p += 3;
+    while ( p < end ) {
+        const unsigned char     *lineEnd = memchr(p, '\n', end - p);
+        const unsigned char     *q = p;
+        int                     indent;
+        
+        if ( ! lineEnd ) lineEnd = end;
+        while ( (q < lineEnd) && (*q == ' ') ) q++;
+        indent = q - p;
+        
+        if ( state.blockScalarIndent >= 0 ) {
+            const unsigned char *r = q;
+            
+            while ( (r < lineEnd) && ((*r == '\t') || (*r == '\r')) ) r++;
+            if ( (r == lineEnd) || (indent > state.blockScalarIndent) ) {
+                p = lineEnd + 1;
+                continue;
+            }
+            state.blockScalarIndent = -1;
+        }
+        if ( ! state.quoteChar && ! state.flowDepth && ((q == lineEnd) || (*q == '#') || (*q == '\r')) ) {
+            // Blank and comment lines are neutral:
+            p = lineEnd + 1;
+            continue;
+        }
+        if ( state.quoteChar || state.flowDepth || (indent > 0) ) {
+            // Continuation of the current entry:
+            if ( ! count ) goto notEligible;
+            __yamlConfigFileScanLineTail(&state, q, lineEnd, indent, ! state.quoteChar && ! state.flowDepth);
+        }
+        else if ( __yamlConfigFileIsDocumentMarker(p, lineEnd, '-') ) {
+            // Only an explicit start of the (sole) document is permitted:
+            const unsigned char *r = p + 3;
+            
+            if ( hasSeenContent ) goto notEligible;
+            while ( (r < lineEnd) && ((*r == ' ') || (*r == '\t') || (*r == '\r')) ) r++;
+            if ( (r < lineEnd) && (*r != '#') ) goto notEligible;
+        }
+        else if ( (*p == '-') && __yamlConfigFileScanIsBreak(p + 1, lineEnd) ) {
+            // A block sequence may sit in column zero under its key:
+            if ( ! count ) goto notEligible;
+            __yamlConfigFileScanLineTail(&state, p, lineEnd, 0, true);
+        }
+        else {
+            const unsigned char *r = p;
+            
+            if ( strchr("-?:,[]{}#&*!|>'\"%@`", *p) || __yamlConfigFileIsDocumentMarker(p, lineEnd, '.') ) goto notEligible;
+            while ( (r < lineEnd) && ! ((*r == ':') && __yamlConfigFileScanIsBreak(r + 1, lineEnd)) ) {
+                if ( (*r == '#') && ((r[-1] == ' ') || (r[-1] == '\t')) ) goto notEligible;
+                r++;
+            }
+            if ( r == lineEnd ) goto notEligible;
+            
+            if ( count == capacity ) {
+                unsigned int                newCapacity = capacity ? 2 * capacity : 16;
+                yamlConfigFileLazySubtree   *newSubtrees = realloc(subtrees, newCapacity * sizeof(yamlConfigFileLazySubtree));
+                
+                if ( ! newSubtrees ) goto notEligible;
+                subtrees = newSubtrees;
+                capacity = newCapacity;
+            }
+            if ( count ) subtrees[count - 1].end = p - bytes;
+            memset(&subtrees[count], 0, sizeof(yamlConfigFileLazySubtree));
+            subtrees[count].start = p - bytes;
+            subtrees[count].keyEnd = r - bytes;
+            count++;
+            __yamlConfigFileScanLineTail(&state, r + 1, lineEnd, 0, true);
         }
+        hasSeenContent = true;
+        p = lineEnd + 1;
     }
-    return success;
+    if ( ! count || state.quoteChar || state.flowDepth ) goto notEligible;
+    subtrees[count - 1].end = length;
+    *outSubtrees = subtrees;
+    *outCount = count;
+    return true;
+
+notEligible:
+    if ( subtrees ) free((void*)subtrees);
+    return false;
 }
 
 //
 
-bool
-yamlConfigFileGetNodeAtPathContentString(
-    yamlConfigFileRef           aConfigFile,
-    yamlKeyPathRef              theKeyPath,
-    yaml_node_t                 *relativeToNode,
-    yamlErrorCode               *outError,
-    yamlKeyPathNodeMatchType*   *failedAtMatchElement,
-    const char*                 *contentString,
-    size_t                      *contentStringLength
+void
+__yamlConfigFileLazyStateDestroy(
+    yamlConfigFileLazyState     *lazyState
 )
 {
-    bool                        success = false;
-    yaml_node_t                 *targetNode = yamlConfigFileGetNodeAtPath(aConfigFile, theKeyPath, relativeToNode, outError, failedAtMatchElement);
+    unsigned int                i;
     
-    if ( targetNode ) {
-        if ( targetNode->type == YAML_SCALAR_NODE ) {
-            *contentString = (const char*)targetNode->data.scalar.value;
-            *contentStringLength = targetNode->data.scalar.length;
-            success = true;
-        } else {
-            if ( outError ) *outError = yamlConfigFileError_invalidType;
-        }
+    for ( i = 0; i < lazyState->subtreeCount; i++ ) {
+        yamlConfigFileLazySubtree   *subtree = &lazyState->subtrees[i];
+        
+        if ( subtree->mappingIndex ) yamlKeyPathMappingIndexRelease(subtree->mappingIndex);
+        if ( subtree->hasOwnDocument ) yaml_document_delete(&subtree->ownDocument);
     }
-    return success;
+    if ( lazyState->fullMappingIndex ) yamlKeyPathMappingIndexRelease(lazyState->fullMappingIndex);
+    if ( lazyState->hasFullDocument ) yaml_document_delete(&lazyState->fullDocument);
+    free((void*)lazyState->subtrees);
+    __yamlConfigFileInputBufferDestroy(&lazyState->inputBuffer);
+    free((void*)lazyState);
 }
 
 //
 
 bool
-yamlConfigFileGetNodeAtPathSequenceLength(
-    yamlConfigFileRef           aConfigFile,
-    yamlKeyPathRef              theKeyPath,
-    yaml_node_t                 *relativeToNode,
-    yamlErrorCode               *outError,
-    yamlKeyPathNodeMatchType*   *failedAtMatchElement,
-    unsigned int                *sequenceLength
+__yamlConfigFileLazyStateLoadFullDocument(
+    yamlConfigFileLazyState     *lazyState
 )
 {
-    bool                        success = false;
-    yaml_node_t                 *targetNode = yamlConfigFileGetNodeAtPath(aConfigFile, theKeyPath, relativeToNode, outError, failedAtMatchElement);
+    yaml_parser_t               parser;
     
-    if ( targetNode ) {
-        if ( targetNode->type == YAML_SEQUENCE_NODE ) {
-            *sequenceLength = targetNode->data.sequence.items.top - targetNode->data.sequence.items.start;
-            success = true;
-        } else {
-            if ( outError ) *outError = yamlConfigFileError_invalidType;
-        }
+    if ( ! lazyState->hasFullDocument ) {
+        if ( ! yaml_parser_initialize(&parser) ) return false;
+        yaml_parser_set_input_string(&parser, lazyState->inputBuffer.bytes, lazyState->inputBuffer.length);
+        lazyState->hasFullDocument = yaml_parser_load(&parser, &lazyState->fullDocument);
+        yaml_parser_delete(&parser);
     }
-    return success;
+    return lazyState->hasFullDocument;
 }
 
+//
+#if 0
+#pragma mark -
+#endif
 //
 
-bool
-yamlConfigFileGetNodeAtPathMappingKeyCount(
-    yamlConfigFileRef           aConfigFile,
-    yamlKeyPathRef              theKeyPath,
-    yaml_node_t                 *relativeToNode,
-    yamlErrorCode               *outError,
-    yamlKeyPathNodeMatchType*   *failedAtMatchElement,
-    unsigned int                *mappingKeyCount
+/*
+ * A parallel load splits a block-mapping document into runs of top-level
+ * entries (found by the same pre-scan as lazy subtrees, which finds line
+ * breaks with memchr()), composes each run on its own thread, and stitches
+ * the resulting documents into one:  the nodes of every later chunk are
+ * renumbered past those already present (each chunk's root mapping is
+ * dropped), their marks are shifted by the characters and lines that
+ * precede the chunk, and the pairs of its root mapping are appended to the
+ * root of the first chunk.  If any chunk cannot be parsed on its own (e.g. it
+ * contains an alias to an anchor in another chunk) or does not yield
+ * exactly the entries the pre-scan found, the caller falls back to the
+ * serial parser.
+ */
+
+#ifndef YAMLCONFIGFILE_PARALLEL_LOAD_MINIMUM_CHUNK_SIZE
+#define YAMLCONFIGFILE_PARALLEL_LOAD_MINIMUM_CHUNK_SIZE (1024 * 1024)
+#endif
+
+static unsigned int __yamlConfigFileParallelLoadThreadCount = 0;
+
+typedef struct {
+    const unsigned char         *bytes;
+    size_t                      length;
+    unsigned int                entryCount;
+    bool                        isParsed;
+    bool                        isValid;
+    yaml_document_t             document;
+} yamlConfigFileParallelChunk;
+
+//
+
+void*
+__yamlConfigFileParallelChunkParse(
+    void                        *context
 )
 {
-    bool                        success = false;
-    yaml_node_t                 *targetNode = yamlConfigFileGetNodeAtPath(aConfigFile, theKeyPath, relativeToNode, outError, failedAtMatchElement);
+    yamlConfigFileParallelChunk *chunk = (yamlConfigFileParallelChunk*)context;
+    yaml_parser_t               parser;
     
-    if ( targetNode ) {
-        if ( targetNode->type == YAML_MAPPING_NODE ) {
-            *mappingKeyCount = targetNode->data.mapping.pairs.top - targetNode->data.mapping.pairs.start;
-            success = true;
-        } else {
-            if ( outError ) *outError = yamlConfigFileError_invalidType;
+    if ( yaml_parser_initialize(&parser) ) {
+        yaml_parser_set_input_string(&parser, chunk->bytes, chunk->length);
+        if ( yaml_parser_load(&parser, &chunk->document) ) {
+            yaml_node_t         *rootNode = yaml_document_get_root_node(&chunk->document);
+            
+            chunk->isParsed = true;
+            chunk->isValid = ( rootNode && (rootNode->type == YAML_MAPPING_NODE) && (rootNode->data.mapping.pairs.top - rootNode->data.mapping.pairs.start == chunk->entryCount) );
         }
+        yaml_parser_delete(&parser);
     }
-    return success;
+    return NULL;
 }
 
 //
 
-bool
-yamlConfigFileGetNodeAtPathMappingOrSequenceLength(
-    yamlConfigFileRef           aConfigFile,
-    yamlKeyPathRef              theKeyPath,
-    yaml_node_t                 *relativeToNode,
-    yamlErrorCode               *outError,
-    yamlKeyPathNodeMatchType*   *failedAtMatchElement,
-    unsigned int                *sequenceOrMappingLength
+static void
+__yamlConfigFileParallelChunkAdvanceMark(
+    yaml_mark_t                 *aMark,
+    const unsigned char         *bytes,
+    size_t                      length
 )
 {
-    bool                        success = false;
-    yaml_node_t                 *targetNode = yamlConfigFileGetNodeAtPath(aConfigFile, theKeyPath, relativeToNode, outError, failedAtMatchElement);
+    const unsigned char         *end = bytes + length;
     
-    if ( targetNode ) {
-        switch ( targetNode->type ) {
-            case YAML_SEQUENCE_NODE: {
-                *sequenceOrMappingLength = targetNode->data.sequence.items.top - targetNode->data.sequence.items.start;
-                success = true;
-                break;
-            }
-            case  YAML_MAPPING_NODE: {
-                *sequenceOrMappingLength = targetNode->data.mapping.pairs.top - targetNode->data.mapping.pairs.start;
-                success = true;
-                break;
-            }
-            default:
-                if ( outError ) *outError = yamlConfigFileError_invalidType;
-                break;
+    // Marks count characters rather than bytes, and every line break
+    // libyaml recognizes (CR LF, LF, CR, NEL, LS, PS) starts a new line:
+    while ( bytes < end ) {
+        unsigned char           c = *bytes++;
+        
+        if ( (c & 0xC0) != 0x80 ) aMark->index++;
+        if ( (c == '\n') || ((c == '\r') && ((bytes == end) || (*bytes != '\n'))) ) {
+            aMark->line++;
+        } else if ( (c == 0xC2) && (bytes < end) && (*bytes == 0x85) ) {
+            aMark->line++;
+        } else if ( (c == 0xE2) && (end - bytes >= 2) && (bytes[0] == 0x80) && ((bytes[1] == 0xA8) || (bytes[1] == 0xA9)) ) {
+            aMark->line++;
         }
     }
-    return success;
 }
 
 //
 
 bool
-__yamlConfigFileCoerceScalar(
-    yamlConfigFileRef           aConfigFile,
-    yamlKeyPathRef              theKeyPath,
-    yaml_node_t                 *relativeToNode,
-    yamlErrorCode               *outError,
-    yamlKeyPathNodeMatchType*   *failedAtMatchElement,
-    yamlConfigFileCoerceToType  coerceToType,
-    va_list                     vargs
+__yamlConfigFileParallelChunksStitch(
+    yamlConfigFileParallelChunk *chunks,
+    unsigned int                chunkCount,
+    yaml_document_t             *outDocument
 )
 {
-    yaml_node_t                 *targetNode = yamlConfigFileGetNodeAtPath(aConfigFile, theKeyPath, relativeToNode, outError, failedAtMatchElement);
+    yaml_document_t             *mergedDocument = &chunks[0].document;
+    yaml_node_t                 *newNodes, *rootNode;
+    yaml_node_pair_t            *newPairs;
+    yaml_mark_t                 chunkMark = { 0, 0, 0 };
+    size_t                      nodeCount = mergedDocument->nodes.top - mergedDocument->nodes.start;
+    size_t                      pairCount = mergedDocument->nodes.start->data.mapping.pairs.top - mergedDocument->nodes.start->data.mapping.pairs.start;
+    unsigned int                i;
     
-    if ( targetNode ) {
-        if ( targetNode->type == YAML_SCALAR_NODE ) {
-            switch ( coerceToType ) {
-                
-                case yamlConfigFileCoerceToType_cstring: {
-                    char            *buffer = va_arg(vargs, char*);
-                    size_t          *bufferLen = va_arg(vargs, size_t*);
-                    
-                    if ( bufferLen ) {
-                        size_t      copyLen = *bufferLen;
-                        
-                        if ( buffer && copyLen ) {
-                            if ( targetNode->data.scalar.length < copyLen ) {
-                                memcpy(buffer, targetNode->data.scalar.value, targetNode->data.scalar.length);
-                                buffer[targetNode->data.scalar.length] = '\0';
-                            } else {
-                                strncpy(buffer, (const char*)targetNode->data.scalar.value, copyLen);
-                            }
-                        }
-                        *bufferLen = targetNode->data.scalar.length;
-                    }
-                    return true;
-                }
+    for ( i = 1; i < chunkCount; i++ ) {
+        nodeCount += (chunks[i].document.nodes.top - chunks[i].document.nodes.start) - 1;
+        pairCount += chunks[i].entryCount;
+    }
+    if ( nodeCount > INT_MAX ) return false;
+    
+    // Grow the first chunk's node stack and root mapping to hold everything
+    // (libyaml frees both with free()):
+    if ( ! (newNodes = realloc(mergedDocument->nodes.start, nodeCount * sizeof(yaml_node_t))) ) return false;
+    mergedDocument->nodes.top = newNodes + (mergedDocument->nodes.top - mergedDocument->nodes.start);
+    mergedDocument->nodes.start = newNodes;
+    mergedDocument->nodes.end = newNodes + nodeCount;
+    rootNode = mergedDocument->nodes.start;
+    if ( ! (newPairs = realloc(rootNode->data.mapping.pairs.start, pairCount * sizeof(yaml_node_pair_t))) ) return false;
+    rootNode->data.mapping.pairs.top = newPairs + (rootNode->data.mapping.pairs.top - rootNode->data.mapping.pairs.start);
+    rootNode->data.mapping.pairs.start = newPairs;
+    rootNode->data.mapping.pairs.end = newPairs + pairCount;
+    
+    // The byte order mark is not counted by libyaml:
+    if ( (chunks[0].length >= 3) && (memcmp(chunks[0].bytes, "\xEF\xBB\xBF", 3) == 0) ) chunkMark.index--;
+    for ( i = 1; i < chunkCount; i++ ) {
+        yaml_document_t         *chunkDocument = &chunks[i].document;
+        yaml_node_t             *chunkRoot = chunkDocument->nodes.start;
+        yaml_node_t             *node = chunkRoot + 1;
+        yaml_node_pair_t        *pair;
+        int                     idOffset = (mergedDocument->nodes.top - mergedDocument->nodes.start) - 1;
+        
+        // Every chunk begins at the start of a line, so columns are already
+        // right; indices and lines are relative to the chunk:
+        __yamlConfigFileParallelChunkAdvanceMark(&chunkMark, chunks[i - 1].bytes, chunks[i - 1].length);
+#define __SHIFT_MARK(M) { (M).index += chunkMark.index; (M).line += chunkMark.line; }
+        
+        // Node id 1 (the chunk's root) becomes the merged root, every other
+        // id shifts past the nodes already present:
+#define __REMAP_NODE_ID(ID) (((ID) == 1) ? 1 : ((ID) + idOffset))
+        while ( node < chunkDocument->nodes.top ) {
+            yaml_node_t         *newNode = mergedDocument->nodes.top++;
+            
+            *newNode = *node++;
+            __SHIFT_MARK(newNode->start_mark);
+            __SHIFT_MARK(newNode->end_mark);
+            if ( newNode->type == YAML_SEQUENCE_NODE ) {
+                yaml_node_item_t    *item = newNode->data.sequence.items.start;
                 
-                case yamlConfigFileCoerceToType_charArray: {
-                    char            *buffer = va_arg(vargs, char*);
-                    size_t          *bufferLen = va_arg(vargs, size_t*);
-                    
-                    if ( bufferLen ) {
-                        size_t      copyLen = *bufferLen;
-                        
-                        if ( buffer && copyLen ) {
-                            if ( targetNode->data.scalar.length <= copyLen ) copyLen = targetNode->data.scalar.length;
-                            memcpy(buffer, targetNode->data.scalar.value, copyLen);
-                        }
-                        *bufferLen = targetNode->data.scalar.length;
-                    }
-                    return true;
+                while ( item < newNode->data.sequence.items.top ) {
+                    *item = __REMAP_NODE_ID(*item);
+                    item++;
                 }
-                
-                case yamlConfigFileCoerceToType_bool: {
-                    bool            tmpValue;
-                    
-                    if ( __yamlScalarNodeToBool(targetNode, &tmpValue) ) {
-                        bool        *outValue = va_arg(vargs, bool*);
-                    
-                        if ( outValue ) *outValue = tmpValue;
-                        return true;
-                    } else {
-                        if ( outError ) *outError = yamlConfigFileError_failedToCoerce;
-                    }
-                    break;
+            } else if ( newNode->type == YAML_MAPPING_NODE ) {
+                pair = newNode->data.mapping.pairs.start;
+                while ( pair < newNode->data.mapping.pairs.top ) {
+                    pair->key = __REMAP_NODE_ID(pair->key);
+                    pair->value = __REMAP_NODE_ID(pair->value);
+                    pair++;
                 }
+            }
+        }
+        pair = chunkRoot->data.mapping.pairs.start;
+        while ( pair < chunkRoot->data.mapping.pairs.top ) {
+            rootNode->data.mapping.pairs.top->key = __REMAP_NODE_ID(pair->key);
+            rootNode->data.mapping.pairs.top->value = __REMAP_NODE_ID(pair->value);
+            rootNode->data.mapping.pairs.top++;
+            pair++;
+        }
+#undef __REMAP_NODE_ID
+        
+        // The merged root and document end where the last chunk's do:
+        if ( i == chunkCount - 1 ) {
+            rootNode->end_mark = chunkRoot->end_mark;
+            __SHIFT_MARK(rootNode->end_mark);
+            mergedDocument->end_mark = chunkDocument->end_mark;
+            __SHIFT_MARK(mergedDocument->end_mark);
+        }
+#undef __SHIFT_MARK
+        
+        // The chunk document now owns nothing but its root mapping and the
+        // (moved) node stack itself:
+        free((void*)chunkRoot->tag);
+        free((void*)chunkRoot->data.mapping.pairs.start);
+        chunkDocument->nodes.top = chunkDocument->nodes.start;
+        yaml_document_delete(chunkDocument);
+        chunks[i].isParsed = false;
+    }
+    *outDocument = *mergedDocument;
+    chunks[0].isParsed = false;
+    return true;
+}
+
+//
+
+bool
+__yamlConfigFileParallelLoad(
+    const unsigned char         *bytes,
+    size_t                      length,
+    yaml_document_t             *outDocument
+)
+{
+    bool                        isLoaded = false;
+#ifdef HAVE_PTHREAD
+    unsigned int                threadCount = yamlConfigFileGetParallelLoadThreadCount();
+    yamlConfigFileLazySubtree   *entries = NULL;
+    unsigned int                entryCount = 0, chunkCount, i, entryIndex;
+    yamlConfigFileParallelChunk *chunks;
+    pthread_t                   *threads;
+    bool                        *isThreadStarted;
+    
+    if ( (threadCount < 2) || (length < 2 * YAMLCONFIGFILE_PARALLEL_LOAD_MINIMUM_CHUNK_SIZE) ) return false;
+    if ( ! __yamlConfigFileScanTopLevelEntries(bytes, length, &entries, &entryCount) ) {
+        DEBUG_PRINTF("document is not eligible for parallel load", NULL);
+        return false;
+    }
+    chunkCount = length / YAMLCONFIGFILE_PARALLEL_LOAD_MINIMUM_CHUNK_SIZE;
+    if ( chunkCount > threadCount ) chunkCount = threadCount;
+    if ( chunkCount > entryCount ) chunkCount = entryCount;
+    if ( chunkCount < 2 ) {
+        free((void*)entries);
+        return false;
+    }
+    chunks = calloc(chunkCount, sizeof(yamlConfigFileParallelChunk) + sizeof(pthread_t) + sizeof(bool));
+    if ( ! chunks ) {
+        free((void*)entries);
+        return false;
+    }
+    threads = (pthread_t*)(chunks + chunkCount);
+    isThreadStarted = (bool*)(threads + chunkCount);
+    
+    // Split into runs of whole entries of roughly equal size; the first
+    // chunk also takes anything preceding the first entry:
+    entryIndex = 0;
+    for ( i = 0; i < chunkCount; i++ ) {
+        size_t                  chunkStart = (i == 0) ? 0 : entries[entryIndex].start;
+        size_t                  target = (length / chunkCount) * (i + 1);
+        unsigned int            firstEntry = entryIndex;
+        
+        // Leave at least one entry for each remaining chunk:
+        do {
+            entryIndex++;
+        } while ( (entryIndex < entryCount - (chunkCount - i - 1)) && (entries[entryIndex].start < target) );
+        if ( i == chunkCount - 1 ) entryIndex = entryCount;
+        chunks[i].bytes = bytes + chunkStart;
+        chunks[i].length = ((entryIndex < entryCount) ? entries[entryIndex].start : length) - chunkStart;
+        chunks[i].entryCount = entryIndex - firstEntry;
+    }
+    free((void*)entries);
+    
+    for ( i = 1; i < chunkCount; i++ ) {
+        isThreadStarted[i] = ( pthread_create(&threads[i], NULL, __yamlConfigFileParallelChunkParse, &chunks[i]) == 0 );
+        if ( ! isThreadStarted[i] ) __yamlConfigFileParallelChunkParse(&chunks[i]);
+    }
+    __yamlConfigFileParallelChunkParse(&chunks[0]);
+    for ( i = 1; i < chunkCount; i++ ) if ( isThreadStarted[i] ) pthread_join(threads[i], NULL);
+    
+    isLoaded = true;
+    for ( i = 0; isLoaded && (i < chunkCount); i++ ) {
+        if ( ! chunks[i].isValid ) {
+            DEBUG_PRINTF("chunk %u of %u could not be parsed alone", i, chunkCount);
+            isLoaded = false;
+        }
+    }
+    if ( isLoaded ) isLoaded = __yamlConfigFileParallelChunksStitch(chunks, chunkCount, outDocument);
+    for ( i = 0; i < chunkCount; i++ ) if ( chunks[i].isParsed ) yaml_document_delete(&chunks[i].document);
+    free((void*)chunks);
+    DEBUG_PRINTF("parallel load in %u chunks %s", chunkCount, isLoaded ? "succeeded" : "failed");
+#endif
+    return isLoaded;
+}
+
+//
+
+unsigned int
+__yamlConfigFileGetThreadCount(
+    unsigned int                threadCount
+)
+{
+#ifdef HAVE_PTHREAD
+    if ( threadCount == 0 ) {
+        long                    onlineCount = sysconf(_SC_NPROCESSORS_ONLN);
+        
+        threadCount = (onlineCount > 0) ? (unsigned int)onlineCount : 1;
+    }
+#else
+    threadCount = 1;
+#endif
+    return threadCount;
+}
+
+//
+
+unsigned int
+yamlConfigFileGetParallelLoadThreadCount()
+{
+    return __yamlConfigFileGetThreadCount(__yamlConfigFileParallelLoadThreadCount);
+}
+
+//
+
+void
+yamlConfigFileSetParallelLoadThreadCount(
+    unsigned int                threadCount
+)
+{
+    __yamlConfigFileParallelLoadThreadCount = threadCount;
+}
+
+//
+#if 0
+#pragma mark -
+#endif
+//
+
+enum {
+    yamlConfigFileState_isDocumentParsed = 1 << 0,
+    yamlConfigFileState_isSnapshotFile = 1 << 1,
+    yamlConfigFileState_hasSourceFileInfo = 1 << 2
+};
+
+//
+
+typedef struct __yamlConfigFile {
+    unsigned int        refCount;
+    yamlConfigFileId    fileId;
+    const char          *sourceFilePath;
+    yamlOptionsBitvec   options;
+    yamlOptionsBitvec   state;
+    yaml_document_t		document;
+    yamlKeyPathCacheRef keyPathCache;
+    unsigned int        mappingIndexMinimumKeyCount;
+    yamlKeyPathMappingIndexRef mappingIndex;
+    yamlConfigFileDocumentIndex *documentIndex;
+    yamlConfigFileLazyState     *lazyState;
+    yamlConfigFileSnapshot      *snapshot;
+    yamlConfigFileSnapshotSource sourceFileInfo;
+} yamlConfigFile;
+
+//
+
+yamlConfigFile*
+__yamlConfigFileAlloc(
+    const char          *sourceFilePath,
+    yamlOptionsBitvec   options
+)
+{
+    size_t              sourceFilePathLen = (sourceFilePath ? (strlen(sourceFilePath) + 1) : 0);
+    yamlConfigFile      *newConfigFile = calloc(1, sizeof(yamlConfigFile) + sourceFilePathLen);
+    
+    if ( newConfigFile ) {
+        newConfigFile->refCount = 1;
+        newConfigFile->fileId = YAMLCONFIGFILE_UNCACHED_ID;
+        newConfigFile->options = options;
+        if ( sourceFilePath ) {
+            newConfigFile->sourceFilePath = (void*)newConfigFile + sizeof(yamlConfigFile);
+            if ( options & yamlConfigFileOptions_caseFoldFilename ) {
+                size_t  i = 0;
                 
-                case yamlConfigFileCoerceToType_int:
-                case yamlConfigFileCoerceToType_longInt: 
-                case yamlConfigFileCoerceToType_longLongInt:
-                case yamlConfigFileCoerceToType_int8:
-                case yamlConfigFileCoerceToType_int16:
-                case yamlConfigFileCoerceToType_int32:
-                case yamlConfigFileCoerceToType_int64: {
-                    long long int   tmpValue;
-                    
-                    if ( __yamlScalarNodeToSignedInt(targetNode, &tmpValue) ) {
-                        bool        okay = false;
-                        
-                        switch ( coerceToType ) {
-                        
-                            case yamlConfigFileCoerceToType_int: {
-                                int     *outValue = va_arg(vargs, int*);
-                                
-                                if ( (tmpValue >= INT_MIN) && (tmpValue <= INT_MAX) ) {
-                                    if ( outValue ) *outValue = (int)tmpValue;
-                                    okay = true;
-                                } else {
-                                    if ( outError ) *outError = yamlConfigFileError_numberOutOfRange;
-                                }
-                                break;
-                            }
-                            
-                            case yamlConfigFileCoerceToType_longInt: {
-                                long int    *outValue = va_arg(vargs, long int*);
-                                
-                                if ( (tmpValue >= LONG_MIN) && (tmpValue <= LONG_MAX) ) {
-                                    if ( outValue ) *outValue = (long int)tmpValue;
-                                    okay = true;
-                                } else {
-                                    if ( outError ) *outError = yamlConfigFileError_numberOutOfRange;
-                                }
-                                break;
-                            }
-                            
-                            case yamlConfigFileCoerceToType_longLongInt: {
-                                long long int   *outValue = va_arg(vargs, long long int*);
-                                
-                                if ( outValue ) *outValue = tmpValue;
-                                okay = true;
-                                break;
-                            }
-                        
-                            case yamlConfigFileCoerceToType_int8: {
-                                int8_t  *outValue = va_arg(vargs, int8_t*);
-                                
-                                if ( (tmpValue >= INT8_MIN) && (tmpValue <= INT8_MAX) ) {
-                                    if ( outValue ) *outValue = (int8_t)tmpValue;
-                                    okay = true;
-                                } else {
-                                    if ( outError ) *outError = yamlConfigFileError_numberOutOfRange;
-                                }
-                                break;
-                            }
-                        
-                            case yamlConfigFileCoerceToType_int16: {
-                                int16_t *outValue = va_arg(vargs, int16_t*);
-                                
-                                if ( (tmpValue >= INT16_MIN) && (tmpValue <= INT16_MAX) ) {
-                                    if ( outValue ) *outValue = (int16_t)tmpValue;
-                                    okay = true;
-                                } else {
-                                    if ( outError ) *outError = yamlConfigFileError_numberOutOfRange;
-                                }
-                                break;
-                            }
-                        
-                            case yamlConfigFileCoerceToType_int32: {
-                                int32_t *outValue = va_arg(vargs, int32_t*);
-                                
-                                if ( (tmpValue >= INT32_MIN) && (tmpValue <= INT32_MAX) ) {
-                                    if ( outValue ) *outValue = (int32_t)tmpValue;
-                                    okay = true;
-                                } else {
-                                    if ( outError ) *outError = yamlConfigFileError_numberOutOfRange;
-                                }
-                                break;
-                            }
-                        
-                            case yamlConfigFileCoerceToType_int64: {
-                                int64_t *outValue = va_arg(vargs, int64_t*);
-                                
-                                if ( (tmpValue >= INT64_MIN) && (tmpValue <= INT64_MAX) ) {
-                                    if ( outValue ) *outValue = (int64_t)tmpValue;
-                                    okay = true;
-                                } else {
-                                    if ( outError ) *outError = yamlConfigFileError_numberOutOfRange;
-                                }
-                                break;
-                            }
-                        }
-                        return okay;
-                    } else {
-                        if ( outError ) *outError = yamlConfigFileError_failedToCoerce;
-                    }
-                    break;
-                }
-                
-                case yamlConfigFileCoerceToType_unsignedInt:
-                case yamlConfigFileCoerceToType_unsignedLongInt:
-                case yamlConfigFileCoerceToType_unsignedLongLongInt:
-                case yamlConfigFileCoerceToType_uint8:
-                case yamlConfigFileCoerceToType_uint16:
-                case yamlConfigFileCoerceToType_uint32:
-                case yamlConfigFileCoerceToType_uint64: {
-                    unsigned long long int  tmpValue;
-                    
-                    if ( __yamlScalarNodeToUnsignedInt(targetNode, &tmpValue) ) {
-                        bool        okay = false;
-                        
-                        switch ( coerceToType ) {
-                        
-                            case yamlConfigFileCoerceToType_unsignedInt: {
-                                unsigned int    *outValue = va_arg(vargs, unsigned int*);
-                                
-                                if ( tmpValue <= UINT_MAX ) {
-                                    if ( outValue ) *outValue = (unsigned int)tmpValue;
-                                    okay = true;
-                                } else {
-                                    if ( outError ) *outError = yamlConfigFileError_numberOutOfRange;
-                                }
-                                break;
-                            }
-                            
-                            case yamlConfigFileCoerceToType_unsignedLongInt: {
-                                unsigned long int   *outValue = va_arg(vargs, unsigned long int*);
-                                
-                                if ( tmpValue <= ULONG_MAX ) {
-                                    if ( outValue )  *outValue = (unsigned long int)tmpValue;
-                                    okay = true;
-                                } else {
-                                    if ( outError ) *outError = yamlConfigFileError_numberOutOfRange;
-                                }
-                                break;
-                            }
-                            
-                            case yamlConfigFileCoerceToType_unsignedLongLongInt: {
-                                unsigned long long int  *outValue = va_arg(vargs, unsigned long long int*);
-                                
-                                if ( outValue ) *outValue = tmpValue;
-                                okay = true;
-                                break;
-                            }
-                        
-                            case yamlConfigFileCoerceToType_uint8: {
-                                uint8_t     *outValue = va_arg(vargs, uint8_t*);
-                                
-                                if ( tmpValue <= UINT8_MAX ) {
-                                    if ( outValue ) *outValue = (uint8_t)tmpValue;
-                                    okay = true;
-                                } else {
-                                    if ( outError ) *outError = yamlConfigFileError_numberOutOfRange;
-                                }
-                                break;
-                            }
-                        
-                            case yamlConfigFileCoerceToType_uint16: {
-                                uint16_t    *outValue = va_arg(vargs, uint16_t*);
-                                
-                                if ( tmpValue <= UINT16_MAX ) {
-                                    if ( outValue ) *outValue = (uint16_t)tmpValue;
-                                    okay = true;
-                                } else {
-                                    if ( outError ) *outError = yamlConfigFileError_numberOutOfRange;
-                                }
-                                break;
-                            }
-                        
-                            case yamlConfigFileCoerceToType_uint32: {
-                                uint32_t    *outValue = va_arg(vargs, uint32_t*);
-                                
-                                if ( tmpValue <= UINT32_MAX ) {
-                                    if ( outValue ) *outValue = (uint32_t)tmpValue;
-                                    okay = true;
-                                } else {
-                                    if ( outError ) *outError = yamlConfigFileError_numberOutOfRange;
-                                }
-                                break;
-                            }
-                        
-                            case yamlConfigFileCoerceToType_uint64: {
-                                uint64_t    *outValue = va_arg(vargs, uint64_t*);
-                                
-                                if ( tmpValue <= UINT64_MAX ) {
-                                    if ( outValue ) *outValue = (uint64_t)tmpValue;
-                                    okay = true;
-                                } else {
-                                    if ( outError ) *outError = yamlConfigFileError_numberOutOfRange;
-                                }
-                                break;
-                            }
-                        }
-                        return okay;
-                    } else {
-                        if ( outError ) *outError = yamlConfigFileError_failedToCoerce;
-                    }
-                    break;
-                }
-                
-                case yamlConfigFileCoerceToType_float: {
-                    float       tmpValue;
-                    
-                    if ( __yamlScalarNodeToFloat(targetNode, &tmpValue) ) {
-                        float   *outValue = va_arg(vargs, float*);
-                        
-                        if ( outValue ) *outValue = tmpValue;
-                        return true;
-                    } else {
-                        if ( outError ) *outError = yamlConfigFileError_failedToCoerce;
-                    }
-                    break;
-                }
-                
-                case yamlConfigFileCoerceToType_double: {
-                    double      tmpValue;
-                    
-                    if ( __yamlScalarNodeToDouble(targetNode, &tmpValue) ) {
-                        double  *outValue = va_arg(vargs, double*);
-                        
-                        if ( outValue ) *outValue = tmpValue;
-                        return true;
-                    } else {
-                        if ( outError ) *outError = yamlConfigFileError_failedToCoerce;
-                    }
-                    break;
+                while ( sourceFilePath[i] ) {
+                    ((char*)newConfigFile->sourceFilePath)[i] = tolower(sourceFilePath[i]);
+                    i++;
                 }
+            } else {
+                strncpy((char*)newConfigFile->sourceFilePath, sourceFilePath, sourceFilePathLen);
+            }
+        }
+        if ( ! (options & yamlConfigFileOptions_noKeyPathCache) ) newConfigFile->keyPathCache = yamlKeyPathCacheCreate(0, NULL);
+        newConfigFile->mappingIndexMinimumKeyCount = YAMLKEYPATH_MAPPINGINDEX_DEFAULT_MINIMUM_KEYCOUNT;
+
+#ifdef YAMLCONFIGFILE_DEBUG
+        DEBUG_PRINTF("yamlConfigFile allocated:", NULL);
+        if ( sourceFilePath ) DEBUG_PRINTF("  sourceFilePath : \"%s\"", newConfigFile->sourceFilePath);
+        DEBUG_PRINTF("  options : %08x", newConfigFile->options);
+        if ( newConfigFile->keyPathCache ) DEBUG_PRINTF("  keyPathCache : %p", newConfigFile->keyPathCache);
+#endif
+    }
+    return newConfigFile;
+}
+
+//
+
+void
+__yamlConfigFileSetSourceFileInfo(
+    yamlConfigFileRef                   aConfigFile,
+    const yamlConfigFileSnapshotSource  *sourceFileInfo
+)
+{
+    // Only an object holding the first document of a whole file at its
+    // sourceFilePath gets one, and only it can index the file's documents:
+    aConfigFile->sourceFileInfo = *sourceFileInfo;
+    aConfigFile->state |= yamlConfigFileState_hasSourceFileInfo;
+}
+
+//
+
+yamlConfigFileRef
+__yamlConfigFileCreateWithParser(
+    yaml_parser_t               *parser,
+    const char                  *sourceFilePath,
+    yamlOptionsBitvec           options,
+    const yamlConfigFileFilter  *aFilter
+)
+{
+    yamlConfigFileRef   newConfigFile = __yamlConfigFileAlloc(sourceFilePath, options);
+    bool                isLoaded;
+    
+    if ( newConfigFile ) {
+        // Attempt to parse the document (or just the selected parts of it):
+        if ( aFilter ) {
+            isLoaded = __yamlConfigFileFilterLoad(parser, aFilter, YAMLCONFIGFILEOPTIONS_KEYPATHOPTIONS(options), &newConfigFile->document);
+        } else {
+            isLoaded = yaml_parser_load(parser, &newConfigFile->document);
+        }
+        if ( isLoaded ) {
+            newConfigFile->state = yamlConfigFileState_isDocumentParsed;
             
-                default:
-                    if ( outError ) *outError = yamlConfigFileError_invalidType;
-                    break;
+            // Do we need to cache it?  A filtered document is never cached,
+            // since it cannot stand in for the whole file:
+            if ( sourceFilePath && ! aFilter && ! (options & yamlConfigFileOptions_doNotCache) ) {
+                newConfigFile->fileId = __yamlConfigFileCacheAdd(newConfigFile);
+                DEBUG_PRINTF("file \"%s\" cached with id %u", sourceFilePath, newConfigFile->fileId);
             }
         } else {
-            if ( outError ) *outError = yamlConfigFileError_invalidType;
+            yamlConfigFileRelease(newConfigFile);
+            newConfigFile = NULL;
         }
     }
-    return false;
+    return newConfigFile;
 }
 
 //
 
-bool
-yamlConfigFileCoerceScalarAtPathString(
-    yamlConfigFileRef           aConfigFile,
-    const char                  *pathString,
-    size_t                      pathStringLen,
-    yaml_node_t                 *relativeToNode,
-    yamlErrorCode               *outError,
-    const char*                 *outErrorAtChar,
-    yamlKeyPathNodeMatchType*   *failedAtMatchElement,
-    yamlConfigFileCoerceToType  coerceToType,
-    ...
+yamlConfigFileRef
+__yamlConfigFileCreate(
+    FILE                        *sourceFilePtr,
+    const char                  *sourceFilePath,
+    yamlOptionsBitvec           options,
+    const yamlConfigFileFilter  *aFilter
 )
 {
-    bool                        okay = false;
-    yamlKeyPathRef              keyPath = yamlKeyPathCreateWithString(
-                                                pathString, pathStringLen,
-                                                YAMLCONFIGFILEOPTIONS_KEYPATHOPTIONS(aConfigFile->options),
-                                                outError, outErrorAtChar
-                                            );
-    if ( keyPath ) {
-        va_list                 vargs;
-        
-        va_start(vargs, coerceToType);
-        okay = __yamlConfigFileCoerceScalar(aConfigFile, keyPath, relativeToNode, outError, failedAtMatchElement, coerceToType, vargs);
-        va_end(vargs);
-        yamlKeyPathRelease(keyPath);
+    yamlConfigFileRef   newConfigFile = NULL;
+    yaml_parser_t       parser;
+    yamlConfigFileDecompressor  *decompressor;
+
+    // Initialize parser:
+    if ( yaml_parser_initialize(&parser) ) {
+        // Attach our input stream (decompressing it if necessary):
+        decompressor = __yamlConfigFileDecompressorSetParserInputFile(&parser, sourceFilePtr);
+        newConfigFile = __yamlConfigFileCreateWithParser(&parser, sourceFilePath, options, aFilter);
+        yaml_parser_delete(&parser);
+        if ( decompressor ) __yamlConfigFileDecompressorDestroy(decompressor);
     }
-    return okay;
+    return newConfigFile;
 }
 
 //
 
-bool
-yamlConfigFileCoerceScalarAtPath(
-    yamlConfigFileRef           aConfigFile,
-    yamlKeyPathRef              theKeyPath,
-    yaml_node_t                 *relativeToNode,
-    yamlErrorCode               *outError,
-    yamlKeyPathNodeMatchType*   *failedAtMatchElement,
-    yamlConfigFileCoerceToType  coerceToType,
-    ...
+yamlConfigFileRef
+__yamlConfigFileCreateWithInputBuffer(
+    yamlConfigFileInputBuffer   *inputBuffer,
+    const char                  *sourceFilePath,
+    yamlOptionsBitvec           options,
+    const yamlConfigFileFilter  *aFilter
 )
 {
-    bool                        okay = false;
-    va_list                     vargs;
-        
-    va_start(vargs, coerceToType);
-    okay = __yamlConfigFileCoerceScalar(aConfigFile, theKeyPath, relativeToNode, outError, failedAtMatchElement, coerceToType, vargs);
-    va_end(vargs);
-    return okay;
+    yamlConfigFileRef   newConfigFile = NULL;
+    yaml_parser_t       parser;
+    yamlConfigFileDecompressor  *decompressor;
+    bool                isCompressed = __yamlConfigFileDecompressorIsCompressed(inputBuffer->bytes, inputBuffer->length);
+
+    // Compressed input is only ever decompressed as libyaml reads it:
+    if ( (options & (yamlConfigFileOptions_jsonInput | yamlConfigFileOptions_fastParse | yamlConfigFileOptions_parallelLoad)) && ! aFilter && ! isCompressed ) {
+        newConfigFile = __yamlConfigFileAlloc(sourceFilePath, options);
+        if ( ! newConfigFile ) return NULL;
+        if ( ((options & yamlConfigFileOptions_jsonInput) && __yamlConfigFileFastParseJSON(inputBuffer->bytes, inputBuffer->length, &newConfigFile->document))
+             || ((options & yamlConfigFileOptions_fastParse) && __yamlConfigFileFastParse(inputBuffer->bytes, inputBuffer->length, &newConfigFile->document))
+             || ((options & yamlConfigFileOptions_parallelLoad) && __yamlConfigFileParallelLoad(inputBuffer->bytes, inputBuffer->length, &newConfigFile->document))
+        ) {
+            newConfigFile->state = yamlConfigFileState_isDocumentParsed;
+            if ( sourceFilePath && ! (options & yamlConfigFileOptions_doNotCache) ) {
+                newConfigFile->fileId = __yamlConfigFileCacheAdd(newConfigFile);
+                DEBUG_PRINTF("file \"%s\" cached with id %u", sourceFilePath, newConfigFile->fileId);
+            }
+            return newConfigFile;
+        }
+        // Not eligible, so parse it serially with libyaml:
+        yamlConfigFileRelease(newConfigFile);
+        newConfigFile = NULL;
+    }
+    
+    // Initialize parser:
+    if ( yaml_parser_initialize(&parser) ) {
+        // Attach the in-memory (possibly mapped) file content:
+        decompressor = __yamlConfigFileDecompressorSetParserInputString(&parser, inputBuffer->bytes, inputBuffer->length);
+        newConfigFile = __yamlConfigFileCreateWithParser(&parser, sourceFilePath, options, aFilter);
+        yaml_parser_delete(&parser);
+        if ( decompressor ) __yamlConfigFileDecompressorDestroy(decompressor);
+    }
+    return newConfigFile;
 }
 
 //
 
-bool
-__yamlConfigFileCoerceSequence(
-    yamlConfigFileRef           aConfigFile,
-    yamlKeyPathRef              theKeyPath,
-    yaml_node_t                 *relativeToNode,
-    yamlErrorCode               *outError,
-    yamlKeyPathNodeMatchType*   *failedAtMatchElement,
-    unsigned int                startSequenceIndex,
-    unsigned int                endSequenceIndex,
-    yamlConfigFileCoerceToType  coerceToType,
-    va_list                     vargs
+const yamlConfigFileFilter*
+__yamlConfigFileFilterIfNotEmpty(
+    const yamlConfigFileFilter  *aFilter
 )
 {
-    if ( startSequenceIndex <= endSequenceIndex ) {
-        yaml_node_t                 *targetNode = yamlConfigFileGetNodeAtPath(aConfigFile, theKeyPath, relativeToNode, outError, failedAtMatchElement);
+    // A filter without any key paths selects everything:
+    if ( aFilter && (aFilter->includePathCount || aFilter->excludePathCount) ) return aFilter;
+    return NULL;
+}
+
+//
+
+yamlConfigFileRef
+__yamlConfigFileCreateWithLazySubtrees(
+    yamlConfigFileInputBuffer   *inputBuffer,
+    const char                  *sourceFilePath,
+    yamlOptionsBitvec           options
+)
+{
+    yamlConfigFileRef           newConfigFile = NULL;
+    yamlConfigFileLazyState     *lazyState;
+    unsigned char               *skeleton;
+    size_t                      skeletonLength = 0;
+    unsigned int                i, lazyCount = 0;
+    yaml_parser_t               parser;
+    yaml_node_t                 *rootNode;
+    
+    if ( ! (lazyState = calloc(1, sizeof(yamlConfigFileLazyState))) ) return NULL;
+    if ( ! __yamlConfigFileScanTopLevelEntries(inputBuffer->bytes, inputBuffer->length, &lazyState->subtrees, &lazyState->subtreeCount) ) {
+        DEBUG_PRINTF("document is not eligible for lazy subtrees", NULL);
+        free((void*)lazyState);
+        return NULL;
+    }
+    for ( i = 0; i < lazyState->subtreeCount; i++ ) {
+        yamlConfigFileLazySubtree   *subtree = &lazyState->subtrees[i];
         
-        if ( targetNode ) {
-            if ( targetNode->type == YAML_SEQUENCE_NODE ) {
-                unsigned int        sequenceLength = targetNode->data.sequence.items.top - targetNode->data.sequence.items.start;
-                
-                // Validate the index range:
-                if ( (startSequenceIndex < sequenceLength) && (endSequenceIndex < sequenceLength) ) {
-                    yaml_node_item_t	*s = targetNode->data.sequence.items.start + startSequenceIndex;
-                    yaml_node_item_t	*e = targetNode->data.sequence.items.start + endSequenceIndex + 1;
-                    
-                    switch ( coerceToType ) {
-                        
+        if ( subtree->end - subtree->start >= YAMLCONFIGFILE_LAZY_SUBTREE_MINIMUM_SIZE ) {
+            subtree->isLazy = true;
+            lazyCount++;
+            skeletonLength += (subtree->keyEnd - subtree->start) + 4;
+        } else {
+            skeletonLength += (subtree->end - subtree->start) + 1;
+        }
+    }
+    if ( ! lazyCount || ! (skeleton = malloc(skeletonLength)) ) {
+        free((void*)lazyState->subtrees);
+        free((void*)lazyState);
+        return NULL;
+    }
+    
+    // Build the skeleton document, with null placeholders for the deferred
+    // subtrees:
+    skeletonLength = 0;
+    for ( i = 0; i < lazyState->subtreeCount; i++ ) {
+        yamlConfigFileLazySubtree   *subtree = &lazyState->subtrees[i];
+        
+        if ( subtree->isLazy ) {
+            memcpy(skeleton + skeletonLength, inputBuffer->bytes + subtree->start, subtree->keyEnd - subtree->start);
+            skeletonLength += subtree->keyEnd - subtree->start;
+            memcpy(skeleton + skeletonLength, ": ~\n", 4);
+            skeletonLength += 4;
+        } else {
+            memcpy(skeleton + skeletonLength, inputBuffer->bytes + subtree->start, subtree->end - subtree->start);
+            skeletonLength += subtree->end - subtree->start;
+            if ( skeleton[skeletonLength - 1] != '\n' ) skeleton[skeletonLength++] = '\n';
+        }
+    }
+    if ( yaml_parser_initialize(&parser) ) {
+        yaml_parser_set_input_string(&parser, skeleton, skeletonLength);
+        newConfigFile = __yamlConfigFileCreateWithParser(&parser, sourceFilePath, options | yamlConfigFileOptions_doNotCache, NULL);
+        yaml_parser_delete(&parser);
+    }
+    free((void*)skeleton);
+    
+    // The skeleton must be a mapping with exactly one pair per entry the
+    // pre-scan found, otherwise the scan was fooled:
+    if ( newConfigFile ) {
+        rootNode = yamlConfigFileGetRootNode(newConfigFile);
+        if ( ! rootNode || (rootNode->type != YAML_MAPPING_NODE) || (rootNode->data.mapping.pairs.top - rootNode->data.mapping.pairs.start != lazyState->subtreeCount) ) {
+            DEBUG_PRINTF("skeleton document does not match pre-scan", NULL);
+            yamlConfigFileRelease(newConfigFile);
+            newConfigFile = NULL;
+        }
+    }
+    if ( ! newConfigFile ) {
+        free((void*)lazyState->subtrees);
+        free((void*)lazyState);
+        return NULL;
+    }
+    
+    // The file takes over the input buffer:
+    lazyState->inputBuffer = *inputBuffer;
+    newConfigFile->lazyState = lazyState;
+    newConfigFile->options = options;
+    if ( sourceFilePath && ! (options & yamlConfigFileOptions_doNotCache) ) {
+        newConfigFile->fileId = __yamlConfigFileCacheAdd(newConfigFile);
+        DEBUG_PRINTF("file \"%s\" cached with id %u", sourceFilePath, newConfigFile->fileId);
+    }
+    DEBUG_PRINTF("%u of %u top-level subtrees deferred", lazyCount, lazyState->subtreeCount);
+    return newConfigFile;
+}
+
+//
+
+bool
+__yamlConfigFileWriteSnapshotToPath(
+    yamlConfigFileRef   aConfigFile,
+    const char          *snapshotPath,
+    const yamlConfigFileSnapshotSource *source,
+    yamlErrorCode       *outError
+)
+{
+    yaml_document_t     *document = &aConfigFile->document;
+    size_t              snapshotPathLen = strlen(snapshotPath);
+    char                *tmpPath;
+    int                 fd;
+    FILE                *fptr;
+    yamlErrorCode       theError = 0;
+    
+    // The deferred subtrees of a lazy file are only placeholders, so the
+    // full document is written:
+    if ( aConfigFile->lazyState ) {
+        if ( ! __yamlConfigFileLazyStateLoadFullDocument(aConfigFile->lazyState) ) {
+            if ( outError ) *outError = yamlConfigFileError_parseFailed;
+            return false;
+        }
+        document = &aConfigFile->lazyState->fullDocument;
+    }
+    
+    // Write to a temporary file alongside the destination and rename it into
+    // place, so that a reader never sees a partial snapshot:
+    if ( ! (tmpPath = malloc(snapshotPathLen + 8)) ) {
+        if ( outError ) *outError = yamlConfigFileError_outOfMemory;
+        return false;
+    }
+    snprintf(tmpPath, snapshotPathLen + 8, "%s.XXXXXX", snapshotPath);
+    if ( (fd = mkstemp(tmpPath)) < 0 ) {
+        free((void*)tmpPath);
+        if ( outError ) *outError = yamlConfigFileError_fileNotWritable;
+        return false;
+    }
+    // mkstemp() creates the file readable by its owner alone:
+    if ( (fchmod(fd, 0644) != 0) || ! (fptr = fdopen(fd, "wb")) ) {
+        close(fd);
+        theError = yamlConfigFileError_fileNotWritable;
+    } else {
+        if ( aConfigFile->snapshot ) {
+            size_t      length;
+            const void  *bytes = __yamlConfigFileSnapshotGetBytes(aConfigFile->snapshot, &length);
+            
+            if ( fwrite(bytes, length, 1, fptr) != 1 ) theError = yamlConfigFileError_fileNotWritable;
+        } else {
+            __yamlConfigFileSnapshotWrite(document, source, fptr, &theError);
+        }
+        if ( ! theError && ((fflush(fptr) != 0) || (fsync(fileno(fptr)) != 0)) ) theError = yamlConfigFileError_fileNotWritable;
+        if ( (fclose(fptr) != 0) && ! theError ) theError = yamlConfigFileError_fileNotWritable;
+    }
+    if ( ! theError && (rename(tmpPath, snapshotPath) != 0) ) theError = yamlConfigFileError_fileNotWritable;
+    if ( theError ) unlink(tmpPath);
+    free((void*)tmpPath);
+    if ( outError ) *outError = theError;
+    return ( theError == 0 );
+}
+
+//
+#if 0
+#pragma mark -
+#endif
+//
+
+/*
+ * The parse cache.  When a cache directory is set, a file loaded by path
+ * is looked-up there under the hash of its canonical path.  An entry is a
+ * snapshot whose header records the size, modification time and content
+ * hash of the YAML file it was compiled from, and it is used only if all
+ * three still match the file; otherwise the file is parsed as usual and
+ * the entry is (re)written.  Entries are written to a temporary file and
+ * renamed into place, so concurrent writers of an entry simply replace one
+ * another's complete files and a reader never sees a partial one (a reader
+ * that has already mapped an entry keeps the content it mapped).
+ *
+ * The content hash must be the same in every process, so it uses a fixed
+ * seed rather than yamlHashGetSeed().  Since entry names can be predicted
+ * by anyone, neither the directory nor an entry is trusted unless it is
+ * owned by the effective user and writable by no one else, and entries are
+ * never opened through a symbolic link.
+ */
+
+#ifndef YAMLCONFIGFILE_PARSE_CACHE_HASH_SEED
+#define YAMLCONFIGFILE_PARSE_CACHE_HASH_SEED 0x59434650415253ULL
+#endif
+
+#define YAMLCONFIGFILE_PARSE_CACHE_ENTRY_SUFFIX ".ycfsnap"
+
+/*
+ * The directory is read from the environment on first use and may be
+ * replaced at any time, by any thread, so it is only touched with the lock
+ * held.  Loads work on a copy of it (see
+ * __yamlConfigFileCopyParseCacheDirectory()) so that a concurrent change
+ * cannot free the string out from under them.
+ */
+static bool __yamlConfigFileParseCacheDirectoryIsSet = false;
+static char *__yamlConfigFileParseCacheDirectory = NULL;
+#ifdef HAVE_PTHREAD
+static pthread_mutex_t __yamlConfigFileParseCacheLock = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+//
+
+static void
+__yamlConfigFileParseCacheDirectoryLock(void)
+{
+#ifdef HAVE_PTHREAD
+    pthread_mutex_lock(&__yamlConfigFileParseCacheLock);
+#endif
+    if ( ! __yamlConfigFileParseCacheDirectoryIsSet ) {
+        const char      *directoryStr = getenv(YAMLCONFIGFILE_PARSE_CACHE_DIR_ENV_VAR);
+        
+        if ( directoryStr && *directoryStr ) __yamlConfigFileParseCacheDirectory = strdup(directoryStr);
+        __yamlConfigFileParseCacheDirectoryIsSet = true;
+    }
+}
+
+//
+
+static void
+__yamlConfigFileParseCacheDirectoryUnlock(void)
+{
+#ifdef HAVE_PTHREAD
+    pthread_mutex_unlock(&__yamlConfigFileParseCacheLock);
+#endif
+}
+
+//
+
+static char*
+__yamlConfigFileCopyParseCacheDirectory(void)
+{
+    char                *directoryCopy = NULL;
+    
+    __yamlConfigFileParseCacheDirectoryLock();
+    if ( __yamlConfigFileParseCacheDirectory ) directoryCopy = strdup(__yamlConfigFileParseCacheDirectory);
+    __yamlConfigFileParseCacheDirectoryUnlock();
+    return directoryCopy;
+}
+
+//
+
+const char*
+yamlConfigFileGetParseCacheDirectory()
+{
+    const char          *directory;
+    
+    __yamlConfigFileParseCacheDirectoryLock();
+    directory = __yamlConfigFileParseCacheDirectory;
+    __yamlConfigFileParseCacheDirectoryUnlock();
+    return directory;
+}
+
+//
+
+bool
+yamlConfigFileSetParseCacheDirectory(
+    const char          *directoryPath
+)
+{
+    char                *newDirectory = NULL;
+    char                *oldDirectory;
+    
+    if ( directoryPath && *directoryPath && ! (newDirectory = strdup(directoryPath)) ) return false;
+    __yamlConfigFileParseCacheDirectoryLock();
+    oldDirectory = __yamlConfigFileParseCacheDirectory;
+    __yamlConfigFileParseCacheDirectory = newDirectory;
+    __yamlConfigFileParseCacheDirectoryUnlock();
+    if ( oldDirectory ) free((void*)oldDirectory);
+    return true;
+}
+
+//
+
+char*
+__yamlConfigFileParseCacheEntryPath(
+    const char          *cacheDirectory,
+    const char          *sourceFilePath
+)
+{
+    char                *canonicalPath = realpath(sourceFilePath, NULL);
+    char                *entryPath = NULL;
+    
+    if ( canonicalPath ) {
+        uint64_t        pathHash = yamlHash64(canonicalPath, strlen(canonicalPath), YAMLCONFIGFILE_PARSE_CACHE_HASH_SEED);
+        size_t          entryPathLen = strlen(cacheDirectory) + 18 + sizeof(YAMLCONFIGFILE_PARSE_CACHE_ENTRY_SUFFIX);
+        
+        if ( (entryPath = malloc(entryPathLen)) ) snprintf(entryPath, entryPathLen, "%s/%016llx" YAMLCONFIGFILE_PARSE_CACHE_ENTRY_SUFFIX, cacheDirectory, (unsigned long long)pathHash);
+        free((void*)canonicalPath);
+    }
+    return entryPath;
+}
+
+//
+
+static bool
+__yamlConfigFileParseCacheStatIsPrivate(
+    const struct stat   *finfo
+)
+{
+    return ( (finfo->st_uid == geteuid()) && ! (finfo->st_mode & (S_IWGRP | S_IWOTH)) );
+}
+
+//
+
+static bool
+__yamlConfigFileParseCacheDirectoryIsPrivate(
+    const char          *cacheDirectory,
+    bool                *outExists
+)
+{
+    struct stat         finfo;
+    bool                isPrivate = false;
+    int                 fd = open(cacheDirectory, O_RDONLY | O_DIRECTORY);
+    
+    if ( outExists ) *outExists = ( (fd >= 0) || (errno != ENOENT) );
+    if ( fd >= 0 ) {
+        isPrivate = ( (fstat(fd, &finfo) == 0) && S_ISDIR(finfo.st_mode) && __yamlConfigFileParseCacheStatIsPrivate(&finfo) );
+        close(fd);
+    }
+    return isPrivate;
+}
+
+//
+
+yamlConfigFileRef
+__yamlConfigFileCreateWithParseCache(
+    const char                  *cacheDirectory,
+    const char                  *sourceFilePath,
+    yamlOptionsBitvec           options,
+    const yamlConfigFileFilter  *aFilter,
+    bool                        *isHandled
+)
+{
+    yamlConfigFileRef           newConfigFile = NULL;
+    yamlConfigFileInputBuffer   inputBuffer;
+    yamlConfigFileSnapshotSource source;
+    struct stat                 finfo;
+    char                        *entryPath;
+    bool                        hasDirectory;
+    int                         fd;
+    
+    *isHandled = false;
+    
+    // Entry names are predictable, so a directory that anyone else can write
+    // is not used at all; a missing one is created when an entry is written:
+    if ( ! __yamlConfigFileParseCacheDirectoryIsPrivate(cacheDirectory, &hasDirectory) && hasDirectory ) {
+        DEBUG_PRINTF("parse cache directory \"%s\" is not private, ignoring it", cacheDirectory);
+        return NULL;
+    }
+    if ( ! (entryPath = __yamlConfigFileParseCacheEntryPath(cacheDirectory, sourceFilePath)) ) return NULL;
+    
+    // Only regular files have a stable identity; the size and modification
+    // time are taken before the content is read, so a change made while
+    // reading leaves an entry that no longer matches:
+    if ( (fd = open(sourceFilePath, O_RDONLY)) < 0 ) goto done;
+    if ( (fstat(fd, &finfo) != 0) || ! __yamlConfigFileSnapshotSourceInitWithStat(&source, &finfo) || ! __yamlConfigFileInputBufferInitWithFileDescriptor(&inputBuffer, fd) ) {
+        close(fd);
+        goto done;
+    }
+    close(fd);
+    *isHandled = true;
+    
+    source.contentHash = yamlHash64(inputBuffer.bytes, inputBuffer.length, YAMLCONFIGFILE_PARSE_CACHE_HASH_SEED);
+    
+    // A current entry satisfies a filtered request, too:
+    if ( (newConfigFile = __yamlConfigFileAlloc(sourceFilePath, options)) ) {
+        if ( hasDirectory && ((fd = open(entryPath, O_RDONLY | O_NOFOLLOW)) >= 0) ) {
+            if ( (fstat(fd, &finfo) == 0) && S_ISREG(finfo.st_mode) && __yamlConfigFileParseCacheStatIsPrivate(&finfo) ) {
+                newConfigFile->snapshot = __yamlConfigFileSnapshotCreateWithFileDescriptor(fd, &source, &newConfigFile->document, NULL);
+            } else {
+                DEBUG_PRINTF("parse cache entry \"%s\" is not private, ignoring it", entryPath);
+            }
+            close(fd);
+        }
+        if ( newConfigFile->snapshot ) {
+            DEBUG_PRINTF("parse cache entry \"%s\" used for \"%s\"", entryPath, sourceFilePath);
+            newConfigFile->state = yamlConfigFileState_isDocumentParsed;
+            if ( ! (options & yamlConfigFileOptions_doNotCache) ) {
+                newConfigFile->fileId = __yamlConfigFileCacheAdd(newConfigFile);
+                DEBUG_PRINTF("file \"%s\" cached with id %u", sourceFilePath, newConfigFile->fileId);
+            }
+        } else {
+            yamlConfigFileRelease(newConfigFile);
+            
+            // The whole document is needed for the entry, so nothing is
+            // deferred:
+            newConfigFile = __yamlConfigFileCreateWithInputBuffer(&inputBuffer, sourceFilePath, options & ~yamlConfigFileOptions_lazySubtrees, aFilter);
+            if ( newConfigFile && ! aFilter && (inputBuffer.length == source.size) ) {
+                yamlErrorCode   writeError;
+                
+                // Whoever creates a missing directory, it must end up ours
+                // and private before anything is written into it:
+                if ( ! hasDirectory && (mkdir(cacheDirectory, 0700) != 0) && (errno != EEXIST) ) {
+                    DEBUG_PRINTF("unable to create parse cache directory \"%s\" (errno %d)", cacheDirectory, errno);
+                } else if ( ! hasDirectory && ! __yamlConfigFileParseCacheDirectoryIsPrivate(cacheDirectory, NULL) ) {
+                    DEBUG_PRINTF("parse cache directory \"%s\" is not private, ignoring it", cacheDirectory);
+                } else if ( ! __yamlConfigFileWriteSnapshotToPath(newConfigFile, entryPath, &source, &writeError) ) {
+                    DEBUG_PRINTF("unable to write parse cache entry \"%s\" (error %u)", entryPath, writeError);
+                }
+            }
+        }
+    }
+    __yamlConfigFileInputBufferDestroy(&inputBuffer);
+    if ( newConfigFile ) __yamlConfigFileSetSourceFileInfo(newConfigFile, &source);
+    
+done:
+    free((void*)entryPath);
+    return newConfigFile;
+}
+
+//
+#if 0
+#pragma mark -
+#endif
+//
+
+yamlConfigFileRef
+yamlConfigFileCreateWithInputString(
+    const char          *inputString,
+    size_t              inputStringLength,
+    yamlOptionsBitvec   options
+)
+{
+    return yamlConfigFileCreateWithInputStringAndFilter(inputString, inputStringLength, options, NULL);
+}
+
+//
+
+yamlConfigFileRef
+yamlConfigFileCreateWithInputStringAndFilter(
+    const char                  *inputString,
+    size_t                      inputStringLength,
+    yamlOptionsBitvec           options,
+    const yamlConfigFileFilter  *aFilter
+)
+{
+    yamlConfigFileInputBuffer   inputBuffer;
+    
+    if ( inputStringLength == yamlCStringFullLength ) inputStringLength = strlen(inputString);
+    inputBuffer.bytes = (const unsigned char*)inputString;
+    inputBuffer.length = inputStringLength;
+    inputBuffer.mappedLength = 0;
+    inputBuffer.ownedBytes = NULL;
+    return __yamlConfigFileCreateWithInputBuffer(&inputBuffer, NULL, options | yamlConfigFileOptions_doNotCache, __yamlConfigFileFilterIfNotEmpty(aFilter));
+}
+
+//
+
+yamlConfigFileRef
+yamlConfigFileCreateWithFilePointer(
+    FILE                *sourceFilePtr,
+    yamlOptionsBitvec   options
+)
+{
+    return yamlConfigFileCreateWithFilePointerAndFilter(sourceFilePtr, options, NULL);
+}
+
+//
+
+yamlConfigFileRef
+yamlConfigFileCreateWithFilePointerAndFilter(
+    FILE                        *sourceFilePtr,
+    yamlOptionsBitvec           options,
+    const yamlConfigFileFilter  *aFilter
+)
+{
+    return __yamlConfigFileCreate(sourceFilePtr, NULL, options | yamlConfigFileOptions_doNotCache, __yamlConfigFileFilterIfNotEmpty(aFilter));
+}
+
+//
+
+yamlConfigFileRef
+yamlConfigFileCreateWithFileAtPath(
+    const char          *sourceFilePath,
+    yamlOptionsBitvec   options
+)
+{
+    return yamlConfigFileCreateWithFileAtPathAndFilter(sourceFilePath, options, NULL);
+}
+
+//
+
+yamlConfigFileRef
+yamlConfigFileCreateWithFileAtPathAndFilter(
+    const char                  *sourceFilePath,
+    yamlOptionsBitvec           options,
+    const yamlConfigFileFilter  *aFilter
+)
+{
+    yamlConfigFileRef   newConfigFile = NULL;
+    
+    // A filtered load composes only part of the document, so there is
+    // nothing left to defer:
+    if ( (aFilter = __yamlConfigFileFilterIfNotEmpty(aFilter)) ) options &= ~yamlConfigFileOptions_lazySubtrees;
+    
+    if ( ! (options & yamlConfigFileOptions_ignoreCachedCopy) ) {
+        // A cached copy of the whole document satisfies a filtered request,
+        // too:
+        newConfigFile = __yamlConfigFileCacheLookup(sourceFilePath, options);
+        if ( newConfigFile ) {
+            newConfigFile = yamlConfigFileRetain(newConfigFile);
+            DEBUG_PRINTF("cached file found for \"%s\" (%p)", sourceFilePath, newConfigFile);
+        }
+    }
+    if ( ! newConfigFile && ! (options & (yamlConfigFileOptions_noParseCache | yamlConfigFileOptions_indexDocuments)) ) {
+        char                    *cacheDirectory = __yamlConfigFileCopyParseCacheDirectory();
+        bool                    isHandled;
+        
+        if ( cacheDirectory ) {
+            newConfigFile = __yamlConfigFileCreateWithParseCache(cacheDirectory, sourceFilePath, options, aFilter, &isHandled);
+            free((void*)cacheDirectory);
+            if ( isHandled ) return newConfigFile;
+        }
+    }
+    if ( ! newConfigFile ) {
+        yamlConfigFileSnapshotSource    sourceFileInfo;
+        bool                            hasSourceFileInfo;
+        
+        // The file's identity is taken before it is read, so a change made
+        // while reading keeps the document index from being built later:
+        hasSourceFileInfo = __yamlConfigFileSnapshotSourceInitWithFileAtPath(&sourceFileInfo, sourceFilePath);
+        
+        if ( options & (yamlConfigFileOptions_mapInputFile | yamlConfigFileOptions_indexDocuments | yamlConfigFileOptions_lazySubtrees | yamlConfigFileOptions_parallelLoad | yamlConfigFileOptions_fastParse | yamlConfigFileOptions_jsonInput) ) {
+            yamlConfigFileInputBuffer   inputBuffer;
+            
+            if ( __yamlConfigFileInputBufferInitWithFileAtPath(&inputBuffer, sourceFilePath) ) {
+                if ( (options & yamlConfigFileOptions_lazySubtrees) && ! __yamlConfigFileDecompressorIsCompressed(inputBuffer.bytes, inputBuffer.length) ) {
+                    // A lazy file keeps its input for on-demand parsing of
+                    // its subtrees; the document index will map its own copy
+                    // if needed:
+                    newConfigFile = __yamlConfigFileCreateWithLazySubtrees(&inputBuffer, sourceFilePath, options);
+                    if ( newConfigFile ) {
+                        if ( hasSourceFileInfo ) __yamlConfigFileSetSourceFileInfo(newConfigFile, &sourceFileInfo);
+                        return newConfigFile;
+                    }
+                }
+                newConfigFile = __yamlConfigFileCreateWithInputBuffer(&inputBuffer, sourceFilePath, options, aFilter);
+                // An indexed file keeps its input for on-demand parsing of the
+                // remaining documents:
+                if ( newConfigFile && (options & yamlConfigFileOptions_indexDocuments) ) {
+                    newConfigFile->documentIndex = __yamlConfigFileDocumentIndexCreate(&inputBuffer);
+                }
+                if ( ! newConfigFile || ! newConfigFile->documentIndex ) __yamlConfigFileInputBufferDestroy(&inputBuffer);
+            }
+        } else {
+            FILE            *sourceFilePtr = fopen(sourceFilePath, "r");
+            
+            if ( sourceFilePtr ) {
+                newConfigFile = __yamlConfigFileCreate(sourceFilePtr, sourceFilePath, options, aFilter);
+                fclose(sourceFilePtr);
+            }
+        }
+        if ( newConfigFile && hasSourceFileInfo ) __yamlConfigFileSetSourceFileInfo(newConfigFile, &sourceFileInfo);
+    }
+    return newConfigFile;
+}
+
+//
+
+yamlConfigFileRef
+yamlConfigFileCreateWithSnapshotAtPath(
+    const char          *snapshotPath,
+    yamlOptionsBitvec   options,
+    yamlErrorCode       *outError
+)
+{
+    yamlConfigFileRef   newConfigFile = NULL;
+    
+    if ( outError ) *outError = 0;
+    if ( ! (options & yamlConfigFileOptions_ignoreCachedCopy) ) {
+        newConfigFile = __yamlConfigFileCacheLookup(snapshotPath, options);
+        if ( newConfigFile ) {
+            DEBUG_PRINTF("cached file found for \"%s\" (%p)", snapshotPath, newConfigFile);
+            return yamlConfigFileRetain(newConfigFile);
+        }
+    }
+    if ( ! (newConfigFile = __yamlConfigFileAlloc(snapshotPath, options)) ) {
+        if ( outError ) *outError = yamlConfigFileError_outOfMemory;
+        return NULL;
+    }
+    newConfigFile->snapshot = __yamlConfigFileSnapshotCreateWithFileAtPath(snapshotPath, NULL, &newConfigFile->document, outError);
+    if ( ! newConfigFile->snapshot ) {
+        yamlConfigFileRelease(newConfigFile);
+        return NULL;
+    }
+    newConfigFile->state = yamlConfigFileState_isDocumentParsed | yamlConfigFileState_isSnapshotFile;
+    if ( ! (options & yamlConfigFileOptions_doNotCache) ) {
+        newConfigFile->fileId = __yamlConfigFileCacheAdd(newConfigFile);
+        DEBUG_PRINTF("file \"%s\" cached with id %u", snapshotPath, newConfigFile->fileId);
+    }
+    return newConfigFile;
+}
+
+//
+
+bool
+yamlConfigFileWriteSnapshotToPath(
+    yamlConfigFileRef   aConfigFile,
+    const char          *snapshotPath,
+    yamlErrorCode       *outError
+)
+{
+    return __yamlConfigFileWriteSnapshotToPath(aConfigFile, snapshotPath, NULL, outError);
+}
+
+//
+
+/*
+ * A batch load runs a pool of threads that claim files by index and load
+ * each with the cache disabled; the file cache is not thread-safe, so all
+ * cache lookups happen before the pool starts and all insertions after it
+ * has finished, on the calling thread.
+ */
+
+typedef struct {
+    const char* const           *sourceFilePaths;
+    unsigned int                fileCount;
+    yamlOptionsBitvec           options;
+    yamlConfigFileRef           *configFiles;
+    yamlErrorCode               *errors;
+    unsigned int                nextFile;
+#ifdef HAVE_PTHREAD
+    pthread_mutex_t             nextFileLock;
+#endif
+} yamlConfigFileBatch;
+
+//
+
+void*
+__yamlConfigFileBatchWorker(
+    void                        *context
+)
+{
+    yamlConfigFileBatch         *batch = (yamlConfigFileBatch*)context;
+    
+    while ( 1 ) {
+        unsigned int            i;
+        
+#ifdef HAVE_PTHREAD
+        pthread_mutex_lock(&batch->nextFileLock);
+#endif
+        i = batch->nextFile++;
+#ifdef HAVE_PTHREAD
+        pthread_mutex_unlock(&batch->nextFileLock);
+#endif
+        if ( i >= batch->fileCount ) break;
+        if ( batch->configFiles[i] ) continue;
+        
+        batch->configFiles[i] = yamlConfigFileCreateWithFileAtPath(batch->sourceFilePaths[i], batch->options | yamlConfigFileOptions_ignoreCachedCopy | yamlConfigFileOptions_doNotCache);
+        if ( ! batch->configFiles[i] ) {
+            batch->errors[i] = ( access(batch->sourceFilePaths[i], R_OK) == 0 ) ? yamlConfigFileError_parseFailed : yamlConfigFileError_fileNotReadable;
+        }
+    }
+    return NULL;
+}
+
+//
+
+unsigned int
+yamlConfigFileCreateWithFilesAtPaths(
+    const char* const   *sourceFilePaths,
+    unsigned int        sourceFileCount,
+    yamlOptionsBitvec   options,
+    unsigned int        threadCount,
+    yamlConfigFileRef   *outConfigFiles,
+    yamlErrorCode       *outErrors
+)
+{
+    yamlConfigFileBatch batch;
+    yamlErrorCode       *errors;
+    bool                *isFromCache;
+    unsigned int        i, loadedCount = 0;
+    
+    if ( ! sourceFileCount ) return 0;
+    if ( ! (errors = calloc(sourceFileCount, sizeof(yamlErrorCode) + sizeof(bool))) ) {
+        for ( i = 0; i < sourceFileCount; i++ ) {
+            outConfigFiles[i] = NULL;
+            if ( outErrors ) outErrors[i] = yamlConfigFileError_outOfMemory;
+        }
+        return 0;
+    }
+    isFromCache = (bool*)(errors + sourceFileCount);
+    batch.sourceFilePaths = sourceFilePaths;
+    batch.fileCount = sourceFileCount;
+    batch.options = options;
+    batch.configFiles = outConfigFiles;
+    batch.errors = outErrors ? outErrors : errors;
+    batch.nextFile = 0;
+    
+    // Satisfy what we can from the cache:
+    for ( i = 0; i < sourceFileCount; i++ ) {
+        outConfigFiles[i] = NULL;
+        batch.errors[i] = 0;
+        if ( ! (options & yamlConfigFileOptions_ignoreCachedCopy) && (outConfigFiles[i] = __yamlConfigFileCacheLookup(sourceFilePaths[i], options)) ) {
+            outConfigFiles[i] = yamlConfigFileRetain(outConfigFiles[i]);
+            isFromCache[i] = true;
+        }
+    }
+    
+    threadCount = __yamlConfigFileGetThreadCount(threadCount);
+    if ( threadCount > sourceFileCount ) threadCount = sourceFileCount;
+#ifdef HAVE_PTHREAD
+    if ( (threadCount > 1) && (pthread_mutex_init(&batch.nextFileLock, NULL) == 0) ) {
+        pthread_t       *threads = malloc((threadCount - 1) * sizeof(pthread_t));
+        unsigned int    startedCount = 0;
+        
+        if ( threads ) {
+            while ( (startedCount < threadCount - 1) && (pthread_create(&threads[startedCount], NULL, __yamlConfigFileBatchWorker, &batch) == 0) ) startedCount++;
+        }
+        __yamlConfigFileBatchWorker(&batch);
+        while ( startedCount ) pthread_join(threads[--startedCount], NULL);
+        if ( threads ) free((void*)threads);
+        pthread_mutex_destroy(&batch.nextFileLock);
+    } else {
+        __yamlConfigFileBatchWorker(&batch);
+    }
+#else
+    __yamlConfigFileBatchWorker(&batch);
+#endif
+    
+    // Add the new files to the cache in order:
+    for ( i = 0; i < sourceFileCount; i++ ) {
+        yamlConfigFileRef   newConfigFile = outConfigFiles[i];
+        
+        if ( ! newConfigFile ) continue;
+        loadedCount++;
+        if ( isFromCache[i] ) continue;
+        newConfigFile->options = options;
+        if ( ! (options & yamlConfigFileOptions_doNotCache) ) {
+            yamlConfigFileRef   cachedConfigFile = NULL;
+            
+            // A path repeated in the batch shares the first copy:
+            if ( ! (options & yamlConfigFileOptions_ignoreCachedCopy) ) cachedConfigFile = __yamlConfigFileCacheLookup(sourceFilePaths[i], options);
+            if ( cachedConfigFile ) {
+                yamlConfigFileRelease(newConfigFile);
+                outConfigFiles[i] = yamlConfigFileRetain(cachedConfigFile);
+            } else {
+                newConfigFile->fileId = __yamlConfigFileCacheAdd(newConfigFile);
+                DEBUG_PRINTF("file \"%s\" cached with id %u", sourceFilePaths[i], newConfigFile->fileId);
+            }
+        }
+    }
+    free((void*)errors);
+    return loadedCount;
+}
+
+//
+
+unsigned int
+yamlConfigFileGetRefCount(
+    yamlConfigFileRef   aConfigFile
+)
+{
+    return aConfigFile->refCount;
+}
+
+//
+
+yamlConfigFileRef
+yamlConfigFileRetain(
+    yamlConfigFileRef   aConfigFile
+)
+{
+    aConfigFile->refCount++;
+    return aConfigFile;
+}
+
+//
+
+void
+yamlConfigFileRelease(
+    yamlConfigFileRef   aConfigFile
+)
+{
+    if ( --aConfigFile->refCount == 0 ) {
+        DEBUG_PRINTF("closing yamlConfigFile@%p (path \"%s\")", aConfigFile, aConfigFile->sourceFilePath ? aConfigFile->sourceFilePath : "<n/a>", aConfigFile);
+        if ( aConfigFile->keyPathCache ) yamlKeyPathCacheRelease(aConfigFile->keyPathCache);
+        if ( aConfigFile->mappingIndex ) yamlKeyPathMappingIndexRelease(aConfigFile->mappingIndex);
+        if ( aConfigFile->documentIndex ) __yamlConfigFileDocumentIndexDestroy(aConfigFile->documentIndex);
+        if ( aConfigFile->lazyState ) __yamlConfigFileLazyStateDestroy(aConfigFile->lazyState);
+        // A snapshot's document points into the snapshot rather than owning
+        // its content:
+        if ( aConfigFile->snapshot ) __yamlConfigFileSnapshotDestroy(aConfigFile->snapshot);
+        else if ( aConfigFile->state & yamlConfigFileState_isDocumentParsed ) yaml_document_delete(&aConfigFile->document);
+        free((void*)aConfigFile);
+    }
+}
+
+//
+
+yamlConfigFileId
+yamlConfigFileGetId(
+    yamlConfigFileRef   aConfigFile
+)
+{
+    return aConfigFile->fileId;
+}
+
+//
+
+const char*
+yamlConfigFileGetSourceFilePath(
+    yamlConfigFileRef   aConfigFile
+)
+{
+    return aConfigFile->sourceFilePath;
+}
+
+//
+
+yaml_node_t*
+yamlConfigFileGetRootNode(
+    yamlConfigFileRef   aConfigFile
+)
+{
+    if ( aConfigFile->snapshot ) return __yamlConfigFileSnapshotGetNode(aConfigFile->snapshot, 1);
+    return ( (aConfigFile->state & yamlConfigFileState_isDocumentParsed) ? yaml_document_get_root_node(&aConfigFile->document) : NULL );
+}
+
+//
+
+yaml_node_t*
+yamlConfigFileGetNodeWithId(
+    yamlConfigFileRef   aConfigFile,
+    int                 nodeId
+)
+{
+    if ( aConfigFile->snapshot ) return __yamlConfigFileSnapshotGetNode(aConfigFile->snapshot, nodeId);
+    return ( (aConfigFile->state & yamlConfigFileState_isDocumentParsed) ? yaml_document_get_node(&aConfigFile->document, nodeId) : NULL );
+}
+
+//
+
+unsigned int
+yamlConfigFileGetMappingIndexThreshold(
+    yamlConfigFileRef   aConfigFile
+)
+{
+    return aConfigFile->mappingIndexMinimumKeyCount;
+}
+
+//
+
+void
+yamlConfigFileSetMappingIndexThreshold(
+    yamlConfigFileRef   aConfigFile,
+    unsigned int        minimumKeyCount
+)
+{
+    aConfigFile->mappingIndexMinimumKeyCount = minimumKeyCount;
+    if ( aConfigFile->mappingIndex ) yamlKeyPathMappingIndexSetMinimumKeyCount(aConfigFile->mappingIndex, minimumKeyCount);
+}
+
+//
+
+bool
+yamlConfigFileGetKeyPathCacheStats(
+    yamlConfigFileRef       aConfigFile,
+    yamlKeyPathCacheStats   *stats
+)
+{
+    if ( ! aConfigFile->keyPathCache ) return false;
+    yamlKeyPathCacheGetStats(aConfigFile->keyPathCache, stats);
+    return true;
+}
+
+//
+
+void
+yamlConfigFileSetKeyPathCacheCapacity(
+    yamlConfigFileRef   aConfigFile,
+    unsigned int        capacity
+)
+{
+    if ( aConfigFile->keyPathCache ) yamlKeyPathCacheSetCapacity(aConfigFile->keyPathCache, capacity);
+}
+
+//
+
+bool
+__yamlConfigFileLazySubtreeMaterialize(
+    yamlConfigFileRef           aConfigFile,
+    unsigned int                subtreeIndex
+)
+{
+    yamlConfigFileLazyState     *lazyState = aConfigFile->lazyState;
+    yamlConfigFileLazySubtree   *subtree = &lazyState->subtrees[subtreeIndex];
+    yaml_parser_t               parser;
+    yaml_node_t                 *rootNode;
+    
+    if ( subtree->document ) return true;
+    
+    // Parse the "key: value" text of the subtree on its own:
+    if ( ! yaml_parser_initialize(&parser) ) return false;
+    yaml_parser_set_input_string(&parser, lazyState->inputBuffer.bytes + subtree->start, subtree->end - subtree->start);
+    if ( yaml_parser_load(&parser, &subtree->ownDocument) ) {
+        subtree->hasOwnDocument = true;
+        rootNode = yaml_document_get_root_node(&subtree->ownDocument);
+        if ( rootNode && (rootNode->type == YAML_MAPPING_NODE) && (rootNode->data.mapping.pairs.top - rootNode->data.mapping.pairs.start == 1) ) {
+            subtree->document = &subtree->ownDocument;
+            subtree->valueNode = yaml_document_get_node(subtree->document, rootNode->data.mapping.pairs.start->value);
+        }
+    }
+    yaml_parser_delete(&parser);
+    
+    if ( ! subtree->valueNode ) {
+        // Most likely an alias to an anchor outside the subtree; resort to
+        // the full document:
+        if ( subtree->hasOwnDocument ) {
+            yaml_document_delete(&subtree->ownDocument);
+            subtree->hasOwnDocument = false;
+        }
+        DEBUG_PRINTF("subtree %u could not be parsed alone, loading full document", subtreeIndex);
+        if ( ! __yamlConfigFileLazyStateLoadFullDocument(lazyState) ) return false;
+        rootNode = yaml_document_get_root_node(&lazyState->fullDocument);
+        if ( ! rootNode || (rootNode->type != YAML_MAPPING_NODE) || (rootNode->data.mapping.pairs.top - rootNode->data.mapping.pairs.start != lazyState->subtreeCount) ) return false;
+        subtree->document = &lazyState->fullDocument;
+        subtree->valueNode = yaml_document_get_node(subtree->document, rootNode->data.mapping.pairs.start[subtreeIndex].value);
+        if ( ! subtree->valueNode ) {
+            subtree->document = NULL;
+            return false;
+        }
+        if ( ! lazyState->fullMappingIndex && aConfigFile->mappingIndexMinimumKeyCount ) {
+            lazyState->fullMappingIndex = yamlKeyPathMappingIndexCreate(subtree->document, aConfigFile->mappingIndexMinimumKeyCount);
+        }
+        if ( lazyState->fullMappingIndex ) subtree->mappingIndex = yamlKeyPathMappingIndexRetain(lazyState->fullMappingIndex);
+    }
+    else if ( aConfigFile->mappingIndexMinimumKeyCount ) {
+        subtree->mappingIndex = yamlKeyPathMappingIndexCreate(subtree->document, aConfigFile->mappingIndexMinimumKeyCount);
+    }
+    DEBUG_PRINTF("materialized subtree %u (%zu bytes)", subtreeIndex, subtree->end - subtree->start);
+    return true;
+}
+
+//
+
+yaml_document_t*
+__yamlConfigFileGetDocumentForNode(
+    yamlConfigFileRef           aConfigFile,
+    yaml_node_t                 *node,
+    yamlKeyPathMappingIndexRef  *outMappingIndex
+)
+{
+    if ( aConfigFile->lazyState && node ) {
+        unsigned int            i;
+        
+        for ( i = 0; i < aConfigFile->lazyState->subtreeCount; i++ ) {
+            yamlConfigFileLazySubtree   *subtree = &aConfigFile->lazyState->subtrees[i];
+            
+            if ( subtree->document && (node >= subtree->document->nodes.start) && (node < subtree->document->nodes.top) ) {
+                if ( outMappingIndex ) *outMappingIndex = subtree->mappingIndex;
+                return subtree->document;
+            }
+        }
+    }
+    if ( outMappingIndex ) *outMappingIndex = aConfigFile->mappingIndex;
+    return &aConfigFile->document;
+}
+
+//
+
+yaml_node_t*
+__yamlConfigFileLazyResolveNodeAtPath(
+    yamlConfigFileRef           aConfigFile,
+    yamlKeyPathRef              theKeyPath,
+    bool                        *isHandled,
+    yamlErrorCode               *outError,
+    yamlKeyPathNodeMatchType*   *failedAtMatchElement
+)
+{
+    yamlKeyPathNodeMatchType    *firstMatch = yamlKeyPathGetFirstNodeMatch(theKeyPath);
+    yaml_node_t                 *rootNode = yamlConfigFileGetRootNode(aConfigFile);
+    bool                        isCaseless = (YAMLCONFIGFILEOPTIONS_KEYPATHOPTIONS(aConfigFile->options) & yamlKeyPathApplyOptions_keysAreCaseless) ? true : false;
+    yaml_node_pair_t            *pair;
+    size_t                      keyLength;
+    
+    *isHandled = false;
+    if ( ! firstMatch || (firstMatch->type != YAML_MAPPING_NODE) || ! rootNode ) return NULL;
+    
+    // The first key match which is a deferred subtree?  Pairs in the
+    // skeleton correspond one-to-one with the subtrees:
+    keyLength = strlen(firstMatch->parameter.key);
+    for ( pair = rootNode->data.mapping.pairs.start; pair < rootNode->data.mapping.pairs.top; pair++ ) {
+        yaml_node_t             *keyNode = yaml_document_get_node(&aConfigFile->document, pair->key);
+        
+        if ( keyNode && (keyNode->type == YAML_SCALAR_NODE) && (keyNode->data.scalar.length == keyLength) ) {
+            if ( isCaseless ? (strncasecmp((const char*)keyNode->data.scalar.value, firstMatch->parameter.key, keyLength) == 0) : (memcmp(keyNode->data.scalar.value, firstMatch->parameter.key, keyLength) == 0) ) break;
+        }
+    }
+    if ( pair < rootNode->data.mapping.pairs.top ) {
+        unsigned int                subtreeIndex = pair - rootNode->data.mapping.pairs.start;
+        yamlConfigFileLazySubtree   *subtree = &aConfigFile->lazyState->subtrees[subtreeIndex];
+        yamlKeyPathNodeMatchType    *nextMatch = yamlKeyPathGetNextNodeMatch(firstMatch);
+        
+        if ( subtree->isLazy ) {
+            *isHandled = true;
+            if ( ! __yamlConfigFileLazySubtreeMaterialize(aConfigFile, subtreeIndex) ) {
+                if ( outError ) *outError = yamlConfigFileError_parseFailed;
+                if ( failedAtMatchElement ) *failedAtMatchElement = firstMatch;
+                return NULL;
+            }
+            if ( ! nextMatch ) return subtree->valueNode;
+            return yamlKeyPathApplyToDocumentFromNodeMatch(
+                            theKeyPath,
+                            nextMatch,
+                            YAMLCONFIGFILEOPTIONS_KEYPATHOPTIONS(aConfigFile->options),
+                            subtree->document,
+                            subtree->valueNode,
+                            subtree->mappingIndex,
+                            outError,
+                            failedAtMatchElement
+                        );
+        }
+    }
+    return NULL;
+}
+
+//
+
+yaml_node_t*
+__yamlConfigFileResolveNodeAtPath(
+    yamlConfigFileRef           aConfigFile,
+    yamlKeyPathRef              theKeyPath,
+    yaml_node_t                 *relativeToNode,
+    yamlErrorCode               *outError,
+    yamlKeyPathNodeMatchType*   *failedAtMatchElement
+)
+{
+    yaml_node_t                 *outNode;
+    
+    // Large mappings are indexed on-demand (a snapshot carries its own
+    // indexes):
+    if ( ! aConfigFile->mappingIndex && aConfigFile->mappingIndexMinimumKeyCount && (aConfigFile->state & yamlConfigFileState_isDocumentParsed) && ! aConfigFile->snapshot ) {
+        aConfigFile->mappingIndex = yamlKeyPathMappingIndexCreate(&aConfigFile->document, aConfigFile->mappingIndexMinimumKeyCount);
+    }
+    if ( aConfigFile->snapshot ) {
+        // Walk the snapshot's node records; only the resulting node is
+        // filled-in:
+        outNode = __yamlConfigFileSnapshotApplyKeyPath(
+                        aConfigFile->snapshot,
+                        theKeyPath,
+                        YAMLCONFIGFILEOPTIONS_KEYPATHOPTIONS(aConfigFile->options),
+                        relativeToNode,
+                        outError,
+                        failedAtMatchElement
+                    );
+    }
+    else if ( aConfigFile->lazyState ) {
+        bool                    isHandled = false;
+        
+        // Descending into a deferred subtree from the root?
+        if ( ! relativeToNode ) {
+            outNode = __yamlConfigFileLazyResolveNodeAtPath(aConfigFile, theKeyPath, &isHandled, outError, failedAtMatchElement);
+        }
+        if ( ! isHandled ) {
+            // The starting node may be in one of the subtree documents:
+            yamlKeyPathMappingIndexRef  mappingIndex;
+            yaml_document_t             *document = __yamlConfigFileGetDocumentForNode(aConfigFile, relativeToNode, &mappingIndex);
+            
+            outNode = yamlKeyPathApplyToDocumentWithMappingIndex(
+                            theKeyPath,
+                            YAMLCONFIGFILEOPTIONS_KEYPATHOPTIONS(aConfigFile->options),
+                            document,
+                            relativeToNode,
+                            mappingIndex,
+                            outError,
+                            failedAtMatchElement
+                        );
+        }
+    } else {
+        // Use the key path to walk to the node:
+        outNode = yamlKeyPathApplyToDocumentWithMappingIndex(
+                        theKeyPath,
+                        YAMLCONFIGFILEOPTIONS_KEYPATHOPTIONS(aConfigFile->options),
+                        &aConfigFile->document,
+                        relativeToNode,
+                        aConfigFile->mappingIndex,
+                        outError,
+                        failedAtMatchElement
+                    );
+    }
+    if ( outNode && aConfigFile->keyPathCache && ! relativeToNode ) yamlKeyPathCacheAdd(aConfigFile->keyPathCache, theKeyPath, outNode);
+    return outNode;
+}
+
+//
+
+yaml_node_t*
+yamlConfigFileGetCachedNodeAtPath(
+    yamlConfigFileRef           aConfigFile,
+    yamlKeyPathRef              theKeyPath
+)
+{
+    const void                  *outNode = NULL;
+    
+    if ( aConfigFile->keyPathCache && yamlKeyPathCacheLookup(aConfigFile->keyPathCache, theKeyPath, &outNode) ) return (yaml_node_t*)outNode;
+    return NULL;
+}
+
+//
+
+yaml_node_t*
+yamlConfigFileResolveNodeAtPath(
+    yamlConfigFileRef           aConfigFile,
+    yamlKeyPathRef              theKeyPath
+)
+{
+    return __yamlConfigFileResolveNodeAtPath(aConfigFile, theKeyPath, NULL, NULL, NULL);
+}
+
+//
+
+yaml_node_t*
+yamlConfigFileGetNodeAtPath(
+    yamlConfigFileRef           aConfigFile,
+    yamlKeyPathRef              theKeyPath,
+    yaml_node_t                 *relativeToNode,
+    yamlErrorCode               *outError,
+    yamlKeyPathNodeMatchType*   *failedAtMatchElement
+)
+{
+    yaml_node_t                 *outNode = NULL;
+    
+    if ( outError ) *outError = 0;
+    if ( failedAtMatchElement ) *failedAtMatchElement = NULL;
+    
+    // Do we have a key path cache?  Cached nodes are relative to the
+    // document root, so nothing else can use the cache:
+    if ( relativeToNode && (relativeToNode == yamlConfigFileGetRootNode(aConfigFile)) ) relativeToNode = NULL;
+    if ( aConfigFile->keyPathCache && ! relativeToNode ) {
+        if ( yamlKeyPathCacheLookup(aConfigFile->keyPathCache, theKeyPath, (const void**)&outNode) ) {
+            DEBUG_PRINTF("cached yaml_node_t@%p found for yamlKeyPath@%p", outNode, theKeyPath);
+            return outNode;
+        }
+    }
+    return __yamlConfigFileResolveNodeAtPath(aConfigFile, theKeyPath, relativeToNode, outError, failedAtMatchElement);
+}
+
+//
+
+bool
+yamlConfigFileGetNodeAtPathIsType(
+    yamlConfigFileRef           aConfigFile,
+    yamlKeyPathRef              theKeyPath,
+    yaml_node_t                 *relativeToNode,
+    yamlErrorCode               *outError,
+    yamlKeyPathNodeMatchType*   *failedAtMatchElement,
+    yaml_node_type_t            yamlNodeType
+)
+{
+    bool                        success = false;
+    yaml_node_t                 *targetNode = yamlConfigFileGetNodeAtPath(aConfigFile, theKeyPath, relativeToNode, outError, failedAtMatchElement);
+    
+    if ( targetNode ) {
+        if ( targetNode->type == yamlNodeType ) {
+            success = true;
+        } else {
+            if ( outError ) *outError = yamlConfigFileError_invalidType;
+        }
+    }
+    return success;
+}
+
+//
+
+bool
+yamlConfigFileGetNodeAtPathContentString(
+    yamlConfigFileRef           aConfigFile,
+    yamlKeyPathRef              theKeyPath,
+    yaml_node_t                 *relativeToNode,
+    yamlErrorCode               *outError,
+    yamlKeyPathNodeMatchType*   *failedAtMatchElement,
+    const char*                 *contentString,
+    size_t                      *contentStringLength
+)
+{
+    bool                        success = false;
+    yaml_node_t                 *targetNode = yamlConfigFileGetNodeAtPath(aConfigFile, theKeyPath, relativeToNode, outError, failedAtMatchElement);
+    
+    if ( targetNode ) {
+        if ( targetNode->type == YAML_SCALAR_NODE ) {
+            *contentString = (const char*)targetNode->data.scalar.value;
+            *contentStringLength = targetNode->data.scalar.length;
+            success = true;
+        } else {
+            if ( outError ) *outError = yamlConfigFileError_invalidType;
+        }
+    }
+    return success;
+}
+
+//
+
+bool
+yamlConfigFileGetNodeAtPathSequenceLength(
+    yamlConfigFileRef           aConfigFile,
+    yamlKeyPathRef              theKeyPath,
+    yaml_node_t                 *relativeToNode,
+    yamlErrorCode               *outError,
+    yamlKeyPathNodeMatchType*   *failedAtMatchElement,
+    unsigned int                *sequenceLength
+)
+{
+    bool                        success = false;
+    yaml_node_t                 *targetNode = yamlConfigFileGetNodeAtPath(aConfigFile, theKeyPath, relativeToNode, outError, failedAtMatchElement);
+    
+    if ( targetNode ) {
+        if ( targetNode->type == YAML_SEQUENCE_NODE ) {
+            *sequenceLength = targetNode->data.sequence.items.top - targetNode->data.sequence.items.start;
+            success = true;
+        } else {
+            if ( outError ) *outError = yamlConfigFileError_invalidType;
+        }
+    }
+    return success;
+}
+
+//
+
+bool
+yamlConfigFileGetNodeAtPathMappingKeyCount(
+    yamlConfigFileRef           aConfigFile,
+    yamlKeyPathRef              theKeyPath,
+    yaml_node_t                 *relativeToNode,
+    yamlErrorCode               *outError,
+    yamlKeyPathNodeMatchType*   *failedAtMatchElement,
+    unsigned int                *mappingKeyCount
+)
+{
+    bool                        success = false;
+    yaml_node_t                 *targetNode = yamlConfigFileGetNodeAtPath(aConfigFile, theKeyPath, relativeToNode, outError, failedAtMatchElement);
+    
+    if ( targetNode ) {
+        if ( targetNode->type == YAML_MAPPING_NODE ) {
+            *mappingKeyCount = targetNode->data.mapping.pairs.top - targetNode->data.mapping.pairs.start;
+            success = true;
+        } else {
+            if ( outError ) *outError = yamlConfigFileError_invalidType;
+        }
+    }
+    return success;
+}
+
+//
+
+bool
+yamlConfigFileGetNodeAtPathMappingOrSequenceLength(
+    yamlConfigFileRef           aConfigFile,
+    yamlKeyPathRef              theKeyPath,
+    yaml_node_t                 *relativeToNode,
+    yamlErrorCode               *outError,
+    yamlKeyPathNodeMatchType*   *failedAtMatchElement,
+    unsigned int                *sequenceOrMappingLength
+)
+{
+    bool                        success = false;
+    yaml_node_t                 *targetNode = yamlConfigFileGetNodeAtPath(aConfigFile, theKeyPath, relativeToNode, outError, failedAtMatchElement);
+    
+    if ( targetNode ) {
+        switch ( targetNode->type ) {
+            case YAML_SEQUENCE_NODE: {
+                *sequenceOrMappingLength = targetNode->data.sequence.items.top - targetNode->data.sequence.items.start;
+                success = true;
+                break;
+            }
+            case  YAML_MAPPING_NODE: {
+                *sequenceOrMappingLength = targetNode->data.mapping.pairs.top - targetNode->data.mapping.pairs.start;
+                success = true;
+                break;
+            }
+            default:
+                if ( outError ) *outError = yamlConfigFileError_invalidType;
+                break;
+        }
+    }
+    return success;
+}
+
+//
+
+bool
+__yamlConfigFileCoerceScalar(
+    yamlConfigFileRef           aConfigFile,
+    yamlKeyPathRef              theKeyPath,
+    yaml_node_t                 *relativeToNode,
+    yamlErrorCode               *outError,
+    yamlKeyPathNodeMatchType*   *failedAtMatchElement,
+    yamlConfigFileCoerceToType  coerceToType,
+    va_list                     vargs
+)
+{
+    yaml_node_t                 *targetNode = yamlConfigFileGetNodeAtPath(aConfigFile, theKeyPath, relativeToNode, outError, failedAtMatchElement);
+    
+    if ( targetNode ) {
+        if ( targetNode->type == YAML_SCALAR_NODE ) {
+            switch ( coerceToType ) {
+                
+                case yamlConfigFileCoerceToType_cstring: {
+                    char            *buffer = va_arg(vargs, char*);
+                    size_t          *bufferLen = va_arg(vargs, size_t*);
+                    
+                    if ( bufferLen ) {
+                        size_t      copyLen = *bufferLen;
+                        
+                        if ( buffer && copyLen ) {
+                            if ( targetNode->data.scalar.length < copyLen ) {
+                                memcpy(buffer, targetNode->data.scalar.value, targetNode->data.scalar.length);
+                                buffer[targetNode->data.scalar.length] = '\0';
+                            } else {
+                                strncpy(buffer, (const char*)targetNode->data.scalar.value, copyLen);
+                            }
+                        }
+                        *bufferLen = targetNode->data.scalar.length;
+                    }
+                    return true;
+                }
+                
+                case yamlConfigFileCoerceToType_charArray: {
+                    char            *buffer = va_arg(vargs, char*);
+                    size_t          *bufferLen = va_arg(vargs, size_t*);
+                    
+                    if ( bufferLen ) {
+                        size_t      copyLen = *bufferLen;
+                        
+                        if ( buffer && copyLen ) {
+                            if ( targetNode->data.scalar.length <= copyLen ) copyLen = targetNode->data.scalar.length;
+                            memcpy(buffer, targetNode->data.scalar.value, copyLen);
+                        }
+                        *bufferLen = targetNode->data.scalar.length;
+                    }
+                    return true;
+                }
+                
+                case yamlConfigFileCoerceToType_bool: {
+                    bool            tmpValue;
+                    
+                    if ( __yamlScalarNodeToBool(targetNode, &tmpValue) ) {
+                        bool        *outValue = va_arg(vargs, bool*);
+                    
+                        if ( outValue ) *outValue = tmpValue;
+                        return true;
+                    } else {
+                        if ( outError ) *outError = yamlConfigFileError_failedToCoerce;
+                    }
+                    break;
+                }
+                
+                case yamlConfigFileCoerceToType_int:
+                case yamlConfigFileCoerceToType_longInt: 
+                case yamlConfigFileCoerceToType_longLongInt:
+                case yamlConfigFileCoerceToType_int8:
+                case yamlConfigFileCoerceToType_int16:
+                case yamlConfigFileCoerceToType_int32:
+                case yamlConfigFileCoerceToType_int64: {
+                    long long int   tmpValue;
+                    
+                    if ( __yamlScalarNodeToSignedInt(targetNode, &tmpValue) ) {
+                        bool        okay = false;
+                        
+                        switch ( coerceToType ) {
+                        
+                            case yamlConfigFileCoerceToType_int: {
+                                int     *outValue = va_arg(vargs, int*);
+                                
+                                if ( (tmpValue >= INT_MIN) && (tmpValue <= INT_MAX) ) {
+                                    if ( outValue ) *outValue = (int)tmpValue;
+                                    okay = true;
+                                } else {
+                                    if ( outError ) *outError = yamlConfigFileError_numberOutOfRange;
+                                }
+                                break;
+                            }
+                            
+                            case yamlConfigFileCoerceToType_longInt: {
+                                long int    *outValue = va_arg(vargs, long int*);
+                                
+                                if ( (tmpValue >= LONG_MIN) && (tmpValue <= LONG_MAX) ) {
+                                    if ( outValue ) *outValue = (long int)tmpValue;
+                                    okay = true;
+                                } else {
+                                    if ( outError ) *outError = yamlConfigFileError_numberOutOfRange;
+                                }
+                                break;
+                            }
+                            
+                            case yamlConfigFileCoerceToType_longLongInt: {
+                                long long int   *outValue = va_arg(vargs, long long int*);
+                                
+                                if ( outValue ) *outValue = tmpValue;
+                                okay = true;
+                                break;
+                            }
+                        
+                            case yamlConfigFileCoerceToType_int8: {
+                                int8_t  *outValue = va_arg(vargs, int8_t*);
+                                
+                                if ( (tmpValue >= INT8_MIN) && (tmpValue <= INT8_MAX) ) {
+                                    if ( outValue ) *outValue = (int8_t)tmpValue;
+                                    okay = true;
+                                } else {
+                                    if ( outError ) *outError = yamlConfigFileError_numberOutOfRange;
+                                }
+                                break;
+                            }
+                        
+                            case yamlConfigFileCoerceToType_int16: {
+                                int16_t *outValue = va_arg(vargs, int16_t*);
+                                
+                                if ( (tmpValue >= INT16_MIN) && (tmpValue <= INT16_MAX) ) {
+                                    if ( outValue ) *outValue = (int16_t)tmpValue;
+                                    okay = true;
+                                } else {
+                                    if ( outError ) *outError = yamlConfigFileError_numberOutOfRange;
+                                }
+                                break;
+                            }
+                        
+                            case yamlConfigFileCoerceToType_int32: {
+                                int32_t *outValue = va_arg(vargs, int32_t*);
+                                
+                                if ( (tmpValue >= INT32_MIN) && (tmpValue <= INT32_MAX) ) {
+                                    if ( outValue ) *outValue = (int32_t)tmpValue;
+                                    okay = true;
+                                } else {
+                                    if ( outError ) *outError = yamlConfigFileError_numberOutOfRange;
+                                }
+                                break;
+                            }
+                        
+                            case yamlConfigFileCoerceToType_int64: {
+                                int64_t *outValue = va_arg(vargs, int64_t*);
+                                
+                                if ( (tmpValue >= INT64_MIN) && (tmpValue <= INT64_MAX) ) {
+                                    if ( outValue ) *outValue = (int64_t)tmpValue;
+                                    okay = true;
+                                } else {
+                                    if ( outError ) *outError = yamlConfigFileError_numberOutOfRange;
+                                }
+                                break;
+                            }
+                        }
+                        return okay;
+                    } else {
+                        if ( outError ) *outError = yamlConfigFileError_failedToCoerce;
+                    }
+                    break;
+                }
+                
+                case yamlConfigFileCoerceToType_unsignedInt:
+                case yamlConfigFileCoerceToType_unsignedLongInt:
+                case yamlConfigFileCoerceToType_unsignedLongLongInt:
+                case yamlConfigFileCoerceToType_uint8:
+                case yamlConfigFileCoerceToType_uint16:
+                case yamlConfigFileCoerceToType_uint32:
+                case yamlConfigFileCoerceToType_uint64: {
+                    unsigned long long int  tmpValue;
+                    
+                    if ( __yamlScalarNodeToUnsignedInt(targetNode, &tmpValue) ) {
+                        bool        okay = false;
+                        
+                        switch ( coerceToType ) {
+                        
+                            case yamlConfigFileCoerceToType_unsignedInt: {
+                                unsigned int    *outValue = va_arg(vargs, unsigned int*);
+                                
+                                if ( tmpValue <= UINT_MAX ) {
+                                    if ( outValue ) *outValue = (unsigned int)tmpValue;
+                                    okay = true;
+                                } else {
+                                    if ( outError ) *outError = yamlConfigFileError_numberOutOfRange;
+                                }
+                                break;
+                            }
+                            
+                            case yamlConfigFileCoerceToType_unsignedLongInt: {
+                                unsigned long int   *outValue = va_arg(vargs, unsigned long int*);
+                                
+                                if ( tmpValue <= ULONG_MAX ) {
+                                    if ( outValue )  *outValue = (unsigned long int)tmpValue;
+                                    okay = true;
+                                } else {
+                                    if ( outError ) *outError = yamlConfigFileError_numberOutOfRange;
+                                }
+                                break;
+                            }
+                            
+                            case yamlConfigFileCoerceToType_unsignedLongLongInt: {
+                                unsigned long long int  *outValue = va_arg(vargs, unsigned long long int*);
+                                
+                                if ( outValue ) *outValue = tmpValue;
+                                okay = true;
+                                break;
+                            }
+                        
+                            case yamlConfigFileCoerceToType_uint8: {
+                                uint8_t     *outValue = va_arg(vargs, uint8_t*);
+                                
+                                if ( tmpValue <= UINT8_MAX ) {
+                                    if ( outValue ) *outValue = (uint8_t)tmpValue;
+                                    okay = true;
+                                } else {
+                                    if ( outError ) *outError = yamlConfigFileError_numberOutOfRange;
+                                }
+                                break;
+                            }
+                        
+                            case yamlConfigFileCoerceToType_uint16: {
+                                uint16_t    *outValue = va_arg(vargs, uint16_t*);
+                                
+                                if ( tmpValue <= UINT16_MAX ) {
+                                    if ( outValue ) *outValue = (uint16_t)tmpValue;
+                                    okay = true;
+                                } else {
+                                    if ( outError ) *outError = yamlConfigFileError_numberOutOfRange;
+                                }
+                                break;
+                            }
+                        
+                            case yamlConfigFileCoerceToType_uint32: {
+                                uint32_t    *outValue = va_arg(vargs, uint32_t*);
+                                
+                                if ( tmpValue <= UINT32_MAX ) {
+                                    if ( outValue ) *outValue = (uint32_t)tmpValue;
+                                    okay = true;
+                                } else {
+                                    if ( outError ) *outError = yamlConfigFileError_numberOutOfRange;
+                                }
+                                break;
+                            }
+                        
+                            case yamlConfigFileCoerceToType_uint64: {
+                                uint64_t    *outValue = va_arg(vargs, uint64_t*);
+                                
+                                if ( tmpValue <= UINT64_MAX ) {
+                                    if ( outValue ) *outValue = (uint64_t)tmpValue;
+                                    okay = true;
+                                } else {
+                                    if ( outError ) *outError = yamlConfigFileError_numberOutOfRange;
+                                }
+                                break;
+                            }
+                        }
+                        return okay;
+                    } else {
+                        if ( outError ) *outError = yamlConfigFileError_failedToCoerce;
+                    }
+                    break;
+                }
+                
+                case yamlConfigFileCoerceToType_float: {
+                    float       tmpValue;
+                    
+                    if ( __yamlScalarNodeToFloat(targetNode, &tmpValue) ) {
+                        float   *outValue = va_arg(vargs, float*);
+                        
+                        if ( outValue ) *outValue = tmpValue;
+                        return true;
+                    } else {
+                        if ( outError ) *outError = yamlConfigFileError_failedToCoerce;
+                    }
+                    break;
+                }
+                
+                case yamlConfigFileCoerceToType_double: {
+                    double      tmpValue;
+                    
+                    if ( __yamlScalarNodeToDouble(targetNode, &tmpValue) ) {
+                        double  *outValue = va_arg(vargs, double*);
+                        
+                        if ( outValue ) *outValue = tmpValue;
+                        return true;
+                    } else {
+                        if ( outError ) *outError = yamlConfigFileError_failedToCoerce;
+                    }
+                    break;
+                }
+            
+                default:
+                    if ( outError ) *outError = yamlConfigFileError_invalidType;
+                    break;
+            }
+        } else {
+            if ( outError ) *outError = yamlConfigFileError_invalidType;
+        }
+    }
+    return false;
+}
+
+//
+
+yamlKeyPathRef
+__yamlConfigFileCreateKeyPathWithString(
+    yamlConfigFileRef           aConfigFile,
+    const char                  *pathString,
+    size_t                      pathStringLen,
+    yamlErrorCode               *outError,
+    const char*                 *outErrorAtChar
+)
+{
+    // The intern table is shared by the whole process, so it is only used
+    // by files that opted in:
+    if ( aConfigFile->options & yamlConfigFileOptions_internKeyPaths ) {
+        return yamlKeyPathCreateWithStringInterned(pathString, pathStringLen, YAMLCONFIGFILEOPTIONS_KEYPATHOPTIONS(aConfigFile->options), outError, outErrorAtChar);
+    }
+    return yamlKeyPathCreateWithString(pathString, pathStringLen, YAMLCONFIGFILEOPTIONS_KEYPATHOPTIONS(aConfigFile->options), outError, outErrorAtChar);
+}
+
+//
+
+bool
+yamlConfigFileCoerceScalarAtPathString(
+    yamlConfigFileRef           aConfigFile,
+    const char                  *pathString,
+    size_t                      pathStringLen,
+    yaml_node_t                 *relativeToNode,
+    yamlErrorCode               *outError,
+    const char*                 *outErrorAtChar,
+    yamlKeyPathNodeMatchType*   *failedAtMatchElement,
+    yamlConfigFileCoerceToType  coerceToType,
+    ...
+)
+{
+    bool                        okay = false;
+    yamlKeyPathRef              keyPath = __yamlConfigFileCreateKeyPathWithString(aConfigFile, pathString, pathStringLen, outError, outErrorAtChar);
+    if ( keyPath ) {
+        va_list                 vargs;
+        
+        va_start(vargs, coerceToType);
+        okay = __yamlConfigFileCoerceScalar(aConfigFile, keyPath, relativeToNode, outError, failedAtMatchElement, coerceToType, vargs);
+        va_end(vargs);
+        yamlKeyPathRelease(keyPath);
+    }
+    return okay;
+}
+
+//
+
+bool
+yamlConfigFileCoerceScalarAtPath(
+    yamlConfigFileRef           aConfigFile,
+    yamlKeyPathRef              theKeyPath,
+    yaml_node_t                 *relativeToNode,
+    yamlErrorCode               *outError,
+    yamlKeyPathNodeMatchType*   *failedAtMatchElement,
+    yamlConfigFileCoerceToType  coerceToType,
+    ...
+)
+{
+    bool                        okay = false;
+    va_list                     vargs;
+        
+    va_start(vargs, coerceToType);
+    okay = __yamlConfigFileCoerceScalar(aConfigFile, theKeyPath, relativeToNode, outError, failedAtMatchElement, coerceToType, vargs);
+    va_end(vargs);
+    return okay;
+}
+
+//
+
+bool
+__yamlConfigFileCoerceSequence(
+    yamlConfigFileRef           aConfigFile,
+    yamlKeyPathRef              theKeyPath,
+    yaml_node_t                 *relativeToNode,
+    yamlErrorCode               *outError,
+    yamlKeyPathNodeMatchType*   *failedAtMatchElement,
+    unsigned int                startSequenceIndex,
+    unsigned int                endSequenceIndex,
+    yamlConfigFileCoerceToType  coerceToType,
+    va_list                     vargs
+)
+{
+    if ( startSequenceIndex <= endSequenceIndex ) {
+        yaml_node_t                 *targetNode = yamlConfigFileGetNodeAtPath(aConfigFile, theKeyPath, relativeToNode, outError, failedAtMatchElement);
+        
+        if ( targetNode ) {
+            yaml_document_t         *targetDocument = __yamlConfigFileGetDocumentForNode(aConfigFile, targetNode, NULL);
+            
+            if ( targetNode->type == YAML_SEQUENCE_NODE ) {
+                unsigned int        sequenceLength = targetNode->data.sequence.items.top - targetNode->data.sequence.items.start;
+                
+                // Validate the index range:
+                if ( (startSequenceIndex < sequenceLength) && (endSequenceIndex < sequenceLength) ) {
+                    yaml_node_item_t	*s = targetNode->data.sequence.items.start + startSequenceIndex;
+                    yaml_node_item_t	*e = targetNode->data.sequence.items.start + endSequenceIndex + 1;
+                    
+                    // Snapshot items are filled-in as they are needed:
+                    if ( aConfigFile->snapshot && ! __yamlConfigFileSnapshotGetItems(aConfigFile->snapshot, targetNode, startSequenceIndex, endSequenceIndex) ) {
+                        if ( outError ) *outError = yamlConfigFileError_internalError;
+                        return false;
+                    }
+                    
+                    switch ( coerceToType ) {
+                        
                         case yamlConfigFileCoerceToType_bool: {
                             bool            *outValue = va_arg(vargs, bool*);
                             
                             if ( outValue ) {
                                 while ( s < e ) {
-                                    yaml_node_t     *node = yaml_document_get_node(&aConfigFile->document, *s++);
+                                    yaml_node_t     *node = yaml_document_get_node(targetDocument, *s++);
                                     
                                     if ( node ) {
                                         if ( ! __yamlScalarNodeToBool(node, outValue) ) {
@@ -1256,7 +3258,7 @@ __yamlConfigFileCoerceSequence(
                             
                             if ( outValue ) {
                                 while ( s < e ) {
-                                    yaml_node_t     *node = yaml_document_get_node(&aConfigFile->document, *s++);
+                                    yaml_node_t     *node = yaml_document_get_node(targetDocument, *s++);
                                     
                                     if ( node ) {
                                         long long int   tmpValue;
@@ -1284,7 +3286,7 @@ __yamlConfigFileCoerceSequence(
                             
                             if ( outValue ) {
                                 while ( s < e ) {
-                                    yaml_node_t     *node = yaml_document_get_node(&aConfigFile->document, *s++);
+                                    yaml_node_t     *node = yaml_document_get_node(targetDocument, *s++);
                                     
                                     if ( node ) {
                                         long long int   tmpValue;
@@ -1312,7 +3314,7 @@ __yamlConfigFileCoerceSequence(
                             
                             if ( outValue ) {
                                 while ( s < e ) {
-                                    yaml_node_t     *node = yaml_document_get_node(&aConfigFile->document, *s++);
+                                    yaml_node_t     *node = yaml_document_get_node(targetDocument, *s++);
                                     
                                     if ( node ) {
                                         long long int   tmpValue;
@@ -1335,7 +3337,7 @@ __yamlConfigFileCoerceSequence(
                             
                             if ( outValue ) {
                                 while ( s < e ) {
-                                    yaml_node_t     *node = yaml_document_get_node(&aConfigFile->document, *s++);
+                                    yaml_node_t     *node = yaml_document_get_node(targetDocument, *s++);
                                     
                                     if ( node ) {
                                         long long int   tmpValue;
@@ -1363,7 +3365,7 @@ __yamlConfigFileCoerceSequence(
                             
                             if ( outValue ) {
                                 while ( s < e ) {
-                                    yaml_node_t     *node = yaml_document_get_node(&aConfigFile->document, *s++);
+                                    yaml_node_t     *node = yaml_document_get_node(targetDocument, *s++);
                                     
                                     if ( node ) {
                                         long long int   tmpValue;
@@ -1391,7 +3393,7 @@ __yamlConfigFileCoerceSequence(
                             
                             if ( outValue ) {
                                 while ( s < e ) {
-                                    yaml_node_t     *node = yaml_document_get_node(&aConfigFile->document, *s++);
+                                    yaml_node_t     *node = yaml_document_get_node(targetDocument, *s++);
                                     
                                     if ( node ) {
                                         long long int   tmpValue;
@@ -1419,7 +3421,7 @@ __yamlConfigFileCoerceSequence(
                             
                             if ( outValue ) {
                                 while ( s < e ) {
-                                    yaml_node_t     *node = yaml_document_get_node(&aConfigFile->document, *s++);
+                                    yaml_node_t     *node = yaml_document_get_node(targetDocument, *s++);
                                     
                                     if ( node ) {
                                         long long int   tmpValue;
@@ -1448,7 +3450,7 @@ __yamlConfigFileCoerceSequence(
                             
                             if ( outValue ) {
                                 while ( s < e ) {
-                                    yaml_node_t     *node = yaml_document_get_node(&aConfigFile->document, *s++);
+                                    yaml_node_t     *node = yaml_document_get_node(targetDocument, *s++);
                                     
                                     if ( node ) {
                                         unsigned long long int  tmpValue;
@@ -1476,7 +3478,7 @@ __yamlConfigFileCoerceSequence(
                             
                             if ( outValue ) {
                                 while ( s < e ) {
-                                    yaml_node_t     *node = yaml_document_get_node(&aConfigFile->document, *s++);
+                                    yaml_node_t     *node = yaml_document_get_node(targetDocument, *s++);
                                     
                                     if ( node ) {
                                         unsigned long long int  tmpValue;
@@ -1504,7 +3506,7 @@ __yamlConfigFileCoerceSequence(
                             
                             if ( outValue ) {
                                 while ( s < e ) {
-                                    yaml_node_t     *node = yaml_document_get_node(&aConfigFile->document, *s++);
+                                    yaml_node_t     *node = yaml_document_get_node(targetDocument, *s++);
                                     
                                     if ( node ) {
                                         unsigned long long int  tmpValue;
@@ -1527,7 +3529,7 @@ __yamlConfigFileCoerceSequence(
                             
                             if ( outValue ) {
                                 while ( s < e ) {
-                                    yaml_node_t     *node = yaml_document_get_node(&aConfigFile->document, *s++);
+                                    yaml_node_t     *node = yaml_document_get_node(targetDocument, *s++);
                                     
                                     if ( node ) {
                                         unsigned long long int  tmpValue;
@@ -1555,7 +3557,7 @@ __yamlConfigFileCoerceSequence(
                             
                             if ( outValue ) {
                                 while ( s < e ) {
-                                    yaml_node_t     *node = yaml_document_get_node(&aConfigFile->document, *s++);
+                                    yaml_node_t     *node = yaml_document_get_node(targetDocument, *s++);
                                     
                                     if ( node ) {
                                         unsigned long long int  tmpValue;
@@ -1583,7 +3585,7 @@ __yamlConfigFileCoerceSequence(
                             
                             if ( outValue ) {
                                 while ( s < e ) {
-                                    yaml_node_t     *node = yaml_document_get_node(&aConfigFile->document, *s++);
+                                    yaml_node_t     *node = yaml_document_get_node(targetDocument, *s++);
                                     
                                     if ( node ) {
                                         unsigned long long int  tmpValue;
@@ -1611,7 +3613,7 @@ __yamlConfigFileCoerceSequence(
                             
                             if ( outValue ) {
                                 while ( s < e ) {
-                                    yaml_node_t     *node = yaml_document_get_node(&aConfigFile->document, *s++);
+                                    yaml_node_t     *node = yaml_document_get_node(targetDocument, *s++);
                                     
                                     if ( node ) {
                                         unsigned long long int  tmpValue;
@@ -1640,7 +3642,7 @@ __yamlConfigFileCoerceSequence(
                             
                             if ( outValue ) {
                                 while ( s < e ) {
-                                    yaml_node_t *node = yaml_document_get_node(&aConfigFile->document, *s++);
+                                    yaml_node_t *node = yaml_document_get_node(targetDocument, *s++);
                                     
                                     if ( node ) {
                                         float   tmpValue;
@@ -1664,7 +3666,7 @@ __yamlConfigFileCoerceSequence(
                             
                             if ( outValue ) {
                                 while ( s < e ) {
-                                    yaml_node_t *node = yaml_document_get_node(&aConfigFile->document, *s++);
+                                    yaml_node_t *node = yaml_document_get_node(targetDocument, *s++);
                                     
                                     if ( node ) {
                                         double  tmpValue;
@@ -1688,72 +3690,2075 @@ __yamlConfigFileCoerceSequence(
                             break;
                     }
                 } else {
-                    if ( outError ) *outError = yamlConfigFileError_invalidSequenceIndex;
+                    if ( outError ) *outError = yamlConfigFileError_invalidSequenceIndex;
+                }
+            } else {
+                if ( outError ) *outError = yamlConfigFileError_invalidType;
+            }
+        }
+    }
+    return false;
+}
+
+//
+
+bool
+yamlConfigFileCoerceSequenceAtPathString(
+    yamlConfigFileRef           aConfigFile,
+    const char                  *pathString,
+    size_t                      pathStringLen,
+    yaml_node_t                 *relativeToNode,
+    yamlErrorCode               *outError,
+    const char*                 *outErrorAtChar,
+    yamlKeyPathNodeMatchType*   *failedAtMatchElement,
+    unsigned int                startSequenceIndex,
+    unsigned int                endSequenceIndex,
+    yamlConfigFileCoerceToType  coerceToType,
+    ...
+)
+{
+    bool                        okay = false;
+    yamlKeyPathRef              keyPath = __yamlConfigFileCreateKeyPathWithString(aConfigFile, pathString, pathStringLen, outError, outErrorAtChar);
+    if ( keyPath ) {
+        va_list                 vargs;
+        
+        va_start(vargs, coerceToType);
+        okay = __yamlConfigFileCoerceSequence(aConfigFile, keyPath, relativeToNode, outError, failedAtMatchElement, startSequenceIndex, endSequenceIndex, coerceToType, vargs);
+        va_end(vargs);
+        yamlKeyPathRelease(keyPath);
+    }
+    return okay;
+}
+
+//
+
+bool
+yamlConfigFileCoerceSequenceAtPath(
+    yamlConfigFileRef           aConfigFile,
+    yamlKeyPathRef              theKeyPath,
+    yaml_node_t                 *relativeToNode,
+    yamlErrorCode               *outError,
+    yamlKeyPathNodeMatchType*   *failedAtMatchElement,
+    unsigned int                startSequenceIndex,
+    unsigned int                endSequenceIndex,
+    yamlConfigFileCoerceToType  coerceToType,
+    ...
+)
+{
+    bool                        okay = false;
+    va_list                     vargs;
+        
+    va_start(vargs, coerceToType);
+    okay = __yamlConfigFileCoerceSequence(aConfigFile, theKeyPath, relativeToNode, outError, failedAtMatchElement, startSequenceIndex, endSequenceIndex, coerceToType, vargs);
+    va_end(vargs);
+    return okay;
+}
+
+//
+#if 0
+#pragma mark -
+#endif
+//
+
+bool
+yamlConfigFileGetBoolAtPathString(
+    yamlConfigFileRef           aConfigFile,
+    const char                  *pathString,
+    size_t                      pathStringLen,
+    bool                        defaultValue
+)
+{
+    yamlKeyPathRef              keyPath = __yamlConfigFileCreateKeyPathWithString(aConfigFile, pathString, pathStringLen, NULL, NULL);
+    
+    if ( keyPath ) {
+        yamlConfigFileTryGetBool(aConfigFile, keyPath, &defaultValue);
+        yamlKeyPathRelease(keyPath);
+    }
+    return defaultValue;
+}
+
+//
+
+int64_t
+yamlConfigFileGetInt64AtPathString(
+    yamlConfigFileRef           aConfigFile,
+    const char                  *pathString,
+    size_t                      pathStringLen,
+    int64_t                     defaultValue
+)
+{
+    yamlKeyPathRef              keyPath = __yamlConfigFileCreateKeyPathWithString(aConfigFile, pathString, pathStringLen, NULL, NULL);
+    
+    if ( keyPath ) {
+        yamlConfigFileTryGetInt64(aConfigFile, keyPath, &defaultValue);
+        yamlKeyPathRelease(keyPath);
+    }
+    return defaultValue;
+}
+
+//
+
+uint64_t
+yamlConfigFileGetUInt64AtPathString(
+    yamlConfigFileRef           aConfigFile,
+    const char                  *pathString,
+    size_t                      pathStringLen,
+    uint64_t                    defaultValue
+)
+{
+    yamlKeyPathRef              keyPath = __yamlConfigFileCreateKeyPathWithString(aConfigFile, pathString, pathStringLen, NULL, NULL);
+    
+    if ( keyPath ) {
+        yamlConfigFileTryGetUInt64(aConfigFile, keyPath, &defaultValue);
+        yamlKeyPathRelease(keyPath);
+    }
+    return defaultValue;
+}
+
+//
+
+double
+yamlConfigFileGetDoubleAtPathString(
+    yamlConfigFileRef           aConfigFile,
+    const char                  *pathString,
+    size_t                      pathStringLen,
+    double                      defaultValue
+)
+{
+    yamlKeyPathRef              keyPath = __yamlConfigFileCreateKeyPathWithString(aConfigFile, pathString, pathStringLen, NULL, NULL);
+    
+    if ( keyPath ) {
+        yamlConfigFileTryGetDouble(aConfigFile, keyPath, &defaultValue);
+        yamlKeyPathRelease(keyPath);
+    }
+    return defaultValue;
+}
+
+//
+#if 0
+#pragma mark -
+#endif
+//
+
+/*
+ * A yamlConfigFileStream keeps a single libyaml parser alive across
+ * calls so each yaml_parser_load() composes just the next document of the
+ * stream.  Nothing but the parser's own (fixed-size) buffers is retained
+ * between documents.
+ */
+
+typedef struct __yamlConfigFileStream {
+    unsigned int                refCount;
+    const char                  *sourceFilePath;
+    yamlOptionsBitvec           options;
+    yamlOptionsBitvec           state;
+    FILE                        *sourceFilePtr;
+    yamlConfigFileInputBuffer   inputBuffer;
+    yamlConfigFileDecompressor  *decompressor;
+    yaml_parser_t               parser;
+    unsigned int                documentCount;
+    size_t                      releasedLength;
+} yamlConfigFileStream;
+
+enum {
+    yamlConfigFileStreamState_ownsFilePtr = 1 << 0,
+    yamlConfigFileStreamState_hasInputBuffer = 1 << 1,
+    yamlConfigFileStreamState_isAtEnd = 1 << 2,
+    yamlConfigFileStreamState_hasFailed = 1 << 3
+};
+
+//
+
+yamlConfigFileStream*
+__yamlConfigFileStreamAlloc(
+    const char          *sourceFilePath,
+    yamlOptionsBitvec   options
+)
+{
+    size_t              sourceFilePathLen = (sourceFilePath ? (strlen(sourceFilePath) + 1) : 0);
+    yamlConfigFileStream *newStream = calloc(1, sizeof(yamlConfigFileStream) + sourceFilePathLen);
+    
+    if ( newStream ) {
+        if ( ! yaml_parser_initialize(&newStream->parser) ) {
+            free((void*)newStream);
+            return NULL;
+        }
+        newStream->refCount = 1;
+        // Documents are never added to the yamlConfigFile cache:
+        newStream->options = options | yamlConfigFileOptions_doNotCache;
+        if ( sourceFilePath ) {
+            newStream->sourceFilePath = (void*)newStream + sizeof(yamlConfigFileStream);
+            strncpy((char*)newStream->sourceFilePath, sourceFilePath, sourceFilePathLen);
+        }
+    }
+    return newStream;
+}
+
+//
+
+yamlConfigFileStreamRef
+yamlConfigFileStreamCreateWithInputString(
+    const char          *inputString,
+    size_t              inputStringLength,
+    yamlOptionsBitvec   options
+)
+{
+    yamlConfigFileStream    *newStream = __yamlConfigFileStreamAlloc(NULL, options);
+    
+    if ( newStream ) {
+        if ( inputStringLength == yamlCStringFullLength ) inputStringLength = strlen(inputString);
+        newStream->decompressor = __yamlConfigFileDecompressorSetParserInputString(&newStream->parser, (const unsigned char*)inputString, inputStringLength);
+    }
+    return newStream;
+}
+
+//
+
+yamlConfigFileStreamRef
+yamlConfigFileStreamCreateWithFilePointer(
+    FILE                *sourceFilePtr,
+    yamlOptionsBitvec   options
+)
+{
+    yamlConfigFileStream    *newStream = __yamlConfigFileStreamAlloc(NULL, options);
+    
+    if ( newStream ) {
+        newStream->sourceFilePtr = sourceFilePtr;
+        newStream->decompressor = __yamlConfigFileDecompressorSetParserInputFile(&newStream->parser, sourceFilePtr);
+    }
+    return newStream;
+}
+
+//
+
+yamlConfigFileStreamRef
+yamlConfigFileStreamCreateWithFileAtPath(
+    const char          *sourceFilePath,
+    yamlOptionsBitvec   options
+)
+{
+    yamlConfigFileStream    *newStream = __yamlConfigFileStreamAlloc(sourceFilePath, options);
+    
+    if ( newStream ) {
+        if ( options & yamlConfigFileOptions_mapInputFile ) {
+            if ( ! __yamlConfigFileInputBufferInitWithFileAtPath(&newStream->inputBuffer, sourceFilePath) ) {
+                yamlConfigFileStreamRelease(newStream);
+                return NULL;
+            }
+            newStream->state |= yamlConfigFileStreamState_hasInputBuffer;
+            newStream->decompressor = __yamlConfigFileDecompressorSetParserInputString(&newStream->parser, newStream->inputBuffer.bytes, newStream->inputBuffer.length);
+        } else {
+            newStream->sourceFilePtr = fopen(sourceFilePath, "r");
+            if ( ! newStream->sourceFilePtr ) {
+                yamlConfigFileStreamRelease(newStream);
+                return NULL;
+            }
+            newStream->state |= yamlConfigFileStreamState_ownsFilePtr;
+            newStream->decompressor = __yamlConfigFileDecompressorSetParserInputFile(&newStream->parser, newStream->sourceFilePtr);
+        }
+    }
+    return newStream;
+}
+
+//
+
+unsigned int
+yamlConfigFileStreamGetRefCount(
+    yamlConfigFileStreamRef aStream
+)
+{
+    return aStream->refCount;
+}
+
+//
+
+yamlConfigFileStreamRef
+yamlConfigFileStreamRetain(
+    yamlConfigFileStreamRef aStream
+)
+{
+    aStream->refCount++;
+    return aStream;
+}
+
+//
+
+void
+yamlConfigFileStreamRelease(
+    yamlConfigFileStreamRef aStream
+)
+{
+    if ( --aStream->refCount == 0 ) {
+        yaml_parser_delete(&aStream->parser);
+        if ( aStream->decompressor ) __yamlConfigFileDecompressorDestroy(aStream->decompressor);
+        if ( aStream->state & yamlConfigFileStreamState_hasInputBuffer ) __yamlConfigFileInputBufferDestroy(&aStream->inputBuffer);
+        if ( aStream->state & yamlConfigFileStreamState_ownsFilePtr ) fclose(aStream->sourceFilePtr);
+        free((void*)aStream);
+    }
+}
+
+//
+
+yamlConfigFileRef
+yamlConfigFileStreamNextDocument(
+    yamlConfigFileStreamRef aStream,
+    yamlErrorCode           *outError
+)
+{
+    yamlConfigFileRef       newConfigFile;
+    
+    if ( outError ) *outError = 0;
+    if ( aStream->state & yamlConfigFileStreamState_hasFailed ) {
+        if ( outError ) *outError = yamlConfigFileError_parseFailed;
+        return NULL;
+    }
+    if ( aStream->state & yamlConfigFileStreamState_isAtEnd ) return NULL;
+    
+    newConfigFile = __yamlConfigFileAlloc(aStream->sourceFilePath, aStream->options);
+    if ( ! newConfigFile ) {
+        if ( outError ) *outError = yamlConfigFileError_outOfMemory;
+        return NULL;
+    }
+    if ( ! yaml_parser_load(&aStream->parser, &newConfigFile->document) ) {
+        DEBUG_PRINTF("parse of document %u failed: %s", aStream->documentCount, aStream->parser.problem ? aStream->parser.problem : "<n/a>");
+        aStream->state |= yamlConfigFileStreamState_hasFailed;
+        if ( outError ) *outError = yamlConfigFileError_parseFailed;
+        yamlConfigFileRelease(newConfigFile);
+        return NULL;
+    }
+    newConfigFile->state = yamlConfigFileState_isDocumentParsed;
+    
+    // An empty document signals the end of the stream:
+    if ( ! yaml_document_get_root_node(&newConfigFile->document) ) {
+        aStream->state |= yamlConfigFileStreamState_isAtEnd;
+        yamlConfigFileRelease(newConfigFile);
+        return NULL;
+    }
+    aStream->documentCount++;
+    
+    // Drop mapped pages the parser has already consumed:
+    if ( aStream->state & yamlConfigFileStreamState_hasInputBuffer ) {
+        __yamlConfigFileInputBufferReleaseConsumed(&aStream->inputBuffer, aStream->decompressor ? __yamlConfigFileDecompressorGetConsumedTo(aStream->decompressor) : aStream->parser.input.string.current, &aStream->releasedLength);
+    }
+    return newConfigFile;
+}
+
+//
+
+unsigned int
+yamlConfigFileStreamGetDocumentCount(
+    yamlConfigFileStreamRef aStream
+)
+{
+    return aStream->documentCount;
+}
+
+//
+
+bool
+yamlConfigFileStreamIsAtEnd(
+    yamlConfigFileStreamRef aStream
+)
+{
+    return ( (aStream->state & yamlConfigFileStreamState_isAtEnd) != 0 );
+}
+
+//
+#if 0
+#pragma mark -
+#endif
+//
+
+yamlConfigFileDocumentIndex*
+__yamlConfigFileGetDocumentIndex(
+    yamlConfigFileRef           aConfigFile
+)
+{
+    // Files loaded by path without yamlConfigFileOptions_indexDocuments are
+    // indexed on first use, provided the file is still the one that was
+    // loaded (documents from streams, record iterators, snapshots et al.
+    // were never the whole file):
+    if ( ! aConfigFile->documentIndex && (aConfigFile->state & yamlConfigFileState_hasSourceFileInfo) ) {
+        yamlConfigFileSnapshotSource    sourceFileInfo;
+        yamlConfigFileInputBuffer       inputBuffer;
+        struct stat                     finfo;
+        int                             fd = open(aConfigFile->sourceFilePath, O_RDONLY);
+        
+        if ( fd >= 0 ) {
+            if ( (fstat(fd, &finfo) == 0) && __yamlConfigFileSnapshotSourceInitWithStat(&sourceFileInfo, &finfo)
+                    && (sourceFileInfo.size == aConfigFile->sourceFileInfo.size)
+                    && (sourceFileInfo.modificationSeconds == aConfigFile->sourceFileInfo.modificationSeconds)
+                    && (sourceFileInfo.modificationNanoseconds == aConfigFile->sourceFileInfo.modificationNanoseconds)
+                    && __yamlConfigFileInputBufferInitWithFileDescriptor(&inputBuffer, fd) )
+            {
+                if ( (inputBuffer.length == sourceFileInfo.size) && (aConfigFile->documentIndex = __yamlConfigFileDocumentIndexCreate(&inputBuffer)) ) {
+                    DEBUG_PRINTF("document index built for \"%s\"", aConfigFile->sourceFilePath);
+                } else {
+                    __yamlConfigFileInputBufferDestroy(&inputBuffer);
                 }
             } else {
-                if ( outError ) *outError = yamlConfigFileError_invalidType;
+                DEBUG_PRINTF("\"%s\" has changed since it was loaded, not indexed", aConfigFile->sourceFilePath);
+            }
+            close(fd);
+        }
+    }
+    return aConfigFile->documentIndex;
+}
+
+//
+
+unsigned int
+yamlConfigFileGetDocumentCount(
+    yamlConfigFileRef           aConfigFile
+)
+{
+    yamlConfigFileDocumentIndex *documentIndex = __yamlConfigFileGetDocumentIndex(aConfigFile);
+    
+    if ( documentIndex && documentIndex->documentCount ) return documentIndex->documentCount;
+    return ( yamlConfigFileGetRootNode(aConfigFile) ? 1 : 0 );
+}
+
+//
+
+yamlConfigFileRef
+yamlConfigFileGetDocumentAtIndex(
+    yamlConfigFileRef           aConfigFile,
+    unsigned int                documentIndex,
+    yamlErrorCode               *outError
+)
+{
+    yamlConfigFileDocumentIndex *theIndex;
+    yamlConfigFileDocumentCacheEntry *slot = NULL;
+    yamlConfigFileRef           theDocument = NULL;
+    yaml_parser_t               parser;
+    unsigned int                i;
+    
+    if ( outError ) *outError = 0;
+    
+    // The first document is the one wrapped by aConfigFile itself:
+    if ( documentIndex == 0 && yamlConfigFileGetRootNode(aConfigFile) ) return yamlConfigFileRetain(aConfigFile);
+    
+    theIndex = __yamlConfigFileGetDocumentIndex(aConfigFile);
+    if ( ! theIndex || (documentIndex >= theIndex->documentCount) ) {
+        if ( outError ) *outError = yamlConfigFileError_invalidDocumentIndex;
+        return NULL;
+    }
+    
+    // Previously-parsed document?
+    for ( i = 0; i < theIndex->cacheCapacity; i++ ) {
+        yamlConfigFileDocumentCacheEntry    *entry = &theIndex->cache[i];
+        
+        if ( ! entry->document ) {
+            if ( ! slot || slot->document ) slot = entry;
+        }
+        else if ( entry->documentIndex == documentIndex ) {
+            entry->lastUse = ++theIndex->useClock;
+            return yamlConfigFileRetain(entry->document);
+        }
+        else if ( ! slot || (slot->document && (entry->lastUse < slot->lastUse)) ) {
+            slot = entry;
+        }
+    }
+    
+    // Parse just the byte range of the document:
+    if ( ! yaml_parser_initialize(&parser) ) {
+        if ( outError ) *outError = yamlConfigFileError_outOfMemory;
+        return NULL;
+    }
+    yaml_parser_set_input_string(&parser,
+            theIndex->inputBuffer.bytes + theIndex->documentOffsets[documentIndex],
+            theIndex->documentOffsets[documentIndex + 1] - theIndex->documentOffsets[documentIndex]
+        );
+    theDocument = __yamlConfigFileCreateWithParser(&parser, aConfigFile->sourceFilePath, aConfigFile->options | yamlConfigFileOptions_doNotCache, NULL);
+    yaml_parser_delete(&parser);
+    if ( ! theDocument ) {
+        if ( outError ) *outError = yamlConfigFileError_parseFailed;
+        return NULL;
+    }
+    theDocument->mappingIndexMinimumKeyCount = aConfigFile->mappingIndexMinimumKeyCount;
+    DEBUG_PRINTF("parsed document %u of \"%s\"", documentIndex, aConfigFile->sourceFilePath);
+    
+    if ( slot ) {
+        if ( slot->document ) yamlConfigFileRelease(slot->document);
+        slot->documentIndex = documentIndex;
+        slot->document = yamlConfigFileRetain(theDocument);
+        slot->lastUse = ++theIndex->useClock;
+    }
+    return theDocument;
+}
+
+//
+
+void
+yamlConfigFileSetDocumentCacheCapacity(
+    yamlConfigFileRef           aConfigFile,
+    unsigned int                capacity
+)
+{
+    yamlConfigFileDocumentIndex *theIndex = __yamlConfigFileGetDocumentIndex(aConfigFile);
+    
+    if ( theIndex && (capacity != theIndex->cacheCapacity) ) {
+        yamlConfigFileDocumentCacheEntry    *newCache = NULL;
+        unsigned int                        i;
+        
+        if ( capacity && ! (newCache = calloc(capacity, sizeof(yamlConfigFileDocumentCacheEntry))) ) return;
+        // Discard all cached documents rather than trying to preserve the
+        // most-recently-used ones:
+        for ( i = 0; i < theIndex->cacheCapacity; i++ ) {
+            if ( theIndex->cache[i].document ) yamlConfigFileRelease(theIndex->cache[i].document);
+        }
+        if ( theIndex->cache ) free((void*)theIndex->cache);
+        theIndex->cache = newCache;
+        theIndex->cacheCapacity = capacity;
+    }
+}
+
+//
+#if 0
+#pragma mark -
+#endif
+//
+
+/*
+ * A yamlConfigFileRecordIterator walks the root sequence of a document by
+ * events, composing one item at a time into the document of a record
+ * yamlConfigFile.  The record object is recycled for the next item unless
+ * the caller has retained it, so iterating costs no per-record allocation
+ * beyond libyaml's nodes.
+ */
+
+typedef struct __yamlConfigFileRecordIterator {
+    unsigned int                refCount;
+    const char                  *sourceFilePath;
+    yamlOptionsBitvec           options;
+    yamlOptionsBitvec           state;
+    FILE                        *sourceFilePtr;
+    yamlConfigFileInputBuffer   inputBuffer;
+    yamlConfigFileDecompressor  *decompressor;
+    yaml_parser_t               parser;
+    unsigned int                recordCount;
+    size_t                      releasedLength;
+    yamlConfigFileRef           record;
+    yamlErrorCode               failedError;
+} yamlConfigFileRecordIterator;
+
+enum {
+    yamlConfigFileRecordIteratorState_ownsFilePtr = 1 << 0,
+    yamlConfigFileRecordIteratorState_hasInputBuffer = 1 << 1,
+    yamlConfigFileRecordIteratorState_isInRootSequence = 1 << 2,
+    yamlConfigFileRecordIteratorState_isAtEnd = 1 << 3,
+    yamlConfigFileRecordIteratorState_hasFailed = 1 << 4
+};
+
+//
+
+yamlConfigFileRecordIterator*
+__yamlConfigFileRecordIteratorAlloc(
+    const char          *sourceFilePath,
+    yamlOptionsBitvec   options
+)
+{
+    size_t              sourceFilePathLen = (sourceFilePath ? (strlen(sourceFilePath) + 1) : 0);
+    yamlConfigFileRecordIterator *newIterator = calloc(1, sizeof(yamlConfigFileRecordIterator) + sourceFilePathLen);
+    
+    if ( newIterator ) {
+        if ( ! yaml_parser_initialize(&newIterator->parser) ) {
+            free((void*)newIterator);
+            return NULL;
+        }
+        newIterator->refCount = 1;
+        // Records are never added to the yamlConfigFile cache:
+        newIterator->options = options | yamlConfigFileOptions_doNotCache;
+        if ( sourceFilePath ) {
+            newIterator->sourceFilePath = (void*)newIterator + sizeof(yamlConfigFileRecordIterator);
+            strncpy((char*)newIterator->sourceFilePath, sourceFilePath, sourceFilePathLen);
+        }
+    }
+    return newIterator;
+}
+
+//
+
+yamlConfigFileRecordIteratorRef
+yamlConfigFileRecordIteratorCreateWithInputString(
+    const char          *inputString,
+    size_t              inputStringLength,
+    yamlOptionsBitvec   options
+)
+{
+    yamlConfigFileRecordIterator    *newIterator = __yamlConfigFileRecordIteratorAlloc(NULL, options);
+    
+    if ( newIterator ) {
+        if ( inputStringLength == yamlCStringFullLength ) inputStringLength = strlen(inputString);
+        newIterator->decompressor = __yamlConfigFileDecompressorSetParserInputString(&newIterator->parser, (const unsigned char*)inputString, inputStringLength);
+    }
+    return newIterator;
+}
+
+//
+
+yamlConfigFileRecordIteratorRef
+yamlConfigFileRecordIteratorCreateWithFilePointer(
+    FILE                *sourceFilePtr,
+    yamlOptionsBitvec   options
+)
+{
+    yamlConfigFileRecordIterator    *newIterator = __yamlConfigFileRecordIteratorAlloc(NULL, options);
+    
+    if ( newIterator ) {
+        newIterator->sourceFilePtr = sourceFilePtr;
+        newIterator->decompressor = __yamlConfigFileDecompressorSetParserInputFile(&newIterator->parser, sourceFilePtr);
+    }
+    return newIterator;
+}
+
+//
+
+yamlConfigFileRecordIteratorRef
+yamlConfigFileRecordIteratorCreateWithFileAtPath(
+    const char          *sourceFilePath,
+    yamlOptionsBitvec   options
+)
+{
+    yamlConfigFileRecordIterator    *newIterator = __yamlConfigFileRecordIteratorAlloc(sourceFilePath, options);
+    
+    if ( newIterator ) {
+        if ( options & yamlConfigFileOptions_mapInputFile ) {
+            if ( ! __yamlConfigFileInputBufferInitWithFileAtPath(&newIterator->inputBuffer, sourceFilePath) ) {
+                yamlConfigFileRecordIteratorRelease(newIterator);
+                return NULL;
+            }
+            newIterator->state |= yamlConfigFileRecordIteratorState_hasInputBuffer;
+            newIterator->decompressor = __yamlConfigFileDecompressorSetParserInputString(&newIterator->parser, newIterator->inputBuffer.bytes, newIterator->inputBuffer.length);
+        } else {
+            newIterator->sourceFilePtr = fopen(sourceFilePath, "r");
+            if ( ! newIterator->sourceFilePtr ) {
+                yamlConfigFileRecordIteratorRelease(newIterator);
+                return NULL;
+            }
+            newIterator->state |= yamlConfigFileRecordIteratorState_ownsFilePtr;
+            newIterator->decompressor = __yamlConfigFileDecompressorSetParserInputFile(&newIterator->parser, newIterator->sourceFilePtr);
+        }
+    }
+    return newIterator;
+}
+
+//
+
+unsigned int
+yamlConfigFileRecordIteratorGetRefCount(
+    yamlConfigFileRecordIteratorRef anIterator
+)
+{
+    return anIterator->refCount;
+}
+
+//
+
+yamlConfigFileRecordIteratorRef
+yamlConfigFileRecordIteratorRetain(
+    yamlConfigFileRecordIteratorRef anIterator
+)
+{
+    anIterator->refCount++;
+    return anIterator;
+}
+
+//
+
+void
+yamlConfigFileRecordIteratorRelease(
+    yamlConfigFileRecordIteratorRef anIterator
+)
+{
+    if ( --anIterator->refCount == 0 ) {
+        if ( anIterator->record ) yamlConfigFileRelease(anIterator->record);
+        yaml_parser_delete(&anIterator->parser);
+        if ( anIterator->decompressor ) __yamlConfigFileDecompressorDestroy(anIterator->decompressor);
+        if ( anIterator->state & yamlConfigFileRecordIteratorState_hasInputBuffer ) __yamlConfigFileInputBufferDestroy(&anIterator->inputBuffer);
+        if ( anIterator->state & yamlConfigFileRecordIteratorState_ownsFilePtr ) fclose(anIterator->sourceFilePtr);
+        free((void*)anIterator);
+    }
+}
+
+//
+
+yamlErrorCode
+__yamlConfigFileRecordIteratorEnterRootSequence(
+    yamlConfigFileRecordIteratorRef anIterator
+)
+{
+    yaml_event_t                    event;
+    
+    // Skip the stream and document start to the root node:
+    while ( 1 ) {
+        if ( ! yaml_parser_parse(&anIterator->parser, &event) ) return yamlConfigFileError_parseFailed;
+        switch ( event.type ) {
+            case YAML_STREAM_START_EVENT:
+            case YAML_DOCUMENT_START_EVENT:
+                yaml_event_delete(&event);
+                continue;
+            case YAML_STREAM_END_EVENT:
+                // An empty stream has no records:
+                anIterator->state |= yamlConfigFileRecordIteratorState_isAtEnd;
+                yaml_event_delete(&event);
+                return 0;
+            case YAML_SEQUENCE_START_EVENT:
+                anIterator->state |= yamlConfigFileRecordIteratorState_isInRootSequence;
+                yaml_event_delete(&event);
+                return 0;
+            default:
+                DEBUG_PRINTF("root node is not a sequence (event type %d)", event.type);
+                yaml_event_delete(&event);
+                return yamlConfigFileError_invalidType;
+        }
+    }
+}
+
+//
+
+yamlConfigFileRef
+__yamlConfigFileRecordIteratorGetRecordObject(
+    yamlConfigFileRecordIteratorRef anIterator
+)
+{
+    yamlConfigFileRef               theRecord = anIterator->record;
+    
+    if ( theRecord && (theRecord->refCount == 1) ) {
+        // Nobody else holds the previous record, so recycle it:
+        if ( theRecord->state & yamlConfigFileState_isDocumentParsed ) yaml_document_delete(&theRecord->document);
+        theRecord->state &= ~yamlConfigFileState_isDocumentParsed;
+        if ( theRecord->keyPathCache ) yamlKeyPathCacheClear(theRecord->keyPathCache);
+        if ( theRecord->mappingIndex ) {
+            yamlKeyPathMappingIndexRelease(theRecord->mappingIndex);
+            theRecord->mappingIndex = NULL;
+        }
+        return theRecord;
+    }
+    if ( theRecord ) yamlConfigFileRelease(theRecord);
+    anIterator->record = __yamlConfigFileAlloc(anIterator->sourceFilePath, anIterator->options);
+    return anIterator->record;
+}
+
+//
+
+yamlConfigFileRef
+yamlConfigFileRecordIteratorNextRecord(
+    yamlConfigFileRecordIteratorRef anIterator,
+    yamlErrorCode                   *outError
+)
+{
+    yamlConfigFileRef               theRecord;
+    yaml_event_t                    event;
+    bool                            isComposed;
+    
+    if ( outError ) *outError = 0;
+    if ( anIterator->state & yamlConfigFileRecordIteratorState_hasFailed ) {
+        if ( outError ) *outError = anIterator->failedError;
+        return NULL;
+    }
+    if ( anIterator->state & yamlConfigFileRecordIteratorState_isAtEnd ) return NULL;
+    
+    if ( ! (anIterator->state & yamlConfigFileRecordIteratorState_isInRootSequence) ) {
+        yamlErrorCode               theError = __yamlConfigFileRecordIteratorEnterRootSequence(anIterator);
+        
+        if ( theError ) {
+            anIterator->state |= yamlConfigFileRecordIteratorState_hasFailed;
+            anIterator->failedError = theError;
+            if ( outError ) *outError = theError;
+            return NULL;
+        }
+        if ( anIterator->state & yamlConfigFileRecordIteratorState_isAtEnd ) return NULL;
+    }
+    
+    // The next event either ends the root sequence or starts an item:
+    if ( ! yaml_parser_parse(&anIterator->parser, &event) ) {
+        anIterator->state |= yamlConfigFileRecordIteratorState_hasFailed;
+        anIterator->failedError = yamlConfigFileError_parseFailed;
+        if ( outError ) *outError = yamlConfigFileError_parseFailed;
+        return NULL;
+    }
+    if ( event.type == YAML_SEQUENCE_END_EVENT ) {
+        anIterator->state |= yamlConfigFileRecordIteratorState_isAtEnd;
+        yaml_event_delete(&event);
+        return NULL;
+    }
+    
+    if ( ! (theRecord = __yamlConfigFileRecordIteratorGetRecordObject(anIterator)) ) {
+        yaml_event_delete(&event);
+        if ( outError ) *outError = yamlConfigFileError_outOfMemory;
+        return NULL;
+    }
+    isComposed = yaml_document_initialize(&theRecord->document, NULL, NULL, NULL, 1, 1);
+    if ( isComposed ) {
+        theRecord->state |= yamlConfigFileState_isDocumentParsed;
+        isComposed = __yamlConfigFileFilterComposeNode(&anIterator->parser, &event, NULL, YAMLCONFIGFILEOPTIONS_KEYPATHOPTIONS(anIterator->options), &theRecord->document);
+    }
+    yaml_event_delete(&event);
+    if ( ! isComposed ) {
+        DEBUG_PRINTF("composition of record %u failed: %s", anIterator->recordCount, anIterator->parser.problem ? anIterator->parser.problem : "<n/a>");
+        anIterator->state |= yamlConfigFileRecordIteratorState_hasFailed;
+        anIterator->failedError = yamlConfigFileError_parseFailed;
+        if ( outError ) *outError = yamlConfigFileError_parseFailed;
+        return NULL;
+    }
+    anIterator->recordCount++;
+    
+    // Drop mapped pages the parser has already consumed:
+    if ( anIterator->state & yamlConfigFileRecordIteratorState_hasInputBuffer ) {
+        __yamlConfigFileInputBufferReleaseConsumed(&anIterator->inputBuffer, anIterator->decompressor ? __yamlConfigFileDecompressorGetConsumedTo(anIterator->decompressor) : anIterator->parser.input.string.current, &anIterator->releasedLength);
+    }
+    return theRecord;
+}
+
+//
+
+unsigned int
+yamlConfigFileRecordIteratorGetRecordCount(
+    yamlConfigFileRecordIteratorRef anIterator
+)
+{
+    return anIterator->recordCount;
+}
+
+//
+
+bool
+yamlConfigFileRecordIteratorIsAtEnd(
+    yamlConfigFileRecordIteratorRef anIterator
+)
+{
+    return ( (anIterator->state & yamlConfigFileRecordIteratorState_isAtEnd) != 0 );
+}
+
+//
+#if 0
+#pragma mark -
+#endif
+//
+
+/*
+ * A yamlConfigFileAsyncLoad is queued to a pool of detached worker threads
+ * that grows on demand up to the configured size.  Both the caller and the
+ * worker hold a reference, so the load's mutex guards its reference count
+ * and state.  Workers never touch the yamlConfigFile cache:  it is
+ * consulted when the load is created and filled when the result is
+ * collected, both on the caller's thread.  For the same reason collection
+ * waits for the worker to drop its reference, so a cached yamlConfigFile
+ * is never released on a worker thread.
+ */
+
+typedef struct __yamlConfigFileAsyncLoad {
+    unsigned int                        refCount;
+    const char                          *sourceFilePath;
+    yamlOptionsBitvec                   options;
+    yamlOptionsBitvec                   state;
+    double                              deadline;
+    yamlConfigFileAsyncLoadCallback     callback;
+    void                                *context;
+    yamlConfigFileRef                   configFile;
+    yamlErrorCode                       error;
+    int                                 notifyFds[2];
+    struct __yamlConfigFileAsyncLoad    *nextQueued;
+#ifdef HAVE_PTHREAD
+    pthread_mutex_t                     lock;
+    pthread_cond_t                      stateChanged;
+#endif
+} yamlConfigFileAsyncLoad;
+
+enum {
+    yamlConfigFileAsyncLoadState_isCancelled = 1 << 0,
+    yamlConfigFileAsyncLoadState_isComplete = 1 << 1,
+    yamlConfigFileAsyncLoadState_isWorkerDone = 1 << 2,
+    yamlConfigFileAsyncLoadState_isFromCache = 1 << 3,
+    yamlConfigFileAsyncLoadState_isCollected = 1 << 4
+};
+
+static unsigned int __yamlConfigFileAsyncLoadThreadCount = 0;
+
+#ifdef HAVE_PTHREAD
+static pthread_mutex_t                  __yamlConfigFileAsyncLoadQueueLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t                   __yamlConfigFileAsyncLoadQueueIsNotEmpty = PTHREAD_COND_INITIALIZER;
+static yamlConfigFileAsyncLoad          *__yamlConfigFileAsyncLoadQueueHead = NULL;
+static yamlConfigFileAsyncLoad          *__yamlConfigFileAsyncLoadQueueTail = NULL;
+static unsigned int                     __yamlConfigFileAsyncLoadQueueLength = 0;
+static unsigned int                     __yamlConfigFileAsyncLoadWorkerCount = 0;
+static unsigned int                     __yamlConfigFileAsyncLoadIdleWorkerCount = 0;
+#endif
+
+//
+
+static inline void
+__yamlConfigFileAsyncLoadLock(
+    yamlConfigFileAsyncLoad     *aLoad
+)
+{
+#ifdef HAVE_PTHREAD
+    pthread_mutex_lock(&aLoad->lock);
+#endif
+}
+
+//
+
+static inline void
+__yamlConfigFileAsyncLoadUnlock(
+    yamlConfigFileAsyncLoad     *aLoad
+)
+{
+#ifdef HAVE_PTHREAD
+    pthread_mutex_unlock(&aLoad->lock);
+#endif
+}
+
+//
+
+double
+__yamlConfigFileGetTime()
+{
+    struct timespec             now;
+    
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + 1.0e-9 * (double)now.tv_nsec;
+}
+
+//
+
+yamlErrorCode
+__yamlConfigFileAsyncLoadGetInterruption(
+    yamlConfigFileAsyncLoad     *aLoad
+)
+{
+    bool                        isCancelled;
+    
+    __yamlConfigFileAsyncLoadLock(aLoad);
+    isCancelled = ( (aLoad->state & yamlConfigFileAsyncLoadState_isCancelled) != 0 );
+    __yamlConfigFileAsyncLoadUnlock(aLoad);
+    if ( isCancelled ) return yamlConfigFileError_loadCancelled;
+    if ( (aLoad->deadline > 0.0) && (__yamlConfigFileGetTime() >= aLoad->deadline) ) return yamlConfigFileError_loadDeadlineExpired;
+    return 0;
+}
+
+//
+
+void
+__yamlConfigFileAsyncLoadNotify(
+    yamlConfigFileAsyncLoad     *aLoad
+)
+{
+#ifdef HAVE_EVENTFD
+    uint64_t                    one = 1;
+    
+    if ( write(aLoad->notifyFds[1], &one, sizeof(one)) < 0 ) {
+        DEBUG_PRINTF("unable to signal eventfd %d", aLoad->notifyFds[1]);
+    }
+#else
+    if ( write(aLoad->notifyFds[1], "", 1) < 0 ) {
+        DEBUG_PRINTF("unable to signal pipe %d", aLoad->notifyFds[1]);
+    }
+#endif
+}
+
+//
+
+/*
+ * The parser pulls its input through this handler so that cancellation and
+ * the deadline are checked every time libyaml needs more bytes.
+ */
+
+typedef struct {
+    yamlConfigFileAsyncLoad     *load;
+    FILE                        *sourceFilePtr;
+    yamlConfigFileInputBuffer   *inputBuffer;
+    size_t                      offset;
+    yamlConfigFileDecompressor  *decompressor;
+    yamlErrorCode               interruption;
+} yamlConfigFileAsyncLoadReader;
+
+//
+
+int
+__yamlConfigFileAsyncLoadRead(
+    void                        *data,
+    unsigned char               *buffer,
+    size_t                      size,
+    size_t                      *size_read
+)
+{
+    yamlConfigFileAsyncLoadReader   *reader = (yamlConfigFileAsyncLoadReader*)data;
+    
+    if ( (reader->interruption = __yamlConfigFileAsyncLoadGetInterruption(reader->load)) ) return 0;
+    if ( reader->decompressor ) return __yamlConfigFileDecompressorRead(reader->decompressor, buffer, size, size_read);
+    if ( reader->inputBuffer ) {
+        size_t                  remaining = reader->inputBuffer->length - reader->offset;
+        
+        if ( size > remaining ) size = remaining;
+        memcpy(buffer, reader->inputBuffer->bytes + reader->offset, size);
+        reader->offset += size;
+        *size_read = size;
+        return 1;
+    }
+    *size_read = fread(buffer, 1, size, reader->sourceFilePtr);
+    return ! ferror(reader->sourceFilePtr);
+}
+
+//
+
+void
+__yamlConfigFileAsyncLoadComplete(
+    yamlConfigFileAsyncLoad     *aLoad,
+    yamlConfigFileRef           newConfigFile,
+    yamlErrorCode               theError
+)
+{
+    __yamlConfigFileAsyncLoadLock(aLoad);
+    aLoad->configFile = newConfigFile;
+    aLoad->error = theError;
+    aLoad->state |= yamlConfigFileAsyncLoadState_isComplete;
+    if ( aLoad->notifyFds[1] >= 0 ) __yamlConfigFileAsyncLoadNotify(aLoad);
+#ifdef HAVE_PTHREAD
+    pthread_cond_broadcast(&aLoad->stateChanged);
+#endif
+    __yamlConfigFileAsyncLoadUnlock(aLoad);
+    
+    if ( aLoad->callback ) aLoad->callback(aLoad, aLoad->context);
+    
+    // Drop the worker's reference:
+    __yamlConfigFileAsyncLoadLock(aLoad);
+    aLoad->state |= yamlConfigFileAsyncLoadState_isWorkerDone;
+#ifdef HAVE_PTHREAD
+    pthread_cond_broadcast(&aLoad->stateChanged);
+#endif
+    __yamlConfigFileAsyncLoadUnlock(aLoad);
+    yamlConfigFileAsyncLoadRelease(aLoad);
+}
+
+//
+
+void
+__yamlConfigFileAsyncLoadRun(
+    yamlConfigFileAsyncLoad     *aLoad
+)
+{
+    yamlConfigFileRef           newConfigFile = NULL;
+    yamlErrorCode               theError = __yamlConfigFileAsyncLoadGetInterruption(aLoad);
+    yamlOptionsBitvec           loadOptions = aLoad->options | yamlConfigFileOptions_ignoreCachedCopy | yamlConfigFileOptions_doNotCache;
+    
+    // A load interrupted before it started goes straight to completion:
+    if ( theError ) {
+        DEBUG_PRINTF("load of \"%s\" interrupted before it started (error %u)", aLoad->sourceFilePath, theError);
+        __yamlConfigFileAsyncLoadComplete(aLoad, NULL, theError);
+        return;
+    }
+    if ( aLoad->options & (yamlConfigFileOptions_indexDocuments | yamlConfigFileOptions_lazySubtrees | yamlConfigFileOptions_parallelLoad | yamlConfigFileOptions_fastParse | yamlConfigFileOptions_jsonInput) ) {
+        // These load paths do their own reading, so the interruptions can
+        // only be honoured once they return:
+        newConfigFile = yamlConfigFileCreateWithFileAtPath(aLoad->sourceFilePath, loadOptions);
+        if ( ! newConfigFile ) {
+            theError = ( access(aLoad->sourceFilePath, R_OK) == 0 ) ? yamlConfigFileError_parseFailed : yamlConfigFileError_fileNotReadable;
+        } else if ( (theError = __yamlConfigFileAsyncLoadGetInterruption(aLoad)) ) {
+            yamlConfigFileRelease(newConfigFile);
+            newConfigFile = NULL;
+        }
+    }
+    else {
+        yamlConfigFileAsyncLoadReader   reader = { .load = aLoad };
+        yamlConfigFileInputBuffer       inputBuffer;
+        yamlConfigFileSnapshotSource    sourceFileInfo;
+        bool                            hasSourceFileInfo = __yamlConfigFileSnapshotSourceInitWithFileAtPath(&sourceFileInfo, aLoad->sourceFilePath);
+        yaml_parser_t                   parser;
+        
+        if ( aLoad->options & yamlConfigFileOptions_mapInputFile ) {
+            if ( __yamlConfigFileInputBufferInitWithFileAtPath(&inputBuffer, aLoad->sourceFilePath) ) {
+                reader.inputBuffer = &inputBuffer;
+                reader.decompressor = __yamlConfigFileDecompressorCreateWithBytes(inputBuffer.bytes, inputBuffer.length);
+            }
+        } else if ( (reader.sourceFilePtr = fopen(aLoad->sourceFilePath, "r")) ) {
+            reader.decompressor = __yamlConfigFileDecompressorCreateWithFilePointer(reader.sourceFilePtr);
+        }
+        if ( ! reader.inputBuffer && ! reader.sourceFilePtr ) {
+            theError = yamlConfigFileError_fileNotReadable;
+        } else {
+            if ( yaml_parser_initialize(&parser) ) {
+                yaml_parser_set_input(&parser, __yamlConfigFileAsyncLoadRead, &reader);
+                newConfigFile = __yamlConfigFileCreateWithParser(&parser, aLoad->sourceFilePath, loadOptions, NULL);
+                yaml_parser_delete(&parser);
+                if ( ! newConfigFile ) theError = reader.interruption ? reader.interruption : yamlConfigFileError_parseFailed;
+                else if ( hasSourceFileInfo ) __yamlConfigFileSetSourceFileInfo(newConfigFile, &sourceFileInfo);
+            } else {
+                theError = yamlConfigFileError_outOfMemory;
+            }
+            if ( reader.decompressor ) __yamlConfigFileDecompressorDestroy(reader.decompressor);
+            if ( reader.inputBuffer ) __yamlConfigFileInputBufferDestroy(reader.inputBuffer);
+            if ( reader.sourceFilePtr ) fclose(reader.sourceFilePtr);
+        }
+    }
+    if ( newConfigFile ) newConfigFile->options = aLoad->options;
+    __yamlConfigFileAsyncLoadComplete(aLoad, newConfigFile, theError);
+}
+
+//
+
+#ifdef HAVE_PTHREAD
+
+void*
+__yamlConfigFileAsyncLoadWorker(
+    void                        *context
+)
+{
+    (void)context;
+    
+    while ( 1 ) {
+        yamlConfigFileAsyncLoad *aLoad;
+        
+        pthread_mutex_lock(&__yamlConfigFileAsyncLoadQueueLock);
+        __yamlConfigFileAsyncLoadIdleWorkerCount++;
+        while ( ! __yamlConfigFileAsyncLoadQueueHead ) pthread_cond_wait(&__yamlConfigFileAsyncLoadQueueIsNotEmpty, &__yamlConfigFileAsyncLoadQueueLock);
+        __yamlConfigFileAsyncLoadIdleWorkerCount--;
+        aLoad = __yamlConfigFileAsyncLoadQueueHead;
+        if ( ! (__yamlConfigFileAsyncLoadQueueHead = aLoad->nextQueued) ) __yamlConfigFileAsyncLoadQueueTail = NULL;
+        __yamlConfigFileAsyncLoadQueueLength--;
+        aLoad->nextQueued = NULL;
+        pthread_mutex_unlock(&__yamlConfigFileAsyncLoadQueueLock);
+        
+        __yamlConfigFileAsyncLoadRun(aLoad);
+    }
+    return NULL;
+}
+
+//
+
+bool
+__yamlConfigFileAsyncLoadEnqueue(
+    yamlConfigFileAsyncLoad     *aLoad
+)
+{
+    pthread_mutex_lock(&__yamlConfigFileAsyncLoadQueueLock);
+    
+    // Start another worker if every idle one already has a load waiting:
+    if ( (__yamlConfigFileAsyncLoadQueueLength >= __yamlConfigFileAsyncLoadIdleWorkerCount) && (__yamlConfigFileAsyncLoadWorkerCount < yamlConfigFileGetAsyncLoadThreadCount()) ) {
+        pthread_t               aThread;
+        
+        if ( pthread_create(&aThread, NULL, __yamlConfigFileAsyncLoadWorker, NULL) == 0 ) {
+            pthread_detach(aThread);
+            __yamlConfigFileAsyncLoadWorkerCount++;
+        }
+    }
+    if ( ! __yamlConfigFileAsyncLoadWorkerCount ) {
+        pthread_mutex_unlock(&__yamlConfigFileAsyncLoadQueueLock);
+        return false;
+    }
+    if ( __yamlConfigFileAsyncLoadQueueTail ) {
+        __yamlConfigFileAsyncLoadQueueTail->nextQueued = aLoad;
+    } else {
+        __yamlConfigFileAsyncLoadQueueHead = aLoad;
+    }
+    __yamlConfigFileAsyncLoadQueueTail = aLoad;
+    __yamlConfigFileAsyncLoadQueueLength++;
+    pthread_cond_signal(&__yamlConfigFileAsyncLoadQueueIsNotEmpty);
+    pthread_mutex_unlock(&__yamlConfigFileAsyncLoadQueueLock);
+    return true;
+}
+
+//
+
+bool
+__yamlConfigFileAsyncLoadDequeue(
+    yamlConfigFileAsyncLoad     *aLoad
+)
+{
+    yamlConfigFileAsyncLoad     *prevLoad = NULL, *curLoad;
+    
+    pthread_mutex_lock(&__yamlConfigFileAsyncLoadQueueLock);
+    curLoad = __yamlConfigFileAsyncLoadQueueHead;
+    while ( curLoad && (curLoad != aLoad) ) {
+        prevLoad = curLoad;
+        curLoad = curLoad->nextQueued;
+    }
+    if ( curLoad ) {
+        if ( prevLoad ) {
+            prevLoad->nextQueued = curLoad->nextQueued;
+        } else {
+            __yamlConfigFileAsyncLoadQueueHead = curLoad->nextQueued;
+        }
+        if ( __yamlConfigFileAsyncLoadQueueTail == curLoad ) __yamlConfigFileAsyncLoadQueueTail = prevLoad;
+        __yamlConfigFileAsyncLoadQueueLength--;
+        curLoad->nextQueued = NULL;
+    }
+    pthread_mutex_unlock(&__yamlConfigFileAsyncLoadQueueLock);
+    return ( curLoad != NULL );
+}
+
+#endif
+
+//
+
+yamlConfigFileAsyncLoadRef
+yamlConfigFileAsyncLoadCreateWithFileAtPath(
+    const char                      *sourceFilePath,
+    yamlOptionsBitvec               options,
+    double                          timeout,
+    yamlConfigFileAsyncLoadCallback callback,
+    void                            *context
+)
+{
+    size_t                          sourceFilePathLen = strlen(sourceFilePath) + 1;
+    yamlConfigFileAsyncLoad         *newLoad = calloc(1, sizeof(yamlConfigFileAsyncLoad) + sourceFilePathLen);
+    yamlConfigFileRef               cachedConfigFile = NULL;
+    
+    if ( ! newLoad ) return NULL;
+#ifdef HAVE_PTHREAD
+    if ( pthread_mutex_init(&newLoad->lock, NULL) != 0 ) {
+        free((void*)newLoad);
+        return NULL;
+    }
+    if ( pthread_cond_init(&newLoad->stateChanged, NULL) != 0 ) {
+        pthread_mutex_destroy(&newLoad->lock);
+        free((void*)newLoad);
+        return NULL;
+    }
+#endif
+    newLoad->refCount = 1;
+    newLoad->sourceFilePath = (void*)newLoad + sizeof(yamlConfigFileAsyncLoad);
+    strncpy((char*)newLoad->sourceFilePath, sourceFilePath, sourceFilePathLen);
+    newLoad->options = options;
+    if ( timeout > 0.0 ) newLoad->deadline = __yamlConfigFileGetTime() + timeout;
+    newLoad->callback = callback;
+    newLoad->context = context;
+    newLoad->notifyFds[0] = newLoad->notifyFds[1] = -1;
+    
+    // The worker's reference, dropped once the load completes:
+    newLoad->refCount++;
+    
+    // A cached copy completes the load immediately; it never reaches a
+    // worker since the cached object must not be retained or released
+    // off the caller's thread:
+    if ( ! (options & yamlConfigFileOptions_ignoreCachedCopy) ) cachedConfigFile = __yamlConfigFileCacheLookup(sourceFilePath, options);
+    if ( cachedConfigFile ) {
+        newLoad->state |= yamlConfigFileAsyncLoadState_isFromCache;
+        __yamlConfigFileAsyncLoadComplete(newLoad, yamlConfigFileRetain(cachedConfigFile), 0);
+        return newLoad;
+    }
+    
+#ifdef HAVE_PTHREAD
+    if ( __yamlConfigFileAsyncLoadEnqueue(newLoad) ) return newLoad;
+    DEBUG_PRINTF("unable to start an asynchronous load worker, loading \"%s\" synchronously", sourceFilePath);
+#endif
+    __yamlConfigFileAsyncLoadRun(newLoad);
+    return newLoad;
+}
+
+//
+
+unsigned int
+yamlConfigFileAsyncLoadGetRefCount(
+    yamlConfigFileAsyncLoadRef  aLoad
+)
+{
+    unsigned int                refCount;
+    
+    __yamlConfigFileAsyncLoadLock(aLoad);
+    refCount = aLoad->refCount;
+    __yamlConfigFileAsyncLoadUnlock(aLoad);
+    return refCount;
+}
+
+//
+
+yamlConfigFileAsyncLoadRef
+yamlConfigFileAsyncLoadRetain(
+    yamlConfigFileAsyncLoadRef  aLoad
+)
+{
+    __yamlConfigFileAsyncLoadLock(aLoad);
+    aLoad->refCount++;
+    __yamlConfigFileAsyncLoadUnlock(aLoad);
+    return aLoad;
+}
+
+//
+
+void
+yamlConfigFileAsyncLoadRelease(
+    yamlConfigFileAsyncLoadRef  aLoad
+)
+{
+    unsigned int                refCount;
+    
+    __yamlConfigFileAsyncLoadLock(aLoad);
+    refCount = --aLoad->refCount;
+    __yamlConfigFileAsyncLoadUnlock(aLoad);
+    if ( refCount == 0 ) {
+        if ( aLoad->configFile ) yamlConfigFileRelease(aLoad->configFile);
+        if ( aLoad->notifyFds[0] >= 0 ) close(aLoad->notifyFds[0]);
+        if ( (aLoad->notifyFds[1] >= 0) && (aLoad->notifyFds[1] != aLoad->notifyFds[0]) ) close(aLoad->notifyFds[1]);
+#ifdef HAVE_PTHREAD
+        pthread_cond_destroy(&aLoad->stateChanged);
+        pthread_mutex_destroy(&aLoad->lock);
+#endif
+        free((void*)aLoad);
+    }
+}
+
+//
+
+int
+yamlConfigFileAsyncLoadGetFileDescriptor(
+    yamlConfigFileAsyncLoadRef  aLoad
+)
+{
+    int                         fd;
+    
+    __yamlConfigFileAsyncLoadLock(aLoad);
+    if ( aLoad->notifyFds[0] < 0 ) {
+#ifdef HAVE_EVENTFD
+        if ( (fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)) >= 0 ) aLoad->notifyFds[0] = aLoad->notifyFds[1] = fd;
+#else
+        int                     fds[2];
+        
+        if ( pipe(fds) == 0 ) {
+            fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+            fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+            fcntl(fds[1], F_SETFL, O_NONBLOCK);
+            aLoad->notifyFds[0] = fds[0];
+            aLoad->notifyFds[1] = fds[1];
+        }
+#endif
+        // Created after the fact?  Signal it right away:
+        if ( (aLoad->notifyFds[1] >= 0) && (aLoad->state & yamlConfigFileAsyncLoadState_isComplete) ) __yamlConfigFileAsyncLoadNotify(aLoad);
+    }
+    fd = aLoad->notifyFds[0];
+    __yamlConfigFileAsyncLoadUnlock(aLoad);
+    return fd;
+}
+
+//
+
+bool
+yamlConfigFileAsyncLoadIsComplete(
+    yamlConfigFileAsyncLoadRef  aLoad
+)
+{
+    bool                        isComplete;
+    
+    __yamlConfigFileAsyncLoadLock(aLoad);
+    isComplete = ( (aLoad->state & yamlConfigFileAsyncLoadState_isComplete) != 0 );
+    __yamlConfigFileAsyncLoadUnlock(aLoad);
+    return isComplete;
+}
+
+//
+
+bool
+yamlConfigFileAsyncLoadWait(
+    yamlConfigFileAsyncLoadRef  aLoad,
+    double                      timeout
+)
+{
+    bool                        isComplete;
+    
+    __yamlConfigFileAsyncLoadLock(aLoad);
+#ifdef HAVE_PTHREAD
+    if ( timeout < 0.0 ) {
+        while ( ! (aLoad->state & yamlConfigFileAsyncLoadState_isComplete) ) pthread_cond_wait(&aLoad->stateChanged, &aLoad->lock);
+    } else {
+        struct timespec         until;
+        
+        clock_gettime(CLOCK_REALTIME, &until);
+        until.tv_sec += (time_t)timeout;
+        until.tv_nsec += (long)((timeout - (double)(time_t)timeout) * 1.0e9);
+        if ( until.tv_nsec >= 1000000000L ) {
+            until.tv_sec++;
+            until.tv_nsec -= 1000000000L;
+        }
+        while ( ! (aLoad->state & yamlConfigFileAsyncLoadState_isComplete) ) {
+            if ( pthread_cond_timedwait(&aLoad->stateChanged, &aLoad->lock, &until) != 0 ) break;
+        }
+    }
+#endif
+    isComplete = ( (aLoad->state & yamlConfigFileAsyncLoadState_isComplete) != 0 );
+    __yamlConfigFileAsyncLoadUnlock(aLoad);
+    return isComplete;
+}
+
+//
+
+void
+yamlConfigFileAsyncLoadCancel(
+    yamlConfigFileAsyncLoadRef  aLoad
+)
+{
+    __yamlConfigFileAsyncLoadLock(aLoad);
+    aLoad->state |= yamlConfigFileAsyncLoadState_isCancelled;
+    __yamlConfigFileAsyncLoadUnlock(aLoad);
+#ifdef HAVE_PTHREAD
+    // A load still waiting for a worker is completed right here rather
+    // than waiting for one to become free:
+    if ( __yamlConfigFileAsyncLoadDequeue(aLoad) ) __yamlConfigFileAsyncLoadComplete(aLoad, NULL, yamlConfigFileError_loadCancelled);
+#endif
+}
+
+//
+
+yamlConfigFileRef
+yamlConfigFileAsyncLoadGetConfigFile(
+    yamlConfigFileAsyncLoadRef  aLoad,
+    yamlErrorCode               *outError
+)
+{
+    bool                        isFirstCollection;
+    
+    __yamlConfigFileAsyncLoadLock(aLoad);
+    if ( ! (aLoad->state & yamlConfigFileAsyncLoadState_isComplete) ) {
+        __yamlConfigFileAsyncLoadUnlock(aLoad);
+        if ( outError ) *outError = yamlConfigFileError_loadNotComplete;
+        return NULL;
+    }
+#ifdef HAVE_PTHREAD
+    // Wait out the callback so the worker's reference is gone:
+    while ( ! (aLoad->state & yamlConfigFileAsyncLoadState_isWorkerDone) ) pthread_cond_wait(&aLoad->stateChanged, &aLoad->lock);
+#endif
+    isFirstCollection = ( aLoad->configFile && ! (aLoad->state & (yamlConfigFileAsyncLoadState_isFromCache | yamlConfigFileAsyncLoadState_isCollected)) );
+    aLoad->state |= yamlConfigFileAsyncLoadState_isCollected;
+    __yamlConfigFileAsyncLoadUnlock(aLoad);
+    
+    if ( outError ) *outError = aLoad->error;
+    if ( isFirstCollection ) {
+        if ( ! (aLoad->options & yamlConfigFileOptions_doNotCache) ) {
+            yamlConfigFileRef   cachedConfigFile = NULL;
+            
+            // Another load of the same path may have been cached first:
+            if ( ! (aLoad->options & yamlConfigFileOptions_ignoreCachedCopy) ) cachedConfigFile = __yamlConfigFileCacheLookup(aLoad->sourceFilePath, aLoad->options);
+            if ( cachedConfigFile ) {
+                yamlConfigFileRelease(aLoad->configFile);
+                aLoad->configFile = yamlConfigFileRetain(cachedConfigFile);
+            } else {
+                aLoad->configFile->fileId = __yamlConfigFileCacheAdd(aLoad->configFile);
+                DEBUG_PRINTF("file \"%s\" cached with id %u", aLoad->sourceFilePath, aLoad->configFile->fileId);
             }
         }
     }
-    return false;
+    return aLoad->configFile;
+}
+
+//
+
+unsigned int
+yamlConfigFileGetAsyncLoadThreadCount()
+{
+    return __yamlConfigFileGetThreadCount(__yamlConfigFileAsyncLoadThreadCount);
+}
+
+//
+
+void
+yamlConfigFileSetAsyncLoadThreadCount(
+    unsigned int                threadCount
+)
+{
+    __yamlConfigFileAsyncLoadThreadCount = threadCount;
+}
+
+//
+#if 0
+#pragma mark -
+#endif
+//
+
+/*
+ * A yamlConfigFilePushParser keeps the bytes it is fed on a queue of
+ * chunks.  libyaml cannot suspend a parse to wait for more input, so the
+ * parse runs on a thread of its own whose read handler blocks until the
+ * queue has bytes or the input is finished.  Without thread support the
+ * whole queue is parsed once the input is finished.
+ */
+
+typedef struct __yamlConfigFilePushParserChunk {
+    struct __yamlConfigFilePushParserChunk  *link;
+    size_t                                  length;
+    size_t                                  offset;
+    unsigned char                           bytes[];
+} yamlConfigFilePushParserChunk;
+
+typedef struct __yamlConfigFilePushParser {
+    unsigned int                    refCount;
+    yamlOptionsBitvec               options;
+    yamlOptionsBitvec               state;
+    yamlConfigFilePushParserChunk   *queueHead;
+    yamlConfigFilePushParserChunk   *queueTail;
+    yamlConfigFileRef               configFile;
+    yamlErrorCode                   error;
+    bool                            hasParseThread;
+#ifdef HAVE_PTHREAD
+    pthread_t                       parseThread;
+    pthread_mutex_t                 lock;
+    pthread_cond_t                  queueChanged;
+#endif
+} yamlConfigFilePushParser;
+
+enum {
+    yamlConfigFilePushParserState_isFinished = 1 << 0,
+    yamlConfigFilePushParserState_isAbandoned = 1 << 1,
+    yamlConfigFilePushParserState_isParsed = 1 << 2
+};
+
+//
+
+static inline void
+__yamlConfigFilePushParserLock(
+    yamlConfigFilePushParser    *aPushParser
+)
+{
+#ifdef HAVE_PTHREAD
+    pthread_mutex_lock(&aPushParser->lock);
+#endif
+}
+
+//
+
+static inline void
+__yamlConfigFilePushParserUnlock(
+    yamlConfigFilePushParser    *aPushParser
+)
+{
+#ifdef HAVE_PTHREAD
+    pthread_mutex_unlock(&aPushParser->lock);
+#endif
+}
+
+//
+
+static inline void
+__yamlConfigFilePushParserSignal(
+    yamlConfigFilePushParser    *aPushParser
+)
+{
+#ifdef HAVE_PTHREAD
+    pthread_cond_signal(&aPushParser->queueChanged);
+#endif
+}
+
+//
+
+void
+__yamlConfigFilePushParserDrainQueue(
+    yamlConfigFilePushParser    *aPushParser
+)
+{
+    while ( aPushParser->queueHead ) {
+        yamlConfigFilePushParserChunk   *chunk = aPushParser->queueHead;
+        
+        aPushParser->queueHead = chunk->link;
+        free((void*)chunk);
+    }
+    aPushParser->queueTail = NULL;
+}
+
+//
+
+int
+__yamlConfigFilePushParserRead(
+    void                        *data,
+    unsigned char               *buffer,
+    size_t                      size,
+    size_t                      *size_read
+)
+{
+    yamlConfigFilePushParser    *aPushParser = (yamlConfigFilePushParser*)data;
+    size_t                      length = 0;
+    
+    __yamlConfigFilePushParserLock(aPushParser);
+#ifdef HAVE_PTHREAD
+    while ( ! aPushParser->queueHead && ! (aPushParser->state & (yamlConfigFilePushParserState_isFinished | yamlConfigFilePushParserState_isAbandoned)) ) {
+        pthread_cond_wait(&aPushParser->queueChanged, &aPushParser->lock);
+    }
+#endif
+    if ( aPushParser->state & yamlConfigFilePushParserState_isAbandoned ) {
+        __yamlConfigFilePushParserUnlock(aPushParser);
+        return 0;
+    }
+    // Fill as much of the buffer as the queued chunks allow; an empty
+    // queue at this point is the end of the input:
+    while ( (length < size) && aPushParser->queueHead ) {
+        yamlConfigFilePushParserChunk   *chunk = aPushParser->queueHead;
+        size_t                          copyLength = chunk->length - chunk->offset;
+        
+        if ( copyLength > size - length ) copyLength = size - length;
+        memcpy(buffer + length, chunk->bytes + chunk->offset, copyLength);
+        length += copyLength;
+        chunk->offset += copyLength;
+        if ( chunk->offset == chunk->length ) {
+            if ( ! (aPushParser->queueHead = chunk->link) ) aPushParser->queueTail = NULL;
+            free((void*)chunk);
+        }
+    }
+    __yamlConfigFilePushParserUnlock(aPushParser);
+    *size_read = length;
+    return 1;
+}
+
+//
+
+void
+__yamlConfigFilePushParserParse(
+    yamlConfigFilePushParser    *aPushParser
+)
+{
+    yamlConfigFileRef           newConfigFile = NULL;
+    yamlErrorCode               theError = yamlConfigFileError_outOfMemory;
+    yaml_parser_t               parser;
+    
+    if ( yaml_parser_initialize(&parser) ) {
+        yaml_parser_set_input(&parser, __yamlConfigFilePushParserRead, aPushParser);
+        newConfigFile = __yamlConfigFileCreateWithParser(&parser, NULL, aPushParser->options, NULL);
+        theError = newConfigFile ? 0 : yamlConfigFileError_parseFailed;
+        DEBUG_PRINTF("push parser %p finished: %s", aPushParser, parser.problem ? parser.problem : "<n/a>");
+        yaml_parser_delete(&parser);
+    }
+    __yamlConfigFilePushParserLock(aPushParser);
+    aPushParser->configFile = newConfigFile;
+    aPushParser->error = theError;
+    aPushParser->state |= yamlConfigFilePushParserState_isParsed;
+    
+    // Anything left (e.g. subsequent documents) will never be read:
+    __yamlConfigFilePushParserDrainQueue(aPushParser);
+    __yamlConfigFilePushParserUnlock(aPushParser);
+}
+
+//
+
+#ifdef HAVE_PTHREAD
+
+void*
+__yamlConfigFilePushParserThread(
+    void                        *context
+)
+{
+    __yamlConfigFilePushParserParse((yamlConfigFilePushParser*)context);
+    return NULL;
+}
+
+#endif
+
+//
+
+yamlConfigFilePushParserRef
+yamlConfigFilePushParserCreate(
+    yamlOptionsBitvec           options
+)
+{
+    yamlConfigFilePushParser    *newPushParser = calloc(1, sizeof(yamlConfigFilePushParser));
+    
+    if ( ! newPushParser ) return NULL;
+#ifdef HAVE_PTHREAD
+    if ( pthread_mutex_init(&newPushParser->lock, NULL) != 0 ) {
+        free((void*)newPushParser);
+        return NULL;
+    }
+    if ( pthread_cond_init(&newPushParser->queueChanged, NULL) != 0 ) {
+        pthread_mutex_destroy(&newPushParser->lock);
+        free((void*)newPushParser);
+        return NULL;
+    }
+#endif
+    newPushParser->refCount = 1;
+    // There is no source path, so nothing to cache:
+    newPushParser->options = options | yamlConfigFileOptions_doNotCache;
+#ifdef HAVE_PTHREAD
+    if ( pthread_create(&newPushParser->parseThread, NULL, __yamlConfigFilePushParserThread, newPushParser) == 0 ) {
+        newPushParser->hasParseThread = true;
+    } else {
+        DEBUG_PRINTF("unable to start parse thread for push parser %p, parsing once finished", newPushParser);
+    }
+#endif
+    return newPushParser;
+}
+
+//
+
+unsigned int
+yamlConfigFilePushParserGetRefCount(
+    yamlConfigFilePushParserRef aPushParser
+)
+{
+    return aPushParser->refCount;
+}
+
+//
+
+yamlConfigFilePushParserRef
+yamlConfigFilePushParserRetain(
+    yamlConfigFilePushParserRef aPushParser
+)
+{
+    aPushParser->refCount++;
+    return aPushParser;
+}
+
+//
+
+void
+yamlConfigFilePushParserRelease(
+    yamlConfigFilePushParserRef aPushParser
+)
+{
+    if ( --aPushParser->refCount == 0 ) {
+#ifdef HAVE_PTHREAD
+        if ( aPushParser->hasParseThread ) {
+            __yamlConfigFilePushParserLock(aPushParser);
+            aPushParser->state |= yamlConfigFilePushParserState_isAbandoned;
+            __yamlConfigFilePushParserSignal(aPushParser);
+            __yamlConfigFilePushParserUnlock(aPushParser);
+            pthread_join(aPushParser->parseThread, NULL);
+        }
+#endif
+        if ( aPushParser->configFile ) yamlConfigFileRelease(aPushParser->configFile);
+        __yamlConfigFilePushParserDrainQueue(aPushParser);
+#ifdef HAVE_PTHREAD
+        pthread_cond_destroy(&aPushParser->queueChanged);
+        pthread_mutex_destroy(&aPushParser->lock);
+#endif
+        free((void*)aPushParser);
+    }
 }
 
 //
 
 bool
-yamlConfigFileCoerceSequenceAtPathString(
-    yamlConfigFileRef           aConfigFile,
-    const char                  *pathString,
-    size_t                      pathStringLen,
-    yaml_node_t                 *relativeToNode,
-    yamlErrorCode               *outError,
-    const char*                 *outErrorAtChar,
-    yamlKeyPathNodeMatchType*   *failedAtMatchElement,
-    unsigned int                startSequenceIndex,
-    unsigned int                endSequenceIndex,
-    yamlConfigFileCoerceToType  coerceToType,
-    ...
+yamlConfigFilePushParserFeed(
+    yamlConfigFilePushParserRef aPushParser,
+    const void                  *bytes,
+    size_t                      length,
+    yamlErrorCode               *outError
 )
 {
-    bool                        okay = false;
-    yamlKeyPathRef              keyPath = yamlKeyPathCreateWithString(
-                                                pathString, pathStringLen,
-                                                YAMLCONFIGFILEOPTIONS_KEYPATHOPTIONS(aConfigFile->options),
-                                                outError, outErrorAtChar
-                                            );
-    if ( keyPath ) {
-        va_list                 vargs;
+    yamlConfigFilePushParserChunk   *chunk = NULL;
+    yamlErrorCode                   theError = 0;
+    
+    if ( length && ! (chunk = malloc(sizeof(yamlConfigFilePushParserChunk) + length)) ) {
+        if ( outError ) *outError = yamlConfigFileError_outOfMemory;
+        return false;
+    }
+    __yamlConfigFilePushParserLock(aPushParser);
+    if ( aPushParser->state & yamlConfigFilePushParserState_isFinished ) {
+        theError = yamlConfigFileError_invalidState;
+    } else if ( aPushParser->state & yamlConfigFilePushParserState_isParsed ) {
+        // Once the document is complete, further input is ignored; once
+        // it has failed, it is refused:
+        theError = aPushParser->error;
+    } else if ( chunk ) {
+        chunk->link = NULL;
+        chunk->length = length;
+        chunk->offset = 0;
+        memcpy(chunk->bytes, bytes, length);
+        if ( aPushParser->queueTail ) {
+            aPushParser->queueTail->link = chunk;
+        } else {
+            aPushParser->queueHead = chunk;
+        }
+        aPushParser->queueTail = chunk;
+        chunk = NULL;
+        __yamlConfigFilePushParserSignal(aPushParser);
+    }
+    __yamlConfigFilePushParserUnlock(aPushParser);
+    if ( chunk ) free((void*)chunk);
+    if ( outError ) *outError = theError;
+    return ( theError == 0 );
+}
+
+//
+
+yamlConfigFileRef
+yamlConfigFilePushParserFinish(
+    yamlConfigFilePushParserRef aPushParser,
+    yamlErrorCode               *outError
+)
+{
+    __yamlConfigFilePushParserLock(aPushParser);
+    aPushParser->state |= yamlConfigFilePushParserState_isFinished;
+    __yamlConfigFilePushParserSignal(aPushParser);
+    __yamlConfigFilePushParserUnlock(aPushParser);
+#ifdef HAVE_PTHREAD
+    if ( aPushParser->hasParseThread ) {
+        pthread_join(aPushParser->parseThread, NULL);
+        aPushParser->hasParseThread = false;
+    }
+#endif
+    if ( ! (aPushParser->state & yamlConfigFilePushParserState_isParsed) ) __yamlConfigFilePushParserParse(aPushParser);
+    if ( outError ) *outError = aPushParser->error;
+    return aPushParser->configFile ? yamlConfigFileRetain(aPushParser->configFile) : NULL;
+}
+
+//
+#if 0
+#pragma mark -
+#endif
+//
+
+/*
+ * A yamlConfigFileIncrementalLoad drives a filter loader (with no filter)
+ * a batch of events at a time, checking the clock between batches.  The
+ * document is composed directly into the yamlConfigFile that is returned
+ * once the load is complete.
+ */
+
+#ifndef YAMLCONFIGFILE_INCREMENTAL_LOAD_EVENTS_PER_CLOCK_CHECK
+#define YAMLCONFIGFILE_INCREMENTAL_LOAD_EVENTS_PER_CLOCK_CHECK 16
+#endif
+
+typedef struct __yamlConfigFileIncrementalLoad {
+    unsigned int                refCount;
+    yamlOptionsBitvec           state;
+    FILE                        *sourceFilePtr;
+    yamlConfigFileInputBuffer   inputBuffer;
+    yamlConfigFileDecompressor  *decompressor;
+    yaml_parser_t               parser;
+    yamlConfigFileFilterLoader  *loader;
+    unsigned long               eventCount;
+    yamlConfigFileRef           configFile;
+    yamlErrorCode               error;
+} yamlConfigFileIncrementalLoad;
+
+enum {
+    yamlConfigFileIncrementalLoadState_hasParser = 1 << 0,
+    yamlConfigFileIncrementalLoadState_hasInputBuffer = 1 << 1,
+    yamlConfigFileIncrementalLoadState_ownsFilePtr = 1 << 2,
+    yamlConfigFileIncrementalLoadState_isFinished = 1 << 3
+};
+
+//
+
+void
+__yamlConfigFileIncrementalLoadCloseInput(
+    yamlConfigFileIncrementalLoad   *aLoad
+)
+{
+    if ( aLoad->loader ) {
+        aLoad->eventCount = __yamlConfigFileFilterLoaderGetEventCount(aLoad->loader);
+        __yamlConfigFileFilterLoaderDestroy(aLoad->loader);
+        aLoad->loader = NULL;
+    }
+    if ( aLoad->state & yamlConfigFileIncrementalLoadState_hasParser ) yaml_parser_delete(&aLoad->parser);
+    if ( aLoad->decompressor ) {
+        __yamlConfigFileDecompressorDestroy(aLoad->decompressor);
+        aLoad->decompressor = NULL;
+    }
+    if ( aLoad->state & yamlConfigFileIncrementalLoadState_hasInputBuffer ) __yamlConfigFileInputBufferDestroy(&aLoad->inputBuffer);
+    if ( aLoad->state & yamlConfigFileIncrementalLoadState_ownsFilePtr ) fclose(aLoad->sourceFilePtr);
+    aLoad->state &= ~(yamlConfigFileIncrementalLoadState_hasParser | yamlConfigFileIncrementalLoadState_hasInputBuffer | yamlConfigFileIncrementalLoadState_ownsFilePtr);
+}
+
+//
+
+void
+__yamlConfigFileIncrementalLoadFinish(
+    yamlConfigFileIncrementalLoad   *aLoad,
+    yamlConfigFileFilterLoaderStatus status
+)
+{
+    yamlConfigFileRef               newConfigFile = aLoad->configFile;
+    
+    if ( status == yamlConfigFileFilterLoaderStatus_isComplete ) {
+        newConfigFile->state |= yamlConfigFileState_isDocumentParsed;
+        if ( newConfigFile->sourceFilePath && ! (newConfigFile->options & yamlConfigFileOptions_doNotCache) ) {
+            newConfigFile->fileId = __yamlConfigFileCacheAdd(newConfigFile);
+            DEBUG_PRINTF("file \"%s\" cached with id %u", newConfigFile->sourceFilePath, newConfigFile->fileId);
+        }
+    } else {
+        DEBUG_PRINTF("incremental load failed: %s", aLoad->parser.problem ? aLoad->parser.problem : "<n/a>");
+        aLoad->error = yamlConfigFileError_parseFailed;
+    }
+    // Input (and any partial document) are no longer needed:
+    __yamlConfigFileIncrementalLoadCloseInput(aLoad);
+    if ( aLoad->error ) {
+        yamlConfigFileRelease(newConfigFile);
+        aLoad->configFile = NULL;
+    }
+    aLoad->state |= yamlConfigFileIncrementalLoadState_isFinished;
+}
+
+//
+
+yamlConfigFileIncrementalLoad*
+__yamlConfigFileIncrementalLoadAlloc(
+    const char          *sourceFilePath,
+    yamlOptionsBitvec   options
+)
+{
+    yamlConfigFileIncrementalLoad   *newLoad = calloc(1, sizeof(yamlConfigFileIncrementalLoad));
+    
+    if ( newLoad ) {
+        newLoad->refCount = 1;
+        if ( (newLoad->configFile = __yamlConfigFileAlloc(sourceFilePath, options)) ) {
+            if ( yaml_parser_initialize(&newLoad->parser) ) {
+                newLoad->state |= yamlConfigFileIncrementalLoadState_hasParser;
+                newLoad->loader = __yamlConfigFileFilterLoaderCreate(NULL, YAMLCONFIGFILEOPTIONS_KEYPATHOPTIONS(options), &newLoad->configFile->document);
+            }
+        }
+        if ( ! newLoad->loader ) {
+            yamlConfigFileIncrementalLoadRelease(newLoad);
+            newLoad = NULL;
+        }
+    }
+    return newLoad;
+}
+
+//
+
+yamlConfigFileIncrementalLoadRef
+yamlConfigFileIncrementalLoadCreateWithInputString(
+    const char          *inputString,
+    size_t              inputStringLength,
+    yamlOptionsBitvec   options
+)
+{
+    yamlConfigFileIncrementalLoad   *newLoad = __yamlConfigFileIncrementalLoadAlloc(NULL, options);
+    
+    if ( newLoad ) {
+        if ( inputStringLength == yamlCStringFullLength ) inputStringLength = strlen(inputString);
+        newLoad->decompressor = __yamlConfigFileDecompressorSetParserInputString(&newLoad->parser, (const unsigned char*)inputString, inputStringLength);
+    }
+    return newLoad;
+}
+
+//
+
+yamlConfigFileIncrementalLoadRef
+yamlConfigFileIncrementalLoadCreateWithFileAtPath(
+    const char          *sourceFilePath,
+    yamlOptionsBitvec   options
+)
+{
+    yamlConfigFileIncrementalLoad   *newLoad;
+    yamlConfigFileRef               cachedConfigFile = NULL;
+    
+    if ( ! (options & yamlConfigFileOptions_ignoreCachedCopy) && (cachedConfigFile = __yamlConfigFileCacheLookup(sourceFilePath, options)) ) {
+        // Nothing to do but hand back the cached copy:
+        if ( (newLoad = calloc(1, sizeof(yamlConfigFileIncrementalLoad))) ) {
+            newLoad->refCount = 1;
+            newLoad->state = yamlConfigFileIncrementalLoadState_isFinished;
+            newLoad->configFile = yamlConfigFileRetain(cachedConfigFile);
+        }
+        return newLoad;
+    }
+    if ( (newLoad = __yamlConfigFileIncrementalLoadAlloc(sourceFilePath, options)) ) {
+        yamlConfigFileSnapshotSource    sourceFileInfo;
         
-        va_start(vargs, coerceToType);
-        okay = __yamlConfigFileCoerceSequence(aConfigFile, keyPath, relativeToNode, outError, failedAtMatchElement, startSequenceIndex, endSequenceIndex, coerceToType, vargs);
-        va_end(vargs);
-        yamlKeyPathRelease(keyPath);
+        // Identify the file before any of it is read:
+        if ( __yamlConfigFileSnapshotSourceInitWithFileAtPath(&sourceFileInfo, sourceFilePath) ) __yamlConfigFileSetSourceFileInfo(newLoad->configFile, &sourceFileInfo);
+        if ( options & yamlConfigFileOptions_mapInputFile ) {
+            if ( __yamlConfigFileInputBufferInitWithFileAtPath(&newLoad->inputBuffer, sourceFilePath) ) {
+                newLoad->state |= yamlConfigFileIncrementalLoadState_hasInputBuffer;
+                newLoad->decompressor = __yamlConfigFileDecompressorSetParserInputString(&newLoad->parser, newLoad->inputBuffer.bytes, newLoad->inputBuffer.length);
+            }
+        } else if ( (newLoad->sourceFilePtr = fopen(sourceFilePath, "r")) ) {
+            newLoad->state |= yamlConfigFileIncrementalLoadState_ownsFilePtr;
+            newLoad->decompressor = __yamlConfigFileDecompressorSetParserInputFile(&newLoad->parser, newLoad->sourceFilePtr);
+        }
+        if ( ! (newLoad->state & (yamlConfigFileIncrementalLoadState_hasInputBuffer | yamlConfigFileIncrementalLoadState_ownsFilePtr)) ) {
+            yamlConfigFileIncrementalLoadRelease(newLoad);
+            newLoad = NULL;
+        }
+    }
+    return newLoad;
+}
+
+//
+
+unsigned int
+yamlConfigFileIncrementalLoadGetRefCount(
+    yamlConfigFileIncrementalLoadRef    aLoad
+)
+{
+    return aLoad->refCount;
+}
+
+//
+
+yamlConfigFileIncrementalLoadRef
+yamlConfigFileIncrementalLoadRetain(
+    yamlConfigFileIncrementalLoadRef    aLoad
+)
+{
+    aLoad->refCount++;
+    return aLoad;
+}
+
+//
+
+void
+yamlConfigFileIncrementalLoadRelease(
+    yamlConfigFileIncrementalLoadRef    aLoad
+)
+{
+    if ( --aLoad->refCount == 0 ) {
+        // An unfinished document is deleted along with the loader:
+        __yamlConfigFileIncrementalLoadCloseInput(aLoad);
+        if ( aLoad->configFile ) yamlConfigFileRelease(aLoad->configFile);
+        free((void*)aLoad);
     }
-    return okay;
 }
 
 //
 
 bool
-yamlConfigFileCoerceSequenceAtPath(
-    yamlConfigFileRef           aConfigFile,
-    yamlKeyPathRef              theKeyPath,
-    yaml_node_t                 *relativeToNode,
-    yamlErrorCode               *outError,
-    yamlKeyPathNodeMatchType*   *failedAtMatchElement,
-    unsigned int                startSequenceIndex,
-    unsigned int                endSequenceIndex,
-    yamlConfigFileCoerceToType  coerceToType,
-    ...
+yamlConfigFileIncrementalLoadStep(
+    yamlConfigFileIncrementalLoadRef    aLoad,
+    double                              timeBudget,
+    unsigned int                        eventBudget,
+    yamlErrorCode                       *outError
 )
 {
-    bool                        okay = false;
-    va_list                     vargs;
+    if ( ! (aLoad->state & yamlConfigFileIncrementalLoadState_isFinished) ) {
+        yamlConfigFileFilterLoaderStatus    status;
         
-    va_start(vargs, coerceToType);
-    okay = __yamlConfigFileCoerceSequence(aConfigFile, theKeyPath, relativeToNode, outError, failedAtMatchElement, startSequenceIndex, endSequenceIndex, coerceToType, vargs);
-    va_end(vargs);
-    return okay;
+        if ( timeBudget > 0.0 ) {
+            double                          deadline = __yamlConfigFileGetTime() + timeBudget;
+            unsigned long                   eventLimit = __yamlConfigFileFilterLoaderGetEventCount(aLoad->loader) + eventBudget;
+            
+            while ( 1 ) {
+                unsigned int                eventCount = YAMLCONFIGFILE_INCREMENTAL_LOAD_EVENTS_PER_CLOCK_CHECK;
+                
+                if ( eventBudget ) {
+                    unsigned long           eventsLeft = eventLimit - __yamlConfigFileFilterLoaderGetEventCount(aLoad->loader);
+                    
+                    if ( eventsLeft < eventCount ) eventCount = (unsigned int)eventsLeft;
+                }
+                status = eventCount ? __yamlConfigFileFilterLoaderStep(aLoad->loader, &aLoad->parser, eventCount) : yamlConfigFileFilterLoaderStatus_inProgress;
+                if ( (status != yamlConfigFileFilterLoaderStatus_inProgress) || ! eventCount || (__yamlConfigFileGetTime() >= deadline) ) break;
+            }
+        } else {
+            status = __yamlConfigFileFilterLoaderStep(aLoad->loader, &aLoad->parser, eventBudget);
+        }
+        if ( status != yamlConfigFileFilterLoaderStatus_inProgress ) __yamlConfigFileIncrementalLoadFinish(aLoad, status);
+    }
+    if ( outError ) *outError = aLoad->error;
+    return ( (aLoad->state & yamlConfigFileIncrementalLoadState_isFinished) != 0 );
+}
+
+//
+
+unsigned long
+yamlConfigFileIncrementalLoadGetEventCount(
+    yamlConfigFileIncrementalLoadRef    aLoad
+)
+{
+    return aLoad->loader ? __yamlConfigFileFilterLoaderGetEventCount(aLoad->loader) : aLoad->eventCount;
+}
+
+//
+
+yamlConfigFileRef
+yamlConfigFileIncrementalLoadGetConfigFile(
+    yamlConfigFileIncrementalLoadRef    aLoad,
+    yamlErrorCode                       *outError
+)
+{
+    if ( ! (aLoad->state & yamlConfigFileIncrementalLoadState_isFinished) ) {
+        if ( outError ) *outError = yamlConfigFileError_loadNotComplete;
+        return NULL;
+    }
+    if ( outError ) *outError = aLoad->error;
+    return aLoad->configFile;
 }
 
 //
@@ -0,0 +1,410 @@
+/*
+ * yamlConfigFileDecompressor
+ * Simplified YAML interface for C/Fortran
+ *
+ * On-the-fly decompression of gzip- and zstd-compressed input
+ * as libyaml reads it.
+ *
+ */
+
+#include "yamlConfigFileDecompressor.h"
+
+#ifdef HAVE_ZLIB
+# include <zlib.h>
+#endif
+#ifdef HAVE_ZSTD
+# include <zstd.h>
+#endif
+
+//
+
+#ifdef YAMLCONFIGFILE_DEBUG
+#define DEBUG_PRINTF(F, ...) fprintf(stderr, "[DEBUG] " F "\n", __VA_ARGS__)
+#else
+#define DEBUG_PRINTF(F, ...)
+#endif
+
+//
+
+/*!
+    @defined YAMLCONFIGFILE_DECOMPRESSOR_CHUNKSIZE
+    Number of bytes of compressed input read from a FILE stream at a time.
+*/
+#ifndef YAMLCONFIGFILE_DECOMPRESSOR_CHUNKSIZE
+#define YAMLCONFIGFILE_DECOMPRESSOR_CHUNKSIZE (64 * 1024)
+#endif
+
+// The longest magic number examined:
+#define YAMLCONFIGFILE_DECOMPRESSOR_MAGIC_LENGTH 4
+
+//
+
+typedef enum {
+    yamlConfigFileCompression_unknown = 0,
+    yamlConfigFileCompression_none,
+    yamlConfigFileCompression_gzip,
+    yamlConfigFileCompression_zstd
+} yamlConfigFileCompression;
+
+//
+
+typedef struct __yamlConfigFileDecompressor {
+    yamlConfigFileCompression   compression;
+    FILE                        *sourceFilePtr;
+    unsigned char               *chunk;
+    const unsigned char         *input;
+    size_t                      inputLength;
+    bool                        isSourceAtEnd;
+    bool                        isFrameAtEnd;
+    bool                        hasFailed;
+#ifdef HAVE_ZLIB
+    bool                        isZStreamInitialized;
+    z_stream                    zStream;
+#endif
+#ifdef HAVE_ZSTD
+    ZSTD_DStream                *zstdStream;
+#endif
+} yamlConfigFileDecompressor;
+
+//
+
+yamlConfigFileCompression
+__yamlConfigFileDecompressorDetect(
+    const unsigned char         *bytes,
+    size_t                      length
+)
+{
+#ifdef HAVE_ZLIB
+    if ( (length >= 2) && (bytes[0] == 0x1f) && (bytes[1] == 0x8b) ) return yamlConfigFileCompression_gzip;
+#endif
+#ifdef HAVE_ZSTD
+    if ( (length >= 4) && (bytes[0] == 0x28) && (bytes[1] == 0xb5) && (bytes[2] == 0x2f) && (bytes[3] == 0xfd) ) return yamlConfigFileCompression_zstd;
+#endif
+    return yamlConfigFileCompression_none;
+}
+
+//
+
+bool
+__yamlConfigFileDecompressorIsCompressed(
+    const unsigned char         *bytes,
+    size_t                      length
+)
+{
+    return ( __yamlConfigFileDecompressorDetect(bytes, length) != yamlConfigFileCompression_none );
+}
+
+//
+
+bool
+__yamlConfigFileDecompressorStart(
+    yamlConfigFileDecompressor  *aDecompressor,
+    yamlConfigFileCompression   compression
+)
+{
+    aDecompressor->compression = compression;
+    switch ( compression ) {
+        case yamlConfigFileCompression_none:
+            return true;
+#ifdef HAVE_ZLIB
+        case yamlConfigFileCompression_gzip:
+            // Only the gzip wrapper is accepted (not raw zlib or deflate):
+            memset(&aDecompressor->zStream, 0, sizeof(z_stream));
+            if ( inflateInit2(&aDecompressor->zStream, 16 + MAX_WBITS) != Z_OK ) return false;
+            aDecompressor->isZStreamInitialized = true;
+            DEBUG_PRINTF("decompressing gzip input", NULL);
+            return true;
+#endif
+#ifdef HAVE_ZSTD
+        case yamlConfigFileCompression_zstd:
+            if ( ! (aDecompressor->zstdStream = ZSTD_createDStream()) ) return false;
+            if ( ZSTD_isError(ZSTD_initDStream(aDecompressor->zstdStream)) ) return false;
+            DEBUG_PRINTF("decompressing zstd input", NULL);
+            return true;
+#endif
+        default:
+            break;
+    }
+    return false;
+}
+
+//
+
+yamlConfigFileDecompressor*
+__yamlConfigFileDecompressorCreateWithBytes(
+    const unsigned char         *bytes,
+    size_t                      length
+)
+{
+    yamlConfigFileCompression   compression = __yamlConfigFileDecompressorDetect(bytes, length);
+    yamlConfigFileDecompressor  *newDecompressor;
+
+    if ( compression == yamlConfigFileCompression_none ) return NULL;
+    if ( (newDecompressor = calloc(1, sizeof(yamlConfigFileDecompressor))) ) {
+        // All of the input is present from the start:
+        newDecompressor->input = bytes;
+        newDecompressor->inputLength = length;
+        newDecompressor->isSourceAtEnd = true;
+        if ( ! __yamlConfigFileDecompressorStart(newDecompressor, compression) ) {
+            __yamlConfigFileDecompressorDestroy(newDecompressor);
+            newDecompressor = NULL;
+        }
+    }
+    return newDecompressor;
+}
+
+//
+
+yamlConfigFileDecompressor*
+__yamlConfigFileDecompressorCreateWithFilePointer(
+    FILE                        *sourceFilePtr
+)
+{
+#if defined(HAVE_ZLIB) || defined(HAVE_ZSTD)
+    yamlConfigFileDecompressor  *newDecompressor = calloc(1, sizeof(yamlConfigFileDecompressor));
+
+    // The compression is determined on the first read:
+    if ( newDecompressor ) newDecompressor->sourceFilePtr = sourceFilePtr;
+    return newDecompressor;
+#else
+    return NULL;
+#endif
+}
+
+//
+
+void
+__yamlConfigFileDecompressorDestroy(
+    yamlConfigFileDecompressor  *aDecompressor
+)
+{
+#ifdef HAVE_ZLIB
+    if ( aDecompressor->isZStreamInitialized ) inflateEnd(&aDecompressor->zStream);
+#endif
+#ifdef HAVE_ZSTD
+    if ( aDecompressor->zstdStream ) ZSTD_freeDStream(aDecompressor->zstdStream);
+#endif
+    if ( aDecompressor->chunk ) free((void*)aDecompressor->chunk);
+    free((void*)aDecompressor);
+}
+
+//
+
+yamlConfigFileDecompressor*
+__yamlConfigFileDecompressorSetParserInputString(
+    yaml_parser_t               *parser,
+    const unsigned char         *bytes,
+    size_t                      length
+)
+{
+    yamlConfigFileDecompressor  *newDecompressor = __yamlConfigFileDecompressorCreateWithBytes(bytes, length);
+
+    if ( newDecompressor ) {
+        yaml_parser_set_input(parser, __yamlConfigFileDecompressorRead, newDecompressor);
+    } else {
+        yaml_parser_set_input_string(parser, bytes, length);
+    }
+    return newDecompressor;
+}
+
+//
+
+yamlConfigFileDecompressor*
+__yamlConfigFileDecompressorSetParserInputFile(
+    yaml_parser_t               *parser,
+    FILE                        *sourceFilePtr
+)
+{
+    yamlConfigFileDecompressor  *newDecompressor = __yamlConfigFileDecompressorCreateWithFilePointer(sourceFilePtr);
+
+    if ( newDecompressor ) {
+        yaml_parser_set_input(parser, __yamlConfigFileDecompressorRead, newDecompressor);
+    } else {
+        yaml_parser_set_input_file(parser, sourceFilePtr);
+    }
+    return newDecompressor;
+}
+
+//
+
+const unsigned char*
+__yamlConfigFileDecompressorGetConsumedTo(
+    yamlConfigFileDecompressor  *aDecompressor
+)
+{
+    return aDecompressor->input;
+}
+
+//
+#if 0
+#pragma mark -
+#endif
+//
+
+bool
+__yamlConfigFileDecompressorFillChunk(
+    yamlConfigFileDecompressor  *aDecompressor
+)
+{
+    size_t                      nbytes = fread(aDecompressor->chunk, 1, YAMLCONFIGFILE_DECOMPRESSOR_CHUNKSIZE, aDecompressor->sourceFilePtr);
+
+    if ( ferror(aDecompressor->sourceFilePtr) ) return false;
+    aDecompressor->input = aDecompressor->chunk;
+    aDecompressor->inputLength = nbytes;
+    if ( nbytes == 0 ) aDecompressor->isSourceAtEnd = true;
+    return true;
+}
+
+//
+
+#ifdef HAVE_ZLIB
+
+bool
+__yamlConfigFileDecompressorInflate(
+    yamlConfigFileDecompressor  *aDecompressor,
+    unsigned char               *buffer,
+    size_t                      size,
+    size_t                      *size_read
+)
+{
+    z_stream                    *zStream = &aDecompressor->zStream;
+    size_t                      inputLength = aDecompressor->inputLength;
+    int                         rc;
+
+    if ( aDecompressor->isFrameAtEnd ) {
+        // Another gzip member follows:
+        if ( inflateReset(zStream) != Z_OK ) return false;
+        aDecompressor->isFrameAtEnd = false;
+    }
+    if ( size > UINT_MAX ) size = UINT_MAX;
+    if ( inputLength > UINT_MAX ) inputLength = UINT_MAX;
+    zStream->next_in = (Bytef*)aDecompressor->input;
+    zStream->avail_in = (uInt)inputLength;
+    zStream->next_out = (Bytef*)buffer;
+    zStream->avail_out = (uInt)size;
+    rc = inflate(zStream, Z_NO_FLUSH);
+    aDecompressor->input += inputLength - zStream->avail_in;
+    aDecompressor->inputLength -= inputLength - zStream->avail_in;
+    *size_read = size - zStream->avail_out;
+    switch ( rc ) {
+        case Z_STREAM_END:
+            aDecompressor->isFrameAtEnd = true;
+            return true;
+        case Z_OK:
+            return true;
+        case Z_BUF_ERROR:
+            // No progress was possible; that is only an error if no more
+            // input is coming:
+            return ! (aDecompressor->isSourceAtEnd && ! aDecompressor->inputLength);
+    }
+    DEBUG_PRINTF("gzip input is corrupt (%d: %s)", rc, zStream->msg ? zStream->msg : "");
+    return false;
+}
+
+#endif
+
+//
+
+#ifdef HAVE_ZSTD
+
+bool
+__yamlConfigFileDecompressorDecompressStream(
+    yamlConfigFileDecompressor  *aDecompressor,
+    unsigned char               *buffer,
+    size_t                      size,
+    size_t                      *size_read
+)
+{
+    ZSTD_inBuffer               input = { aDecompressor->input, aDecompressor->inputLength, 0 };
+    ZSTD_outBuffer              output = { buffer, size, 0 };
+    size_t                      rc = ZSTD_decompressStream(aDecompressor->zstdStream, &output, &input);
+
+    if ( ZSTD_isError(rc) ) {
+        DEBUG_PRINTF("zstd input is corrupt (%s)", ZSTD_getErrorName(rc));
+        return false;
+    }
+    aDecompressor->input += input.pos;
+    aDecompressor->inputLength -= input.pos;
+    *size_read = output.pos;
+
+    // Any further frame is decompressed by the same stream:
+    aDecompressor->isFrameAtEnd = ( rc == 0 );
+    if ( ! output.pos && ! input.pos && aDecompressor->isSourceAtEnd && ! aDecompressor->inputLength ) return aDecompressor->isFrameAtEnd;
+    return true;
+}
+
+#endif
+
+//
+
+int
+__yamlConfigFileDecompressorRead(
+    void                        *data,
+    unsigned char               *buffer,
+    size_t                      size,
+    size_t                      *size_read
+)
+{
+    yamlConfigFileDecompressor  *aDecompressor = (yamlConfigFileDecompressor*)data;
+
+    *size_read = 0;
+    if ( aDecompressor->hasFailed ) return 0;
+
+    if ( aDecompressor->compression == yamlConfigFileCompression_unknown ) {
+        // Look at the leading bytes of the stream to decide:
+        if ( ! (aDecompressor->chunk = malloc(YAMLCONFIGFILE_DECOMPRESSOR_CHUNKSIZE)) ) goto failed;
+        aDecompressor->input = aDecompressor->chunk;
+        aDecompressor->inputLength = fread(aDecompressor->chunk, 1, YAMLCONFIGFILE_DECOMPRESSOR_MAGIC_LENGTH, aDecompressor->sourceFilePtr);
+        if ( ferror(aDecompressor->sourceFilePtr) ) goto failed;
+        if ( ! __yamlConfigFileDecompressorStart(aDecompressor, __yamlConfigFileDecompressorDetect(aDecompressor->input, aDecompressor->inputLength)) ) goto failed;
+    }
+
+    if ( aDecompressor->compression == yamlConfigFileCompression_none ) {
+        // Hand over the bytes read to detect the compression, then read
+        // straight into the parser's buffer:
+        if ( aDecompressor->inputLength ) {
+            if ( size > aDecompressor->inputLength ) size = aDecompressor->inputLength;
+            memcpy(buffer, aDecompressor->input, size);
+            aDecompressor->input += size;
+            aDecompressor->inputLength -= size;
+            *size_read = size;
+            return 1;
+        }
+        *size_read = fread(buffer, 1, size, aDecompressor->sourceFilePtr);
+        return ! ferror(aDecompressor->sourceFilePtr);
+    }
+
+    // Keep going until some output is produced or the input is exhausted:
+    while ( *size_read == 0 ) {
+        bool                    okay = false;
+
+        if ( ! aDecompressor->inputLength ) {
+            if ( ! aDecompressor->isSourceAtEnd && ! __yamlConfigFileDecompressorFillChunk(aDecompressor) ) goto failed;
+
+            // A complete frame followed by nothing is the end of the input:
+            if ( aDecompressor->isSourceAtEnd && aDecompressor->isFrameAtEnd ) return 1;
+        }
+        switch ( aDecompressor->compression ) {
+#ifdef HAVE_ZLIB
+            case yamlConfigFileCompression_gzip:
+                okay = __yamlConfigFileDecompressorInflate(aDecompressor, buffer, size, size_read);
+                break;
+#endif
+#ifdef HAVE_ZSTD
+            case yamlConfigFileCompression_zstd:
+                okay = __yamlConfigFileDecompressorDecompressStream(aDecompressor, buffer, size, size_read);
+                if ( okay && ! *size_read && aDecompressor->isSourceAtEnd && ! aDecompressor->inputLength && aDecompressor->isFrameAtEnd ) return 1;
+                break;
+#endif
+            default:
+                break;
+        }
+        if ( ! okay ) goto failed;
+    }
+    return 1;
+
+failed:
+    DEBUG_PRINTF("unable to decompress input", NULL);
+    aDecompressor->hasFailed = true;
+    return 0;
+}
@@ -0,0 +1,139 @@
+/*
+ * yamlConfigFileDecompressor
+ * Simplified YAML interface for C/Fortran
+ *
+ * Private interface to the on-the-fly decompression of compressed input.
+ * Not installed with the library.
+ *
+ */
+
+#ifndef __YAMLCONFIGFILEDECOMPRESSOR_H__
+#define __YAMLCONFIGFILEDECOMPRESSOR_H__
+
+#include "yamlConfigFile.h"
+
+/*!
+    @typedef yamlConfigFileDecompressor
+    Type of a libyaml read handler that decompresses its source as the
+    parser consumes it.
+
+    The compression format is recognized by its magic bytes:  gzip (when
+    built with zlib) and zstd (when built with libzstd).  Concatenated gzip
+    members and zstd frames are decompressed in turn.  Only a fixed-size
+    chunk of compressed input is held at a time, and decompressed bytes go
+    straight into the parser's own input buffer, so memory use does not
+    depend on the size of the document.
+
+    A decompressor reading from a FILE stream must examine the first bytes
+    of the stream before it knows whether they are compressed; it does so
+    on the parser's first read, and passes uncompressed input through
+    unchanged.
+*/
+typedef struct __yamlConfigFileDecompressor yamlConfigFileDecompressor;
+
+/*!
+    @function __yamlConfigFileDecompressorIsCompressed
+    Returns boolean true if the length bytes at bytes start with the magic
+    bytes of a compression format this build can decompress.
+*/
+bool
+__yamlConfigFileDecompressorIsCompressed(
+    const unsigned char         *bytes,
+    size_t                      length
+);
+
+/*!
+    @function __yamlConfigFileDecompressorSetParserInputString
+    Attach the length bytes at bytes to parser as its input, as
+    yaml_parser_set_input_string() would, but decompress them as the parser
+    reads them if they are compressed.  The bytes must remain valid until
+    the parser has been deleted.
+
+    @return NULL if the bytes are not compressed, otherwise the decompressor
+        that must be passed to __yamlConfigFileDecompressorDestroy() once
+        the parser has been deleted
+*/
+yamlConfigFileDecompressor*
+__yamlConfigFileDecompressorSetParserInputString(
+    yaml_parser_t               *parser,
+    const unsigned char         *bytes,
+    size_t                      length
+);
+
+/*!
+    @function __yamlConfigFileDecompressorSetParserInputFile
+    Attach sourceFilePtr to parser as its input, as
+    yaml_parser_set_input_file() would, but decompress the stream as the
+    parser reads it if it turns out to be compressed.
+
+    @return NULL if no decompression is possible in this build (the stream
+        is attached directly), otherwise the decompressor that must be
+        passed to __yamlConfigFileDecompressorDestroy() once the parser has
+        been deleted
+*/
+yamlConfigFileDecompressor*
+__yamlConfigFileDecompressorSetParserInputFile(
+    yaml_parser_t               *parser,
+    FILE                        *sourceFilePtr
+);
+
+/*!
+    @function __yamlConfigFileDecompressorCreateWithBytes
+    Create a decompressor for the compressed length bytes at bytes.
+
+    @return NULL if the bytes are not compressed or on error
+*/
+yamlConfigFileDecompressor*
+__yamlConfigFileDecompressorCreateWithBytes(
+    const unsigned char         *bytes,
+    size_t                      length
+);
+
+/*!
+    @function __yamlConfigFileDecompressorCreateWithFilePointer
+    Create a decompressor for the (possibly) compressed stream
+    sourceFilePtr.
+
+    @return NULL if no decompression is possible in this build or on error
+*/
+yamlConfigFileDecompressor*
+__yamlConfigFileDecompressorCreateWithFilePointer(
+    FILE                        *sourceFilePtr
+);
+
+/*!
+    @function __yamlConfigFileDecompressorDestroy
+    Dispose of aDecompressor.  A FILE stream it reads from is not closed.
+*/
+void
+__yamlConfigFileDecompressorDestroy(
+    yamlConfigFileDecompressor  *aDecompressor
+);
+
+/*!
+    @function __yamlConfigFileDecompressorGetConsumedTo
+    For a decompressor created with bytes, returns the address just past
+    the last compressed byte it has consumed.
+*/
+const unsigned char*
+__yamlConfigFileDecompressorGetConsumedTo(
+    yamlConfigFileDecompressor  *aDecompressor
+);
+
+/*!
+    @function __yamlConfigFileDecompressorRead
+    A yaml_read_handler_t that fills buffer with up to size decompressed
+    bytes from the decompressor at data; *size_read is zero only at the end
+    of the input.
+
+    @return Zero if the input could not be read or is corrupt or truncated
+*/
+int
+__yamlConfigFileDecompressorRead(
+    void                        *data,
+    unsigned char               *buffer,
+    size_t                      size,
+    size_t                      *size_read
+);
+
+#endif /* __YAMLCONFIGFILEDECOMPRESSOR_H__ */
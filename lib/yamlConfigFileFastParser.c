@@ -0,0 +1,1049 @@
+/*
+ * yamlConfigFileFastParser
+ * Simplified YAML interface for C/Fortran
+ *
+ * Hand-written parsers for the common configuration subset of
+ * YAML and for JSON, building the same yaml_document_t as libyaml.
+ *
+ */
+
+#include "yamlConfigFileFastParser.h"
+
+//
+
+#ifdef YAMLCONFIGFILE_DEBUG
+#define DEBUG_PRINTF(F, ...) fprintf(stderr, "[DEBUG] " F "\n", __VA_ARGS__)
+#else
+#define DEBUG_PRINTF(F, ...)
+#endif
+
+//
+
+/*!
+    @defined YAMLCONFIGFILE_FAST_PARSE_MAX_DEPTH
+    Collections nested deeper than this are left to libyaml rather than
+    risk exhausting the stack.
+*/
+#ifndef YAMLCONFIGFILE_FAST_PARSE_MAX_DEPTH
+#define YAMLCONFIGFILE_FAST_PARSE_MAX_DEPTH 256
+#endif
+
+/*!
+    @defined YAMLCONFIGFILE_FAST_PARSE_MAX_KEY_LENGTH
+    libyaml refuses simple keys longer than 1024 characters; anything close
+    to that is left to libyaml.
+*/
+#ifndef YAMLCONFIGFILE_FAST_PARSE_MAX_KEY_LENGTH
+#define YAMLCONFIGFILE_FAST_PARSE_MAX_KEY_LENGTH 1000
+#endif
+
+//
+#if 0
+#pragma mark -
+#endif
+//
+
+/*
+ * libyaml's reader rejects malformed UTF-8 and non-printable characters,
+ * and its scanner treats NEL, LS, PS and the BOM specially; rather than
+ * mimic all of that, any such input is left to libyaml.  Carriage returns
+ * are left to libyaml, too, unless allowsCarriageReturn is true.
+ */
+bool
+__yamlConfigFileFastParserIsPlainText(
+    const unsigned char     *bytes,
+    size_t                  length,
+    bool                    allowsCarriageReturn
+)
+{
+    const unsigned char     *end = bytes + length;
+
+    while ( bytes < end ) {
+        unsigned char       c = *bytes;
+        uint32_t            codePoint, minimum;
+        unsigned int        width, i;
+
+        if ( c < 0x80 ) {
+            if ( ((c < 0x20) && (c != '\n') && (c != '\t') && ((c != '\r') || ! allowsCarriageReturn)) || (c == 0x7F) ) return false;
+            bytes++;
+            continue;
+        }
+        if ( (c & 0xE0) == 0xC0 ) {
+            width = 2; codePoint = c & 0x1F; minimum = 0x80;
+        } else if ( (c & 0xF0) == 0xE0 ) {
+            width = 3; codePoint = c & 0x0F; minimum = 0x800;
+        } else if ( (c & 0xF8) == 0xF0 ) {
+            width = 4; codePoint = c & 0x07; minimum = 0x10000;
+        } else {
+            return false;
+        }
+        if ( bytes + width > end ) return false;
+        for ( i = 1; i < width; i++ ) {
+            if ( (bytes[i] & 0xC0) != 0x80 ) return false;
+            codePoint = (codePoint << 6) | (bytes[i] & 0x3F);
+        }
+        if ( (codePoint < minimum) || (codePoint < 0xA0) || (codePoint > 0x10FFFF) ) return false;
+        if ( (codePoint >= 0xD800) && (codePoint <= 0xDFFF) ) return false;
+        if ( (codePoint == 0x2028) || (codePoint == 0x2029) || (codePoint == 0xFEFF) || (codePoint == 0xFFFE) || (codePoint == 0xFFFF) ) return false;
+        bytes += width;
+    }
+    return true;
+}
+
+/*
+ * Scalars are by far the most numerous nodes, so rather than going through
+ * yaml_document_add_scalar() (which copies the value and re-validates the
+ * UTF-8 we have already checked) they are pushed onto the document's node
+ * stack directly; libyaml frees the stack, the tag, and the value with
+ * free().  The document takes ownership of value (allocated with malloc()
+ * and NUL-terminated), even on failure.
+ */
+int
+__yamlConfigFileFastParserPushScalar(
+    yaml_document_t         *aDocument,
+    yaml_char_t             *value,
+    size_t                  length,
+    yaml_scalar_style_t     style
+)
+{
+    yaml_node_t             *newNode;
+    yaml_char_t             *tagCopy;
+    size_t                  nodeCount = aDocument->nodes.top - aDocument->nodes.start;
+
+    if ( (length >= INT_MAX) || (nodeCount >= INT_MAX) ) goto failed;
+    if ( aDocument->nodes.top == aDocument->nodes.end ) {
+        size_t              newCapacity = nodeCount ? 2 * nodeCount : 16;
+        yaml_node_t         *newNodes = realloc(aDocument->nodes.start, newCapacity * sizeof(yaml_node_t));
+
+        if ( ! newNodes ) goto failed;
+        aDocument->nodes.start = newNodes;
+        aDocument->nodes.top = newNodes + nodeCount;
+        aDocument->nodes.end = newNodes + newCapacity;
+    }
+    if ( ! (tagCopy = (yaml_char_t*)strdup(YAML_DEFAULT_SCALAR_TAG)) ) goto failed;
+
+    newNode = aDocument->nodes.top++;
+    memset(newNode, 0, sizeof(yaml_node_t));
+    newNode->type = YAML_SCALAR_NODE;
+    newNode->tag = tagCopy;
+    newNode->data.scalar.value = value;
+    newNode->data.scalar.length = length;
+    newNode->data.scalar.style = style;
+    return (int)(nodeCount + 1);
+
+failed:
+    free((void*)value);
+    return 0;
+}
+
+//
+#if 0
+#pragma mark -
+#endif
+//
+
+/*
+ * The parser works a line at a time.  Each parse function starts with
+ * the cursor at the first character of its node and, on success, leaves
+ * it at the first character of the next line with content (setting that
+ * line's indentation) or at the end of the input.  Any failure simply
+ * unwinds:  the caller throws the document away and lets libyaml have a
+ * go.
+ *
+ * Node ids are allocated in the order libyaml's composer allocates them:
+ * a collection before its children, a key before its value.
+ */
+
+typedef struct {
+    const unsigned char     *end;
+    const unsigned char     *line;
+    const unsigned char     *p;
+    int                     indent;
+    bool                    isAtEnd;
+    bool                    allowsDocumentStart;
+    unsigned int            depth;
+    yaml_document_t         *document;
+} yamlConfigFileFastParser;
+
+//
+
+static inline bool
+__yamlConfigFileFastParserIsBlank(
+    unsigned char           c
+)
+{
+    return ( (c == ' ') || (c == '\t') );
+}
+
+//
+
+static inline bool
+__yamlConfigFileFastParserIsBlankOrBreak(
+    yamlConfigFileFastParser    *aParser,
+    const unsigned char         *q
+)
+{
+    return ( (q >= aParser->end) || (*q == '\n') || __yamlConfigFileFastParserIsBlank(*q) );
+}
+
+//
+
+static inline bool
+__yamlConfigFileFastParserIsSequenceEntry(
+    yamlConfigFileFastParser    *aParser,
+    const unsigned char         *q
+)
+{
+    return ( (*q == '-') && __yamlConfigFileFastParserIsBlankOrBreak(aParser, q + 1) );
+}
+
+//
+
+static inline bool
+__yamlConfigFileFastParserIsPlainStart(
+    yamlConfigFileFastParser    *aParser,
+    const unsigned char         *q
+)
+{
+    switch ( *q ) {
+        case '-':
+            return ! __yamlConfigFileFastParserIsBlankOrBreak(aParser, q + 1);
+        case '?': case ':': case ',': case '[': case ']': case '{': case '}':
+        case '#': case '&': case '*': case '!': case '|': case '>': case '\'':
+        case '"': case '%': case '@': case '`':
+            return false;
+    }
+    return true;
+}
+
+//
+
+//
+
+/*
+ * Move to the next line with content, skipping blank and comment-only
+ * lines.  The cursor must be at the start of a line.  A tab before the
+ * content of a line is an error to libyaml, as is a document marker we do
+ * not handle.
+ */
+bool
+__yamlConfigFileFastParserNextContentLine(
+    yamlConfigFileFastParser    *aParser
+)
+{
+    const unsigned char         *q = aParser->p;
+
+    while ( q < aParser->end ) {
+        const unsigned char     *line = q;
+
+        while ( (q < aParser->end) && (*q == ' ') ) q++;
+        if ( q == aParser->end ) break;
+        if ( *q == '\t' ) return false;
+        if ( *q == '#' ) {
+            while ( (q < aParser->end) && (*q != '\n') ) q++;
+        }
+        if ( q == aParser->end ) break;
+        if ( *q == '\n' ) {
+            q++;
+            continue;
+        }
+        aParser->line = line;
+        aParser->p = q;
+        aParser->indent = (int)(q - line);
+        if ( aParser->indent == 0 ) {
+            if ( *q == '%' ) return false;
+            if ( ((aParser->end - q) >= 3) && ((memcmp(q, "---", 3) == 0) || (memcmp(q, "...", 3) == 0)) && __yamlConfigFileFastParserIsBlankOrBreak(aParser, q + 3) ) {
+                if ( ! aParser->allowsDocumentStart || (*q == '.') ) return false;
+            }
+        }
+        return true;
+    }
+    aParser->p = aParser->end;
+    aParser->isAtEnd = true;
+    return true;
+}
+
+//
+
+/*
+ * Finish the current line at q, which may only be followed by blanks
+ * and/or a comment, then move to the next line with content.
+ */
+bool
+__yamlConfigFileFastParserFinishLine(
+    yamlConfigFileFastParser    *aParser,
+    const unsigned char         *q
+)
+{
+    const unsigned char         *blanksStart = q;
+
+    while ( (q < aParser->end) && __yamlConfigFileFastParserIsBlank(*q) ) q++;
+    if ( (q < aParser->end) && (*q == '#') && (q > blanksStart) ) {
+        while ( (q < aParser->end) && (*q != '\n') ) q++;
+    }
+    if ( q < aParser->end ) {
+        if ( *q != '\n' ) return false;
+        q++;
+    }
+    aParser->p = q;
+    return __yamlConfigFileFastParserNextContentLine(aParser);
+}
+
+//
+
+/*
+ * Locate the closing quote of the single-line quoted scalar that starts at
+ * q.  Double-quoted scalars with escapes are left to libyaml; doubled
+ * single quotes are noted so the value can be unescaped.
+ */
+const unsigned char*
+__yamlConfigFileFastParserScanQuoted(
+    yamlConfigFileFastParser    *aParser,
+    const unsigned char         *q,
+    bool                        *needsUnescape
+)
+{
+    unsigned char               quote = *q++;
+
+    *needsUnescape = false;
+    while ( (q < aParser->end) && (*q != '\n') ) {
+        if ( *q == quote ) {
+            if ( (quote == '\'') && (q + 1 < aParser->end) && (q[1] == '\'') ) {
+                *needsUnescape = true;
+                q += 2;
+                continue;
+            }
+            return q;
+        }
+        if ( (quote == '"') && (*q == '\\') ) return NULL;
+        q++;
+    }
+    return NULL;
+}
+
+//
+
+/*
+ * Scan the plain scalar that starts at q in the block context:  it ends
+ * at the end of the line or at a comment.  If a ':' followed by a blank
+ * (or the end of the line) is present, the scalar is actually a mapping
+ * key and *colon is set to point at the ':'.
+ */
+const unsigned char*
+__yamlConfigFileFastParserScanPlain(
+    yamlConfigFileFastParser    *aParser,
+    const unsigned char         *q,
+    const unsigned char*        *colon
+)
+{
+    const unsigned char         *valueEnd = q;
+
+    *colon = NULL;
+    while ( (q < aParser->end) && (*q != '\n') ) {
+        if ( __yamlConfigFileFastParserIsBlank(*q) ) {
+            if ( (q + 1 < aParser->end) && (q[1] == '#') ) break;
+        } else {
+            if ( (*q == ':') && __yamlConfigFileFastParserIsBlankOrBreak(aParser, q + 1) ) {
+                *colon = q;
+                return valueEnd;
+            }
+            valueEnd = q + 1;
+        }
+        q++;
+    }
+    return valueEnd;
+}
+
+//
+
+int
+__yamlConfigFileFastParserAddScalar(
+    yamlConfigFileFastParser    *aParser,
+    const unsigned char         *value,
+    size_t                      length,
+    yaml_scalar_style_t         style,
+    bool                        needsUnescape
+)
+{
+    yaml_char_t                 *valueCopy = malloc(length + 1);
+
+    if ( ! valueCopy ) return 0;
+    if ( needsUnescape ) {
+        size_t                  i = 0, j = 0;
+
+        while ( i < length ) {
+            valueCopy[j++] = value[i];
+            i += ( value[i] == '\'' ) ? 2 : 1;
+        }
+        length = j;
+    } else {
+        memcpy(valueCopy, value, length);
+    }
+    valueCopy[length] = '\0';
+    return __yamlConfigFileFastParserPushScalar(aParser->document, valueCopy, length, style);
+}
+
+//
+
+int __yamlConfigFileFastParserParseNode(yamlConfigFileFastParser *aParser, int parentIndent, bool allowsCollection);
+
+//
+
+/*
+ * Parse a flow sequence of scalars that opens and closes on the current
+ * line; *q points at the '[' and is left just past the ']'.
+ */
+int
+__yamlConfigFileFastParserParseFlowSequence(
+    yamlConfigFileFastParser    *aParser,
+    const unsigned char*        *q
+)
+{
+    const unsigned char         *r = *q + 1;
+    int                         sequenceId = yaml_document_add_sequence(aParser->document, NULL, YAML_FLOW_SEQUENCE_STYLE);
+
+    if ( ! sequenceId ) return 0;
+    while ( (r < aParser->end) && __yamlConfigFileFastParserIsBlank(*r) ) r++;
+    if ( (r < aParser->end) && (*r == ']') ) {
+        *q = r + 1;
+        return sequenceId;
+    }
+    while ( 1 ) {
+        int                     itemId;
+
+        if ( (r == aParser->end) || (*r == '\n') ) return 0;
+        if ( (*r == '\'') || (*r == '"') ) {
+            bool                needsUnescape;
+            const unsigned char *closeQuote = __yamlConfigFileFastParserScanQuoted(aParser, r, &needsUnescape);
+
+            if ( ! closeQuote ) return 0;
+            itemId = __yamlConfigFileFastParserAddScalar(aParser, r + 1, closeQuote - r - 1, (*r == '"') ? YAML_DOUBLE_QUOTED_SCALAR_STYLE : YAML_SINGLE_QUOTED_SCALAR_STYLE, needsUnescape);
+            r = closeQuote + 1;
+        } else {
+            const unsigned char *valueStart = r, *valueEnd = r;
+
+            if ( ! __yamlConfigFileFastParserIsPlainStart(aParser, r) ) return 0;
+            while ( (r < aParser->end) && (*r != '\n') && (*r != ',') && (*r != ']') ) {
+                switch ( *r ) {
+                    case '[': case '{': case '}': case ':':
+                        // Nested collections and pairs are left to libyaml:
+                        return 0;
+                    case ' ': case '\t':
+                        if ( (r + 1 < aParser->end) && (r[1] == '#') ) return 0;
+                        break;
+                    default:
+                        valueEnd = r + 1;
+                        break;
+                }
+                r++;
+            }
+            itemId = __yamlConfigFileFastParserAddScalar(aParser, valueStart, valueEnd - valueStart, YAML_PLAIN_SCALAR_STYLE, false);
+        }
+        if ( ! itemId || ! yaml_document_append_sequence_item(aParser->document, sequenceId, itemId) ) return 0;
+        while ( (r < aParser->end) && __yamlConfigFileFastParserIsBlank(*r) ) r++;
+        if ( r == aParser->end ) return 0;
+        if ( *r == ']' ) {
+            *q = r + 1;
+            return sequenceId;
+        }
+        if ( *r != ',' ) return 0;
+        r++;
+        while ( (r < aParser->end) && __yamlConfigFileFastParserIsBlank(*r) ) r++;
+        // Trailing comma:
+        if ( (r < aParser->end) && (*r == ']') ) return 0;
+    }
+}
+
+//
+
+/*
+ * Parse the value that follows a ':' or '-' indicator; the cursor is just
+ * past the indicator.  The value is either on the same line or (if the
+ * rest of the line is empty) on the following, more-indented lines;
+ * failing that, it is an empty scalar or an indentless sequence.
+ */
+int
+__yamlConfigFileFastParserParseValue(
+    yamlConfigFileFastParser    *aParser,
+    int                         parentIndent,
+    bool                        isSequenceItem
+)
+{
+    const unsigned char         *q = aParser->p;
+
+    while ( (q < aParser->end) && (*q == ' ') ) q++;
+    if ( (q < aParser->end) && (*q == '\t') ) return 0;
+    if ( (q == aParser->end) || (*q == '\n') || (*q == '#') ) {
+        if ( ! __yamlConfigFileFastParserFinishLine(aParser, aParser->p) ) return 0;
+        if ( ! aParser->isAtEnd ) {
+            if ( aParser->indent > parentIndent ) return __yamlConfigFileFastParserParseNode(aParser, parentIndent, true);
+            if ( ! isSequenceItem && (aParser->indent == parentIndent) && __yamlConfigFileFastParserIsSequenceEntry(aParser, aParser->p) ) {
+                return __yamlConfigFileFastParserParseNode(aParser, parentIndent - 1, true);
+            }
+        }
+        return __yamlConfigFileFastParserAddScalar(aParser, (const unsigned char*)"", 0, YAML_PLAIN_SCALAR_STYLE, false);
+    }
+    aParser->p = q;
+    return __yamlConfigFileFastParserParseNode(aParser, parentIndent, isSequenceItem);
+}
+
+//
+
+int
+__yamlConfigFileFastParserParseBlockSequence(
+    yamlConfigFileFastParser    *aParser,
+    int                         indent
+)
+{
+    int                         sequenceId = yaml_document_add_sequence(aParser->document, NULL, YAML_BLOCK_SEQUENCE_STYLE);
+
+    if ( ! sequenceId ) return 0;
+    while ( 1 ) {
+        int                     itemId;
+
+        aParser->p++;
+        if ( ! (itemId = __yamlConfigFileFastParserParseValue(aParser, indent, true)) ) return 0;
+        if ( ! yaml_document_append_sequence_item(aParser->document, sequenceId, itemId) ) return 0;
+        if ( aParser->isAtEnd || (aParser->indent < indent) ) break;
+        if ( aParser->indent > indent ) return 0;
+
+        // An indentless sequence ends at the next key of its mapping:
+        if ( ! __yamlConfigFileFastParserIsSequenceEntry(aParser, aParser->p) ) break;
+    }
+    return sequenceId;
+}
+
+//
+
+int
+__yamlConfigFileFastParserParseBlockMapping(
+    yamlConfigFileFastParser    *aParser,
+    int                         indent
+)
+{
+    int                         mappingId = yaml_document_add_mapping(aParser->document, NULL, YAML_BLOCK_MAPPING_STYLE);
+
+    if ( ! mappingId ) return 0;
+    while ( 1 ) {
+        const unsigned char     *q = aParser->p, *colon;
+        int                     keyId, valueId;
+
+        if ( (*q == '\'') || (*q == '"') ) {
+            bool                needsUnescape;
+            const unsigned char *closeQuote = __yamlConfigFileFastParserScanQuoted(aParser, q, &needsUnescape);
+
+            if ( ! closeQuote ) return 0;
+            colon = closeQuote + 1;
+            while ( (colon < aParser->end) && __yamlConfigFileFastParserIsBlank(*colon) ) colon++;
+            if ( (colon == aParser->end) || (*colon != ':') || ! __yamlConfigFileFastParserIsBlankOrBreak(aParser, colon + 1) ) return 0;
+            keyId = __yamlConfigFileFastParserAddScalar(aParser, q + 1, closeQuote - q - 1, (*q == '"') ? YAML_DOUBLE_QUOTED_SCALAR_STYLE : YAML_SINGLE_QUOTED_SCALAR_STYLE, needsUnescape);
+        } else {
+            const unsigned char *keyEnd;
+
+            if ( ! __yamlConfigFileFastParserIsPlainStart(aParser, q) ) return 0;
+            keyEnd = __yamlConfigFileFastParserScanPlain(aParser, q, &colon);
+            if ( ! colon ) return 0;
+            keyId = __yamlConfigFileFastParserAddScalar(aParser, q, keyEnd - q, YAML_PLAIN_SCALAR_STYLE, false);
+        }
+        if ( ! keyId || (colon - q > YAMLCONFIGFILE_FAST_PARSE_MAX_KEY_LENGTH) ) return 0;
+        aParser->p = colon + 1;
+        if ( ! (valueId = __yamlConfigFileFastParserParseValue(aParser, indent, false)) ) return 0;
+        if ( ! yaml_document_append_mapping_pair(aParser->document, mappingId, keyId, valueId) ) return 0;
+        if ( aParser->isAtEnd || (aParser->indent < indent) ) break;
+        if ( (aParser->indent > indent) || __yamlConfigFileFastParserIsSequenceEntry(aParser, aParser->p) ) return 0;
+    }
+    return mappingId;
+}
+
+//
+
+/*
+ * Parse the node that starts at the cursor.  If allowsCollection is false
+ * (a value on the same line as its key) only a scalar or flow sequence is
+ * permitted.  A scalar or flow sequence must be the last thing on its
+ * line, and the next line with content may not be indented beyond
+ * parentIndent (it would be the continuation of a multi-line scalar).
+ */
+int
+__yamlConfigFileFastParserParseNode(
+    yamlConfigFileFastParser    *aParser,
+    int                         parentIndent,
+    bool                        allowsCollection
+)
+{
+    const unsigned char         *q = aParser->p, *after, *colon = NULL;
+    int                         column = (int)(q - aParser->line), nodeId = 0;
+
+    if ( ++aParser->depth > YAMLCONFIGFILE_FAST_PARSE_MAX_DEPTH ) return 0;
+
+    if ( __yamlConfigFileFastParserIsSequenceEntry(aParser, q) ) {
+        if ( allowsCollection ) nodeId = __yamlConfigFileFastParserParseBlockSequence(aParser, column);
+        aParser->depth--;
+        return nodeId;
+    }
+    if ( *q == '[' ) {
+        after = q;
+        nodeId = __yamlConfigFileFastParserParseFlowSequence(aParser, &after);
+    }
+    else if ( (*q == '\'') || (*q == '"') ) {
+        bool                    needsUnescape;
+        const unsigned char     *closeQuote = __yamlConfigFileFastParserScanQuoted(aParser, q, &needsUnescape);
+
+        if ( ! closeQuote ) return 0;
+        after = closeQuote + 1;
+        while ( (after < aParser->end) && __yamlConfigFileFastParserIsBlank(*after) ) after++;
+        if ( (after < aParser->end) && (*after == ':') && __yamlConfigFileFastParserIsBlankOrBreak(aParser, after + 1) ) {
+            colon = after;
+        } else {
+            nodeId = __yamlConfigFileFastParserAddScalar(aParser, q + 1, closeQuote - q - 1, (*q == '"') ? YAML_DOUBLE_QUOTED_SCALAR_STYLE : YAML_SINGLE_QUOTED_SCALAR_STYLE, needsUnescape);
+            after = closeQuote + 1;
+        }
+    }
+    else if ( __yamlConfigFileFastParserIsPlainStart(aParser, q) ) {
+        const unsigned char     *valueEnd = __yamlConfigFileFastParserScanPlain(aParser, q, &colon);
+
+        if ( ! colon ) {
+            nodeId = __yamlConfigFileFastParserAddScalar(aParser, q, valueEnd - q, YAML_PLAIN_SCALAR_STYLE, false);
+            after = valueEnd;
+        }
+    }
+    else {
+        return 0;
+    }
+
+    if ( colon ) {
+        // The node is a block mapping, and this is its first key:
+        if ( allowsCollection ) nodeId = __yamlConfigFileFastParserParseBlockMapping(aParser, column);
+    }
+    else if ( nodeId ) {
+        if ( ! __yamlConfigFileFastParserFinishLine(aParser, after) ) return 0;
+        if ( ! aParser->isAtEnd && (aParser->indent > parentIndent) ) return 0;
+    }
+    aParser->depth--;
+    return nodeId;
+}
+
+//
+#if 0
+#pragma mark -
+#endif
+//
+
+bool
+__yamlConfigFileFastParse(
+    const unsigned char     *bytes,
+    size_t                  length,
+    yaml_document_t         *aDocument
+)
+{
+    yamlConfigFileFastParser    parser;
+    int                         startImplicit = 1;
+    bool                        isParsed = false;
+
+    if ( ! __yamlConfigFileFastParserIsPlainText(bytes, length, false) ) return false;
+
+    memset(&parser, 0, sizeof(parser));
+    parser.end = bytes + length;
+    parser.line = parser.p = bytes;
+    parser.document = aDocument;
+    parser.allowsDocumentStart = true;
+    if ( ! __yamlConfigFileFastParserNextContentLine(&parser) ) return false;
+
+    // An explicit start to the document:
+    if ( ! parser.isAtEnd && (parser.indent == 0) && ((parser.end - parser.p) >= 3) && (memcmp(parser.p, "---", 3) == 0) && __yamlConfigFileFastParserIsBlankOrBreak(&parser, parser.p + 3) ) {
+        parser.allowsDocumentStart = false;
+        startImplicit = 0;
+        if ( ! __yamlConfigFileFastParserFinishLine(&parser, parser.p + 3) ) return false;
+    }
+    parser.allowsDocumentStart = false;
+
+    // An empty stream is left to libyaml:
+    if ( parser.isAtEnd ) return false;
+
+    if ( yaml_document_initialize(aDocument, NULL, NULL, NULL, startImplicit, 1) ) {
+        isParsed = ( __yamlConfigFileFastParserParseNode(&parser, -1, true) && parser.isAtEnd );
+        if ( ! isParsed ) {
+            DEBUG_PRINTF("fast parse stopped at byte %lld", (long long)(parser.p - bytes));
+            yaml_document_delete(aDocument);
+        }
+    }
+    return isParsed;
+}
+
+//
+#if 0
+#pragma mark -
+#endif
+//
+
+/*
+ * JSON is a subset of YAML's flow syntax, so the JSON parser produces
+ * exactly what libyaml's composer does for the same text:  flow-style
+ * mappings and sequences, double-quoted strings, and plain numbers and
+ * literals, all with the default tags.  The few places where libyaml reads
+ * valid JSON differently (a key separated from its ':' by a line break, an
+ * over-long key, tabs outside the root value) are left to libyaml.
+ */
+
+typedef struct {
+    const unsigned char     *end;
+    const unsigned char     *p;
+    unsigned int            depth;
+    yaml_document_t         *document;
+} yamlConfigFileJSONParser;
+
+//
+
+static inline void
+__yamlConfigFileJSONParserSkipWhitespace(
+    yamlConfigFileJSONParser    *aParser
+)
+{
+    while ( (aParser->p < aParser->end) && ((*aParser->p == ' ') || (*aParser->p == '\n') || (*aParser->p == '\r') || (*aParser->p == '\t')) ) aParser->p++;
+}
+
+//
+
+static inline int
+__yamlConfigFileJSONParserHexValue(
+    unsigned char           c
+)
+{
+    if ( (c >= '0') && (c <= '9') ) return c - '0';
+    if ( (c >= 'a') && (c <= 'f') ) return c - 'a' + 10;
+    if ( (c >= 'A') && (c <= 'F') ) return c - 'A' + 10;
+    return -1;
+}
+
+//
+
+/*
+ * Decode the four hex digits at q as a UTF-16 code unit.
+ */
+bool
+__yamlConfigFileJSONParserScanCodeUnit(
+    yamlConfigFileJSONParser    *aParser,
+    const unsigned char         *q,
+    uint32_t                    *codeUnit
+)
+{
+    unsigned int                i;
+
+    if ( aParser->end - q < 4 ) return false;
+    *codeUnit = 0;
+    for ( i = 0; i < 4; i++ ) {
+        int                     digit = __yamlConfigFileJSONParserHexValue(q[i]);
+
+        if ( digit < 0 ) return false;
+        *codeUnit = (*codeUnit << 4) | digit;
+    }
+    return true;
+}
+
+//
+
+/*
+ * Parse the string that starts at the cursor and add it to the document as
+ * a double-quoted scalar.  No escape sequence is longer than the UTF-8 it
+ * decodes to, so the value fits in a buffer as long as the quoted text.
+ *
+ * libyaml does not pair UTF-16 surrogates in \u escapes (it rejects them
+ * outright), so a surrogate pair is the one valid JSON construct decoded
+ * here that libyaml would fail on; a lone surrogate is still an error.
+ */
+int
+__yamlConfigFileJSONParserParseString(
+    yamlConfigFileJSONParser    *aParser
+)
+{
+    const unsigned char         *q = aParser->p + 1, *closeQuote = q;
+    yaml_char_t                 *value, *v;
+
+    while ( 1 ) {
+        if ( closeQuote >= aParser->end ) return 0;
+        if ( *closeQuote == '"' ) break;
+        // Raw control characters are invalid JSON (and line breaks would
+        // be folded by libyaml):
+        if ( *closeQuote < 0x20 ) return 0;
+        closeQuote += ( *closeQuote == '\\' ) ? 2 : 1;
+    }
+    if ( ! (v = value = malloc(closeQuote - q + 1)) ) return 0;
+    while ( q < closeQuote ) {
+        uint32_t                codePoint;
+
+        if ( *q != '\\' ) {
+            *v++ = *q++;
+            continue;
+        }
+        switch ( q[1] ) {
+            case '"': case '\\': case '/':
+                *v++ = q[1];
+                break;
+            case 'b':
+                *v++ = '\b';
+                break;
+            case 'f':
+                *v++ = '\f';
+                break;
+            case 'n':
+                *v++ = '\n';
+                break;
+            case 'r':
+                *v++ = '\r';
+                break;
+            case 't':
+                *v++ = '\t';
+                break;
+            case 'u':
+                if ( ! __yamlConfigFileJSONParserScanCodeUnit(aParser, q + 2, &codePoint) ) goto failed;
+                if ( (codePoint >= 0xDC00) && (codePoint <= 0xDFFF) ) goto failed;
+                if ( (codePoint >= 0xD800) && (codePoint <= 0xDBFF) ) {
+                    uint32_t    lowSurrogate;
+
+                    if ( (q + 12 > closeQuote) || (q[6] != '\\') || (q[7] != 'u') ) goto failed;
+                    if ( ! __yamlConfigFileJSONParserScanCodeUnit(aParser, q + 8, &lowSurrogate) ) goto failed;
+                    if ( (lowSurrogate < 0xDC00) || (lowSurrogate > 0xDFFF) ) goto failed;
+                    codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (lowSurrogate - 0xDC00);
+                    q += 6;
+                }
+                q += 4;
+                if ( codePoint < 0x80 ) {
+                    *v++ = codePoint;
+                } else if ( codePoint < 0x800 ) {
+                    *v++ = 0xC0 | (codePoint >> 6);
+                    *v++ = 0x80 | (codePoint & 0x3F);
+                } else if ( codePoint < 0x10000 ) {
+                    *v++ = 0xE0 | (codePoint >> 12);
+                    *v++ = 0x80 | ((codePoint >> 6) & 0x3F);
+                    *v++ = 0x80 | (codePoint & 0x3F);
+                } else {
+                    *v++ = 0xF0 | (codePoint >> 18);
+                    *v++ = 0x80 | ((codePoint >> 12) & 0x3F);
+                    *v++ = 0x80 | ((codePoint >> 6) & 0x3F);
+                    *v++ = 0x80 | (codePoint & 0x3F);
+                }
+                break;
+            default:
+                goto failed;
+        }
+        q += 2;
+    }
+    *v = '\0';
+    aParser->p = closeQuote + 1;
+    return __yamlConfigFileFastParserPushScalar(aParser->document, value, v - value, YAML_DOUBLE_QUOTED_SCALAR_STYLE);
+
+failed:
+    free((void*)value);
+    return 0;
+}
+
+//
+
+/*
+ * Parse the number or literal (true, false, null) that starts at the
+ * cursor and add it to the document as a plain scalar.
+ */
+int
+__yamlConfigFileJSONParserParseLiteral(
+    yamlConfigFileJSONParser    *aParser
+)
+{
+    const unsigned char         *q = aParser->p, *valueStart = q;
+    yaml_char_t                 *value;
+    size_t                      length;
+
+    if ( (aParser->end - q >= 4) && ((memcmp(q, "true", 4) == 0) || (memcmp(q, "null", 4) == 0)) ) {
+        q += 4;
+    }
+    else if ( (aParser->end - q >= 5) && (memcmp(q, "false", 5) == 0) ) {
+        q += 5;
+    }
+    else {
+        if ( (q < aParser->end) && (*q == '-') ) q++;
+        if ( (q < aParser->end) && (*q == '0') ) {
+            q++;
+        } else if ( (q < aParser->end) && (*q >= '1') && (*q <= '9') ) {
+            while ( (q < aParser->end) && (*q >= '0') && (*q <= '9') ) q++;
+        } else {
+            return 0;
+        }
+        if ( (q < aParser->end) && (*q == '.') ) {
+            const unsigned char *digits = ++q;
+
+            while ( (q < aParser->end) && (*q >= '0') && (*q <= '9') ) q++;
+            if ( q == digits ) return 0;
+        }
+        if ( (q < aParser->end) && ((*q == 'e') || (*q == 'E')) ) {
+            const unsigned char *digits;
+
+            q++;
+            if ( (q < aParser->end) && ((*q == '+') || (*q == '-')) ) q++;
+            digits = q;
+            while ( (q < aParser->end) && (*q >= '0') && (*q <= '9') ) q++;
+            if ( q == digits ) return 0;
+        }
+    }
+    // The token must end where libyaml's plain scalar would:
+    if ( (q < aParser->end) && ! strchr(" \t\r\n,]}", *q) ) return 0;
+
+    length = q - valueStart;
+    if ( ! (value = malloc(length + 1)) ) return 0;
+    memcpy(value, valueStart, length);
+    value[length] = '\0';
+    aParser->p = q;
+    return __yamlConfigFileFastParserPushScalar(aParser->document, value, length, YAML_PLAIN_SCALAR_STYLE);
+}
+
+//
+
+int __yamlConfigFileJSONParserParseValue(yamlConfigFileJSONParser *aParser);
+
+//
+
+int
+__yamlConfigFileJSONParserParseObject(
+    yamlConfigFileJSONParser    *aParser
+)
+{
+    int                         mappingId = yaml_document_add_mapping(aParser->document, NULL, YAML_FLOW_MAPPING_STYLE);
+
+    if ( ! mappingId ) return 0;
+    aParser->p++;
+    __yamlConfigFileJSONParserSkipWhitespace(aParser);
+    if ( (aParser->p < aParser->end) && (*aParser->p == '}') ) {
+        aParser->p++;
+        return mappingId;
+    }
+    while ( 1 ) {
+        const unsigned char     *keyStart = aParser->p;
+        int                     keyId, valueId;
+
+        if ( (keyStart == aParser->end) || (*keyStart != '"') ) return 0;
+        if ( ! (keyId = __yamlConfigFileJSONParserParseString(aParser)) ) return 0;
+
+        // libyaml only recognizes a key whose ':' is on the same line and
+        // not too far off:
+        while ( (aParser->p < aParser->end) && ((*aParser->p == ' ') || (*aParser->p == '\t')) ) aParser->p++;
+        if ( (aParser->p == aParser->end) || (*aParser->p != ':') ) return 0;
+        if ( aParser->p - keyStart > YAMLCONFIGFILE_FAST_PARSE_MAX_KEY_LENGTH ) return 0;
+        aParser->p++;
+
+        if ( ! (valueId = __yamlConfigFileJSONParserParseValue(aParser)) ) return 0;
+        if ( ! yaml_document_append_mapping_pair(aParser->document, mappingId, keyId, valueId) ) return 0;
+        __yamlConfigFileJSONParserSkipWhitespace(aParser);
+        if ( aParser->p == aParser->end ) return 0;
+        if ( *aParser->p == '}' ) break;
+        if ( *aParser->p != ',' ) return 0;
+        aParser->p++;
+        __yamlConfigFileJSONParserSkipWhitespace(aParser);
+    }
+    aParser->p++;
+    return mappingId;
+}
+
+//
+
+int
+__yamlConfigFileJSONParserParseArray(
+    yamlConfigFileJSONParser    *aParser
+)
+{
+    int                         sequenceId = yaml_document_add_sequence(aParser->document, NULL, YAML_FLOW_SEQUENCE_STYLE);
+
+    if ( ! sequenceId ) return 0;
+    aParser->p++;
+    __yamlConfigFileJSONParserSkipWhitespace(aParser);
+    if ( (aParser->p < aParser->end) && (*aParser->p == ']') ) {
+        aParser->p++;
+        return sequenceId;
+    }
+    while ( 1 ) {
+        int                     itemId;
+
+        if ( ! (itemId = __yamlConfigFileJSONParserParseValue(aParser)) ) return 0;
+        if ( ! yaml_document_append_sequence_item(aParser->document, sequenceId, itemId) ) return 0;
+        __yamlConfigFileJSONParserSkipWhitespace(aParser);
+        if ( aParser->p == aParser->end ) return 0;
+        if ( *aParser->p == ']' ) break;
+        if ( *aParser->p != ',' ) return 0;
+        aParser->p++;
+    }
+    aParser->p++;
+    return sequenceId;
+}
+
+//
+
+int
+__yamlConfigFileJSONParserParseValue(
+    yamlConfigFileJSONParser    *aParser
+)
+{
+    int                         nodeId = 0;
+
+    __yamlConfigFileJSONParserSkipWhitespace(aParser);
+    if ( aParser->p == aParser->end ) return 0;
+    switch ( *aParser->p ) {
+        case '{':
+        case '[':
+            if ( ++aParser->depth > YAMLCONFIGFILE_FAST_PARSE_MAX_DEPTH ) return 0;
+            nodeId = ( *aParser->p == '{' ) ? __yamlConfigFileJSONParserParseObject(aParser) : __yamlConfigFileJSONParserParseArray(aParser);
+            aParser->depth--;
+            break;
+        case '"':
+            nodeId = __yamlConfigFileJSONParserParseString(aParser);
+            break;
+        default:
+            nodeId = __yamlConfigFileJSONParserParseLiteral(aParser);
+            break;
+    }
+    return nodeId;
+}
+
+//
+
+bool
+__yamlConfigFileFastParserIsJSON(
+    const unsigned char     *bytes,
+    size_t                  length
+)
+{
+    const unsigned char     *end = bytes + length;
+
+    while ( (bytes < end) && ((*bytes == ' ') || (*bytes == '\n') || (*bytes == '\r')) ) bytes++;
+    return ( (bytes < end) && ((*bytes == '{') || (*bytes == '[')) );
+}
+
+//
+
+bool
+__yamlConfigFileFastParseJSON(
+    const unsigned char     *bytes,
+    size_t                  length,
+    yaml_document_t         *aDocument
+)
+{
+    yamlConfigFileJSONParser    parser;
+    bool                        isParsed = false;
+
+    if ( ! __yamlConfigFileFastParserIsJSON(bytes, length) ) return false;
+    if ( ! __yamlConfigFileFastParserIsPlainText(bytes, length, true) ) return false;
+
+    parser.end = bytes + length;
+    parser.p = bytes;
+    parser.depth = 0;
+    parser.document = aDocument;
+    if ( yaml_document_initialize(aDocument, NULL, NULL, NULL, 1, 1) ) {
+        if ( __yamlConfigFileJSONParserParseValue(&parser) ) {
+            // Nothing but whitespace may follow (libyaml rejects a tab at
+            // the start of a line outside of a flow collection):
+            while ( (parser.p < parser.end) && ((*parser.p == ' ') || (*parser.p == '\n') || (*parser.p == '\r')) ) parser.p++;
+            isParsed = ( parser.p == parser.end );
+        }
+        if ( ! isParsed ) {
+            DEBUG_PRINTF("JSON parse stopped at byte %lld", (long long)(parser.p - bytes));
+            yaml_document_delete(aDocument);
+        }
+    }
+    return isParsed;
+}
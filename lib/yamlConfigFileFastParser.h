@@ -0,0 +1,93 @@
+/*
+ * yamlConfigFileFastParser
+ * Simplified YAML interface for C/Fortran
+ *
+ * Private interface to the hand-written parsers for the common
+ * configuration subset of YAML and for JSON.  Not installed with the
+ * library.
+ *
+ */
+
+#ifndef __YAMLCONFIGFILEFASTPARSER_H__
+#define __YAMLCONFIGFILEFASTPARSER_H__
+
+#include "yamlConfigFile.h"
+
+/*!
+    @function __yamlConfigFileFastParse
+    Parse the first document in the length bytes at bytes into aDocument,
+    producing exactly the nodes (in the same order, with the same tags and
+    styles) that yaml_parser_load() would, but without libyaml's general
+    scanner and parser.
+
+    Only a subset of YAML is understood:  block mappings with plain or
+    quoted single-line keys, block sequences (including compact and
+    indentless forms), single-line flow sequences of scalars, single-line
+    plain scalars, single-line quoted scalars without escape sequences,
+    comments, and a leading "---".  Anything else (anchors, aliases, tags,
+    block scalars, flow mappings, multi-line scalars, directives, further
+    documents, tabs where libyaml would reject them, non-printable
+    characters, etc.) makes the parse fail so that the caller can fall back
+    to libyaml, which either handles the construct or reports the error.
+
+    @param bytes
+        The (UTF-8) document text
+    @param length
+        Number of bytes at bytes
+    @param aDocument
+        The document to initialize and fill-in; on success the caller must
+        eventually yaml_document_delete() it, on failure it has already
+        been deleted
+
+    @return Boolean false if the text is outside the supported subset
+*/
+bool
+__yamlConfigFileFastParse(
+    const unsigned char     *bytes,
+    size_t                  length,
+    yaml_document_t         *aDocument
+);
+
+/*!
+    @function __yamlConfigFileFastParserIsJSON
+    Returns boolean true if the first character other than whitespace in the
+    length bytes at bytes opens a JSON object or array.
+*/
+bool
+__yamlConfigFileFastParserIsJSON(
+    const unsigned char     *bytes,
+    size_t                  length
+);
+
+/*!
+    @function __yamlConfigFileFastParseJSON
+    Parse the JSON object or array in the length bytes at bytes into
+    aDocument, producing exactly the nodes that yaml_parser_load() would
+    (flow-style collections, double-quoted strings, plain numbers and
+    literals) without going through libyaml's YAML scanner.
+
+    Text that is not valid JSON, or that libyaml would read differently
+    (e.g. a key separated from its ':' by a line break), makes the parse
+    fail so that the caller can fall back to libyaml.  The exception is a
+    UTF-16 surrogate pair in a \u escape, which is decoded here although
+    libyaml rejects it.
+
+    @param bytes
+        The (UTF-8) JSON text
+    @param length
+        Number of bytes at bytes
+    @param aDocument
+        The document to initialize and fill-in; on success the caller must
+        eventually yaml_document_delete() it, on failure it has already
+        been deleted
+
+    @return Boolean false if the text could not be parsed as JSON
+*/
+bool
+__yamlConfigFileFastParseJSON(
+    const unsigned char     *bytes,
+    size_t                  length,
+    yaml_document_t         *aDocument
+);
+
+#endif /* __YAMLCONFIGFILEFASTPARSER_H__ */
@@ -0,0 +1,633 @@
+/*
+ * yamlConfigFileFilter
+ * Simplified YAML interface for C/Fortran
+ *
+ * Event-driven composition of the parts of a YAML document
+ * selected by include/exclude key paths.
+ *
+ */
+
+#include "yamlConfigFileFilter.h"
+#include "yamlKeyPathPrivate.h"
+
+//
+
+#ifdef YAMLCONFIGFILE_DEBUG
+#define DEBUG_PRINTF(F, ...) fprintf(stderr, "[DEBUG] " F "\n", __VA_ARGS__)
+#else
+#define DEBUG_PRINTF(F, ...)
+#endif
+
+//
+#if 0
+#pragma mark -
+#endif
+//
+
+/*
+ * A selection records how a node relates to the filter:  whether it is
+ * composed at all, whether everything beneath it is included, and -- for
+ * each include path followed by each exclude path -- the key path element
+ * its children must match to stay on that path (NULL once the path has
+ * diverged).
+ */
+typedef struct {
+    bool                        isKept;
+    bool                        isFullyIncluded;
+    unsigned int                liveIncludeCount;
+    unsigned int                liveExcludeCount;
+    yamlKeyPathNodeMatchType*   *matches;
+} yamlConfigFileFilterSelection;
+
+typedef struct {
+    yaml_node_type_t            type;
+    int                         nodeId;
+    yamlConfigFileFilterSelection selection;
+    bool                        isExpectingKey;
+    int                         keyId;
+    int                         itemIndex;
+    yamlConfigFileFilterSelection childSelection;
+    yamlKeyPathNodeMatchType*   *matchesBuffer;
+} yamlConfigFileFilterFrame;
+
+typedef struct {
+    const char                  *anchor;
+    int                         nodeId;
+} yamlConfigFileFilterAnchor;
+
+typedef struct {
+    const yamlConfigFileFilter  *filter;
+    unsigned int                matchCount;
+    bool                        isCaseless;
+    yaml_document_t             *document;
+    unsigned int                depth, frameCapacity;
+    yamlConfigFileFilterFrame   *frames;
+    unsigned int                anchorCount, anchorCapacity;
+    yamlConfigFileFilterAnchor  *anchors;
+    yamlConfigFileFilterSelection rootSelection;
+} yamlConfigFileFilterState;
+
+//
+
+static const yamlConfigFileFilterSelection __yamlConfigFileFilterSelectionDiscard = { false, false, 0, 0, NULL };
+static const yamlConfigFileFilterSelection __yamlConfigFileFilterSelectionWhole = { true, true, 0, 0, NULL };
+
+//
+
+static inline bool
+__yamlConfigFileFilterSelectionIsFiltering(
+    const yamlConfigFileFilterSelection *aSelection
+)
+{
+    return ( aSelection->isKept && (aSelection->liveIncludeCount || aSelection->liveExcludeCount) );
+}
+
+//
+
+void
+__yamlConfigFileFilterSelectChild(
+    yamlConfigFileFilterState           *aState,
+    const yamlConfigFileFilterSelection *parentSelection,
+    yaml_node_type_t                    parentType,
+    yaml_char_t                         *key,
+    size_t                              keyLength,
+    int                                 index,
+    yamlConfigFileFilterSelection       *childSelection
+)
+{
+    unsigned int                        includeCount = aState->filter->includePathCount;
+    unsigned int                        i;
+    bool                                isExcluded = false;
+
+    childSelection->isFullyIncluded = parentSelection->isFullyIncluded;
+    childSelection->liveIncludeCount = childSelection->liveExcludeCount = 0;
+    for ( i = 0; i < aState->matchCount; i++ ) {
+        yamlKeyPathNodeMatchType        *m = parentSelection->matches[i];
+        bool                            isMatch = false;
+
+        childSelection->matches[i] = NULL;
+        if ( m && (m->type == parentType) ) {
+            if ( parentType == YAML_MAPPING_NODE ) {
+                isMatch = ( key && m->parameter.key && (__yamlKeyPathKeyCmp(key, keyLength, m->parameter.key, aState->isCaseless) == 0) );
+            } else {
+                isMatch = ( m->parameter.index == index );
+            }
+        }
+        if ( isMatch ) {
+            yamlKeyPathNodeMatchType    *nextM = yamlKeyPathGetNextNodeMatch(m);
+
+            if ( i < includeCount ) {
+                if ( ! nextM ) childSelection->isFullyIncluded = true;
+                else {
+                    childSelection->matches[i] = nextM;
+                    childSelection->liveIncludeCount++;
+                }
+            } else {
+                if ( ! nextM ) isExcluded = true;
+                else {
+                    childSelection->matches[i] = nextM;
+                    childSelection->liveExcludeCount++;
+                }
+            }
+        }
+    }
+    if ( childSelection->isFullyIncluded && childSelection->liveIncludeCount ) {
+        // Partial include paths under a fully-included node are moot:
+        for ( i = 0; i < includeCount; i++ ) childSelection->matches[i] = NULL;
+        childSelection->liveIncludeCount = 0;
+    }
+    childSelection->isKept = ! isExcluded && (childSelection->isFullyIncluded || childSelection->liveIncludeCount);
+}
+
+//
+
+bool
+__yamlConfigFileFilterPushFrame(
+    yamlConfigFileFilterState           *aState,
+    yaml_node_type_t                    type,
+    int                                 nodeId,
+    const yamlConfigFileFilterSelection *aSelection
+)
+{
+    yamlConfigFileFilterSelection       theSelection = *aSelection;
+    yamlConfigFileFilterFrame           *frame;
+
+    // aSelection may point into the frame stack, so it is copied before the
+    // stack is grown:
+    if ( aState->depth == aState->frameCapacity ) {
+        unsigned int                    newCapacity = aState->frameCapacity + 32;
+        yamlConfigFileFilterFrame       *newFrames = realloc(aState->frames, newCapacity * sizeof(yamlConfigFileFilterFrame));
+
+        if ( ! newFrames ) return false;
+        memset(newFrames + aState->frameCapacity, 0, (newCapacity - aState->frameCapacity) * sizeof(yamlConfigFileFilterFrame));
+        aState->frames = newFrames;
+        aState->frameCapacity = newCapacity;
+    }
+    frame = &aState->frames[aState->depth];
+    frame->type = type;
+    frame->nodeId = nodeId;
+    frame->selection = theSelection;
+    frame->isExpectingKey = true;
+    frame->keyId = 0;
+    frame->itemIndex = 0;
+    frame->childSelection = __yamlConfigFileFilterSelectionDiscard;
+    if ( __yamlConfigFileFilterSelectionIsFiltering(&theSelection) ) {
+        // Match buffers are allocated once per depth and reused:
+        if ( ! frame->matchesBuffer && ! (frame->matchesBuffer = malloc(2 * aState->matchCount * sizeof(yamlKeyPathNodeMatchType*))) ) return false;
+        frame->selection.matches = frame->matchesBuffer;
+        memcpy(frame->selection.matches, theSelection.matches, aState->matchCount * sizeof(yamlKeyPathNodeMatchType*));
+        frame->childSelection.matches = frame->matchesBuffer + aState->matchCount;
+    } else {
+        frame->selection.matches = NULL;
+    }
+    aState->depth++;
+    return true;
+}
+
+//
+
+bool
+__yamlConfigFileFilterAddAnchor(
+    yamlConfigFileFilterState   *aState,
+    const yaml_char_t           *anchor,
+    int                         nodeId
+)
+{
+    if ( aState->anchorCount == aState->anchorCapacity ) {
+        unsigned int                newCapacity = aState->anchorCapacity + 16;
+        yamlConfigFileFilterAnchor  *newAnchors = realloc(aState->anchors, newCapacity * sizeof(yamlConfigFileFilterAnchor));
+
+        if ( ! newAnchors ) return false;
+        aState->anchors = newAnchors;
+        aState->anchorCapacity = newCapacity;
+    }
+    if ( ! (aState->anchors[aState->anchorCount].anchor = strdup((const char*)anchor)) ) return false;
+    aState->anchors[aState->anchorCount++].nodeId = nodeId;
+    return true;
+}
+
+//
+
+int
+__yamlConfigFileFilterFindAnchor(
+    yamlConfigFileFilterState   *aState,
+    const yaml_char_t           *anchor
+)
+{
+    unsigned int                i = aState->anchorCount;
+
+    // Most recent definition wins, as in the libyaml composer:
+    while ( i-- > 0 ) if ( strcmp(aState->anchors[i].anchor, (const char*)anchor) == 0 ) return aState->anchors[i].nodeId;
+    return 0;
+}
+
+//
+
+bool
+__yamlConfigFileFilterNodeEvent(
+    yamlConfigFileFilterState   *aState,
+    yaml_event_t                *anEvent
+)
+{
+    yamlConfigFileFilterFrame           *parent = aState->depth ? &aState->frames[aState->depth - 1] : NULL;
+    const yamlConfigFileFilterSelection *selection;
+    bool                                isKey = false;
+    yaml_char_t                         *anchor = NULL, *tag = NULL;
+    yamlConfigFileFilterSelection       theSelection;
+    unsigned int                        parentDepth;
+    int                                 nodeId = 0;
+
+    switch ( anEvent->type ) {
+        case YAML_SCALAR_EVENT:
+            anchor = anEvent->data.scalar.anchor;
+            tag = anEvent->data.scalar.tag;
+            break;
+        case YAML_SEQUENCE_START_EVENT:
+            anchor = anEvent->data.sequence_start.anchor;
+            tag = anEvent->data.sequence_start.tag;
+            break;
+        case YAML_MAPPING_START_EVENT:
+            anchor = anEvent->data.mapping_start.anchor;
+            tag = anEvent->data.mapping_start.tag;
+            break;
+        default:
+            break;
+    }
+    if ( tag && (strcmp((const char*)tag, "!") == 0) ) tag = NULL;
+
+    // How is this node selected?
+    if ( ! parent ) {
+        selection = &aState->rootSelection;
+    } else if ( ! parent->nodeId ) {
+        selection = &__yamlConfigFileFilterSelectionDiscard;
+        if ( parent->type == YAML_MAPPING_NODE ) {
+            isKey = parent->isExpectingKey;
+            parent->isExpectingKey = ! isKey;
+        }
+    } else if ( ! __yamlConfigFileFilterSelectionIsFiltering(&parent->selection) ) {
+        selection = &__yamlConfigFileFilterSelectionWhole;
+        if ( parent->type == YAML_MAPPING_NODE ) {
+            isKey = parent->isExpectingKey;
+            parent->isExpectingKey = ! isKey;
+        }
+    } else if ( parent->type == YAML_MAPPING_NODE ) {
+        if ( (isKey = parent->isExpectingKey) ) {
+            // The key decides the fate of the value; only scalar keys can
+            // match a key path:
+            if ( anEvent->type == YAML_SCALAR_EVENT ) {
+                __yamlConfigFileFilterSelectChild(aState, &parent->selection, YAML_MAPPING_NODE, anEvent->data.scalar.value, anEvent->data.scalar.length, 0, &parent->childSelection);
+            } else {
+                __yamlConfigFileFilterSelectChild(aState, &parent->selection, YAML_MAPPING_NODE, NULL, 0, 0, &parent->childSelection);
+            }
+            selection = parent->childSelection.isKept ? &__yamlConfigFileFilterSelectionWhole : &__yamlConfigFileFilterSelectionDiscard;
+        } else {
+            selection = &parent->childSelection;
+        }
+        parent->isExpectingKey = ! isKey;
+    } else {
+        __yamlConfigFileFilterSelectChild(aState, &parent->selection, YAML_SEQUENCE_NODE, NULL, 0, parent->itemIndex, &parent->childSelection);
+        selection = &parent->childSelection;
+    }
+
+    // Pushing a frame can move the frame stack, so work with a copy of the
+    // selection (the match buffers themselves never move):
+    theSelection = *selection;
+    parentDepth = aState->depth;
+
+    switch ( anEvent->type ) {
+        case YAML_ALIAS_EVENT:
+            if ( theSelection.isKept ) {
+                if ( ! (nodeId = __yamlConfigFileFilterFindAnchor(aState, anEvent->data.alias.anchor)) ) {
+                    DEBUG_PRINTF("undefined alias *%s", anEvent->data.alias.anchor);
+                    return false;
+                }
+            }
+            break;
+        case YAML_SCALAR_EVENT:
+            // Anchored nodes are always composed (whole) so that aliases
+            // resolve:
+            if ( theSelection.isKept || anchor ) {
+                nodeId = yaml_document_add_scalar(aState->document, tag, anEvent->data.scalar.value, (int)anEvent->data.scalar.length, anEvent->data.scalar.style);
+                if ( ! nodeId ) return false;
+            }
+            break;
+        case YAML_SEQUENCE_START_EVENT:
+            if ( theSelection.isKept || anchor ) {
+                nodeId = yaml_document_add_sequence(aState->document, tag, anEvent->data.sequence_start.style);
+                if ( ! nodeId ) return false;
+            }
+            if ( ! __yamlConfigFileFilterPushFrame(aState, YAML_SEQUENCE_NODE, nodeId, (anchor && nodeId) ? &__yamlConfigFileFilterSelectionWhole : &theSelection) ) return false;
+            break;
+        case YAML_MAPPING_START_EVENT:
+            if ( theSelection.isKept || anchor ) {
+                nodeId = yaml_document_add_mapping(aState->document, tag, anEvent->data.mapping_start.style);
+                if ( ! nodeId ) return false;
+            }
+            if ( ! __yamlConfigFileFilterPushFrame(aState, YAML_MAPPING_NODE, nodeId, (anchor && nodeId) ? &__yamlConfigFileFilterSelectionWhole : &theSelection) ) return false;
+            break;
+        default:
+            break;
+    }
+    if ( anchor && nodeId && ! __yamlConfigFileFilterAddAnchor(aState, anchor, nodeId) ) return false;
+
+    // Attach the node to its parent:
+    parent = parentDepth ? &aState->frames[parentDepth - 1] : NULL;
+    if ( parent && parent->nodeId ) {
+        if ( parent->type == YAML_MAPPING_NODE ) {
+            if ( theSelection.isKept ) {
+                if ( isKey ) {
+                    parent->keyId = nodeId;
+                } else if ( ! yaml_document_append_mapping_pair(aState->document, parent->nodeId, parent->keyId, nodeId) ) {
+                    return false;
+                }
+            }
+        } else {
+            // Unselected sequence items become null scalars so that the
+            // indices of the selected items are unchanged:
+            if ( ! theSelection.isKept ) {
+                nodeId = yaml_document_add_scalar(aState->document, NULL, (yaml_char_t*)"~", 1, YAML_PLAIN_SCALAR_STYLE);
+                if ( ! nodeId ) return false;
+            }
+            if ( ! yaml_document_append_sequence_item(aState->document, parent->nodeId, nodeId) ) return false;
+            parent->itemIndex++;
+        }
+    } else if ( parent && (parent->type == YAML_SEQUENCE_NODE) ) {
+        parent->itemIndex++;
+    }
+    return true;
+}
+
+//
+
+bool
+__yamlConfigFileFilterStateInit(
+    yamlConfigFileFilterState   *aState,
+    const yamlConfigFileFilter  *aFilter,
+    yamlOptionsBitvec           keyPathOptions,
+    yaml_document_t             *aDocument
+)
+{
+    static const yamlConfigFileFilter   noFilter = { NULL, 0, NULL, 0 };
+    unsigned int                        i;
+
+    if ( ! aFilter ) aFilter = &noFilter;
+    memset(aState, 0, sizeof(*aState));
+    aState->filter = aFilter;
+    aState->matchCount = aFilter->includePathCount + aFilter->excludePathCount;
+    aState->isCaseless = (keyPathOptions & yamlKeyPathApplyOptions_keysAreCaseless) ? true : false;
+    aState->document = aDocument;
+
+    // The root node starts every include and exclude path:
+    aState->rootSelection.isFullyIncluded = (aFilter->includePathCount == 0);
+    if ( aState->matchCount ) {
+        if ( ! (aState->rootSelection.matches = malloc(aState->matchCount * sizeof(yamlKeyPathNodeMatchType*))) ) return false;
+        for ( i = 0; i < aState->matchCount; i++ ) {
+            yamlKeyPathRef      aKeyPath = (i < aFilter->includePathCount) ? aFilter->includePaths[i] : aFilter->excludePaths[i - aFilter->includePathCount];
+
+            aState->rootSelection.matches[i] = yamlKeyPathGetFirstNodeMatch(aKeyPath);
+            if ( aState->rootSelection.matches[i] ) {
+                if ( i < aFilter->includePathCount ) aState->rootSelection.liveIncludeCount++;
+                else aState->rootSelection.liveExcludeCount++;
+            } else if ( i < aFilter->includePathCount ) {
+                // An empty include path selects the entire document:
+                aState->rootSelection.isFullyIncluded = true;
+            }
+        }
+        if ( aState->rootSelection.isFullyIncluded ) {
+            for ( i = 0; i < aFilter->includePathCount; i++ ) aState->rootSelection.matches[i] = NULL;
+            aState->rootSelection.liveIncludeCount = 0;
+        }
+    }
+    // The root node is always composed (an unselected root is composed as
+    // an empty container):
+    aState->rootSelection.isKept = true;
+    return true;
+}
+
+//
+
+void
+__yamlConfigFileFilterStateDestroy(
+    yamlConfigFileFilterState   *aState
+)
+{
+    unsigned int                i;
+
+    for ( i = 0; i < aState->frameCapacity; i++ ) if ( aState->frames[i].matchesBuffer ) free((void*)aState->frames[i].matchesBuffer);
+    if ( aState->frames ) free((void*)aState->frames);
+    for ( i = 0; i < aState->anchorCount; i++ ) free((void*)aState->anchors[i].anchor);
+    if ( aState->anchors ) free((void*)aState->anchors);
+    if ( aState->rootSelection.matches ) free((void*)aState->rootSelection.matches);
+}
+
+//
+
+/*
+ * A loader wraps the composer state with the document-level events, so a
+ * document can be composed a limited number of events at a time.
+ */
+struct __yamlConfigFileFilterLoader {
+    yamlConfigFileFilterState   state;
+    yaml_document_t             *document;
+    bool                        isDocumentStarted;
+    yamlConfigFileFilterLoaderStatus status;
+    unsigned long               eventCount;
+};
+
+//
+
+bool
+__yamlConfigFileFilterLoaderInit(
+    yamlConfigFileFilterLoader  *aLoader,
+    const yamlConfigFileFilter  *aFilter,
+    yamlOptionsBitvec           keyPathOptions,
+    yaml_document_t             *aDocument
+)
+{
+    aLoader->document = aDocument;
+    aLoader->isDocumentStarted = false;
+    aLoader->status = yamlConfigFileFilterLoaderStatus_inProgress;
+    aLoader->eventCount = 0;
+    if ( ! __yamlConfigFileFilterStateInit(&aLoader->state, aFilter, keyPathOptions, aDocument) ) {
+        __yamlConfigFileFilterStateDestroy(&aLoader->state);
+        return false;
+    }
+    return true;
+}
+
+//
+
+void
+__yamlConfigFileFilterLoaderDestroyState(
+    yamlConfigFileFilterLoader  *aLoader
+)
+{
+    // A document that was not completed is of no use to anyone:
+    if ( aLoader->isDocumentStarted && (aLoader->status != yamlConfigFileFilterLoaderStatus_isComplete) ) yaml_document_delete(aLoader->document);
+    __yamlConfigFileFilterStateDestroy(&aLoader->state);
+}
+
+//
+
+yamlConfigFileFilterLoader*
+__yamlConfigFileFilterLoaderCreate(
+    const yamlConfigFileFilter  *aFilter,
+    yamlOptionsBitvec           keyPathOptions,
+    yaml_document_t             *aDocument
+)
+{
+    yamlConfigFileFilterLoader  *newLoader = malloc(sizeof(yamlConfigFileFilterLoader));
+    
+    if ( newLoader && ! __yamlConfigFileFilterLoaderInit(newLoader, aFilter, keyPathOptions, aDocument) ) {
+        free((void*)newLoader);
+        newLoader = NULL;
+    }
+    return newLoader;
+}
+
+//
+
+void
+__yamlConfigFileFilterLoaderDestroy(
+    yamlConfigFileFilterLoader  *aLoader
+)
+{
+    __yamlConfigFileFilterLoaderDestroyState(aLoader);
+    free((void*)aLoader);
+}
+
+//
+
+yamlConfigFileFilterLoaderStatus
+__yamlConfigFileFilterLoaderStep(
+    yamlConfigFileFilterLoader  *aLoader,
+    yaml_parser_t               *parser,
+    unsigned int                maxEvents
+)
+{
+    yaml_event_t                event;
+    bool                        isOkay = true, isLimited = (maxEvents > 0);
+    
+    while ( (aLoader->status == yamlConfigFileFilterLoaderStatus_inProgress) && (! isLimited || maxEvents--) ) {
+        if ( ! yaml_parser_parse(parser, &event) ) {
+            isOkay = false;
+        } else {
+            aLoader->eventCount++;
+            switch ( event.type ) {
+                case YAML_STREAM_START_EVENT:
+                    break;
+                case YAML_STREAM_END_EVENT:
+                    // No document in the stream, as with yaml_parser_load():
+                    if ( ! aLoader->isDocumentStarted ) {
+                        isOkay = yaml_document_initialize(aLoader->document, NULL, NULL, NULL, 1, 1);
+                        aLoader->isDocumentStarted = isOkay;
+                    }
+                    if ( isOkay ) aLoader->status = yamlConfigFileFilterLoaderStatus_isComplete;
+                    break;
+                case YAML_DOCUMENT_START_EVENT:
+                    isOkay = yaml_document_initialize(aLoader->document,
+                                    event.data.document_start.version_directive,
+                                    event.data.document_start.tag_directives.start,
+                                    event.data.document_start.tag_directives.end,
+                                    event.data.document_start.implicit, 1);
+                    aLoader->isDocumentStarted = isOkay;
+                    break;
+                case YAML_DOCUMENT_END_EVENT:
+                    aLoader->document->end_implicit = event.data.document_end.implicit;
+                    aLoader->status = yamlConfigFileFilterLoaderStatus_isComplete;
+                    break;
+                case YAML_SEQUENCE_END_EVENT:
+                case YAML_MAPPING_END_EVENT:
+                    if ( aLoader->state.depth ) aLoader->state.depth--;
+                    break;
+                default:
+                    isOkay = __yamlConfigFileFilterNodeEvent(&aLoader->state, &event);
+                    break;
+            }
+            yaml_event_delete(&event);
+        }
+        if ( ! isOkay ) {
+            if ( aLoader->isDocumentStarted ) yaml_document_delete(aLoader->document);
+            aLoader->isDocumentStarted = false;
+            aLoader->status = yamlConfigFileFilterLoaderStatus_hasFailed;
+        }
+    }
+    return aLoader->status;
+}
+
+//
+
+unsigned long
+__yamlConfigFileFilterLoaderGetEventCount(
+    yamlConfigFileFilterLoader  *aLoader
+)
+{
+    return aLoader->eventCount;
+}
+
+//
+
+bool
+__yamlConfigFileFilterLoad(
+    yaml_parser_t               *parser,
+    const yamlConfigFileFilter  *aFilter,
+    yamlOptionsBitvec           keyPathOptions,
+    yaml_document_t             *aDocument
+)
+{
+    yamlConfigFileFilterLoader  loader;
+    bool                        isOkay;
+
+    if ( ! __yamlConfigFileFilterLoaderInit(&loader, aFilter, keyPathOptions, aDocument) ) return false;
+    isOkay = ( __yamlConfigFileFilterLoaderStep(&loader, parser, 0) == yamlConfigFileFilterLoaderStatus_isComplete );
+    __yamlConfigFileFilterLoaderDestroyState(&loader);
+    return isOkay;
+}
+
+//
+
+bool
+__yamlConfigFileFilterComposeNode(
+    yaml_parser_t               *parser,
+    yaml_event_t                *firstEvent,
+    const yamlConfigFileFilter  *aFilter,
+    yamlOptionsBitvec           keyPathOptions,
+    yaml_document_t             *aDocument
+)
+{
+    yamlConfigFileFilterState   state;
+    yaml_event_t                event;
+    bool                        isOkay;
+
+    if ( ! __yamlConfigFileFilterStateInit(&state, aFilter, keyPathOptions, aDocument) ) {
+        __yamlConfigFileFilterStateDestroy(&state);
+        return false;
+    }
+    isOkay = __yamlConfigFileFilterNodeEvent(&state, firstEvent);
+
+    // Consume events until the node is complete:
+    while ( isOkay && state.depth ) {
+        if ( ! yaml_parser_parse(parser, &event) ) {
+            isOkay = false;
+            break;
+        }
+        switch ( event.type ) {
+            case YAML_SEQUENCE_END_EVENT:
+            case YAML_MAPPING_END_EVENT:
+                state.depth--;
+                break;
+            case YAML_ALIAS_EVENT:
+            case YAML_SCALAR_EVENT:
+            case YAML_SEQUENCE_START_EVENT:
+            case YAML_MAPPING_START_EVENT:
+                isOkay = __yamlConfigFileFilterNodeEvent(&state, &event);
+                break;
+            default:
+                isOkay = false;
+                break;
+        }
+        yaml_event_delete(&event);
+    }
+    __yamlConfigFileFilterStateDestroy(&state);
+    return isOkay;
+}
@@ -0,0 +1,140 @@
+/*
+ * yamlConfigFileFilter
+ * Simplified YAML interface for C/Fortran
+ *
+ * Private interface to the event-driven document composer used
+ * for filtered (pruned) loads and record iteration.  Not installed
+ * with the library.
+ *
+ */
+
+#ifndef __YAMLCONFIGFILEFILTER_H__
+#define __YAMLCONFIGFILEFILTER_H__
+
+#include "yamlConfigFile.h"
+
+/*!
+    @function __yamlConfigFileFilterLoad
+    Equivalent to yaml_parser_load(), but the parser's events are composed
+    into aDocument only where they fall on or under the include paths of
+    aFilter and not under any of its exclude paths; everything else is
+    discarded as the events stream by.
+
+    Mappings and sequences on the way to an included node are kept, with
+    only their selected children.  Unselected items of such a sequence are
+    replaced by null scalars so that item indices are unchanged.  Anchored
+    nodes are always composed in their entirety (but only attached to the
+    document where selected) so that any alias to them resolves.
+
+    @param parser
+        An initialized parser with its input attached
+    @param aFilter
+        The include and exclude key paths
+    @param keyPathOptions
+        Options from the yamlKeyPathApplyOptions enumeration that govern
+        how mapping keys are matched against the key paths
+    @param aDocument
+        The document to initialize and fill-in; on success the caller must
+        eventually yaml_document_delete() it
+
+    @return Boolean false if the document could not be parsed
+*/
+bool
+__yamlConfigFileFilterLoad(
+    yaml_parser_t               *parser,
+    const yamlConfigFileFilter  *aFilter,
+    yamlOptionsBitvec           keyPathOptions,
+    yaml_document_t             *aDocument
+);
+
+/*!
+    @function __yamlConfigFileFilterComposeNode
+    Compose the node that begins with firstEvent (a scalar, alias, or
+    sequence- or mapping-start event already taken from parser) as the root
+    of aDocument, consuming the parser's events through the end of that
+    node.  aDocument must already be initialized and empty; it is not
+    deleted on failure.  aFilter may be NULL to compose the whole node.
+
+    An alias to an anchor outside the node cannot be resolved and is
+    treated as an error.
+
+    @return Boolean false if the node could not be composed
+*/
+bool
+__yamlConfigFileFilterComposeNode(
+    yaml_parser_t               *parser,
+    yaml_event_t                *firstEvent,
+    const yamlConfigFileFilter  *aFilter,
+    yamlOptionsBitvec           keyPathOptions,
+    yaml_document_t             *aDocument
+);
+
+/*!
+    @typedef yamlConfigFileFilterLoader
+    Type of the resumable form of __yamlConfigFileFilterLoad():  a
+    document is composed a limited number of parser events at a time by
+    __yamlConfigFileFilterLoaderStep().
+*/
+typedef struct __yamlConfigFileFilterLoader yamlConfigFileFilterLoader;
+
+/*!
+    @enum yamlConfigFileFilterLoaderStatus
+    Progress of a yamlConfigFileFilterLoader.
+*/
+typedef enum {
+    yamlConfigFileFilterLoaderStatus_inProgress = 0,
+    yamlConfigFileFilterLoaderStatus_isComplete,
+    yamlConfigFileFilterLoaderStatus_hasFailed
+} yamlConfigFileFilterLoaderStatus;
+
+/*!
+    @function __yamlConfigFileFilterLoaderCreate
+    Allocate a loader that will compose the first document produced by a
+    parser into aDocument, as __yamlConfigFileFilterLoad() does.  aFilter
+    may be NULL to compose the whole document.
+
+    @return NULL on error, otherwise a loader to be disposed of with
+        __yamlConfigFileFilterLoaderDestroy()
+*/
+yamlConfigFileFilterLoader*
+__yamlConfigFileFilterLoaderCreate(
+    const yamlConfigFileFilter  *aFilter,
+    yamlOptionsBitvec           keyPathOptions,
+    yaml_document_t             *aDocument
+);
+
+/*!
+    @function __yamlConfigFileFilterLoaderDestroy
+    Dispose of aLoader.  A document that was started but not completed is
+    deleted; a completed document belongs to the caller.
+*/
+void
+__yamlConfigFileFilterLoaderDestroy(
+    yamlConfigFileFilterLoader  *aLoader
+);
+
+/*!
+    @function __yamlConfigFileFilterLoaderStep
+    Consume up to maxEvents events from parser (zero for no limit),
+    stopping early once the document is complete.  On failure the document
+    has already been deleted.
+
+    @return The loader's status after the step
+*/
+yamlConfigFileFilterLoaderStatus
+__yamlConfigFileFilterLoaderStep(
+    yamlConfigFileFilterLoader  *aLoader,
+    yaml_parser_t               *parser,
+    unsigned int                maxEvents
+);
+
+/*!
+    @function __yamlConfigFileFilterLoaderGetEventCount
+    Returns the number of parser events aLoader has consumed.
+*/
+unsigned long
+__yamlConfigFileFilterLoaderGetEventCount(
+    yamlConfigFileFilterLoader  *aLoader
+);
+
+#endif /* __YAMLCONFIGFILEFILTER_H__ */
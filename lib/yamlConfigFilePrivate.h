@@ -0,0 +1,37 @@
+/*
+ * yamlConfigFile
+ * Simplified YAML interface for C/Fortran
+ *
+ * Private interface shared by the parts of the library that act on a
+ * yamlConfigFile on a caller's behalf.  Not installed with the library.
+ *
+ */
+
+#ifndef __YAMLCONFIGFILEPRIVATE_H__
+#define __YAMLCONFIGFILEPRIVATE_H__
+
+#include "yamlConfigFile.h"
+
+/*!
+    @function __yamlConfigFileCreateKeyPathWithString
+    Compile the key path in pathString (pathStringLen bytes) using the key
+    path options implied by aConfigFile's options.  If aConfigFile has the
+    yamlConfigFileOptions_internKeyPaths option, the key path is obtained
+    from the key path intern table instead of being compiled anew.
+
+    The returned key path must be released with yamlKeyPathRelease() in
+    either case.
+
+    @return NULL on error (with outError and outErrorAtChar set as by
+        yamlKeyPathCreateWithString())
+*/
+yamlKeyPathRef
+__yamlConfigFileCreateKeyPathWithString(
+    yamlConfigFileRef           aConfigFile,
+    const char                  *pathString,
+    size_t                      pathStringLen,
+    yamlErrorCode               *outError,
+    const char*                 *outErrorAtChar
+);
+
+#endif /* __YAMLCONFIGFILEPRIVATE_H__ */
@@ -0,0 +1,1069 @@
+/*
+ * yamlConfigFileSnapshot
+ * Simplified YAML interface for C/Fortran
+ *
+ * Compiled binary snapshots of a YAML document that are loaded
+ * by mapping them into memory rather than by parsing.
+ *
+ */
+
+#include "yamlConfigFileSnapshot.h"
+#include "yamlKeyPathPrivate.h"
+
+#include <ctype.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#ifdef HAVE_MMAP
+# include <sys/mman.h>
+#endif
+
+//
+
+#ifdef YAMLCONFIGFILE_DEBUG
+#define DEBUG_PRINTF(F, ...) fprintf(stderr, "[DEBUG] " F "\n", __VA_ARGS__)
+#else
+#define DEBUG_PRINTF(F, ...)
+#endif
+
+//
+
+/*!
+    @defined YAMLCONFIGFILE_SNAPSHOT_MINIMUM_INDEXED_KEYCOUNT
+    Mapping nodes with at least this many key-value pairs get a perfect
+    hash of their keys in the snapshot; smaller mappings are scanned.
+*/
+#ifndef YAMLCONFIGFILE_SNAPSHOT_MINIMUM_INDEXED_KEYCOUNT
+#define YAMLCONFIGFILE_SNAPSHOT_MINIMUM_INDEXED_KEYCOUNT 8
+#endif
+
+/*!
+    @defined YAMLCONFIGFILE_SNAPSHOT_MAX_HASH_SEEDS
+    Number of hash seeds tried when building the perfect hash for a
+    mapping before giving up and leaving the mapping to be scanned.
+*/
+#ifndef YAMLCONFIGFILE_SNAPSHOT_MAX_HASH_SEEDS
+#define YAMLCONFIGFILE_SNAPSHOT_MAX_HASH_SEEDS 8
+#endif
+
+//
+#if 0
+#pragma mark -
+#endif
+//
+
+/*
+ * The file format.  All multi-byte values are in the byte order of the
+ * host that wrote the snapshot (the byte order mark lets a host with the
+ * other byte order refuse it), every section starts on an 8-byte boundary,
+ * and all references are offsets or indices rather than pointers.
+ *
+ * The header also records the identity (size, modification time and
+ * content hash) of the YAML file the snapshot was compiled from, when the
+ * writer supplied one; the parse cache uses it to decide whether an entry
+ * is still current.
+ *
+ * Items and pairs are stored exactly as libyaml lays out yaml_node_item_t
+ * and yaml_node_pair_t, so a node's items and pairs can point straight into
+ * the mapped file.
+ *
+ * Each indexed mapping has a block of 32-bit words in the index section:
+ *
+ *     seed, bucketCount (r), slotCount (m), displacement[r], slot[m]
+ *
+ * A key hashes (yamlHash64() with the seed) to h; with g = h >> 32 and
+ * f = (uint32_t)h, its bucket is g % r and its slot is
+ * (f + displacement[bucket] * (g | 1)) % m.  A slot holds 1 + the index of
+ * the pair (within the mapping) whose key hashed to it, or zero.  Every
+ * distinct key has its own slot (the first pair is indexed when a key is
+ * duplicated), so a lookup needs one comparison to confirm a match.
+ *
+ * Unless two keys of the mapping differ only in case, the index is built
+ * over the keys compared without regard to case (hashed with
+ * yamlHash64Caseless()) and the mapping's record has the caselessKeyIndex
+ * flag.  Such an index serves both kinds of lookup, since the key found
+ * for a caseless match is then the only candidate for an exact match, too;
+ * otherwise only exact lookups can use the index.
+ */
+
+#define YAMLCONFIGFILE_SNAPSHOT_MAGIC       "YCFSNAP"
+#define YAMLCONFIGFILE_SNAPSHOT_BYTE_ORDER  0x01020304
+#define YAMLCONFIGFILE_SNAPSHOT_VERSION     3
+#define YAMLCONFIGFILE_SNAPSHOT_NO_STRING   UINT32_MAX
+
+enum {
+    yamlConfigFileSnapshotSection_nodes = 0,
+    yamlConfigFileSnapshotSection_items,
+    yamlConfigFileSnapshotSection_pairs,
+    yamlConfigFileSnapshotSection_index,
+    yamlConfigFileSnapshotSection_strings,
+    yamlConfigFileSnapshotSection_max
+};
+
+enum {
+    yamlConfigFileSnapshotFlags_startImplicit = 1 << 0,
+    yamlConfigFileSnapshotFlags_endImplicit = 1 << 1
+};
+
+enum {
+    yamlConfigFileSnapshotNodeFlags_caselessKeyIndex = 1 << 0
+};
+
+typedef struct {
+    uint64_t        offset;
+    uint64_t        size;
+} yamlConfigFileSnapshotSection;
+
+typedef struct {
+    char            magic[8];
+    uint32_t        byteOrderMark;
+    uint32_t        version;
+    uint64_t        fileSize;
+    uint32_t        nodeCount;
+    uint32_t        flags;
+    yamlConfigFileSnapshotSource    source;
+    yamlConfigFileSnapshotSection   sections[yamlConfigFileSnapshotSection_max];
+} yamlConfigFileSnapshotHeader;
+
+/*
+ * For a scalar, start and count are the string pool offset and length of
+ * the value; for a sequence (mapping) they are the index of the first item
+ * (pair) and the number of items (pairs).  keyIndex is 1 + the word offset
+ * of a mapping's perfect hash, or zero; flags describe that hash.
+ */
+typedef struct {
+    uint8_t         type;
+    uint8_t         style;
+    uint16_t        flags;
+    uint32_t        tag;
+    uint32_t        start;
+    uint32_t        count;
+    uint32_t        keyIndex;
+} yamlConfigFileSnapshotNode;
+
+// Items and pairs are written as-is, which requires 32-bit node ids:
+typedef char __yamlConfigFileSnapshotNodeIdCheck[(sizeof(yaml_node_item_t) == 4 && sizeof(yaml_node_pair_t) == 8) ? 1 : -1];
+
+//
+
+typedef struct __yamlConfigFileSnapshot {
+    const unsigned char                 *bytes;
+    size_t                              length;
+    bool                                isMapped;
+    yaml_document_t                     *document;
+    const yamlConfigFileSnapshotNode    *nodes;
+    unsigned int                        nodeCount;
+    yaml_node_item_t                    *items;
+    size_t                              itemCount;
+    yaml_node_pair_t                    *pairs;
+    size_t                              pairCount;
+    const uint32_t                      *keyIndexWords;
+    size_t                              keyIndexWordCount;
+    const char                          *strings;
+    size_t                              stringsSize;
+} yamlConfigFileSnapshot;
+
+//
+
+static inline size_t
+__yamlConfigFileSnapshotAlign(
+    size_t          offset
+)
+{
+    return (offset + 7) & ~(size_t)7;
+}
+
+//
+
+static inline uint32_t
+__yamlConfigFileSnapshotSlot(
+    uint64_t        h,
+    uint32_t        displacement,
+    uint32_t        slotCount
+)
+{
+    uint64_t        g = h >> 32;
+
+    return (uint32_t)(((h & 0xFFFFFFFF) + (uint64_t)displacement * (g | 1)) % slotCount);
+}
+
+//
+#if 0
+#pragma mark -
+#endif
+//
+
+/*
+ * Growable byte buffer used to assemble each section before it is
+ * written.
+ */
+typedef struct {
+    unsigned char   *bytes;
+    size_t          length, capacity;
+} yamlConfigFileSnapshotBuffer;
+
+//
+
+bool
+__yamlConfigFileSnapshotBufferAppend(
+    yamlConfigFileSnapshotBuffer    *aBuffer,
+    const void                      *bytes,
+    size_t                          length
+)
+{
+    if ( length > aBuffer->capacity - aBuffer->length ) {
+        size_t                      newCapacity = aBuffer->capacity ? aBuffer->capacity : 4096;
+        unsigned char               *newBytes;
+
+        while ( newCapacity - aBuffer->length < length ) {
+            if ( newCapacity > SIZE_MAX / 2 ) return false;
+            newCapacity *= 2;
+        }
+        if ( ! (newBytes = realloc(aBuffer->bytes, newCapacity)) ) return false;
+        aBuffer->bytes = newBytes;
+        aBuffer->capacity = newCapacity;
+    }
+    if ( length ) memcpy(aBuffer->bytes + aBuffer->length, bytes, length);
+    aBuffer->length += length;
+    return true;
+}
+
+//
+
+/*
+ * The string pool stores each distinct string once; an open-addressed
+ * table of (hash, offset, length) finds strings already in the pool.
+ */
+typedef struct {
+    uint64_t        hash;
+    uint32_t        offset;
+    uint32_t        length;
+} yamlConfigFileSnapshotPoolEntry;
+
+typedef struct {
+    yamlConfigFileSnapshotBuffer    pool;
+    yamlConfigFileSnapshotPoolEntry *entries;
+    size_t                          entryCount, capacity;
+    uint64_t                        seed;
+} yamlConfigFileSnapshotStringPool;
+
+//
+
+yamlErrorCode
+__yamlConfigFileSnapshotStringPoolAdd(
+    yamlConfigFileSnapshotStringPool    *aPool,
+    const void                          *bytes,
+    size_t                              length,
+    uint32_t                            *outOffset
+)
+{
+    uint64_t                            h = yamlHash64(bytes, length, aPool->seed);
+    size_t                              i;
+
+    if ( 2 * (aPool->entryCount + 1) > aPool->capacity ) {
+        size_t                          newCapacity = aPool->capacity ? 2 * aPool->capacity : 1024;
+        yamlConfigFileSnapshotPoolEntry *newEntries = malloc(newCapacity * sizeof(yamlConfigFileSnapshotPoolEntry));
+
+        if ( ! newEntries ) return yamlConfigFileError_outOfMemory;
+        // Empty entries have an offset of YAMLCONFIGFILE_SNAPSHOT_NO_STRING:
+        memset(newEntries, 0xFF, newCapacity * sizeof(yamlConfigFileSnapshotPoolEntry));
+        for ( i = 0; i < aPool->capacity; i++ ) {
+            if ( aPool->entries[i].offset != YAMLCONFIGFILE_SNAPSHOT_NO_STRING ) {
+                size_t                  j = aPool->entries[i].hash & (newCapacity - 1);
+
+                while ( newEntries[j].offset != YAMLCONFIGFILE_SNAPSHOT_NO_STRING ) j = (j + 1) & (newCapacity - 1);
+                newEntries[j] = aPool->entries[i];
+            }
+        }
+        if ( aPool->entries ) free((void*)aPool->entries);
+        aPool->entries = newEntries;
+        aPool->capacity = newCapacity;
+    }
+    i = h & (aPool->capacity - 1);
+    while ( aPool->entries[i].offset != YAMLCONFIGFILE_SNAPSHOT_NO_STRING ) {
+        yamlConfigFileSnapshotPoolEntry *entry = &aPool->entries[i];
+
+        if ( (entry->hash == h) && (entry->length == length) && (memcmp(aPool->pool.bytes + entry->offset, bytes, length) == 0) ) {
+            *outOffset = entry->offset;
+            return 0;
+        }
+        i = (i + 1) & (aPool->capacity - 1);
+    }
+
+    // Offsets and lengths are 32-bit, and the terminating NUL must fit, too:
+    if ( (length >= UINT32_MAX) || (aPool->pool.length + length + 1 >= YAMLCONFIGFILE_SNAPSHOT_NO_STRING) ) return yamlConfigFileError_invalidSnapshot;
+    *outOffset = aPool->pool.length;
+    if ( ! __yamlConfigFileSnapshotBufferAppend(&aPool->pool, bytes, length) || ! __yamlConfigFileSnapshotBufferAppend(&aPool->pool, "", 1) ) return yamlConfigFileError_outOfMemory;
+    aPool->entries[i].hash = h;
+    aPool->entries[i].offset = *outOffset;
+    aPool->entries[i].length = length;
+    aPool->entryCount++;
+    return 0;
+}
+
+//
+
+typedef struct {
+    unsigned int    size;
+    uint32_t        bucket;
+} yamlConfigFileSnapshotBucket;
+
+static int
+__yamlConfigFileSnapshotBucketCmp(
+    const void      *b1,
+    const void      *b2
+)
+{
+    const yamlConfigFileSnapshotBucket  *B1 = (const yamlConfigFileSnapshotBucket*)b1;
+    const yamlConfigFileSnapshotBucket  *B2 = (const yamlConfigFileSnapshotBucket*)b2;
+
+    // Largest buckets first, ties broken by bucket number for a stable
+    // (reproducible) layout:
+    if ( B1->size != B2->size ) return ( B1->size > B2->size ) ? -1 : 1;
+    return ( B1->bucket < B2->bucket ) ? -1 : (( B1->bucket > B2->bucket ) ? 1 : 0);
+}
+
+//
+
+/*
+ * Attempt to build a perfect hash over the keyCount distinct keys of a
+ * mapping with the given seed, appending its block to keyIndexWords.
+ * Returns false (with nothing appended) if some bucket cannot be placed.
+ */
+bool
+__yamlConfigFileSnapshotBuildKeyIndexWithSeed(
+    yaml_char_t*                    *keys,
+    size_t                          *keyLengths,
+    uint32_t                        *pairIndices,
+    uint32_t                        keyCount,
+    uint32_t                        seed,
+    bool                            isCaseless,
+    yamlConfigFileSnapshotBuffer    *keyIndexWords,
+    uint32_t                        *outKeyIndex,
+    bool                            *outOfMemory
+)
+{
+    uint32_t                        bucketCount = (keyCount + 3) / 4, slotCount = keyCount + keyCount / 4 + 1;
+    uint32_t                        maxDisplacement = 16 * slotCount + 256;
+    size_t                          blockWordCount = 3 + (size_t)bucketCount + slotCount;
+    uint64_t                        *hashes = malloc(keyCount * sizeof(uint64_t));
+    uint32_t                        *bucketStarts = calloc(bucketCount + 1, sizeof(uint32_t));
+    uint32_t                        *bucketKeys = malloc(keyCount * sizeof(uint32_t));
+    yamlConfigFileSnapshotBucket    *buckets = malloc(bucketCount * sizeof(yamlConfigFileSnapshotBucket));
+    uint32_t                        *block = calloc(blockWordCount, sizeof(uint32_t));
+    uint32_t                        *displacements, *slots, *bucketSlots = malloc(keyCount * sizeof(uint32_t));
+    uint32_t                        i, j, k;
+    bool                            isBuilt = false;
+
+    if ( ! hashes || ! bucketStarts || ! bucketKeys || ! buckets || ! block || ! bucketSlots ) {
+        *outOfMemory = true;
+        goto cleanup;
+    }
+    block[0] = seed;
+    block[1] = bucketCount;
+    block[2] = slotCount;
+    displacements = block + 3;
+    slots = displacements + bucketCount;
+
+    // Group the keys by bucket:
+    for ( i = 0; i < keyCount; i++ ) {
+        hashes[i] = isCaseless ? yamlHash64Caseless(keys[i], keyLengths[i], seed) : yamlHash64(keys[i], keyLengths[i], seed);
+        bucketStarts[(hashes[i] >> 32) % bucketCount + 1]++;
+    }
+    for ( i = 0; i < bucketCount; i++ ) {
+        buckets[i].size = bucketStarts[i + 1];
+        buckets[i].bucket = i;
+        bucketStarts[i + 1] += bucketStarts[i];
+    }
+    for ( i = 0; i < keyCount; i++ ) {
+        uint32_t                    b = (hashes[i] >> 32) % bucketCount;
+
+        bucketKeys[bucketStarts[b] + (--buckets[b].size)] = i;
+    }
+    for ( i = 0; i < bucketCount; i++ ) buckets[i].size = bucketStarts[i + 1] - bucketStarts[i];
+    qsort(buckets, bucketCount, sizeof(yamlConfigFileSnapshotBucket), __yamlConfigFileSnapshotBucketCmp);
+
+    // Place the buckets, largest first, at the first displacement that puts
+    // all of their keys in distinct free slots:
+    for ( i = 0; (i < bucketCount) && buckets[i].size; i++ ) {
+        uint32_t                    b = buckets[i].bucket, d;
+        uint32_t                    *bKeys = bucketKeys + bucketStarts[b];
+
+        for ( d = 0; d < maxDisplacement; d++ ) {
+            for ( j = 0; j < buckets[i].size; j++ ) {
+                uint32_t            slot = __yamlConfigFileSnapshotSlot(hashes[bKeys[j]], d, slotCount);
+
+                if ( slots[slot] ) break;
+                for ( k = 0; k < j; k++ ) if ( bucketSlots[k] == slot ) break;
+                if ( k < j ) break;
+                bucketSlots[j] = slot;
+            }
+            if ( j == buckets[i].size ) break;
+        }
+        if ( d == maxDisplacement ) goto cleanup;
+        displacements[b] = d;
+        for ( j = 0; j < buckets[i].size; j++ ) slots[bucketSlots[j]] = pairIndices[bKeys[j]] + 1;
+    }
+    if ( (keyIndexWords->length / sizeof(uint32_t)) + 1 >= UINT32_MAX ) goto cleanup;
+    *outKeyIndex = keyIndexWords->length / sizeof(uint32_t) + 1;
+    if ( ! __yamlConfigFileSnapshotBufferAppend(keyIndexWords, block, blockWordCount * sizeof(uint32_t)) ) {
+        *outOfMemory = true;
+        goto cleanup;
+    }
+    isBuilt = true;
+
+cleanup:
+    if ( bucketSlots ) free((void*)bucketSlots);
+    if ( block ) free((void*)block);
+    if ( buckets ) free((void*)buckets);
+    if ( bucketKeys ) free((void*)bucketKeys);
+    if ( bucketStarts ) free((void*)bucketStarts);
+    if ( hashes ) free((void*)hashes);
+    return isBuilt;
+}
+
+//
+
+static bool
+__yamlConfigFileSnapshotKeysAreEqual(
+    const yaml_char_t               *k1,
+    size_t                          lenk1,
+    const yaml_char_t               *k2,
+    size_t                          lenk2,
+    bool                            isCaseless
+)
+{
+    if ( lenk1 != lenk2 ) return false;
+    if ( ! isCaseless ) return ( memcmp(k1, k2, lenk1) == 0 );
+    while ( lenk1-- ) if ( tolower(*k1++) != tolower(*k2++) ) return false;
+    return true;
+}
+
+//
+
+/*
+ * Build the perfect hash for a mapping node, if it is large enough and all
+ * of its keys are scalars without embedded NULs (any other key can only be
+ * matched the way a linear scan would match it).  *outKeyIndex is left zero
+ * if no index is built; *outFlags receives the node flags describing it.
+ */
+bool
+__yamlConfigFileSnapshotBuildKeyIndex(
+    yaml_document_t                 *aDocument,
+    yaml_node_t                     *aNode,
+    yamlConfigFileSnapshotBuffer    *keyIndexWords,
+    uint32_t                        *outKeyIndex,
+    uint16_t                        *outFlags
+)
+{
+    size_t                          pairCount = aNode->data.mapping.pairs.top - aNode->data.mapping.pairs.start;
+    size_t                          tableCapacity = 16, i;
+    yaml_char_t*                    *keys = NULL;
+    size_t                          *keyLengths = NULL;
+    uint32_t                        *pairIndices = NULL, *table = NULL, keyCount = 0, seed;
+    uint64_t                        hashSeed = yamlHashGetSeed();
+    bool                            outOfMemory = false, isCaseless = true;
+
+    *outKeyIndex = 0;
+    *outFlags = 0;
+    if ( (pairCount < YAMLCONFIGFILE_SNAPSHOT_MINIMUM_INDEXED_KEYCOUNT) || (pairCount >= UINT32_MAX / 2) ) return true;
+    while ( tableCapacity < 2 * pairCount ) tableCapacity *= 2;
+    keys = malloc(pairCount * sizeof(yaml_char_t*));
+    keyLengths = malloc(pairCount * sizeof(size_t));
+    pairIndices = malloc(pairCount * sizeof(uint32_t));
+    table = calloc(tableCapacity, sizeof(uint32_t));
+    if ( ! keys || ! keyLengths || ! pairIndices || ! table ) {
+        outOfMemory = true;
+        goto cleanup;
+    }
+
+    // Collect the distinct keys, each with the first pair that has it; keys
+    // are first compared without regard to case, and again with it if two
+    // of them differ only in case:
+    for ( i = 0; i < pairCount; i++ ) {
+        yaml_node_t                 *keyNode = yaml_document_get_node(aDocument, aNode->data.mapping.pairs.start[i].key);
+        size_t                      slot;
+
+        if ( ! keyNode || (keyNode->type != YAML_SCALAR_NODE) || memchr(keyNode->data.scalar.value, '\0', keyNode->data.scalar.length) ) goto cleanup;
+        if ( isCaseless ) {
+            slot = yamlHash64Caseless(keyNode->data.scalar.value, keyNode->data.scalar.length, hashSeed) & (tableCapacity - 1);
+        } else {
+            slot = yamlHash64(keyNode->data.scalar.value, keyNode->data.scalar.length, hashSeed) & (tableCapacity - 1);
+        }
+        while ( table[slot] ) {
+            uint32_t                k = table[slot] - 1;
+
+            if ( __yamlConfigFileSnapshotKeysAreEqual(keys[k], keyLengths[k], keyNode->data.scalar.value, keyNode->data.scalar.length, isCaseless) ) break;
+            slot = (slot + 1) & (tableCapacity - 1);
+        }
+        if ( ! table[slot] ) {
+            keys[keyCount] = keyNode->data.scalar.value;
+            keyLengths[keyCount] = keyNode->data.scalar.length;
+            pairIndices[keyCount] = i;
+            table[slot] = ++keyCount;
+        } else if ( isCaseless && ! __yamlConfigFileSnapshotKeysAreEqual(keys[table[slot] - 1], keyLengths[table[slot] - 1], keyNode->data.scalar.value, keyNode->data.scalar.length, false) ) {
+            isCaseless = false;
+            memset(table, 0, tableCapacity * sizeof(uint32_t));
+            keyCount = 0;
+            i = (size_t)-1;
+        }
+    }
+
+    // The seeds are fixed so that a document always produces the same
+    // snapshot:
+    for ( seed = 0; (seed < YAMLCONFIGFILE_SNAPSHOT_MAX_HASH_SEEDS) && ! outOfMemory; seed++ ) {
+        if ( __yamlConfigFileSnapshotBuildKeyIndexWithSeed(keys, keyLengths, pairIndices, keyCount, 0x9E3779B9 * (seed + 1), isCaseless, keyIndexWords, outKeyIndex, &outOfMemory) ) break;
+    }
+    if ( *outKeyIndex && isCaseless ) *outFlags = yamlConfigFileSnapshotNodeFlags_caselessKeyIndex;
+    DEBUG_PRINTF("mapping with %zu pairs (%u distinct keys) %s", pairCount, keyCount, *outKeyIndex ? (isCaseless ? "indexed without regard to case" : "indexed") : "not indexed");
+
+cleanup:
+    if ( table ) free((void*)table);
+    if ( pairIndices ) free((void*)pairIndices);
+    if ( keyLengths ) free((void*)keyLengths);
+    if ( keys ) free((void*)keys);
+    return ! outOfMemory;
+}
+
+//
+
+bool
+__yamlConfigFileSnapshotWrite(
+    yaml_document_t         *aDocument,
+    const yamlConfigFileSnapshotSource *source,
+    FILE                    *fptr,
+    yamlErrorCode           *outError
+)
+{
+    size_t                              nodeCount = aDocument->nodes.top - aDocument->nodes.start;
+    yamlConfigFileSnapshotNode          *nodes = NULL;
+    yamlConfigFileSnapshotBuffer        items = { NULL, 0, 0 }, pairs = { NULL, 0, 0 }, keyIndexWords = { NULL, 0, 0 };
+    yamlConfigFileSnapshotStringPool    strings = { { NULL, 0, 0 }, NULL, 0, 0, yamlHashGetSeed() };
+    yamlConfigFileSnapshotHeader        header;
+    const void                          *sectionBytes[yamlConfigFileSnapshotSection_max];
+    static const unsigned char          padding[8] = { 0 };
+    yamlErrorCode                       theError = yamlConfigFileError_outOfMemory;
+    size_t                              i, offset;
+
+    if ( nodeCount >= INT_MAX ) {
+        theError = yamlConfigFileError_invalidSnapshot;
+        goto cleanup;
+    }
+    if ( nodeCount && ! (nodes = calloc(nodeCount, sizeof(yamlConfigFileSnapshotNode))) ) goto cleanup;
+
+    for ( i = 0; i < nodeCount; i++ ) {
+        yaml_node_t                     *node = &aDocument->nodes.start[i];
+        yamlConfigFileSnapshotNode      *record = &nodes[i];
+        size_t                          count;
+
+        record->type = node->type;
+        record->tag = YAMLCONFIGFILE_SNAPSHOT_NO_STRING;
+        if ( node->tag && (theError = __yamlConfigFileSnapshotStringPoolAdd(&strings, node->tag, strlen((const char*)node->tag), &record->tag)) ) goto cleanup;
+        switch ( node->type ) {
+            case YAML_SCALAR_NODE:
+                record->style = node->data.scalar.style;
+                record->count = node->data.scalar.length;
+                if ( (theError = __yamlConfigFileSnapshotStringPoolAdd(&strings, node->data.scalar.value, node->data.scalar.length, &record->start)) ) goto cleanup;
+                break;
+
+            case YAML_SEQUENCE_NODE:
+                count = node->data.sequence.items.top - node->data.sequence.items.start;
+                if ( items.length / sizeof(yaml_node_item_t) + count >= UINT32_MAX ) goto tooLarge;
+                record->style = node->data.sequence.style;
+                record->start = items.length / sizeof(yaml_node_item_t);
+                record->count = count;
+                if ( ! __yamlConfigFileSnapshotBufferAppend(&items, node->data.sequence.items.start, count * sizeof(yaml_node_item_t)) ) goto cleanup;
+                break;
+
+            case YAML_MAPPING_NODE:
+                count = node->data.mapping.pairs.top - node->data.mapping.pairs.start;
+                if ( pairs.length / sizeof(yaml_node_pair_t) + count >= UINT32_MAX ) goto tooLarge;
+                record->style = node->data.mapping.style;
+                record->start = pairs.length / sizeof(yaml_node_pair_t);
+                record->count = count;
+                if ( ! __yamlConfigFileSnapshotBufferAppend(&pairs, node->data.mapping.pairs.start, count * sizeof(yaml_node_pair_t)) ) goto cleanup;
+                if ( ! __yamlConfigFileSnapshotBuildKeyIndex(aDocument, node, &keyIndexWords, &record->keyIndex, &record->flags) ) goto cleanup;
+                break;
+
+            default:
+                theError = yamlConfigFileError_internalError;
+                goto cleanup;
+        }
+    }
+
+    // Lay out the sections:
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, YAMLCONFIGFILE_SNAPSHOT_MAGIC, sizeof(YAMLCONFIGFILE_SNAPSHOT_MAGIC));
+    header.byteOrderMark = YAMLCONFIGFILE_SNAPSHOT_BYTE_ORDER;
+    header.version = YAMLCONFIGFILE_SNAPSHOT_VERSION;
+    header.nodeCount = nodeCount;
+    if ( source ) header.source = *source;
+    if ( aDocument->start_implicit ) header.flags |= yamlConfigFileSnapshotFlags_startImplicit;
+    if ( aDocument->end_implicit ) header.flags |= yamlConfigFileSnapshotFlags_endImplicit;
+    header.sections[yamlConfigFileSnapshotSection_nodes].size = nodeCount * sizeof(yamlConfigFileSnapshotNode);
+    sectionBytes[yamlConfigFileSnapshotSection_nodes] = nodes;
+    header.sections[yamlConfigFileSnapshotSection_items].size = items.length;
+    sectionBytes[yamlConfigFileSnapshotSection_items] = items.bytes;
+    header.sections[yamlConfigFileSnapshotSection_pairs].size = pairs.length;
+    sectionBytes[yamlConfigFileSnapshotSection_pairs] = pairs.bytes;
+    header.sections[yamlConfigFileSnapshotSection_index].size = keyIndexWords.length;
+    sectionBytes[yamlConfigFileSnapshotSection_index] = keyIndexWords.bytes;
+    header.sections[yamlConfigFileSnapshotSection_strings].size = strings.pool.length;
+    sectionBytes[yamlConfigFileSnapshotSection_strings] = strings.pool.bytes;
+    offset = __yamlConfigFileSnapshotAlign(sizeof(header));
+    for ( i = 0; i < yamlConfigFileSnapshotSection_max; i++ ) {
+        header.sections[i].offset = offset;
+        offset = __yamlConfigFileSnapshotAlign(offset + header.sections[i].size);
+    }
+    header.fileSize = offset;
+
+    // Write it all out:
+    theError = yamlConfigFileError_fileNotWritable;
+    if ( fwrite(&header, sizeof(header), 1, fptr) != 1 ) goto cleanup;
+    offset = sizeof(header);
+    for ( i = 0; i < yamlConfigFileSnapshotSection_max; i++ ) {
+        if ( (header.sections[i].offset > offset) && (fwrite(padding, header.sections[i].offset - offset, 1, fptr) != 1) ) goto cleanup;
+        if ( header.sections[i].size && (fwrite(sectionBytes[i], header.sections[i].size, 1, fptr) != 1) ) goto cleanup;
+        offset = header.sections[i].offset + header.sections[i].size;
+    }
+    if ( (header.fileSize > offset) && (fwrite(padding, header.fileSize - offset, 1, fptr) != 1) ) goto cleanup;
+    DEBUG_PRINTF("snapshot written:  %zu nodes, %zu bytes of strings, %zu index words", nodeCount, strings.pool.length, keyIndexWords.length / sizeof(uint32_t));
+    theError = 0;
+    goto cleanup;
+
+tooLarge:
+    theError = yamlConfigFileError_invalidSnapshot;
+
+cleanup:
+    if ( strings.entries ) free((void*)strings.entries);
+    if ( strings.pool.bytes ) free((void*)strings.pool.bytes);
+    if ( keyIndexWords.bytes ) free((void*)keyIndexWords.bytes);
+    if ( pairs.bytes ) free((void*)pairs.bytes);
+    if ( items.bytes ) free((void*)items.bytes);
+    if ( nodes ) free((void*)nodes);
+    if ( outError ) *outError = theError;
+    return ( theError == 0 );
+}
+
+//
+#if 0
+#pragma mark -
+#endif
+//
+
+bool
+__yamlConfigFileSnapshotReadFile(
+    yamlConfigFileSnapshot  *aSnapshot,
+    int                     fd
+)
+{
+    struct stat             finfo;
+    unsigned char           *buffer;
+    size_t                  length = 0;
+
+    if ( (fstat(fd, &finfo) != 0) || ! S_ISREG(finfo.st_mode) ) return false;
+    if ( ((uint64_t)finfo.st_size < sizeof(yamlConfigFileSnapshotHeader)) || ((uint64_t)finfo.st_size > SIZE_MAX) ) return false;
+    aSnapshot->length = (size_t)finfo.st_size;
+
+#ifdef HAVE_MMAP
+    {
+        void                *mapping = mmap(NULL, aSnapshot->length, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if ( mapping != MAP_FAILED ) {
+            // Pages are faulted-in as nodes are reached, so no read-ahead
+            // advice is given:
+            aSnapshot->bytes = (const unsigned char*)mapping;
+            aSnapshot->isMapped = true;
+            return true;
+        }
+        DEBUG_PRINTF("unable to mmap() snapshot file descriptor %d, falling back to read()", fd);
+    }
+#endif
+    // malloc() returns memory aligned for any type, so the sections are
+    // aligned as in the file:
+    if ( ! (buffer = malloc(aSnapshot->length)) ) return false;
+    while ( length < aSnapshot->length ) {
+        ssize_t             nbytes = read(fd, buffer + length, aSnapshot->length - length);
+
+        if ( nbytes < 0 ) {
+            if ( errno == EINTR ) continue;
+            break;
+        }
+        if ( nbytes == 0 ) break;
+        length += nbytes;
+    }
+    if ( length != aSnapshot->length ) {
+        free((void*)buffer);
+        return false;
+    }
+    aSnapshot->bytes = buffer;
+    return true;
+}
+
+//
+
+yamlConfigFileSnapshot*
+__yamlConfigFileSnapshotCreateWithFileDescriptor(
+    int                     fd,
+    const yamlConfigFileSnapshotSource *source,
+    yaml_document_t         *aDocument,
+    yamlErrorCode           *outError
+)
+{
+    yamlConfigFileSnapshot          *newSnapshot = calloc(1, sizeof(yamlConfigFileSnapshot));
+    const yamlConfigFileSnapshotHeader  *header;
+    yamlErrorCode                   theError = yamlConfigFileError_invalidSnapshot;
+    size_t                          i;
+
+    if ( ! newSnapshot ) {
+        if ( outError ) *outError = yamlConfigFileError_outOfMemory;
+        return NULL;
+    }
+    if ( ! __yamlConfigFileSnapshotReadFile(newSnapshot, fd) ) {
+        // Too short to be a snapshot or unreadable:
+        struct stat                 finfo;
+
+        if ( (fstat(fd, &finfo) != 0) || ! S_ISREG(finfo.st_mode) || ((uint64_t)finfo.st_size >= sizeof(yamlConfigFileSnapshotHeader)) ) theError = yamlConfigFileError_fileNotReadable;
+        if ( outError ) *outError = theError;
+        free((void*)newSnapshot);
+        return NULL;
+    }
+
+    // Only the header is checked now; node records are checked as each is
+    // reached:
+    header = (const yamlConfigFileSnapshotHeader*)newSnapshot->bytes;
+    if ( memcmp(header->magic, YAMLCONFIGFILE_SNAPSHOT_MAGIC, sizeof(YAMLCONFIGFILE_SNAPSHOT_MAGIC)) != 0 ) goto invalid;
+    if ( header->byteOrderMark != YAMLCONFIGFILE_SNAPSHOT_BYTE_ORDER ) goto invalid;
+    if ( header->version != YAMLCONFIGFILE_SNAPSHOT_VERSION ) goto invalid;
+    if ( header->fileSize != newSnapshot->length ) goto invalid;
+    if ( header->nodeCount >= INT_MAX ) goto invalid;
+    if ( source && memcmp(&header->source, source, sizeof(yamlConfigFileSnapshotSource)) ) {
+        DEBUG_PRINTF("snapshot on descriptor %d was compiled from a different source", fd);
+        goto invalid;
+    }
+    for ( i = 0; i < yamlConfigFileSnapshotSection_max; i++ ) {
+        const yamlConfigFileSnapshotSection *section = &header->sections[i];
+
+        if ( (section->offset % 8) || (section->offset < sizeof(yamlConfigFileSnapshotHeader)) || (section->offset > newSnapshot->length) || (section->size > newSnapshot->length - section->offset) ) goto invalid;
+    }
+    if ( header->sections[yamlConfigFileSnapshotSection_nodes].size != (uint64_t)header->nodeCount * sizeof(yamlConfigFileSnapshotNode) ) goto invalid;
+    if ( header->sections[yamlConfigFileSnapshotSection_items].size % sizeof(yaml_node_item_t) ) goto invalid;
+    if ( header->sections[yamlConfigFileSnapshotSection_pairs].size % sizeof(yaml_node_pair_t) ) goto invalid;
+    if ( header->sections[yamlConfigFileSnapshotSection_index].size % sizeof(uint32_t) ) goto invalid;
+
+    // Every string in the pool ends with a NUL, so the pool must, too:
+    if ( header->sections[yamlConfigFileSnapshotSection_strings].size && newSnapshot->bytes[header->sections[yamlConfigFileSnapshotSection_strings].offset + header->sections[yamlConfigFileSnapshotSection_strings].size - 1] ) goto invalid;
+
+    newSnapshot->nodes = (const yamlConfigFileSnapshotNode*)(newSnapshot->bytes + header->sections[yamlConfigFileSnapshotSection_nodes].offset);
+    newSnapshot->nodeCount = header->nodeCount;
+    newSnapshot->items = (yaml_node_item_t*)(newSnapshot->bytes + header->sections[yamlConfigFileSnapshotSection_items].offset);
+    newSnapshot->itemCount = header->sections[yamlConfigFileSnapshotSection_items].size / sizeof(yaml_node_item_t);
+    newSnapshot->pairs = (yaml_node_pair_t*)(newSnapshot->bytes + header->sections[yamlConfigFileSnapshotSection_pairs].offset);
+    newSnapshot->pairCount = header->sections[yamlConfigFileSnapshotSection_pairs].size / sizeof(yaml_node_pair_t);
+    newSnapshot->keyIndexWords = (const uint32_t*)(newSnapshot->bytes + header->sections[yamlConfigFileSnapshotSection_index].offset);
+    newSnapshot->keyIndexWordCount = header->sections[yamlConfigFileSnapshotSection_index].size / sizeof(uint32_t);
+    newSnapshot->strings = (const char*)(newSnapshot->bytes + header->sections[yamlConfigFileSnapshotSection_strings].offset);
+    newSnapshot->stringsSize = header->sections[yamlConfigFileSnapshotSection_strings].size;
+
+    // The node array is zeroed (YAML_NO_NODE) until each node is reached;
+    // calloc() of a large array costs nothing until its pages are touched:
+    memset(aDocument, 0, sizeof(yaml_document_t));
+    if ( ! (aDocument->nodes.start = calloc(newSnapshot->nodeCount ? newSnapshot->nodeCount : 1, sizeof(yaml_node_t))) ) {
+        theError = yamlConfigFileError_outOfMemory;
+        goto invalid;
+    }
+    aDocument->nodes.top = aDocument->nodes.end = aDocument->nodes.start + newSnapshot->nodeCount;
+    aDocument->start_implicit = ( header->flags & yamlConfigFileSnapshotFlags_startImplicit ) ? 1 : 0;
+    aDocument->end_implicit = ( header->flags & yamlConfigFileSnapshotFlags_endImplicit ) ? 1 : 0;
+    newSnapshot->document = aDocument;
+    DEBUG_PRINTF("snapshot on descriptor %d loaded:  %u nodes", fd, newSnapshot->nodeCount);
+    return newSnapshot;
+
+invalid:
+    if ( outError ) *outError = theError;
+#ifdef HAVE_MMAP
+    if ( newSnapshot->isMapped ) munmap((void*)newSnapshot->bytes, newSnapshot->length);
+    else
+#endif
+    free((void*)newSnapshot->bytes);
+    free((void*)newSnapshot);
+    return NULL;
+}
+
+//
+
+yamlConfigFileSnapshot*
+__yamlConfigFileSnapshotCreateWithFileAtPath(
+    const char              *snapshotPath,
+    const yamlConfigFileSnapshotSource *source,
+    yaml_document_t         *aDocument,
+    yamlErrorCode           *outError
+)
+{
+    yamlConfigFileSnapshot  *newSnapshot;
+    int                     fd;
+
+    if ( (fd = open(snapshotPath, O_RDONLY)) < 0 ) {
+        if ( outError ) *outError = yamlConfigFileError_fileNotReadable;
+        return NULL;
+    }
+    newSnapshot = __yamlConfigFileSnapshotCreateWithFileDescriptor(fd, source, aDocument, outError);
+    close(fd);
+    return newSnapshot;
+}
+
+//
+
+void
+__yamlConfigFileSnapshotDestroy(
+    yamlConfigFileSnapshot  *aSnapshot
+)
+{
+    if ( aSnapshot->document ) free((void*)aSnapshot->document->nodes.start);
+#ifdef HAVE_MMAP
+    if ( aSnapshot->isMapped ) munmap((void*)aSnapshot->bytes, aSnapshot->length);
+    else
+#endif
+    free((void*)aSnapshot->bytes);
+    free((void*)aSnapshot);
+}
+
+//
+
+const void*
+__yamlConfigFileSnapshotGetBytes(
+    yamlConfigFileSnapshot  *aSnapshot,
+    size_t                  *length
+)
+{
+    *length = aSnapshot->length;
+    return aSnapshot->bytes;
+}
+
+//
+#if 0
+#pragma mark -
+#endif
+//
+
+static inline const yamlConfigFileSnapshotNode*
+__yamlConfigFileSnapshotGetRecord(
+    yamlConfigFileSnapshot  *aSnapshot,
+    int                     nodeId
+)
+{
+    return ( (nodeId >= 1) && ((unsigned int)nodeId <= aSnapshot->nodeCount) ) ? &aSnapshot->nodes[nodeId - 1] : NULL;
+}
+
+//
+
+static inline const char*
+__yamlConfigFileSnapshotGetScalarValue(
+    yamlConfigFileSnapshot              *aSnapshot,
+    const yamlConfigFileSnapshotNode    *record
+)
+{
+    if ( ((uint64_t)record->start + record->count >= aSnapshot->stringsSize) || aSnapshot->strings[record->start + record->count] ) return NULL;
+    return aSnapshot->strings + record->start;
+}
+
+//
+
+yaml_node_t*
+__yamlConfigFileSnapshotGetNode(
+    yamlConfigFileSnapshot  *aSnapshot,
+    int                     nodeId
+)
+{
+    const yamlConfigFileSnapshotNode    *record = __yamlConfigFileSnapshotGetRecord(aSnapshot, nodeId);
+    yaml_node_t                         *node, newNode;
+
+    if ( ! record ) return NULL;
+    node = &aSnapshot->document->nodes.start[nodeId - 1];
+    if ( node->type != YAML_NO_NODE ) return node;
+
+    memset(&newNode, 0, sizeof(newNode));
+    if ( record->tag != YAMLCONFIGFILE_SNAPSHOT_NO_STRING ) {
+        if ( record->tag >= aSnapshot->stringsSize ) return NULL;
+        newNode.tag = (yaml_char_t*)(aSnapshot->strings + record->tag);
+    }
+    switch ( record->type ) {
+        case YAML_SCALAR_NODE:
+            if ( ! (newNode.data.scalar.value = (yaml_char_t*)__yamlConfigFileSnapshotGetScalarValue(aSnapshot, record)) ) return NULL;
+            newNode.data.scalar.length = record->count;
+            newNode.data.scalar.style = record->style;
+            break;
+        case YAML_SEQUENCE_NODE:
+            if ( (uint64_t)record->start + record->count > aSnapshot->itemCount ) return NULL;
+            newNode.data.sequence.items.start = aSnapshot->items + record->start;
+            newNode.data.sequence.items.top = newNode.data.sequence.items.end = newNode.data.sequence.items.start + record->count;
+            newNode.data.sequence.style = record->style;
+            break;
+        case YAML_MAPPING_NODE:
+            if ( (uint64_t)record->start + record->count > aSnapshot->pairCount ) return NULL;
+            newNode.data.mapping.pairs.start = aSnapshot->pairs + record->start;
+            newNode.data.mapping.pairs.top = newNode.data.mapping.pairs.end = newNode.data.mapping.pairs.start + record->count;
+            newNode.data.mapping.style = record->style;
+            break;
+        default:
+            return NULL;
+    }
+    newNode.type = record->type;
+    *node = newNode;
+    return node;
+}
+
+//
+
+bool
+__yamlConfigFileSnapshotGetItems(
+    yamlConfigFileSnapshot  *aSnapshot,
+    yaml_node_t             *aNode,
+    unsigned int            startIndex,
+    unsigned int            endIndex
+)
+{
+    while ( startIndex <= endIndex ) {
+        if ( ! __yamlConfigFileSnapshotGetNode(aSnapshot, aNode->data.sequence.items.start[startIndex]) ) return false;
+        startIndex++;
+    }
+    return true;
+}
+
+//
+
+/*
+ * Find the pair of the mapping record whose key matches key, using the
+ * mapping's perfect hash if it has one.  Returns the index of the pair
+ * within the mapping, -1 if there is no such key, or -2 if a non-scalar
+ * key or malformed record was encountered.
+ */
+long
+__yamlConfigFileSnapshotFindPair(
+    yamlConfigFileSnapshot              *aSnapshot,
+    const yamlConfigFileSnapshotNode    *record,
+    const char                          *key,
+    bool                                isCaseless
+)
+{
+    const yaml_node_pair_t              *pairs;
+    uint32_t                            i;
+
+    if ( (uint64_t)record->start + record->count > aSnapshot->pairCount ) return -2;
+    pairs = aSnapshot->pairs + record->start;
+
+    // A case-sensitive perfect hash cannot find keys that differ in case:
+    if ( record->keyIndex && (! isCaseless || (record->flags & yamlConfigFileSnapshotNodeFlags_caselessKeyIndex)) ) {
+        size_t                          w = record->keyIndex - 1;
+
+        if ( w + 3 <= aSnapshot->keyIndexWordCount ) {
+            const uint32_t              *block = aSnapshot->keyIndexWords + w;
+            uint32_t                    bucketCount = block[1], slotCount = block[2];
+
+            if ( bucketCount && slotCount && ((uint64_t)w + 3 + bucketCount + slotCount <= aSnapshot->keyIndexWordCount) ) {
+                size_t                  keyLength = strlen(key);
+                uint64_t                h = ( record->flags & yamlConfigFileSnapshotNodeFlags_caselessKeyIndex ) ? yamlHash64Caseless(key, keyLength, block[0]) : yamlHash64(key, keyLength, block[0]);
+                uint32_t                displacement = block[3 + (h >> 32) % bucketCount];
+                uint32_t                slot = block[3 + bucketCount + __yamlConfigFileSnapshotSlot(h, displacement, slotCount)];
+                const yamlConfigFileSnapshotNode    *keyRecord;
+                const char              *keyValue;
+
+                if ( ! slot ) return -1;
+                if ( slot > record->count ) return -2;
+                if ( ! (keyRecord = __yamlConfigFileSnapshotGetRecord(aSnapshot, pairs[slot - 1].key)) || (keyRecord->type != YAML_SCALAR_NODE) ) return -2;
+                if ( ! (keyValue = __yamlConfigFileSnapshotGetScalarValue(aSnapshot, keyRecord)) ) return -2;
+                if ( isCaseless ) return ( __yamlKeyPathKeyCmp((yaml_char_t*)keyValue, keyRecord->count, key, true) == 0 ) ? (long)(slot - 1) : -1;
+                return ( (keyRecord->count == keyLength) && (memcmp(keyValue, key, keyLength) == 0) ) ? (long)(slot - 1) : -1;
+            }
+        }
+        return -2;
+    }
+    for ( i = 0; i < record->count; i++ ) {
+        const yamlConfigFileSnapshotNode    *keyRecord = __yamlConfigFileSnapshotGetRecord(aSnapshot, pairs[i].key);
+        const char                          *keyValue;
+
+        if ( ! keyRecord || (keyRecord->type != YAML_SCALAR_NODE) ) return -2;
+        if ( ! (keyValue = __yamlConfigFileSnapshotGetScalarValue(aSnapshot, keyRecord)) ) return -2;
+        if ( __yamlKeyPathKeyCmp((yaml_char_t*)keyValue, keyRecord->count, key, isCaseless) == 0 ) return i;
+    }
+    return -1;
+}
+
+//
+
+yaml_node_t*
+__yamlConfigFileSnapshotApplyKeyPath(
+    yamlConfigFileSnapshot      *aSnapshot,
+    yamlKeyPathRef              aKeyPath,
+    yamlOptionsBitvec           options,
+    yaml_node_t                 *relativeToNode,
+    yamlErrorCode               *failedError,
+    yamlKeyPathNodeMatchType*   *failedAtElement
+)
+{
+    yamlKeyPathNodeMatchType    *m = yamlKeyPathGetFirstNodeMatch(aKeyPath), *lastM = NULL;
+    bool                        isCaseless = (options & yamlKeyPathApplyOptions_keysAreCaseless) ? true : false;
+    yamlErrorCode               theError = 0;
+    yaml_node_t                 *outNode = NULL;
+    int                         nodeId;
+
+    if ( failedError ) *failedError = 0;
+    if ( failedAtElement ) *failedAtElement = NULL;
+
+    if ( relativeToNode ) {
+        nodeId = relativeToNode - aSnapshot->document->nodes.start + 1;
+    } else if ( aSnapshot->nodeCount ) {
+        nodeId = 1;
+    } else {
+        return NULL;
+    }
+
+    // Walk the node records, exactly as yamlKeyPathApplyToDocument() walks
+    // the nodes:
+    while ( m ) {
+        const yamlConfigFileSnapshotNode    *record = __yamlConfigFileSnapshotGetRecord(aSnapshot, nodeId);
+
+        lastM = m;
+        if ( ! record ) {
+            theError = yamlKeyPathError_internalError;
+            break;
+        }
+        if ( record->type != m->type ) {
+            theError = yamlKeyPathError_invalidType;
+            break;
+        }
+        if ( record->type == YAML_MAPPING_NODE ) {
+            long                    pairIndex = __yamlConfigFileSnapshotFindPair(aSnapshot, record, m->parameter.key, isCaseless);
+
+            if ( pairIndex < 0 ) {
+                theError = ( pairIndex == -1 ) ? yamlKeyPathError_invalidKey : yamlKeyPathError_internalError;
+                break;
+            }
+            nodeId = aSnapshot->pairs[record->start + pairIndex].value;
+        }
+        else if ( record->type == YAML_SEQUENCE_NODE ) {
+            if ( (m->parameter.index < 0) || ((uint32_t)m->parameter.index >= record->count) ) {
+                theError = yamlKeyPathError_invalidIndex;
+                break;
+            }
+            if ( (uint64_t)record->start + record->count > aSnapshot->itemCount ) {
+                theError = yamlKeyPathError_internalError;
+                break;
+            }
+            nodeId = aSnapshot->items[record->start + m->parameter.index];
+        }
+        else if ( record->type != YAML_SCALAR_NODE ) {
+            theError = yamlKeyPathError_invalidType;
+            break;
+        }
+        m = yamlKeyPathGetNextNodeMatch(m);
+    }
+
+    // Only the node at the end of the path is filled-in:
+    if ( ! theError && ! (outNode = __yamlConfigFileSnapshotGetNode(aSnapshot, nodeId)) ) theError = yamlKeyPathError_internalError;
+    if ( theError ) {
+        if ( failedError ) *failedError = theError;
+        if ( failedAtElement ) *failedAtElement = lastM;
+    }
+    return outNode;
+}
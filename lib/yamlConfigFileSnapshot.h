@@ -0,0 +1,176 @@
+/*
+ * yamlConfigFileSnapshot
+ * Simplified YAML interface for C/Fortran
+ *
+ * Private interface to the compiled binary snapshot format.  Not
+ * installed with the library.
+ *
+ */
+
+#ifndef __YAMLCONFIGFILESNAPSHOT_H__
+#define __YAMLCONFIGFILESNAPSHOT_H__
+
+#include "yamlConfigFile.h"
+
+/*!
+    @typedef yamlConfigFileSnapshot
+    Type of a loaded (memory-mapped) snapshot.
+
+    A snapshot file holds a header followed by five sections, all at
+    offsets relative to the start of the file so that it can be mapped at
+    any address:
+
+        - a fixed-size record for each node of the document, numbered as in
+          the yaml_document_t it was written from
+        - the node ids of every sequence's items
+        - the key and value node ids of every mapping's pairs
+        - a minimal perfect hash (CHD) over the scalar keys of each larger
+          mapping
+        - a pool of NUL-terminated strings (tags and scalar values)
+
+    Loading a snapshot only maps the file and checks its header.  The
+    yaml_document_t presented to the rest of the library has a node array
+    that is allocated but left zeroed; each node is filled-in the first time
+    it is reached, with its tag, value, items and pairs pointing directly
+    into the mapped file.  Key paths are resolved over the node records
+    themselves (using the perfect hashes), so only the nodes actually
+    returned are ever filled-in.
+*/
+typedef struct __yamlConfigFileSnapshot yamlConfigFileSnapshot;
+
+/*!
+    @typedef yamlConfigFileSnapshotSource
+    Identity of the YAML file a snapshot was compiled from, as recorded in
+    the snapshot's header.  A snapshot written without one has an all-zero
+    identity.  The reserved field must be zero.
+*/
+typedef struct {
+    uint64_t        size;
+    int64_t         modificationSeconds;
+    uint32_t        modificationNanoseconds;
+    uint32_t        reserved;
+    uint64_t        contentHash;
+} yamlConfigFileSnapshotSource;
+
+/*!
+    @function __yamlConfigFileSnapshotWrite
+    Write aDocument to fptr in the snapshot format.  If source is not NULL
+    it is recorded in the header as the identity of the YAML file the
+    document was parsed from.
+
+    @return Boolean false on error, with *outError set
+*/
+bool
+__yamlConfigFileSnapshotWrite(
+    yaml_document_t         *aDocument,
+    const yamlConfigFileSnapshotSource *source,
+    FILE                    *fptr,
+    yamlErrorCode           *outError
+);
+
+/*!
+    @function __yamlConfigFileSnapshotCreateWithFileDescriptor
+    Map the snapshot file open on fd and initialize aDocument as the
+    (lazily filled-in) view of its nodes, exactly as
+    __yamlConfigFileSnapshotCreateWithFileAtPath() does.  The caller keeps
+    ownership of fd and may close it as soon as this function returns.
+
+    @return NULL on error (with *outError set), otherwise the snapshot
+*/
+yamlConfigFileSnapshot*
+__yamlConfigFileSnapshotCreateWithFileDescriptor(
+    int                     fd,
+    const yamlConfigFileSnapshotSource *source,
+    yaml_document_t         *aDocument,
+    yamlErrorCode           *outError
+);
+
+/*!
+    @function __yamlConfigFileSnapshotCreateWithFileAtPath
+    Map the snapshot file at snapshotPath and initialize aDocument as the
+    (lazily filled-in) view of its nodes.  aDocument must not be passed to
+    yaml_document_delete(); it is torn down by
+    __yamlConfigFileSnapshotDestroy().
+
+    If source is not NULL, a snapshot whose recorded source identity differs
+    from it is refused with yamlConfigFileError_invalidSnapshot.
+
+    @return NULL on error (with *outError set), otherwise the snapshot
+*/
+yamlConfigFileSnapshot*
+__yamlConfigFileSnapshotCreateWithFileAtPath(
+    const char              *snapshotPath,
+    const yamlConfigFileSnapshotSource *source,
+    yaml_document_t         *aDocument,
+    yamlErrorCode           *outError
+);
+
+/*!
+    @function __yamlConfigFileSnapshotDestroy
+    Unmap aSnapshot and dispose of the node array of its document.
+*/
+void
+__yamlConfigFileSnapshotDestroy(
+    yamlConfigFileSnapshot  *aSnapshot
+);
+
+/*!
+    @function __yamlConfigFileSnapshotGetBytes
+    Returns the raw content of the snapshot file; *length is set to its
+    size in bytes.
+*/
+const void*
+__yamlConfigFileSnapshotGetBytes(
+    yamlConfigFileSnapshot  *aSnapshot,
+    size_t                  *length
+);
+
+/*!
+    @function __yamlConfigFileSnapshotGetNode
+    Returns the node with the given (1-based) id, filling it in if this is
+    the first time it has been reached.
+
+    @return NULL if nodeId is out of range or its record is malformed
+*/
+yaml_node_t*
+__yamlConfigFileSnapshotGetNode(
+    yamlConfigFileSnapshot  *aSnapshot,
+    int                     nodeId
+);
+
+/*!
+    @function __yamlConfigFileSnapshotGetItems
+    Fill-in the items startIndex through endIndex (inclusive) of the
+    sequence node aNode so that they can be reached through
+    yaml_document_get_node().
+
+    @return Boolean false if any of the items could not be filled-in
+*/
+bool
+__yamlConfigFileSnapshotGetItems(
+    yamlConfigFileSnapshot  *aSnapshot,
+    yaml_node_t             *aNode,
+    unsigned int            startIndex,
+    unsigned int            endIndex
+);
+
+/*!
+    @function __yamlConfigFileSnapshotApplyKeyPath
+    Equivalent to yamlKeyPathApplyToDocument() on the snapshot's document,
+    but the key path is resolved over the snapshot's node records (with
+    mapping keys found via the perfect hashes where possible) and only the
+    resulting node is filled-in.
+
+    @return NULL on error, otherwise the node associated with aKeyPath
+*/
+yaml_node_t*
+__yamlConfigFileSnapshotApplyKeyPath(
+    yamlConfigFileSnapshot      *aSnapshot,
+    yamlKeyPathRef              aKeyPath,
+    yamlOptionsBitvec           options,
+    yaml_node_t                 *relativeToNode,
+    yamlErrorCode               *failedError,
+    yamlKeyPathNodeMatchType*   *failedAtElement
+);
+
+#endif /* __YAMLCONFIGFILESNAPSHOT_H__ */
@@ -8,6 +8,7 @@
 
 #include "yamlKeyPath.h"
 #include "yamlConfigFile.h"
+#include "yamlConfigFilePrivate.h"
 
 //
 
@@ -73,7 +74,7 @@ YAMLFORTRANINTERFACE_FORTRAN_API(yamlconfigfile_open)(
 			memcpy(C_filename, filename, filenameLength);
 			C_filename[filenameLength] = '\0';
 			
-			configFile = yamlConfigFileCreateWithFileAtPath(C_filename, yamlConfigFileOptions_oneBasedIndices | yamlConfigFileOptions_caseFoldKeys);
+			configFile = yamlConfigFileCreateWithFileAtPath(C_filename, yamlConfigFileOptions_oneBasedIndices | yamlConfigFileOptions_caseFoldKeys | yamlConfigFileOptions_internKeyPaths);
 			if ( configFile ) {
                 yamlConfigFileId    fileId = yamlConfigFileGetId(configFile);
                 
@@ -103,6 +104,7 @@ void
 YAMLFORTRANINTERFACE_FORTRAN_API(yamlconfigfile_closeall)()
 {
 	yamlConfigFileCacheFlush();
+	yamlKeyPathInternTableFlush();
 }
 
 //
@@ -225,10 +227,10 @@ YAMLFORTRANINTERFACE_FORTRAN_API(yamlconfigfile_getnodeistype)(
     if ( theConfigFile ) {
         yamlErrorCode               errorCode = 0;
         const char                  *errorAtChar = NULL;
-        yamlKeyPathRef              compiledKeyPath = yamlKeyPathCreateWithString(
+        yamlKeyPathRef              compiledKeyPath = __yamlConfigFileCreateKeyPathWithString(
+                                                            theConfigFile,
                                                             keyPath,
                                                             keyPathLen,
-                                                            yamlKeyPathCompileOptions_oneBasedIndices | yamlKeyPathCompileOptions_caseFoldKeys,
                                                             &errorCode,
                                                             &errorAtChar
                                                         );
@@ -281,10 +283,10 @@ YAMLFORTRANINTERFACE_FORTRAN_API(yamlconfigfile_getnodecollectionsize)(
     if ( theConfigFile ) {
         yamlErrorCode               errorCode = 0;
         const char                  *errorAtChar = NULL;
-        yamlKeyPathRef              compiledKeyPath = yamlKeyPathCreateWithString(
+        yamlKeyPathRef              compiledKeyPath = __yamlConfigFileCreateKeyPathWithString(
+                                                            theConfigFile,
                                                             keyPath,
                                                             keyPathLen,
-                                                            yamlKeyPathCompileOptions_oneBasedIndices | yamlKeyPathCompileOptions_caseFoldKeys,
                                                             &errorCode,
                                                             &errorAtChar
                                                         );
@@ -305,6 +307,7 @@ YAMLFORTRANINTERFACE_FORTRAN_API(yamlconfigfile_getnodecollectionsize)(
                 __yamlFortranInterfacePrintKeyPathUsageError("failed to traverse key path", errorCode, compiledKeyPath, failedAtMatchElement);
                 *ierr = errorCode;
             }
+            yamlKeyPathRelease(compiledKeyPath);
         } else {
             __yamlFortranInterfacePrintKeyPathCompileError(errorCode, keyPath, keyPathLen, errorAtChar);
             *ierr = errorCode;
@@ -415,10 +418,10 @@ YAMLFORTRANINTERFACE_FORTRAN_API(yamlconfigfile_getstring)(
     if ( theConfigFile ) {
         yamlErrorCode               errorCode = 0;
         const char                  *errorAtChar = NULL;
-        yamlKeyPathRef              compiledKeyPath = yamlKeyPathCreateWithString(
+        yamlKeyPathRef              compiledKeyPath = __yamlConfigFileCreateKeyPathWithString(
+                                                            theConfigFile,
                                                             keyPath,
                                                             keyPathLen,
-                                                            yamlKeyPathCompileOptions_oneBasedIndices | yamlKeyPathCompileOptions_caseFoldKeys,
                                                             &errorCode,
                                                             &errorAtChar
                                                         );
@@ -463,10 +466,10 @@ YAMLFORTRANINTERFACE_FORTRAN_API(yamlconfigfile_getstring)(
     if ( theConfigFile ) { \
         yamlErrorCode               errorCode = 0; \
         const char                  *errorAtChar = NULL; \
-        yamlKeyPathRef              compiledKeyPath = yamlKeyPathCreateWithString( \
+        yamlKeyPathRef              compiledKeyPath = __yamlConfigFileCreateKeyPathWithString( \
+                                                            theConfigFile, \
                                                             keyPath, \
                                                             keyPathLen, \
-                                                            yamlKeyPathCompileOptions_oneBasedIndices | yamlKeyPathCompileOptions_caseFoldKeys, \
                                                             &errorCode, \
                                                             &errorAtChar \
                                                         ); \
@@ -606,10 +609,10 @@ YAMLFORTRANINTERFACE_FORTRAN_API(yamlconfigfile_getlogical)(
     if ( theConfigFile ) {
         yamlErrorCode               errorCode = 0;
         const char                  *errorAtChar = NULL;
-        yamlKeyPathRef              compiledKeyPath = yamlKeyPathCreateWithString(
+        yamlKeyPathRef              compiledKeyPath = __yamlConfigFileCreateKeyPathWithString(
+                                                            theConfigFile,
                                                             keyPath,
                                                             keyPathLen,
-                                                            yamlKeyPathCompileOptions_oneBasedIndices | yamlKeyPathCompileOptions_caseFoldKeys,
                                                             &errorCode,
                                                             &errorAtChar
                                                         );
@@ -652,10 +655,10 @@ YAMLFORTRANINTERFACE_FORTRAN_API(yamlconfigfile_getlogical)(
     if ( theConfigFile ) { \
         yamlErrorCode               errorCode = 0; \
         const char                  *errorAtChar = NULL; \
-        yamlKeyPathRef              compiledKeyPath = yamlKeyPathCreateWithString( \
+        yamlKeyPathRef              compiledKeyPath = __yamlConfigFileCreateKeyPathWithString( \
+                                                            theConfigFile, \
                                                             keyPath, \
                                                             keyPathLen, \
-                                                            yamlKeyPathCompileOptions_oneBasedIndices | yamlKeyPathCompileOptions_caseFoldKeys, \
                                                             &errorCode, \
                                                             &errorAtChar \
                                                         ); \
@@ -813,10 +816,10 @@ YAMLFORTRANINTERFACE_FORTRAN_API(yamlconfigfile_getlogicalarray)(
     if ( theConfigFile ) {
         yamlErrorCode               errorCode = 0;
         const char                  *errorAtChar = NULL;
-        yamlKeyPathRef              compiledKeyPath = yamlKeyPathCreateWithString(
+        yamlKeyPathRef              compiledKeyPath = __yamlConfigFileCreateKeyPathWithString(
+                                                            theConfigFile,
                                                             keyPath,
                                                             keyPathLen,
-                                                            yamlKeyPathCompileOptions_oneBasedIndices | yamlKeyPathCompileOptions_caseFoldKeys,
                                                             &errorCode,
                                                             &errorAtChar
                                                         );
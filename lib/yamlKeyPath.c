@@ -7,76 +7,146 @@
  *
  */
 
-#include "yamlKeyPath.h"
+#include "yamlKeyPathPrivate.h"
 #include <ctype.h>
+#include <strings.h>
+#include <stddef.h>
 
 //
 
-uint64_t
-__yamlKeyPathCStringHash(
-    const char      *cString,
-    size_t          cStringLength
+/*
+ * A compiled key path is a single allocation:  the yamlKeyPath header is
+ * followed by a flat array of node-matching elements, which is followed
+ * by the NUL-terminated mapping keys the elements point to.
+ */
+
+typedef struct yamlKeyPathNodeMatchPrivate {
+    yamlKeyPathNodeMatchType            matchData;
+    unsigned int                        keyLength;
+    bool                                isLast;
+} yamlKeyPathNodeMatchPrivateType;
+
+//
+
+enum {
+    yamlKeyPathState_isInBuffer = 1 << 0
+};
+
+typedef struct __yamlKeyPath {
+    unsigned int                    refCount;
+    uint64_t                        hash;
+    yamlOptionsBitvec               options;
+    yamlOptionsBitvec               state;
+    unsigned int                    matchCount;
+    size_t                          byteSize;
+    yamlKeyPathNodeMatchPrivateType matchList[];
+} yamlKeyPath;
+
+//
+
+typedef struct {
+    yamlKeyPath                     *keyPath;
+    unsigned int                    matchCount;
+    size_t                          keyBytes;
+    char                            *nextKey;
+} yamlKeyPathBuilder;
+
+//
+
+size_t
+__yamlKeyPathByteSize(
+    unsigned int        matchCount,
+    size_t              keyBytes
 )
 {
-    uint64_t        hashVal = 5381;
-    int             c;
-
-    if ( cStringLength <= 0 ) {
-        while ( (c = *cString++) ) hashVal = ((hashVal << 5) + hashVal) + c; /* hash * 33 + c */
-    } else {
-        while ( cStringLength-- && (c = *cString++) ) hashVal = ((hashVal << 5) + hashVal) + c; /* hash * 33 + c */
-    }
-    return hashVal;
+    return sizeof(yamlKeyPath) + matchCount * sizeof(yamlKeyPathNodeMatchPrivateType) + keyBytes;
 }
 
 //
 
-typedef struct yamlKeyPathNodeMatchPrivate {
-    yamlKeyPathNodeMatchType            matchData;
-    struct yamlKeyPathNodeMatchPrivate  *link;
-} yamlKeyPathNodeMatchPrivateType;
+yamlKeyPath*
+__yamlKeyPathInitInBuffer(
+    void                *buffer,
+    unsigned int        matchCount,
+    size_t              keyBytes,
+    yamlOptionsBitvec   options,
+    yamlKeyPathBuilder  *builder
+)
+{
+    yamlKeyPath         *newKeyPath = (yamlKeyPath*)buffer;
+    
+    newKeyPath->refCount = 1;
+    newKeyPath->hash = 0;
+    newKeyPath->options = options;
+    newKeyPath->state = 0;
+    newKeyPath->matchCount = matchCount;
+    newKeyPath->byteSize = __yamlKeyPathByteSize(matchCount, keyBytes);
+    if ( builder ) {
+        builder->keyPath = newKeyPath;
+        builder->matchCount = 0;
+        builder->keyBytes = 0;
+        builder->nextKey = (char*)&newKeyPath->matchList[matchCount];
+    }
+    return newKeyPath;
+}
 
 //
 
 yamlKeyPathNodeMatchPrivateType*
-yamlKeyPathNodeMatchPrivateAllocScalar()
+__yamlKeyPathBuilderNextMatch(
+    yamlKeyPathBuilder  *builder
+)
 {
-    yamlKeyPathNodeMatchPrivateType*    newMatch = malloc(sizeof(yamlKeyPathNodeMatchPrivateType));
+    yamlKeyPathNodeMatchPrivateType *newMatch = NULL;
     
-    if ( newMatch ) {
-        newMatch->matchData.type = YAML_SCALAR_NODE;
-        newMatch->link = NULL;
+    if ( builder->keyPath ) {
+        newMatch = &builder->keyPath->matchList[builder->matchCount];
+        newMatch->keyLength = 0;
+        newMatch->isLast = (builder->matchCount + 1 == builder->keyPath->matchCount);
     }
+    builder->matchCount++;
     return newMatch;
 }
 
 //
 
-yamlKeyPathNodeMatchPrivateType*
-yamlKeyPathNodeMatchPrivateAllocSequenceIndex(
-    int             index
+void
+__yamlKeyPathBuilderAddScalar(
+    yamlKeyPathBuilder  *builder
+)
+{
+    yamlKeyPathNodeMatchPrivateType *newMatch = __yamlKeyPathBuilderNextMatch(builder);
+    
+    if ( newMatch ) newMatch->matchData.type = YAML_SCALAR_NODE;
+}
+
+//
+
+void
+__yamlKeyPathBuilderAddSequenceIndex(
+    yamlKeyPathBuilder  *builder,
+    int                 index
 )
 {
-    yamlKeyPathNodeMatchPrivateType*    newMatch = malloc(sizeof(yamlKeyPathNodeMatchPrivateType));
+    yamlKeyPathNodeMatchPrivateType *newMatch = __yamlKeyPathBuilderNextMatch(builder);
     
     if ( newMatch ) {
         newMatch->matchData.type = YAML_SEQUENCE_NODE;
         newMatch->matchData.parameter.index = index;
-        newMatch->link = NULL;
     }
-    return newMatch;
 }
 
 //
 
-yamlKeyPathNodeMatchPrivateType*
-yamlKeyPathNodeMatchPrivateAllocMappingKey(
+void
+__yamlKeyPathBuilderAddMappingKey(
+    yamlKeyPathBuilder  *builder,
     const char          *key,
     size_t              keyLength,
     yamlOptionsBitvec   options
 )
 {
-    yamlKeyPathNodeMatchPrivateType*    newMatch;
+    yamlKeyPathNodeMatchPrivateType *newMatch = __yamlKeyPathBuilderNextMatch(builder);
     
     if ( ! key ) {
         keyLength = 0;
@@ -84,76 +154,77 @@ yamlKeyPathNodeMatchPrivateAllocMappingKey(
     else if ( keyLength == yamlCStringFullLength ) {
         keyLength = strlen(key);
     }
-    newMatch = malloc(sizeof(yamlKeyPathNodeMatchPrivateType) + keyLength + (key ? 1 : 0));
-    
     if ( newMatch ) {
         newMatch->matchData.type = YAML_MAPPING_NODE;
+        newMatch->keyLength = keyLength;
         if ( key ) {
-            newMatch->matchData.parameter.key = (void*)newMatch + sizeof(yamlKeyPathNodeMatchPrivateType);
+            char        *keyCopy = builder->nextKey;
+            
+            newMatch->matchData.parameter.key = keyCopy;
             if ( options & yamlKeyPathCompileOptions_caseFoldKeys ) {
                 size_t  i = 0;
                 while ( i < keyLength ) {
-                    ((char*)newMatch->matchData.parameter.key)[i] = tolower(key[i]);
+                    keyCopy[i] = tolower(key[i]);
                     i++;
                 }
             } else {
-                strncpy((char*)newMatch->matchData.parameter.key, key, keyLength);
+                memcpy(keyCopy, key, keyLength);
             }
-            ((char*)newMatch->matchData.parameter.key)[keyLength] = '\0';
+            keyCopy[keyLength] = '\0';
+            builder->nextKey += keyLength + 1;
         } else {
             newMatch->matchData.parameter.key = NULL;
         }
-        newMatch->link = NULL;
     }
-    return newMatch;
+    if ( key ) builder->keyBytes += keyLength + 1;
 }
 
 //
 
 void
-yamlKeyPathNodeMatchPrivateDeallocChain(
-    yamlKeyPathNodeMatchPrivateType     *match
+__yamlKeyPathComputeHash(
+    yamlKeyPath         *aKeyPath
 )
 {
-    while ( match ) {
-        yamlKeyPathNodeMatchPrivateType *next = match->link;
-        
-        free((void*)match);
-        match = next;
+    yamlKeyPathNodeMatchPrivateType *m = aKeyPath->matchList;
+    unsigned int                    i = aKeyPath->matchCount;
+    uint64_t                        seed = yamlHashGetSeed();
+    uint64_t                        h = seed + aKeyPath->matchCount;
+    
+    // Hash the compiled elements (not the source text) so that equal key
+    // paths hash identically regardless of how they were constructed:
+    while ( i-- ) {
+        h = yamlHash64Combine(h, m->matchData.type);
+        switch ( m->matchData.type ) {
+            case YAML_SEQUENCE_NODE:
+                h = yamlHash64Combine(h, (uint64_t)m->matchData.parameter.index);
+                break;
+            case YAML_MAPPING_NODE:
+                h = yamlHash64Combine(h, m->matchData.parameter.key ? yamlHash64(m->matchData.parameter.key, m->keyLength, seed) : 0);
+                break;
+            default:
+                break;
+        }
+        m++;
     }
+    aKeyPath->hash = yamlHash64Finalize(h);
 }
 
 //
 
-typedef struct __yamlKeyPath {
-    unsigned int                    refCount;
-    uint64_t                        hash;
-    yamlOptionsBitvec               options;
-    yamlKeyPathNodeMatchPrivateType *matchList;
-} yamlKeyPath;
-
-//
-
-yamlKeyPathRef
-yamlKeyPathCreate(
+bool
+__yamlKeyPathBuildWithArgs(
+    yamlKeyPathBuilder  *builder,
     yamlOptionsBitvec   options,
     yamlErrorCode       *outError,
     yaml_node_type_t    nodeType,
-    ...
+    va_list             vargs
 )
 {
-    yamlKeyPath                         *newKeyPath = NULL;
-    yamlKeyPathNodeMatchPrivateType     *listHead = NULL;
-    yamlKeyPathNodeMatchPrivateType     *match;
-    va_list                             vargs;
-    
-    va_start(vargs, nodeType);
     while ( nodeType != YAML_NO_NODE ) {
-        yamlKeyPathNodeMatchPrivateType *newMatch = NULL;
-        
         switch ( nodeType ) {
             case YAML_SCALAR_NODE: {
-                newMatch = yamlKeyPathNodeMatchPrivateAllocScalar();
+                __yamlKeyPathBuilderAddScalar(builder);
                 break;
             }
             case YAML_SEQUENCE_NODE: {
@@ -162,73 +233,66 @@ yamlKeyPathCreate(
                 if ( options & yamlKeyPathCompileOptions_oneBasedIndices ) index--;
                 if ( index < 0 ) {
                     if ( outError ) *outError = yamlKeyPathError_invalidIndex;
-                    yamlKeyPathNodeMatchPrivateDeallocChain(listHead);
-                    return NULL;
+                    return false;
                 }
-                newMatch = yamlKeyPathNodeMatchPrivateAllocSequenceIndex(index);
+                __yamlKeyPathBuilderAddSequenceIndex(builder, index);
                 break;
             }
             case YAML_MAPPING_NODE: {
                 const char  *key = va_arg(vargs, const char*);
                 
-                newMatch = yamlKeyPathNodeMatchPrivateAllocMappingKey(key, 0, options);
+                __yamlKeyPathBuilderAddMappingKey(builder, key, yamlCStringFullLength, options);
                 break;
             }
             default: {
                 if ( outError ) *outError = yamlKeyPathError_invalidType;
-                yamlKeyPathNodeMatchPrivateDeallocChain(listHead);
-                return NULL;
+                return false;
             }
         }
-        if ( newMatch == NULL ) {
-            if ( outError ) *outError = yamlKeyPathError_outOfMemory;
-            yamlKeyPathNodeMatchPrivateDeallocChain(listHead);
-            return NULL;
-        }
-        if ( listHead ) {
-            match->link = newMatch;
-            match = newMatch;
-        } else {
-            listHead = match = newMatch;
-        }
         nodeType = va_arg(vargs, yaml_node_type_t);
     }
+    return true;
+}
+
+//
+
+yamlKeyPathRef
+yamlKeyPathCreate(
+    yamlOptionsBitvec   options,
+    yamlErrorCode       *outError,
+    yaml_node_type_t    nodeType,
+    ...
+)
+{
+    yamlKeyPath                         *newKeyPath = NULL;
+    yamlKeyPathBuilder                  builder = { .keyPath = NULL, .matchCount = 0, .keyBytes = 0, .nextKey = NULL };
+    va_list                             vargs;
+    bool                                okay;
     
-    newKeyPath = malloc(sizeof(yamlKeyPath));
-    if ( newKeyPath ) {
-        size_t              stringFormLength;
-        char                tmpStringForm[64];
-        
-        newKeyPath->refCount = 1;
-        newKeyPath->options = options;
-        newKeyPath->matchList = listHead;
-        
-        // The new object is complete enough that we can call the
-        // yamlKeyPathSprintf() function to convert to a string:
-        stringFormLength = yamlKeyPathSprintf(newKeyPath, tmpStringForm, sizeof(tmpStringForm));
-        if ( stringFormLength < sizeof(tmpStringForm) ) {
-            newKeyPath->hash = __yamlKeyPathCStringHash(tmpStringForm, stringFormLength);
-        } else {
-            char            *stringForm = malloc(1 + stringFormLength);
-            
-             if ( ! stringForm ) {
-                if ( outError ) *outError = yamlKeyPathError_outOfMemory;
-                yamlKeyPathNodeMatchPrivateDeallocChain(listHead);
-                free((void*)newKeyPath);
-                return NULL;
-            }
-            stringFormLength = yamlKeyPathSprintf(newKeyPath, stringForm, stringFormLength + 1);
-            newKeyPath->hash = __yamlKeyPathCStringHash(stringForm, stringFormLength);
-            free(stringForm);
-        }
+    // Size the key path first, then allocate and fill it in:
+    va_start(vargs, nodeType);
+    okay = __yamlKeyPathBuildWithArgs(&builder, options, outError, nodeType, vargs);
+    va_end(vargs);
+    if ( ! okay ) return NULL;
+    
+    newKeyPath = malloc(__yamlKeyPathByteSize(builder.matchCount, builder.keyBytes));
+    if ( ! newKeyPath ) {
+        if ( outError ) *outError = yamlKeyPathError_outOfMemory;
+        return NULL;
     }
+    __yamlKeyPathInitInBuffer(newKeyPath, builder.matchCount, builder.keyBytes, options, &builder);
+    va_start(vargs, nodeType);
+    __yamlKeyPathBuildWithArgs(&builder, options, outError, nodeType, vargs);
+    va_end(vargs);
+    __yamlKeyPathComputeHash(newKeyPath);
     return newKeyPath;
 }
 
 //
 
-yamlKeyPathRef
-yamlKeyPathCreateWithString(
+bool
+__yamlKeyPathBuildWithString(
+    yamlKeyPathBuilder  *builder,
     const char          *keyPathString,
     size_t              keyPathStringLength,
     yamlOptionsBitvec   options,
@@ -236,11 +300,7 @@ yamlKeyPathCreateWithString(
     const char*         *outErrorAtChar
 )
 {
-    yamlKeyPath                         *newKeyPath = NULL;
-    yamlKeyPathNodeMatchPrivateType     *listHead = NULL;
-    yamlKeyPathNodeMatchPrivateType     *match;
     bool                                atRoot = true;
-    const char                          *start = keyPathString, *end = keyPathString;
     
     if ( (keyPathStringLength == yamlCStringFullLength) && keyPathString ) keyPathStringLength = strlen(keyPathString);
     
@@ -251,11 +311,8 @@ yamlKeyPathCreateWithString(
         
         // Drop leading whitespace:
         while ( (keyPathString < endKeyPathString) && isspace(*keyPathString) ) keyPathString++;
-        start = keyPathString;
         
         while ( *keyPathString && (keyPathString < endKeyPathString) && ! isspace(*keyPathString) ) {
-            yamlKeyPathNodeMatchPrivateType *newMatch = NULL;
-            
             if ( *keyPathString == '[' ) {
                 const char              *savedPos = ++keyPathString;
                 uint64_t                index = 0;
@@ -266,8 +323,7 @@ yamlKeyPathCreateWithString(
                     if ( newIndex < index ) {
                         if ( outError ) *outError = yamlKeyPathError_invalidIndex;
                         if ( outErrorAtChar ) *outErrorAtChar = savedPos;
-                        yamlKeyPathNodeMatchPrivateDeallocChain(listHead);
-                        return NULL;
+                        return false;
                     }
                     index = newIndex;
                     keyPathString++;
@@ -275,18 +331,16 @@ yamlKeyPathCreateWithString(
                 if ( (keyPathString >= endKeyPathString) || (*keyPathString != ']') ) {
                     if ( outError ) *outError = yamlKeyPathError_invalidExpression;
                     if ( outErrorAtChar ) *outErrorAtChar = keyPathString;
-                    yamlKeyPathNodeMatchPrivateDeallocChain(listHead);
-                    return NULL;
+                    return false;
                 }
                 keyPathString++;
                 if ( options & yamlKeyPathCompileOptions_oneBasedIndices ) index--;
                 if ( (index < 0) || (index > INT_MAX) ) {
                     if ( outError ) *outError = yamlKeyPathError_invalidIndex;
                     if ( outErrorAtChar ) *outErrorAtChar = savedPos;
-                    yamlKeyPathNodeMatchPrivateDeallocChain(listHead);
-                    return NULL;
+                    return false;
                 }
-                newMatch = yamlKeyPathNodeMatchPrivateAllocSequenceIndex(index);
+                __yamlKeyPathBuilderAddSequenceIndex(builder, index);
             }
             else if ( atRoot || (*keyPathString == '.') ) {
                 const char      *startOfKey = keyPathString;
@@ -299,56 +353,112 @@ yamlKeyPathCreateWithString(
                 while ( (endOfKey < endKeyPathString) && *endOfKey && (*endOfKey != '.') && (*endOfKey != '[') ) endOfKey++;
                 
                 if ( endOfKey > startOfKey ) {
-                    newMatch = yamlKeyPathNodeMatchPrivateAllocMappingKey(startOfKey, (endOfKey - startOfKey), options);
+                    __yamlKeyPathBuilderAddMappingKey(builder, startOfKey, (endOfKey - startOfKey), options);
                 } else {
                     if ( outError ) *outError = yamlKeyPathError_invalidExpression;
                     if ( outErrorAtChar ) *outErrorAtChar = startOfKey;
-                    yamlKeyPathNodeMatchPrivateDeallocChain(listHead);
-                    return NULL;
+                    return false;
                 }
                 keyPathString = endOfKey;
             }
             else {
                 if ( outError ) *outError = yamlKeyPathError_invalidExpression;
                 if ( outErrorAtChar ) *outErrorAtChar = keyPathString;
-                yamlKeyPathNodeMatchPrivateDeallocChain(listHead);
-                return NULL;
-            }
-            if ( newMatch == NULL ) {
-                if ( outError ) *outError = yamlKeyPathError_outOfMemory;
-                if ( outErrorAtChar ) *outErrorAtChar = keyPathString;
-                yamlKeyPathNodeMatchPrivateDeallocChain(listHead);
-                return NULL;
-            }
-            if ( listHead ) {
-                match->link = newMatch;
-                match = newMatch;
-            } else {
-                listHead = match = newMatch;
+                return false;
             }
             atRoot = false;
         }
-        end = keyPathString;
-        
         // If there's trailing whitespace, ensure it's all whitespace:
         while ( (keyPathString < endKeyPathString) && isspace(*keyPathString) ) keyPathString++;
         if ( keyPathString < endKeyPathString ) {
             if ( outError ) *outError = yamlKeyPathError_invalidExpression;
             if ( outErrorAtChar ) *outErrorAtChar = keyPathString;
-            yamlKeyPathNodeMatchPrivateDeallocChain(listHead);
-            return NULL;
+            return false;
+        }
+    }
+    return true;
+}
+
+//
+
+yamlKeyPathRef
+yamlKeyPathCreateWithString(
+    const char          *keyPathString,
+    size_t              keyPathStringLength,
+    yamlOptionsBitvec   options,
+    yamlErrorCode       *outError,
+    const char*         *outErrorAtChar
+)
+{
+    yamlKeyPath                         *newKeyPath = NULL;
+    yamlKeyPathBuilder                  builder = { .keyPath = NULL, .matchCount = 0, .keyBytes = 0, .nextKey = NULL };
+    
+    // Size the key path first, then allocate and fill it in:
+    if ( __yamlKeyPathBuildWithString(&builder, keyPathString, keyPathStringLength, options, outError, outErrorAtChar) ) {
+        newKeyPath = malloc(__yamlKeyPathByteSize(builder.matchCount, builder.keyBytes));
+        if ( newKeyPath ) {
+            __yamlKeyPathInitInBuffer(newKeyPath, builder.matchCount, builder.keyBytes, options, &builder);
+            __yamlKeyPathBuildWithString(&builder, keyPathString, keyPathStringLength, options, NULL, NULL);
+            __yamlKeyPathComputeHash(newKeyPath);
+        } else {
+            if ( outError ) *outError = yamlKeyPathError_outOfMemory;
         }
     }
+    return newKeyPath;
+}
+
+//
 
-    newKeyPath = malloc(sizeof(yamlKeyPath));
+yamlKeyPathRef
+yamlKeyPathCreateWithStringInBuffer(
+    const char          *keyPathString,
+    size_t              keyPathStringLength,
+    yamlOptionsBitvec   options,
+    void                *buffer,
+    size_t              bufferSize,
+    yamlErrorCode       *outError,
+    const char*         *outErrorAtChar
+)
+{
+    yamlKeyPath                         *newKeyPath = NULL;
+    yamlKeyPathBuilder                  builder = { .keyPath = NULL, .matchCount = 0, .keyBytes = 0, .nextKey = NULL };
+    
+    // Size the key path first, then fill it in if it fits:
+    if ( __yamlKeyPathBuildWithString(&builder, keyPathString, keyPathStringLength, options, outError, outErrorAtChar) ) {
+        if ( ((uintptr_t)buffer % sizeof(uint64_t)) || (__yamlKeyPathByteSize(builder.matchCount, builder.keyBytes) > bufferSize) ) {
+            if ( outError ) *outError = yamlKeyPathError_bufferTooSmall;
+        } else {
+            newKeyPath = __yamlKeyPathInitInBuffer(buffer, builder.matchCount, builder.keyBytes, options, &builder);
+            newKeyPath->state = yamlKeyPathState_isInBuffer;
+            __yamlKeyPathBuildWithString(&builder, keyPathString, keyPathStringLength, options, NULL, NULL);
+            __yamlKeyPathComputeHash(newKeyPath);
+        }
+    }
+    return newKeyPath;
+}
+
+//
+
+yamlKeyPathRef
+yamlKeyPathCopy(
+    yamlKeyPathRef              aKeyPath
+)
+{
+    yamlKeyPath                 *newKeyPath = malloc(aKeyPath->byteSize);
+    
     if ( newKeyPath ) {
+        ptrdiff_t               delta = (char*)newKeyPath - (char*)aKeyPath;
+        unsigned int            i = 0;
+        
+        memcpy(newKeyPath, aKeyPath, aKeyPath->byteSize);
         newKeyPath->refCount = 1;
-        newKeyPath->options = options;
-        newKeyPath->matchList = listHead;
-        if ( start ) {
-            newKeyPath->hash = __yamlKeyPathCStringHash(start, end - start);
-        } else {
-            newKeyPath->hash = __yamlKeyPathCStringHash("", 0);
+        newKeyPath->state = 0;
+        
+        // Relocate the key pointers into the new allocation:
+        while ( i < newKeyPath->matchCount ) {
+            yamlKeyPathNodeMatchPrivateType *m = &newKeyPath->matchList[i++];
+            
+            if ( (m->matchData.type == YAML_MAPPING_NODE) && m->matchData.parameter.key ) m->matchData.parameter.key += delta;
         }
     }
     return newKeyPath;
@@ -382,10 +492,8 @@ yamlKeyPathRelease(
     yamlKeyPathRef              aKeyPath
 )
 {
-    if ( --aKeyPath->refCount == 0 ) {
-        if ( aKeyPath->matchList ) yamlKeyPathNodeMatchPrivateDeallocChain(aKeyPath->matchList);
-        free((void*)aKeyPath);
-    }
+    // The caller owns the storage of a key path compiled into its buffer:
+    if ( (--aKeyPath->refCount == 0) && ! (aKeyPath->state & yamlKeyPathState_isInBuffer) ) free((void*)aKeyPath);
 }
 
 //
@@ -399,40 +507,38 @@ yamlKeyPathIsEqual(
     bool                        okay = true;
     
     if ( keyPath1 != keyPath2 ) {
-        yamlKeyPathNodeMatchPrivateType *matchList1 = keyPath1->matchList;
-        yamlKeyPathNodeMatchPrivateType *matchList2 = keyPath2->matchList;
+        yamlKeyPathNodeMatchPrivateType *m1 = keyPath1->matchList;
+        yamlKeyPathNodeMatchPrivateType *m2 = keyPath2->matchList;
+        unsigned int                    i = keyPath1->matchCount;
         
-        if ( ! matchList1 && ! matchList2 ) return true;
+        if ( keyPath1->matchCount != keyPath2->matchCount ) return false;
         
-        if ( matchList1 && matchList2 ) {
-            // Walk the two lists in parallel, comparing each entry:
-            while ( okay && matchList1 && matchList2 ) {
-                if ( matchList1->matchData.type != matchList2->matchData.type ) {
-                    okay = false;
-                } else {
-                    switch ( matchList1->matchData.type ) {
-                        case YAML_NO_NODE:
-                        case YAML_SCALAR_NODE: {
-                            break;
-                        }
-                        case YAML_MAPPING_NODE: {
-                            if ( ! matchList1->matchData.parameter.key ) {
-                                if ( matchList2->matchData.parameter.key ) okay = false;
-                            } else if ( ! matchList2->matchData.parameter.key ) {
-                                okay = false;
-                            } else {
-                                if ( strcmp(matchList1->matchData.parameter.key, matchList2->matchData.parameter.key) != 0 ) okay = false;
-                            }
-                            break;
+        // Walk the two arrays in parallel, comparing each entry:
+        while ( okay && i-- ) {
+            if ( m1->matchData.type != m2->matchData.type ) {
+                okay = false;
+            } else {
+                switch ( m1->matchData.type ) {
+                    case YAML_NO_NODE:
+                    case YAML_SCALAR_NODE: {
+                        break;
+                    }
+                    case YAML_MAPPING_NODE: {
+                        if ( ! m1->matchData.parameter.key ) {
+                            if ( m2->matchData.parameter.key ) okay = false;
+                        } else if ( ! m2->matchData.parameter.key ) {
+                            okay = false;
+                        } else {
+                            if ( (m1->keyLength != m2->keyLength) || (memcmp(m1->matchData.parameter.key, m2->matchData.parameter.key, m1->keyLength) != 0) ) okay = false;
                         }
-                        case YAML_SEQUENCE_NODE:
-                            if ( matchList1->matchData.parameter.index != matchList2->matchData.parameter.index ) okay = false;
-                            break;
+                        break;
                     }
+                    case YAML_SEQUENCE_NODE:
+                        if ( m1->matchData.parameter.index != m2->matchData.parameter.index ) okay = false;
+                        break;
                 }
-                matchList1 = matchList1->link;
-                matchList2 = matchList2->link;
             }
+            m1++, m2++;
         }
     }
     return okay;
@@ -450,23 +556,13 @@ yamlKeyPathGetHash(
 
 //
 
-
-/*!
-    @function yamlKeyPathGetFirstNodeMatch
-    Return the first (root) node-matching element in the compiled expression.
- 
-    @param aKeyPath
-        A compiled key path
- 
-    @return The first node-matching element for the expression, or NULL.
-*/
 yamlKeyPathNodeMatchType*
 yamlKeyPathGetFirstNodeMatch(
     yamlKeyPathRef              aKeyPath
 )
 {
-    if ( aKeyPath->matchList ) {
-        return &aKeyPath->matchList->matchData;
+    if ( aKeyPath->matchCount ) {
+        return &aKeyPath->matchList[0].matchData;
     }
     return NULL;
 }
@@ -480,7 +576,7 @@ yamlKeyPathGetNextNodeMatch(
 {
     if ( matchingElement ) {
         yamlKeyPathNodeMatchPrivateType *castToPrivate = (yamlKeyPathNodeMatchPrivateType*)matchingElement;
-        if ( castToPrivate->link ) return &castToPrivate->link->matchData;
+        if ( ! castToPrivate->isLast ) return &castToPrivate[1].matchData;
     }
     return NULL;
 }
@@ -495,11 +591,12 @@ yamlKeyPathNodeMatchEnumerate(
 )
 {
     yamlKeyPathNodeMatchPrivateType *m = aKeyPath->matchList;
+    unsigned int                    i = aKeyPath->matchCount;
     bool                            shouldContinue = true;
     
-    while ( m && shouldContinue ) {
+    while ( i-- && shouldContinue ) {
         shouldContinue = enumeratorFn(&m->matchData, context);
-        m = m->link;
+        m++;
     }
     return shouldContinue;
 }
@@ -514,19 +611,20 @@ yamlKeyPathSprintf(
 )
 {
     yamlKeyPathNodeMatchPrivateType *m = aKeyPath->matchList;
+    unsigned int                    i = aKeyPath->matchCount;
     size_t                          fullSize = 0;
     
     if ( buffer && bufferSize ) memset(buffer, 0, bufferSize);
     
     // Determine the full size of the resulting string and copy what
     // we can into buffer as we go:
-    while ( m ) {
+    while ( i-- ) {
         switch ( m->matchData.type ) {
             case YAML_NO_NODE:
             case YAML_SCALAR_NODE:
                 break;
             case YAML_SEQUENCE_NODE: {
-                int             index = m->matchData.parameter.index;
+                int             index = m->matchData.parameter.index + (( aKeyPath->options & yamlKeyPathCompileOptions_oneBasedIndices ) ? 1 : 0);
                 
                 fullSize += 3;
                 while ( index >= 10 ) {
@@ -537,7 +635,7 @@ yamlKeyPathSprintf(
                     int         n;
                     
                     *buffer++ = '[', bufferSize--;
-                    n = snprintf(buffer, bufferSize, "%d", m->matchData.parameter.index + ( aKeyPath->options & yamlKeyPathCompileOptions_oneBasedIndices ) ? 1 : 0 );
+                    n = snprintf(buffer, bufferSize, "%d", m->matchData.parameter.index + (( aKeyPath->options & yamlKeyPathCompileOptions_oneBasedIndices ) ? 1 : 0));
                     buffer += n;
                     bufferSize -= ( n  > bufferSize ) ? bufferSize : n;
                     if ( bufferSize ) *buffer++ = ']', bufferSize--;
@@ -547,7 +645,7 @@ yamlKeyPathSprintf(
             case YAML_MAPPING_NODE: {
                 if ( m->matchData.parameter.key ) {
                     
-                    fullSize += strlen(m->matchData.parameter.key);
+                    fullSize += m->keyLength;
                     if ( m != aKeyPath->matchList ) {
                         if ( buffer && bufferSize ) *buffer++ = '.', bufferSize--;
                         fullSize++;
@@ -561,7 +659,7 @@ yamlKeyPathSprintf(
                 break;
             }
         }
-        m = m->link;
+        m++;
     }
     return fullSize;
 }
@@ -594,12 +692,272 @@ __yamlKeyPathKeyCmp(
     return cmp;
 }
 
+//
+#if 0
+#pragma mark -
+#endif
+//
+
+/*
+ * A mapping index is a lazily-populated array (one slot per document
+ * node) of open-addressed hash tables over the keys of large mapping
+ * nodes.  Each table slot holds the index of a key-value pair (+1, so
+ * zero marks an empty slot) and the low 32 bits of the key's hash.
+ *
+ * Mappings with non-scalar keys are never indexed:  they are marked as
+ * such so that the linear scan (and its error reporting) is used.
+ */
+
+typedef struct {
+    uint32_t                pairIndex;
+    uint32_t                hashLow;
+} yamlKeyPathMappingIndexSlot;
+
+typedef struct {
+    bool                    isCaseless;
+    uint32_t                slotMask;
+    yamlKeyPathMappingIndexSlot slots[];
+} yamlKeyPathMappingIndexTable;
+
+#define YAMLKEYPATH_MAPPINGINDEX_UNINDEXABLE    ((yamlKeyPathMappingIndexTable*)-1)
+
+typedef struct __yamlKeyPathMappingIndex {
+    unsigned int                    refCount;
+    yaml_document_t                 *document;
+    unsigned int                    minimumKeyCount;
+    uint64_t                        seed;
+    size_t                          nodeCount;
+    yamlKeyPathMappingIndexTable*   *tables;
+} yamlKeyPathMappingIndex;
+
+//
+
+uint64_t
+__yamlKeyPathMappingKeyHash(
+    const char      *key,
+    size_t          keyLength,
+    bool            isCaseless,
+    uint64_t        seed
+)
+{
+    return ( isCaseless ? yamlHash64Caseless(key, keyLength, seed) : yamlHash64(key, keyLength, seed) );
+}
+
+//
+
+bool
+__yamlKeyPathMappingKeyIsEqual(
+    const char      *k1,
+    const char      *k2,
+    size_t          keyLength,
+    bool            isCaseless
+)
+{
+    if ( isCaseless ) return ( strncasecmp(k1, k2, keyLength) == 0 );
+    return ( memcmp(k1, k2, keyLength) == 0 );
+}
+
+//
+
+yamlKeyPathMappingIndexTable*
+__yamlKeyPathMappingIndexTableCreate(
+    yaml_document_t     *yamlDocument,
+    yaml_node_t         *mappingNode,
+    bool                isCaseless,
+    uint64_t            seed
+)
+{
+    yaml_node_pair_t                *startKey = mappingNode->data.mapping.pairs.start;
+    yaml_node_pair_t                *endKey = mappingNode->data.mapping.pairs.top;
+    size_t                          pairCount = endKey - startKey;
+    uint32_t                        slotCount = 8;
+    yamlKeyPathMappingIndexTable    *newTable;
+    
+    if ( pairCount >= UINT32_MAX / 4 ) return YAMLKEYPATH_MAPPINGINDEX_UNINDEXABLE;
+    
+    // Keep the load factor at or below 1/2:
+    while ( slotCount < 2 * pairCount ) slotCount *= 2;
+    newTable = calloc(1, sizeof(yamlKeyPathMappingIndexTable) + slotCount * sizeof(yamlKeyPathMappingIndexSlot));
+    if ( newTable ) {
+        uint32_t                    pairIndex = 0;
+        
+        newTable->isCaseless = isCaseless;
+        newTable->slotMask = slotCount - 1;
+        while ( startKey < endKey ) {
+            yaml_node_t             *key = yaml_document_get_node(yamlDocument, startKey->key);
+            
+            if ( key && (key->type == YAML_SCALAR_NODE) ) {
+                const char          *keyStr = (const char*)key->data.scalar.value;
+                size_t              keyLen = strnlen(keyStr, key->data.scalar.length);
+                uint64_t            keyHash = __yamlKeyPathMappingKeyHash(keyStr, keyLen, isCaseless, seed);
+                uint32_t            slot = keyHash & newTable->slotMask;
+                
+                // Probe for an empty slot; if an equal key is already present then
+                // this pair is shadowed by it (first match wins, as with a scan):
+                while ( newTable->slots[slot].pairIndex ) {
+                    if ( newTable->slots[slot].hashLow == (uint32_t)keyHash ) {
+                        yaml_node_t *otherKey = yaml_document_get_node(yamlDocument, mappingNode->data.mapping.pairs.start[newTable->slots[slot].pairIndex - 1].key);
+                        const char  *otherKeyStr = (const char*)otherKey->data.scalar.value;
+                        
+                        if ( (strnlen(otherKeyStr, otherKey->data.scalar.length) == keyLen) && __yamlKeyPathMappingKeyIsEqual(keyStr, otherKeyStr, keyLen, isCaseless) ) break;
+                    }
+                    slot = (slot + 1) & newTable->slotMask;
+                }
+                if ( ! newTable->slots[slot].pairIndex ) {
+                    newTable->slots[slot].pairIndex = pairIndex + 1;
+                    newTable->slots[slot].hashLow = (uint32_t)keyHash;
+                }
+            } else {
+                free((void*)newTable);
+                return YAMLKEYPATH_MAPPINGINDEX_UNINDEXABLE;
+            }
+            startKey++, pairIndex++;
+        }
+    }
+    return newTable;
+}
+
+//
+
+yamlKeyPathMappingIndexRef
+yamlKeyPathMappingIndexCreate(
+    yaml_document_t     *yamlDocument,
+    unsigned int        minimumKeyCount
+)
+{
+    yamlKeyPathMappingIndex *newIndex = calloc(1, sizeof(yamlKeyPathMappingIndex));
+    
+    if ( newIndex ) {
+        newIndex->refCount = 1;
+        newIndex->document = yamlDocument;
+        newIndex->minimumKeyCount = minimumKeyCount;
+        newIndex->seed = yamlHashGetSeed();
+        newIndex->nodeCount = yamlDocument->nodes.top - yamlDocument->nodes.start;
+    }
+    return (yamlKeyPathMappingIndexRef)newIndex;
+}
+
+//
+
+unsigned int
+yamlKeyPathMappingIndexGetRefCount(
+    yamlKeyPathMappingIndexRef  aMappingIndex
+)
+{
+    return aMappingIndex->refCount;
+}
+
+//
+
+yamlKeyPathMappingIndexRef
+yamlKeyPathMappingIndexRetain(
+    yamlKeyPathMappingIndexRef  aMappingIndex
+)
+{
+    aMappingIndex->refCount++;
+    return aMappingIndex;
+}
+
+//
+
+void
+yamlKeyPathMappingIndexRelease(
+    yamlKeyPathMappingIndexRef  aMappingIndex
+)
+{
+    if ( --aMappingIndex->refCount == 0 ) {
+        if ( aMappingIndex->tables ) {
+            size_t              i = 0;
+            
+            while ( i < aMappingIndex->nodeCount ) {
+                yamlKeyPathMappingIndexTable    *table = aMappingIndex->tables[i++];
+                
+                if ( table && (table != YAMLKEYPATH_MAPPINGINDEX_UNINDEXABLE) ) free((void*)table);
+            }
+            free((void*)aMappingIndex->tables);
+        }
+        free((void*)aMappingIndex);
+    }
+}
+
+//
+
+unsigned int
+yamlKeyPathMappingIndexGetMinimumKeyCount(
+    yamlKeyPathMappingIndexRef  aMappingIndex
+)
+{
+    return aMappingIndex->minimumKeyCount;
+}
+
+//
+
+void
+yamlKeyPathMappingIndexSetMinimumKeyCount(
+    yamlKeyPathMappingIndexRef  aMappingIndex,
+    unsigned int                minimumKeyCount
+)
+{
+    aMappingIndex->minimumKeyCount = minimumKeyCount;
+}
+
+//
+
+yaml_node_pair_t*
+__yamlKeyPathMappingIndexFindPair(
+    yamlKeyPathMappingIndex     *aMappingIndex,
+    yaml_node_t                 *mappingNode,
+    const char                  *key,
+    bool                        isCaseless,
+    bool                        *isIndexed
+)
+{
+    yamlKeyPathMappingIndexTable    *table;
+    size_t                          nodeIndex = mappingNode - aMappingIndex->document->nodes.start;
+    
+    *isIndexed = false;
+    if ( (aMappingIndex->minimumKeyCount == 0) || ((size_t)(mappingNode->data.mapping.pairs.top - mappingNode->data.mapping.pairs.start) < aMappingIndex->minimumKeyCount) ) return NULL;
+    if ( (mappingNode < aMappingIndex->document->nodes.start) || (nodeIndex >= aMappingIndex->nodeCount) ) return NULL;
+    
+    if ( ! aMappingIndex->tables ) {
+        aMappingIndex->tables = calloc(aMappingIndex->nodeCount, sizeof(yamlKeyPathMappingIndexTable*));
+        if ( ! aMappingIndex->tables ) return NULL;
+    }
+    table = aMappingIndex->tables[nodeIndex];
+    if ( ! table ) {
+        table = __yamlKeyPathMappingIndexTableCreate(aMappingIndex->document, mappingNode, isCaseless, aMappingIndex->seed);
+        if ( ! table ) return NULL;
+        aMappingIndex->tables[nodeIndex] = table;
+    }
+    if ( (table != YAMLKEYPATH_MAPPINGINDEX_UNINDEXABLE) && (table->isCaseless == isCaseless) ) {
+        size_t              keyLen = strlen(key);
+        uint64_t            keyHash = __yamlKeyPathMappingKeyHash(key, keyLen, isCaseless, aMappingIndex->seed);
+        uint32_t            slot = keyHash & table->slotMask;
+        
+        *isIndexed = true;
+        while ( table->slots[slot].pairIndex ) {
+            if ( table->slots[slot].hashLow == (uint32_t)keyHash ) {
+                yaml_node_pair_t    *pair = mappingNode->data.mapping.pairs.start + (table->slots[slot].pairIndex - 1);
+                yaml_node_t         *pairKey = yaml_document_get_node(aMappingIndex->document, pair->key);
+                
+                if ( __yamlKeyPathKeyCmp(pairKey->data.scalar.value, pairKey->data.scalar.length, key, isCaseless) == 0 ) return pair;
+            }
+            slot = (slot + 1) & table->slotMask;
+        }
+    }
+    return NULL;
+}
+
+//
+
 yaml_node_t*
-yamlKeyPathApplyToDocument(
+yamlKeyPathApplyToDocumentFromNodeMatch(
     yamlKeyPathRef              aKeyPath,
+    yamlKeyPathNodeMatchType    *startingElement,
     yamlOptionsBitvec           options,
     yaml_document_t             *yamlDocument,
     yaml_node_t                 *rootNode,
+    yamlKeyPathMappingIndexRef  aMappingIndex,
     yamlErrorCode               *failedError,
     yamlKeyPathNodeMatchType*   *failedAtElement
 )
@@ -610,17 +968,25 @@ yamlKeyPathApplyToDocument(
     if ( failedAtElement ) *failedAtElement = NULL;
 
     if ( rootNode ) {
-        yamlKeyPathNodeMatchPrivateType     *m = aKeyPath->matchList;
+        yamlKeyPathNodeMatchPrivateType     *m = startingElement ? (yamlKeyPathNodeMatchPrivateType*)startingElement : aKeyPath->matchList;
+        yamlKeyPathNodeMatchPrivateType     *mEnd = aKeyPath->matchList + aKeyPath->matchCount;
         
-        while ( m && rootNode ) {
+        while ( (m < mEnd) && rootNode ) {
             // Correct node type?
             if ( rootNode->type == m->matchData.type ) {
                 switch ( rootNode->type ) {
                     case YAML_MAPPING_NODE: {
                         yaml_node_pair_t    *startKey = rootNode->data.mapping.pairs.start;
                         yaml_node_pair_t    *endKey = rootNode->data.mapping.pairs.top;
+                        bool                isIndexed = false;
                         
-                        while ( startKey < endKey ) {
+                        // Large mappings are resolved via hash index if possible:
+                        if ( aMappingIndex && (aMappingIndex->document == yamlDocument) ) {
+                            yaml_node_pair_t    *foundPair = __yamlKeyPathMappingIndexFindPair(aMappingIndex, rootNode, m->matchData.parameter.key, (options & yamlKeyPathApplyOptions_keysAreCaseless) ? true : false, &isIndexed);
+                            
+                            if ( isIndexed ) startKey = foundPair ? foundPair : endKey;
+                        }
+                        while ( ! isIndexed && (startKey < endKey) ) {
                             yaml_node_t     *key = yaml_document_get_node(yamlDocument, startKey->key);
                             
                             if ( key && (key->type == YAML_SCALAR_NODE) ) {
@@ -683,12 +1049,43 @@ yamlKeyPathApplyToDocument(
                 rootNode = NULL;
                 break;
             }
-            if ( rootNode ) m = m->link;
+            if ( rootNode ) m++;
         }
     }
     return rootNode;
 }
 
+//
+
+yaml_node_t*
+yamlKeyPathApplyToDocumentWithMappingIndex(
+    yamlKeyPathRef              aKeyPath,
+    yamlOptionsBitvec           options,
+    yaml_document_t             *yamlDocument,
+    yaml_node_t                 *rootNode,
+    yamlKeyPathMappingIndexRef  aMappingIndex,
+    yamlErrorCode               *failedError,
+    yamlKeyPathNodeMatchType*   *failedAtElement
+)
+{
+    return yamlKeyPathApplyToDocumentFromNodeMatch(aKeyPath, NULL, options, yamlDocument, rootNode, aMappingIndex, failedError, failedAtElement);
+}
+
+//
+
+yaml_node_t*
+yamlKeyPathApplyToDocument(
+    yamlKeyPathRef              aKeyPath,
+    yamlOptionsBitvec           options,
+    yaml_document_t             *yamlDocument,
+    yaml_node_t                 *rootNode,
+    yamlErrorCode               *failedError,
+    yamlKeyPathNodeMatchType*   *failedAtElement
+)
+{
+    return yamlKeyPathApplyToDocumentWithMappingIndex(aKeyPath, options, yamlDocument, rootNode, NULL, failedError, failedAtElement);
+}
+
 //
 #if 0
 #pragma mark -
@@ -718,51 +1115,151 @@ const yamlKeyPathCacheValueCallbacks yamlKeyPathCacheValueCStringCallbacks = {
 
 //
 
+/*
+ * The cache is set-associative:  the entry array is divided into sets of
+ * YAMLKEYPATH_CACHE_WAYS entries, a key path's hash selects a set, and
+ * when the set is full the least-recently-used entry is evicted.  The
+ * cache starts small and doubles its set count (up to the capacity) when
+ * a set overflows while the cache is at least half full.
+ */
+
+#define YAMLKEYPATH_CACHE_WAYS 4
+
+#ifndef YAMLKEYPATH_CACHE_INITIAL_CAPACITY
+#define YAMLKEYPATH_CACHE_INITIAL_CAPACITY 64
+#endif
+
+typedef struct {
+    yamlKeyPathRef                          key;
+    const void                              *value;
+    uint64_t                                hash;
+    uint64_t                                lastUse;
+} yamlKeyPathCacheEntry;
+
 typedef struct __yamlKeyPathCache {
     unsigned int                            refCount;
     
     yamlKeyPathCacheValueCallbacks          callbacks;
     
-    unsigned int                            slotCount;
-    yamlKeyPathRef                          *keys;
-    const void*                             *values;
+    unsigned int                            capacity;
+    unsigned int                            setCount;
+    unsigned int                            count;
+    uint64_t                                useClock;
+    yamlKeyPathCacheEntry                   *entries;
+    
+    uint64_t                                hits, misses, evictions;
 } yamlKeyPathCache;
 
 //
 
-yamlKeyPathCache*
-__yamlKeyPathCacheAlloc(
-    unsigned int        slotCount
+unsigned int
+__yamlKeyPathCacheNormalizeCapacity(
+    unsigned int        capacity
 )
 {
-    yamlKeyPathCache    *newCache;
+    unsigned int        normCapacity = YAMLKEYPATH_CACHE_WAYS;
     
-    if ( slotCount == 0 ) slotCount = 17;
-    newCache = (yamlKeyPathCache*)calloc(sizeof(yamlKeyPathCache) + slotCount * (sizeof(yamlKeyPathRef) + sizeof(const void*)), 1);
-    if ( newCache ) {
-        void            *base = (void*)newCache + sizeof(yamlKeyPathCache);
+    if ( capacity == 0 ) capacity = YAMLKEYPATH_CACHE_DEFAULT_CAPACITY;
+    while ( (normCapacity < capacity) && (normCapacity <= UINT_MAX / 2) ) normCapacity *= 2;
+    return normCapacity;
+}
+
+//
+
+void
+__yamlKeyPathCacheEntryDestroy(
+    yamlKeyPathCache        *aCache,
+    yamlKeyPathCacheEntry   *anEntry
+)
+{
+    yamlKeyPathRelease(anEntry->key);
+    if ( aCache->callbacks.release ) aCache->callbacks.release(anEntry->value);
+    anEntry->key = NULL;
+    anEntry->value = NULL;
+}
+
+//
+
+yamlKeyPathCacheEntry*
+__yamlKeyPathCacheSlotForInsert(
+    yamlKeyPathCacheEntry   *entries,
+    unsigned int            setCount,
+    uint64_t                keyHash
+)
+{
+    yamlKeyPathCacheEntry   *set = entries + (keyHash & (setCount - 1)) * YAMLKEYPATH_CACHE_WAYS;
+    yamlKeyPathCacheEntry   *victim = set;
+    unsigned int            i;
+    
+    for ( i = 0; i < YAMLKEYPATH_CACHE_WAYS; i++ ) {
+        if ( ! set[i].key ) return &set[i];
+        if ( set[i].lastUse < victim->lastUse ) victim = &set[i];
+    }
+    return victim;
+}
+
+//
+
+bool
+__yamlKeyPathCacheResize(
+    yamlKeyPathCache        *aCache,
+    unsigned int            newSetCount
+)
+{
+    yamlKeyPathCacheEntry   *newEntries = calloc(newSetCount * YAMLKEYPATH_CACHE_WAYS, sizeof(yamlKeyPathCacheEntry));
+    unsigned int            i = 0, iMax = aCache->setCount * YAMLKEYPATH_CACHE_WAYS;
+    
+    if ( ! newEntries ) return false;
+    
+    // Re-insert all entries; when shrinking, the less-recently-used entry
+    // loses any conflict:
+    while ( i < iMax ) {
+        yamlKeyPathCacheEntry   *oldEntry = &aCache->entries[i++];
         
-        newCache->refCount = 1;
-        newCache->slotCount = slotCount;
-        newCache->keys = base; base += slotCount * sizeof(yamlKeyPathRef);
-        newCache->values = base;
+        if ( oldEntry->key ) {
+            yamlKeyPathCacheEntry   *newEntry = __yamlKeyPathCacheSlotForInsert(newEntries, newSetCount, oldEntry->hash);
+            
+            if ( newEntry->key ) {
+                aCache->evictions++;
+                aCache->count--;
+                if ( newEntry->lastUse > oldEntry->lastUse ) {
+                    __yamlKeyPathCacheEntryDestroy(aCache, oldEntry);
+                    continue;
+                }
+                __yamlKeyPathCacheEntryDestroy(aCache, newEntry);
+            }
+            *newEntry = *oldEntry;
+        }
     }
-    return newCache;
+    free((void*)aCache->entries);
+    aCache->entries = newEntries;
+    aCache->setCount = newSetCount;
+    return true;
 }
 
 //
 
 yamlKeyPathCacheRef
 yamlKeyPathCacheCreate(
-    unsigned int                            slotCount,
+    unsigned int                            capacity,
     const yamlKeyPathCacheValueCallbacks    *callbacks
 )
 {
-    yamlKeyPathCache        *newCache = __yamlKeyPathCacheAlloc(slotCount);
+    yamlKeyPathCache        *newCache = calloc(1, sizeof(yamlKeyPathCache));
     
     if ( newCache ) {
-        if ( callbacks ) newCache->callbacks = *callbacks;
+        unsigned int        initialCapacity;
         
+        newCache->refCount = 1;
+        newCache->capacity = __yamlKeyPathCacheNormalizeCapacity(capacity);
+        initialCapacity = (newCache->capacity < YAMLKEYPATH_CACHE_INITIAL_CAPACITY) ? newCache->capacity : YAMLKEYPATH_CACHE_INITIAL_CAPACITY;
+        newCache->setCount = initialCapacity / YAMLKEYPATH_CACHE_WAYS;
+        newCache->entries = calloc(initialCapacity, sizeof(yamlKeyPathCacheEntry));
+        if ( ! newCache->entries ) {
+            free((void*)newCache);
+            return NULL;
+        }
+        if ( callbacks ) newCache->callbacks = *callbacks;
     }
     return (yamlKeyPathCacheRef)newCache;
 }
@@ -797,12 +1294,61 @@ yamlKeyPathCacheRelease(
 {
     if ( --aCache->refCount == 0 ) {
         yamlKeyPathCacheClear(aCache);
+        free((void*)aCache->entries);
         free((void*)aCache);
     }
 }
 
 //
 
+unsigned int
+yamlKeyPathCacheGetCapacity(
+    yamlKeyPathCacheRef aCache
+)
+{
+    return aCache->capacity;
+}
+
+//
+
+void
+yamlKeyPathCacheSetCapacity(
+    yamlKeyPathCacheRef aCache,
+    unsigned int        capacity
+)
+{
+    aCache->capacity = __yamlKeyPathCacheNormalizeCapacity(capacity);
+    if ( aCache->setCount * YAMLKEYPATH_CACHE_WAYS > aCache->capacity ) __yamlKeyPathCacheResize(aCache, aCache->capacity / YAMLKEYPATH_CACHE_WAYS);
+}
+
+//
+
+void
+yamlKeyPathCacheGetStats(
+    yamlKeyPathCacheRef     aCache,
+    yamlKeyPathCacheStats   *stats
+)
+{
+    stats->hits = aCache->hits;
+    stats->misses = aCache->misses;
+    stats->evictions = aCache->evictions;
+    stats->count = aCache->count;
+    stats->size = aCache->setCount * YAMLKEYPATH_CACHE_WAYS;
+    stats->capacity = aCache->capacity;
+}
+
+//
+
+void
+yamlKeyPathCacheResetStats(
+    yamlKeyPathCacheRef aCache
+)
+{
+    aCache->hits = aCache->misses = aCache->evictions = 0;
+}
+
+//
+
 void
 yamlKeyPathCacheAdd(
     yamlKeyPathCacheRef aCache,
@@ -810,16 +1356,43 @@ yamlKeyPathCacheAdd(
     const void          *cachedValue
 )
 {
-    uint64_t            keyHash = yamlKeyPathGetHash(aKeyPath);
-    unsigned int        keyIndex = keyHash % aCache->slotCount;
+    uint64_t                keyHash = yamlKeyPathGetHash(aKeyPath);
+    yamlKeyPathCacheEntry   *set = aCache->entries + (keyHash & (aCache->setCount - 1)) * YAMLKEYPATH_CACHE_WAYS;
+    yamlKeyPathCacheEntry   *slot;
+    yamlKeyPathRef          keyPathCopy;
+    unsigned int            i;
     
-    if ( aCache->keys[keyIndex] ) {
-        yamlKeyPathRelease(aCache->keys[keyIndex]);
-        if ( aCache->callbacks.release ) aCache->callbacks.release(aCache->values[keyIndex]);
-        aCache->keys[keyIndex] = NULL;
+    // Replace the value if the key path is already present:
+    for ( i = 0; i < YAMLKEYPATH_CACHE_WAYS; i++ ) {
+        if ( set[i].key && (set[i].hash == keyHash) && ((set[i].key == aKeyPath) || yamlKeyPathIsEqual(set[i].key, aKeyPath)) ) {
+            __yamlKeyPathCacheEntryDestroy(aCache, &set[i]);
+            aCache->count--;
+            break;
+        }
+    }
+    
+    // A key path compiled into a caller's buffer cannot outlive it, so the
+    // cache holds a heap-allocated copy:
+    keyPathCopy = ( aKeyPath->state & yamlKeyPathState_isInBuffer ) ? yamlKeyPathCopy(aKeyPath) : yamlKeyPathRetain(aKeyPath);
+    if ( ! keyPathCopy ) return;
+    
+    slot = __yamlKeyPathCacheSlotForInsert(aCache->entries, aCache->setCount, keyHash);
+    if ( slot->key ) {
+        // The set is full; grow rather than evict if there's room to do so:
+        if ( (aCache->count >= aCache->setCount * YAMLKEYPATH_CACHE_WAYS / 2) && (aCache->setCount * YAMLKEYPATH_CACHE_WAYS < aCache->capacity) ) {
+            if ( __yamlKeyPathCacheResize(aCache, aCache->setCount * 2) ) slot = __yamlKeyPathCacheSlotForInsert(aCache->entries, aCache->setCount, keyHash);
+        }
+        if ( slot->key ) {
+            __yamlKeyPathCacheEntryDestroy(aCache, slot);
+            aCache->evictions++;
+            aCache->count--;
+        }
     }
-    aCache->keys[keyIndex] = yamlKeyPathRetain(aKeyPath);
-    aCache->values[keyIndex] = ( aCache->callbacks.retain ? aCache->callbacks.retain(cachedValue) : cachedValue );
+    slot->key = keyPathCopy;
+    slot->value = ( aCache->callbacks.retain ? aCache->callbacks.retain(cachedValue) : cachedValue );
+    slot->hash = keyHash;
+    slot->lastUse = ++aCache->useClock;
+    aCache->count++;
 }
 
 //
@@ -830,14 +1403,15 @@ yamlKeyPathCacheDrop(
     yamlKeyPathRef      aKeyPath
 )
 {
-    uint64_t            keyHash = yamlKeyPathGetHash(aKeyPath);
-    unsigned int        keyIndex = keyHash % aCache->slotCount;
+    uint64_t                keyHash = yamlKeyPathGetHash(aKeyPath);
+    yamlKeyPathCacheEntry   *set = aCache->entries + (keyHash & (aCache->setCount - 1)) * YAMLKEYPATH_CACHE_WAYS;
+    unsigned int            i;
     
-    if ( aCache->keys[keyIndex] ) {
-        if ( yamlKeyPathIsEqual(aCache->keys[keyIndex], aKeyPath) ) {
-            yamlKeyPathRelease(aCache->keys[keyIndex]);
-            if ( aCache->callbacks.release ) aCache->callbacks.release(aCache->values[keyIndex]);
-            aCache->keys[keyIndex] = NULL;
+    for ( i = 0; i < YAMLKEYPATH_CACHE_WAYS; i++ ) {
+        if ( set[i].key && (set[i].hash == keyHash) && ((set[i].key == aKeyPath) || yamlKeyPathIsEqual(set[i].key, aKeyPath)) ) {
+            __yamlKeyPathCacheEntryDestroy(aCache, &set[i]);
+            aCache->count--;
+            break;
         }
     }
 }
@@ -849,15 +1423,13 @@ yamlKeyPathCacheClear(
     yamlKeyPathCacheRef aCache
 )
 {
-    unsigned int    i = 0;
+    unsigned int    i = 0, iMax = aCache->setCount * YAMLKEYPATH_CACHE_WAYS;
 
-    while ( i < aCache->slotCount ) {
-        if ( aCache->keys[i] ) {
-            yamlKeyPathRelease(aCache->keys[i]);
-            if ( aCache->callbacks.release ) aCache->callbacks.release(aCache->values[i]);
-        }
+    while ( i < iMax ) {
+        if ( aCache->entries[i].key ) __yamlKeyPathCacheEntryDestroy(aCache, &aCache->entries[i]);
         i++;
     }
+    aCache->count = 0;
 }
 
 //
@@ -869,15 +1441,19 @@ yamlKeyPathCacheLookup(
     const void*         *cachedValue
 )
 {
-    uint64_t            keyHash = yamlKeyPathGetHash(aKeyPath);
-    unsigned int        keyIndex = keyHash % aCache->slotCount;
+    uint64_t                keyHash = yamlKeyPathGetHash(aKeyPath);
+    yamlKeyPathCacheEntry   *set = aCache->entries + (keyHash & (aCache->setCount - 1)) * YAMLKEYPATH_CACHE_WAYS;
+    unsigned int            i;
     
-    if ( aCache->keys[keyIndex] ) {
-        if ( (aCache->keys[keyIndex] == aKeyPath) || yamlKeyPathIsEqual(aCache->keys[keyIndex], aKeyPath) ) {
-            if ( cachedValue ) *cachedValue = aCache->values[keyIndex];
+    for ( i = 0; i < YAMLKEYPATH_CACHE_WAYS; i++ ) {
+        if ( set[i].key && (set[i].hash == keyHash) && ((set[i].key == aKeyPath) || yamlKeyPathIsEqual(set[i].key, aKeyPath)) ) {
+            set[i].lastUse = ++aCache->useClock;
+            aCache->hits++;
+            if ( cachedValue ) *cachedValue = set[i].value;
             return true;
         }
     }
+    aCache->misses++;
     return false;
 }
 
@@ -887,6 +1463,174 @@ yamlKeyPathCacheLookup(
 #endif
 //
 
+/*
+ * The intern table is a fixed-size, 4-way set-associative table keyed by
+ * the key path string (as delimited by its length and any NUL) and the
+ * compile options.  It is allocated on first use; the least-recently-used
+ * entry in a full set is evicted (the table's reference to the key path is
+ * released, so callers still holding it are unaffected).
+ */
+
+typedef struct {
+    yamlKeyPathRef                          keyPath;
+    const char                              *keyPathString;
+    size_t                                  keyPathStringLength;
+    yamlOptionsBitvec                       options;
+    uint64_t                                hash;
+    uint64_t                                lastUse;
+} yamlKeyPathInternEntry;
+
+static unsigned int __yamlKeyPathInternCapacity = YAMLKEYPATH_INTERN_DEFAULT_CAPACITY;
+static unsigned int __yamlKeyPathInternSetCount = 0;
+static unsigned int __yamlKeyPathInternCount = 0;
+static uint64_t __yamlKeyPathInternUseClock = 0;
+static yamlKeyPathInternEntry *__yamlKeyPathInternEntries = NULL;
+static uint64_t __yamlKeyPathInternHits = 0, __yamlKeyPathInternMisses = 0, __yamlKeyPathInternEvictions = 0;
+
+//
+
+void
+__yamlKeyPathInternEntryDestroy(
+    yamlKeyPathInternEntry  *anEntry
+)
+{
+    yamlKeyPathRelease(anEntry->keyPath);
+    free((void*)anEntry->keyPathString);
+    anEntry->keyPath = NULL;
+    anEntry->keyPathString = NULL;
+    __yamlKeyPathInternCount--;
+}
+
+//
+
+yamlKeyPathRef
+yamlKeyPathCreateWithStringInterned(
+    const char          *keyPathString,
+    size_t              keyPathStringLength,
+    yamlOptionsBitvec   options,
+    yamlErrorCode       *outError,
+    const char*         *outErrorAtChar
+)
+{
+    yamlKeyPathInternEntry  *set, *slot;
+    yamlKeyPathRef          newKeyPath;
+    uint64_t                keyHash;
+    unsigned int            i;
+    
+    if ( ! keyPathString ) return yamlKeyPathCreateWithString(keyPathString, keyPathStringLength, options, outError, outErrorAtChar);
+    
+    // The compiler stops at the first NUL, so the key does too:
+    keyPathStringLength = ( keyPathStringLength == yamlCStringFullLength ) ? strlen(keyPathString) : strnlen(keyPathString, keyPathStringLength);
+    
+    // Trailing whitespace is ignored by the compiler (and pads Fortran strings):
+    while ( keyPathStringLength && isspace(keyPathString[keyPathStringLength - 1]) ) keyPathStringLength--;
+    
+    if ( ! __yamlKeyPathInternEntries ) {
+        __yamlKeyPathInternEntries = calloc(__yamlKeyPathInternCapacity, sizeof(yamlKeyPathInternEntry));
+        if ( ! __yamlKeyPathInternEntries ) return yamlKeyPathCreateWithString(keyPathString, keyPathStringLength, options, outError, outErrorAtChar);
+        __yamlKeyPathInternSetCount = __yamlKeyPathInternCapacity / YAMLKEYPATH_CACHE_WAYS;
+    }
+    keyHash = yamlHash64(keyPathString, keyPathStringLength, yamlHashGetSeed() + options);
+    set = __yamlKeyPathInternEntries + (keyHash & (__yamlKeyPathInternSetCount - 1)) * YAMLKEYPATH_CACHE_WAYS;
+    slot = set;
+    for ( i = 0; i < YAMLKEYPATH_CACHE_WAYS; i++ ) {
+        if ( set[i].keyPath ) {
+            if ( (set[i].hash == keyHash) && (set[i].options == options) && (set[i].keyPathStringLength == keyPathStringLength) && (memcmp(set[i].keyPathString, keyPathString, keyPathStringLength) == 0) ) {
+                set[i].lastUse = ++__yamlKeyPathInternUseClock;
+                __yamlKeyPathInternHits++;
+                if ( outErrorAtChar ) *outErrorAtChar = NULL;
+                return yamlKeyPathRetain(set[i].keyPath);
+            }
+            if ( slot->keyPath && (set[i].lastUse < slot->lastUse) ) slot = &set[i];
+        } else if ( slot->keyPath ) {
+            slot = &set[i];
+        }
+    }
+    __yamlKeyPathInternMisses++;
+    
+    newKeyPath = yamlKeyPathCreateWithString(keyPathString, keyPathStringLength, options, outError, outErrorAtChar);
+    if ( newKeyPath ) {
+        char                *keyPathStringCopy = malloc(keyPathStringLength + 1);
+        
+        if ( keyPathStringCopy ) {
+            if ( slot->keyPath ) {
+                __yamlKeyPathInternEntryDestroy(slot);
+                __yamlKeyPathInternEvictions++;
+            }
+            memcpy(keyPathStringCopy, keyPathString, keyPathStringLength);
+            keyPathStringCopy[keyPathStringLength] = '\0';
+            slot->keyPath = yamlKeyPathRetain(newKeyPath);
+            slot->keyPathString = keyPathStringCopy;
+            slot->keyPathStringLength = keyPathStringLength;
+            slot->options = options;
+            slot->hash = keyHash;
+            slot->lastUse = ++__yamlKeyPathInternUseClock;
+            __yamlKeyPathInternCount++;
+        }
+    }
+    return newKeyPath;
+}
+
+//
+
+void
+yamlKeyPathInternTableFlush()
+{
+    if ( __yamlKeyPathInternEntries ) {
+        unsigned int        i = 0, iMax = __yamlKeyPathInternSetCount * YAMLKEYPATH_CACHE_WAYS;
+        
+        while ( i < iMax ) {
+            if ( __yamlKeyPathInternEntries[i].keyPath ) __yamlKeyPathInternEntryDestroy(&__yamlKeyPathInternEntries[i]);
+            i++;
+        }
+        free((void*)__yamlKeyPathInternEntries);
+        __yamlKeyPathInternEntries = NULL;
+        __yamlKeyPathInternSetCount = 0;
+    }
+}
+
+//
+
+unsigned int
+yamlKeyPathInternTableGetCapacity()
+{
+    return __yamlKeyPathInternCapacity;
+}
+
+//
+
+void
+yamlKeyPathInternTableSetCapacity(
+    unsigned int    capacity
+)
+{
+    yamlKeyPathInternTableFlush();
+    __yamlKeyPathInternCapacity = YAMLKEYPATH_CACHE_WAYS;
+    if ( capacity == 0 ) capacity = YAMLKEYPATH_INTERN_DEFAULT_CAPACITY;
+    while ( (__yamlKeyPathInternCapacity < capacity) && (__yamlKeyPathInternCapacity <= UINT_MAX / 2) ) __yamlKeyPathInternCapacity *= 2;
+}
+
+//
+
+void
+yamlKeyPathInternTableGetStats(
+    yamlKeyPathCacheStats   *stats
+)
+{
+    stats->hits = __yamlKeyPathInternHits;
+    stats->misses = __yamlKeyPathInternMisses;
+    stats->evictions = __yamlKeyPathInternEvictions;
+    stats->count = __yamlKeyPathInternCount;
+    stats->size = __yamlKeyPathInternSetCount * YAMLKEYPATH_CACHE_WAYS;
+    stats->capacity = __yamlKeyPathInternCapacity;
+}
+
+//
+#if 0
+#pragma mark -
+#endif
+//
+
 #if 0
 
 int
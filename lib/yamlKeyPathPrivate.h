@@ -0,0 +1,33 @@
+/*
+ * yamlKeyPath
+ * Simplified YAML interface for C/Fortran
+ *
+ * Private interface shared by the parts of the library that match
+ * mapping keys the way key paths do.  Not installed with the library.
+ *
+ */
+
+#ifndef __YAMLKEYPATHPRIVATE_H__
+#define __YAMLKEYPATHPRIVATE_H__
+
+#include "yamlKeyPath.h"
+
+/*!
+    @function __yamlKeyPathKeyCmp
+    Compare the mapping key k1 (lenk1 bytes, not necessarily NUL-terminated)
+    with the NUL-terminated key path key k2, exactly as
+    yamlKeyPathApplyToDocument() does.  If isCaseless is true, characters
+    are compared without regard to case.
+
+    @return Zero if the keys match, otherwise a non-zero value whose sign
+        orders k2 relative to k1
+*/
+int
+__yamlKeyPathKeyCmp(
+    yaml_char_t     *k1,
+    size_t          lenk1,
+    const char      *k2,
+    bool            isCaseless
+);
+
+#endif /* __YAMLKEYPATHPRIVATE_H__ */
@@ -0,0 +1,546 @@
+/*
+ * yamlScalar
+ * Simplified YAML interface for C/Fortran
+ *
+ * Locale-independent conversion of YAML scalar text to
+ * numeric values.
+ *
+ */
+
+#ifndef _GNU_SOURCE
+# define _GNU_SOURCE    /* strtod_l() et al. on glibc */
+#endif
+
+#include "yamlScalar.h"
+
+#include <float.h>
+#include <math.h>
+#include <locale.h>
+#ifdef HAVE_XLOCALE_H
+# include <xlocale.h>
+#endif
+
+//
+
+#ifndef YAMLSCALAR_FALLBACK_STACKBUFFERSIZE
+#define YAMLSCALAR_FALLBACK_STACKBUFFERSIZE  64
+#endif
+
+/*
+ * The exact-arithmetic fast paths are only valid when intermediate
+ * results are not held in extended precision (e.g. x87).
+ */
+#if defined(FLT_EVAL_METHOD) && (FLT_EVAL_METHOD == 0)
+# define YAMLSCALAR_HAVE_EXACT_FAST_PATH
+#endif
+
+//
+
+static const double __yamlScalarPowersOfTen[] = {
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10,
+        1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+static const float __yamlScalarPowersOfTenFloat[] = {
+        1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f
+    };
+
+//
+
+void
+__yamlScalarTrim(
+    const char      *scalar,
+    size_t          scalarLength,
+    const char*     *outStart,
+    const char*     *outEnd
+)
+{
+    const char      *end = scalar + ((scalarLength == yamlCStringFullLength) ? strlen(scalar) : strnlen(scalar, scalarLength));
+
+    while ( (scalar < end) && isspace((unsigned char)*scalar) ) scalar++;
+    while ( (end > scalar) && isspace((unsigned char)*(end - 1)) ) end--;
+    *outStart = scalar;
+    *outEnd = end;
+}
+
+//
+
+int
+__yamlScalarDigitValue(
+    char            c
+)
+{
+    if ( (c >= '0') && (c <= '9') ) return c - '0';
+    if ( (c >= 'a') && (c <= 'f') ) return 10 + (c - 'a');
+    if ( (c >= 'A') && (c <= 'F') ) return 10 + (c - 'A');
+    return 99;
+}
+
+//
+
+bool
+__yamlScalarParseIntegerMagnitude(
+    const char              *s,
+    const char              *end,
+    bool                    allowLegacyOctal,
+    unsigned long long int  *outMagnitude
+)
+{
+    unsigned long long int  magnitude = 0;
+    unsigned int            base = 10, digitCount = 0;
+
+    if ( s >= end ) return false;
+    if ( (*s == '0') && (end - s > 1) ) {
+        switch ( s[1] ) {
+            case 'x':
+            case 'X':
+                base = 16, s += 2;
+                break;
+            case 'o':
+            case 'O':
+                base = 8, s += 2;
+                break;
+            case 'b':
+            case 'B':
+                base = 2, s += 2;
+                break;
+            default:
+                if ( allowLegacyOctal ) base = 8;
+                break;
+        }
+    }
+    while ( s < end ) {
+        char                c = *s++;
+        unsigned int        d;
+
+        // Underscores may only separate digits:
+        if ( c == '_' ) {
+            if ( ! digitCount || (s >= end) || (__yamlScalarDigitValue(*s) >= base) ) return false;
+            continue;
+        }
+        d = __yamlScalarDigitValue(c);
+        if ( d >= base ) return false;
+        if ( magnitude > (ULLONG_MAX - d) / base ) return false;
+        magnitude = magnitude * base + d;
+        digitCount++;
+    }
+    if ( ! digitCount ) return false;
+    *outMagnitude = magnitude;
+    return true;
+}
+
+//
+
+bool
+yamlScalarStringToBool(
+    const char              *scalar,
+    size_t                  scalarLength,
+    bool                    *outValue
+)
+{
+    const char              *s, *end;
+    size_t                  l;
+
+    __yamlScalarTrim(scalar, scalarLength, &s, &end);
+    l = end - s;
+    if ( l == 0 ) return false;
+    if ( l == 1 ) {
+        switch ( *s ) {
+
+            case 't':
+            case 'T':
+            case 'y':
+            case 'Y':
+            case '1':
+                *outValue = true;
+                return true;
+
+            case 'f':
+            case 'F':
+            case 'n':
+            case 'N':
+            case '0':
+                *outValue = false;
+                return true;
+
+        }
+    }
+    if ( ((l == 4) && (strncasecmp(s, "true", l) == 0)) ||
+        ((l == 3) && (strncasecmp(s, "yes", l) == 0)) ||
+        ((l == 2) && (strncasecmp(s, "on", l) == 0)) )
+    {
+        *outValue = true;
+        return true;
+    }
+    if ( ((l == 5) && (strncasecmp(s, "false", l) == 0)) ||
+        ((l == 2) && (strncasecmp(s, "no", l) == 0)) ||
+        ((l == 3) && (strncasecmp(s, "off", l) == 0)) )
+    {
+        *outValue = false;
+        return true;
+    }
+    // Any decimal integer, non-zero being true:
+    if ( (*s == '-') || (*s == '+') ) s++;
+    if ( s < end ) {
+        bool                isZero = true;
+
+        while ( s < end ) {
+            if ( ! isdigit((unsigned char)*s) ) return false;
+            if ( *s++ != '0' ) isZero = false;
+        }
+        *outValue = ! isZero;
+        return true;
+    }
+    return false;
+}
+
+//
+
+bool
+yamlScalarStringToSignedInt(
+    const char              *scalar,
+    size_t                  scalarLength,
+    long long int           *outValue
+)
+{
+    const char              *s, *end;
+    bool                    isNegative = false;
+    unsigned long long int  magnitude;
+
+    __yamlScalarTrim(scalar, scalarLength, &s, &end);
+    if ( (s < end) && ((*s == '-') || (*s == '+')) ) isNegative = (*s++ == '-');
+    if ( ! __yamlScalarParseIntegerMagnitude(s, end, true, &magnitude) ) return false;
+    if ( isNegative ) {
+        if ( magnitude > (unsigned long long int)LLONG_MAX + 1 ) return false;
+        *outValue = ( magnitude == (unsigned long long int)LLONG_MAX + 1 ) ? LLONG_MIN : -(long long int)magnitude;
+    } else {
+        if ( magnitude > LLONG_MAX ) return false;
+        *outValue = (long long int)magnitude;
+    }
+    return true;
+}
+
+//
+
+bool
+yamlScalarStringToUnsignedInt(
+    const char              *scalar,
+    size_t                  scalarLength,
+    unsigned long long int  *outValue
+)
+{
+    const char              *s, *end;
+    bool                    isNegative = false;
+    unsigned long long int  magnitude;
+
+    __yamlScalarTrim(scalar, scalarLength, &s, &end);
+    if ( (s < end) && ((*s == '-') || (*s == '+')) ) isNegative = (*s++ == '-');
+    if ( ! __yamlScalarParseIntegerMagnitude(s, end, true, &magnitude) ) return false;
+    if ( isNegative && magnitude ) return false;
+    *outValue = magnitude;
+    return true;
+}
+
+//
+
+bool
+__yamlScalarParseSpecialValue(
+    const char      *s,
+    const char      *end,
+    double          *outValue
+)
+{
+    size_t          l = end - s;
+
+    if ( (l == 4) && (*s == '.') ) s++, l--;
+    if ( ((l == 3) && (strncasecmp(s, "inf", 3) == 0)) || ((l == 8) && (strncasecmp(s, "infinity", 8) == 0)) ) {
+        *outValue = HUGE_VAL;
+        return true;
+    }
+    if ( (l == 3) && (strncasecmp(s, "nan", 3) == 0) ) {
+        *outValue = NAN;
+        return true;
+    }
+    return false;
+}
+
+//
+
+typedef struct {
+    uint64_t        mantissa;
+    int             exponent;
+    bool            isInexact;
+} yamlScalarDecimal;
+
+#define YAMLSCALAR_DECIMAL_MAX_DIGITS   19
+#define YAMLSCALAR_DECIMAL_MAX_EXPONENT 100000
+
+//
+
+bool
+__yamlScalarParseDecimal(
+    const char          *s,
+    const char          *end,
+    yamlScalarDecimal   *outDecimal
+)
+{
+    const char          *start = s;
+    uint64_t            mantissa = 0;
+    int                 exponent = 0, significantDigits = 0;
+    bool                sawDigit = false, isInexact = false;
+
+    // Underscores may only separate digits:
+#define __IS_DIGIT_SEPARATOR(P) ( (*(P) == '_') && ((P) > start) && isdigit((unsigned char)(P)[-1]) && ((P) + 1 < end) && isdigit((unsigned char)(P)[1]) )
+
+    // Integer part:
+    while ( s < end ) {
+        if ( isdigit((unsigned char)*s) ) {
+            int         d = *s - '0';
+
+            if ( significantDigits < YAMLSCALAR_DECIMAL_MAX_DIGITS ) {
+                mantissa = mantissa * 10 + d;
+                if ( mantissa ) significantDigits++;
+            } else {
+                exponent++;
+                if ( d ) isInexact = true;
+            }
+            sawDigit = true;
+        } else if ( ! __IS_DIGIT_SEPARATOR(s) ) {
+            break;
+        }
+        s++;
+    }
+    // Fractional part:
+    if ( (s < end) && (*s == '.') ) {
+        s++;
+        while ( s < end ) {
+            if ( isdigit((unsigned char)*s) ) {
+                int     d = *s - '0';
+
+                if ( significantDigits < YAMLSCALAR_DECIMAL_MAX_DIGITS ) {
+                    mantissa = mantissa * 10 + d;
+                    if ( mantissa ) significantDigits++;
+                    exponent--;
+                } else if ( d ) {
+                    isInexact = true;
+                }
+                sawDigit = true;
+            } else if ( ! __IS_DIGIT_SEPARATOR(s) ) {
+                break;
+            }
+            s++;
+        }
+    }
+#undef __IS_DIGIT_SEPARATOR
+    if ( ! sawDigit ) return false;
+
+    // Exponent:
+    if ( (s < end) && ((*s == 'e') || (*s == 'E')) ) {
+        bool            isNegative = false;
+        int             e = 0;
+
+        s++;
+        if ( (s < end) && ((*s == '-') || (*s == '+')) ) isNegative = (*s++ == '-');
+        if ( (s >= end) || ! isdigit((unsigned char)*s) ) return false;
+        while ( (s < end) && isdigit((unsigned char)*s) ) {
+            if ( e < YAMLSCALAR_DECIMAL_MAX_EXPONENT ) e = e * 10 + (*s - '0');
+            s++;
+        }
+        exponent += isNegative ? -e : e;
+    }
+    if ( s != end ) return false;
+
+    outDecimal->mantissa = mantissa;
+    outDecimal->exponent = exponent;
+    outDecimal->isInexact = isInexact;
+    return true;
+}
+
+//
+
+#ifdef HAVE_STRTOD_L
+
+static locale_t __yamlScalarCLocale = (locale_t)0;
+
+locale_t
+__yamlScalarGetCLocale()
+{
+    if ( ! __yamlScalarCLocale ) __yamlScalarCLocale = newlocale(LC_ALL_MASK, "C", (locale_t)0);
+    return __yamlScalarCLocale;
+}
+
+#endif
+
+//
+
+bool
+__yamlScalarFallbackParse(
+    const char      *s,
+    const char      *end,
+    bool            isNegative,
+    bool            isSinglePrecision,
+    double          *outValue
+)
+{
+    char            bufferOnStack[YAMLSCALAR_FALLBACK_STACKBUFFERSIZE];
+    char            *buffer = bufferOnStack, *p, *endPtr = NULL;
+    const char      *start = s;
+    size_t          bufferLength = 2 + (end - s);
+    bool            okay = false, isExponent = false;
+#ifndef HAVE_STRTOD_L
+    char            decimalPoint = *(localeconv()->decimal_point);
+#endif
+
+    if ( bufferLength > sizeof(bufferOnStack) ) {
+        buffer = malloc(bufferLength);
+        if ( ! buffer ) return false;
+    }
+    // Build a NUL-terminated copy without underscores, which may only
+    // separate the (hexadecimal) digits of the significand:
+    p = buffer;
+    if ( isNegative ) *p++ = '-';
+    while ( s < end ) {
+        char        c = *s++;
+
+        if ( c == '_' ) {
+            if ( isExponent || (s - 2 < start) || (__yamlScalarDigitValue(s[-2]) >= 16) || (s >= end) || (__yamlScalarDigitValue(*s) >= 16) ) {
+                if ( buffer != bufferOnStack ) free((void*)buffer);
+                return false;
+            }
+            continue;
+        }
+        if ( (c == 'p') || (c == 'P') ) isExponent = true;
+#ifndef HAVE_STRTOD_L
+        if ( c == '.' ) c = decimalPoint;
+#endif
+        *p++ = c;
+    }
+    *p = '\0';
+
+#ifdef HAVE_STRTOD_L
+    if ( __yamlScalarGetCLocale() ) {
+        if ( isSinglePrecision ) {
+            *outValue = strtof_l(buffer, &endPtr, __yamlScalarGetCLocale());
+        } else {
+            *outValue = strtod_l(buffer, &endPtr, __yamlScalarGetCLocale());
+        }
+    } else
+#endif
+    {
+        if ( isSinglePrecision ) {
+            *outValue = strtof(buffer, &endPtr);
+        } else {
+            *outValue = strtod(buffer, &endPtr);
+        }
+    }
+    okay = ( (endPtr > buffer) && (endPtr == p) );
+    if ( buffer != bufferOnStack ) free((void*)buffer);
+    return okay;
+}
+
+//
+
+bool
+__yamlScalarStringToReal(
+    const char      *scalar,
+    size_t          scalarLength,
+    bool            isSinglePrecision,
+    double          *outValue
+)
+{
+    const char              *s, *end;
+    bool                    isNegative = false;
+    yamlScalarDecimal       decimal;
+
+    __yamlScalarTrim(scalar, scalarLength, &s, &end);
+    if ( (s < end) && ((*s == '-') || (*s == '+')) ) isNegative = (*s++ == '-');
+    if ( s >= end ) return false;
+
+    if ( __yamlScalarParseSpecialValue(s, end, outValue) ) {
+        if ( isNegative ) *outValue = -*outValue;
+        return true;
+    }
+
+    // Prefixed integer forms:
+    if ( (*s == '0') && (end - s > 2) && strchr("xXoObB", s[1]) ) {
+        unsigned long long int  magnitude;
+
+        if ( __yamlScalarParseIntegerMagnitude(s, end, false, &magnitude) ) {
+            *outValue = isSinglePrecision ? (double)(float)magnitude : (double)magnitude;
+            if ( isNegative ) *outValue = -*outValue;
+            return true;
+        }
+        // Hexadecimal floating-point, e.g. 0x1.8p3:
+        if ( (s[1] == 'x') || (s[1] == 'X') ) return __yamlScalarFallbackParse(s, end, isNegative, isSinglePrecision, outValue);
+        return false;
+    }
+
+    if ( ! __yamlScalarParseDecimal(s, end, &decimal) ) return false;
+
+    if ( decimal.mantissa == 0 ) {
+        *outValue = isNegative ? -0.0 : 0.0;
+        return true;
+    }
+#ifdef YAMLSCALAR_HAVE_EXACT_FAST_PATH
+    if ( ! decimal.isInexact ) {
+        // Clinger's fast path:  the mantissa and the power of ten are both
+        // exactly representable, so a single correctly-rounded multiply or
+        // divide produces the correctly-rounded result.
+        if ( isSinglePrecision ) {
+            uint64_t    mantissa = decimal.mantissa;
+            int         exponent = decimal.exponent;
+
+            // Shift excess powers of ten into the mantissa if it stays exact:
+            while ( (exponent > 10) && (mantissa <= (1ULL << 24) / 10) ) mantissa *= 10, exponent--;
+            if ( (mantissa <= (1ULL << 24)) && (exponent >= -10) && (exponent <= 10) ) {
+                float   f = (float)mantissa;
+
+                f = ( exponent < 0 ) ? (f / __yamlScalarPowersOfTenFloat[-exponent]) : (f * __yamlScalarPowersOfTenFloat[exponent]);
+                *outValue = isNegative ? -f : f;
+                return true;
+            }
+        } else {
+            uint64_t    mantissa = decimal.mantissa;
+            int         exponent = decimal.exponent;
+
+            while ( (exponent > 22) && (mantissa <= (1ULL << 53) / 10) ) mantissa *= 10, exponent--;
+            if ( (mantissa <= (1ULL << 53)) && (exponent >= -22) && (exponent <= 22) ) {
+                double  d = (double)mantissa;
+
+                d = ( exponent < 0 ) ? (d / __yamlScalarPowersOfTen[-exponent]) : (d * __yamlScalarPowersOfTen[exponent]);
+                *outValue = isNegative ? -d : d;
+                return true;
+            }
+        }
+    }
+#endif
+    return __yamlScalarFallbackParse(s, end, isNegative, isSinglePrecision, outValue);
+}
+
+//
+
+bool
+yamlScalarStringToDouble(
+    const char              *scalar,
+    size_t                  scalarLength,
+    double                  *outValue
+)
+{
+    return __yamlScalarStringToReal(scalar, scalarLength, false, outValue);
+}
+
+//
+
+bool
+yamlScalarStringToFloat(
+    const char              *scalar,
+    size_t                  scalarLength,
+    float                   *outValue
+)
+{
+    double                  value;
+
+    if ( ! __yamlScalarStringToReal(scalar, scalarLength, true, &value) ) return false;
+    *outValue = (float)value;
+    return true;
+}
@@ -0,0 +1,60 @@
+#include "yamlConfigFile.h"
+
+//
+// Compile YAML (or JSON) files to snapshots that
+// yamlConfigFileCreateWithSnapshotAtPath() loads without parsing, e.g. as
+// a build step for configuration files that are read by many processes.
+//
+// usage:  yaml_snapshot {-f} {-j} <yaml-file> <snapshot-file> {<yaml-file> <snapshot-file> ..}
+//
+//     -f      try the native fast-path parser first
+//             (yamlConfigFileOptions_fastParse)
+//     -j      try the native JSON parser first
+//             (yamlConfigFileOptions_jsonInput)
+//
+// The exit status is zero if every snapshot was written.
+//
+
+int
+main(
+    int                     argc,
+    const char*             argv[]
+)
+{
+    yamlOptionsBitvec       options = yamlConfigFileOptions_doNotCache | yamlConfigFileOptions_mapInputFile;
+    int                     argi = 1, rc = 0;
+
+    while ( (argi < argc) && (argv[argi][0] == '-') ) {
+        if ( strcmp(argv[argi], "-f") == 0 ) {
+            options |= yamlConfigFileOptions_fastParse;
+        } else if ( strcmp(argv[argi], "-j") == 0 ) {
+            options |= yamlConfigFileOptions_jsonInput;
+        } else {
+            fprintf(stderr, "ERROR:  unknown option %s\n", argv[argi]);
+            return EINVAL;
+        }
+        argi++;
+    }
+    if ( (argi == argc) || ((argc - argi) % 2) ) {
+        fprintf(stderr, "usage:  %s {-f} {-j} <yaml-file> <snapshot-file> {<yaml-file> <snapshot-file> ..}\n", argv[0]);
+        return EINVAL;
+    }
+    while ( argi < argc ) {
+        const char          *yamlPath = argv[argi++];
+        const char          *snapshotPath = argv[argi++];
+        yamlConfigFileRef   configFile = yamlConfigFileCreateWithFileAtPath(yamlPath, options);
+        yamlErrorCode       errorCode = 0;
+
+        if ( ! configFile ) {
+            fprintf(stderr, "ERROR:  unable to load %s\n", yamlPath);
+            rc = EIO;
+            continue;
+        }
+        if ( ! yamlConfigFileWriteSnapshotToPath(configFile, snapshotPath, &errorCode) ) {
+            fprintf(stderr, "ERROR:  unable to write snapshot %s (error %u)\n", snapshotPath, errorCode);
+            rc = EIO;
+        }
+        yamlConfigFileRelease(configFile);
+    }
+    return rc;
+}